@@ -222,6 +222,7 @@ else:
     EXCLUDE_MODULES = [
         "aud",
         "bgl",
+        "bl_math",
         "blf",
         "imbuf",
         "bmesh",
@@ -1776,7 +1777,7 @@ def write_rst_contents(basepath):
 
     standalone_modules = (
         # submodules are added in parent page
-        "mathutils", "freestyle", "bgl", "blf", "imbuf", "gpu", "gpu_extras",
+        "mathutils", "freestyle", "bgl", "bl_math", "blf", "imbuf", "gpu", "gpu_extras",
         "aud", "bpy_extras", "idprop.types", "bmesh",
     )
 
@@ -1905,6 +1906,7 @@ def write_rst_importable_modules(basepath):
 
         # C_modules
         "aud": "Audio System",
+        "bl_math": "Additional Math Functions",
         "blf": "Font Drawing",
         "imbuf": "Image Buffer",
         "gpu": "GPU Shader Module",
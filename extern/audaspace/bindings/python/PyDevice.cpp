@@ -22,6 +22,7 @@
 #include "Exception.h"
 #include "devices/IDevice.h"
 #include "devices/I3DDevice.h"
+#include "devices/SoftwareDevice.h"
 #include "devices/DeviceManager.h"
 #include "devices/IDeviceFactory.h"
 
@@ -31,6 +32,7 @@ using namespace aud;
 
 extern PyObject* AUDError;
 static const char* device_not_3d_error = "Device is not a 3D device!";
+static const char* device_not_software_error = "Device is not a software device!";
 
 // ====================================================================
 
@@ -649,6 +651,118 @@ Device_set_speed_of_sound(Device* self, PyObject* args, void* nothing)
 	return -1;
 }
 
+PyDoc_STRVAR(M_aud_Device_virtual_volume_doc,
+			 "The volume below which playing sounds become virtual.\n"
+			 "Virtual sounds keep their playback position but aren't read "
+			 "or mixed. The volume includes the distance attenuation, 0 "
+			 "disables the threshold. Only software devices support it.");
+
+static PyObject *
+Device_get_virtual_volume(Device* self, void* nothing)
+{
+	try
+	{
+		SoftwareDevice* device = dynamic_cast<SoftwareDevice*>(reinterpret_cast<std::shared_ptr<IDevice>*>(self->device)->get());
+		if(device)
+		{
+			return Py_BuildValue("f", device->getVirtualVolume());
+		}
+		else
+		{
+			PyErr_SetString(AUDError, device_not_software_error);
+			return nullptr;
+		}
+	}
+	catch(Exception& e)
+	{
+		PyErr_SetString(AUDError, e.what());
+		return nullptr;
+	}
+}
+
+static int
+Device_set_virtual_volume(Device* self, PyObject* args, void* nothing)
+{
+	float volume;
+
+	if(!PyArg_Parse(args, "f:virtual_volume", &volume))
+		return -1;
+
+	try
+	{
+		SoftwareDevice* device = dynamic_cast<SoftwareDevice*>(reinterpret_cast<std::shared_ptr<IDevice>*>(self->device)->get());
+		if(device)
+		{
+			device->setVirtualVolume(volume);
+			return 0;
+		}
+		else
+			PyErr_SetString(AUDError, device_not_software_error);
+	}
+	catch(Exception& e)
+	{
+		PyErr_SetString(AUDError, e.what());
+	}
+
+	return -1;
+}
+
+PyDoc_STRVAR(M_aud_Device_voices_maximum_doc,
+			 "The maximum number of sounds that are mixed, 0 for no limit.\n"
+			 "When more sounds are playing, the ones with the lowest priority "
+			 "and volume become virtual until others stop. Only software "
+			 "devices support it.");
+
+static PyObject *
+Device_get_voices_maximum(Device* self, void* nothing)
+{
+	try
+	{
+		SoftwareDevice* device = dynamic_cast<SoftwareDevice*>(reinterpret_cast<std::shared_ptr<IDevice>*>(self->device)->get());
+		if(device)
+		{
+			return Py_BuildValue("i", device->getMaximumVoices());
+		}
+		else
+		{
+			PyErr_SetString(AUDError, device_not_software_error);
+			return nullptr;
+		}
+	}
+	catch(Exception& e)
+	{
+		PyErr_SetString(AUDError, e.what());
+		return nullptr;
+	}
+}
+
+static int
+Device_set_voices_maximum(Device* self, PyObject* args, void* nothing)
+{
+	int count;
+
+	if(!PyArg_Parse(args, "i:voices_maximum", &count))
+		return -1;
+
+	try
+	{
+		SoftwareDevice* device = dynamic_cast<SoftwareDevice*>(reinterpret_cast<std::shared_ptr<IDevice>*>(self->device)->get());
+		if(device)
+		{
+			device->setMaximumVoices(count);
+			return 0;
+		}
+		else
+			PyErr_SetString(AUDError, device_not_software_error);
+	}
+	catch(Exception& e)
+	{
+		PyErr_SetString(AUDError, e.what());
+	}
+
+	return -1;
+}
+
 PyDoc_STRVAR(M_aud_Device_volume_doc,
 			 "The overall volume of the device.");
 
@@ -705,6 +819,10 @@ static PyGetSetDef Device_properties[] = {
 	 M_aud_Device_rate_doc, nullptr },
 	{(char*)"speed_of_sound", (getter)Device_get_speed_of_sound, (setter)Device_set_speed_of_sound,
 	 M_aud_Device_speed_of_sound_doc, nullptr },
+	{(char*)"virtual_volume", (getter)Device_get_virtual_volume, (setter)Device_set_virtual_volume,
+	 M_aud_Device_virtual_volume_doc, nullptr },
+	{(char*)"voices_maximum", (getter)Device_get_voices_maximum, (setter)Device_set_voices_maximum,
+	 M_aud_Device_voices_maximum_doc, nullptr },
 	{(char*)"volume", (getter)Device_get_volume, (setter)Device_set_volume,
 	 M_aud_Device_volume_doc, nullptr },
 	{nullptr}  /* Sentinel */
@@ -18,6 +18,7 @@
 
 #include "devices/IHandle.h"
 #include "devices/I3DHandle.h"
+#include "devices/SoftwareDevice.h"
 #include "Exception.h"
 
 #include <memory>
@@ -28,6 +29,7 @@ using namespace aud;
 
 extern PyObject* AUDError;
 static const char* device_not_3d_error = "Device is not a 3D device!";
+static const char* device_not_software_error = "Device is not a software device!";
 
 static void
 Handle_dealloc(Handle* self)
@@ -727,6 +729,48 @@ Handle_set_position(Handle* self, PyObject* args, void* nothing)
 	return -1;
 }
 
+PyDoc_STRVAR(M_aud_Handle_priority_doc,
+			 "The priority of the sound, the default is 0.\n"
+			 "When the device limits the number of mixed sounds, the ones "
+			 "with the lowest priority become virtual first. Only handles of "
+			 "software devices support it.");
+
+static PyObject *
+Handle_get_priority(Handle* self, void* nothing)
+{
+	try
+	{
+		return Py_BuildValue("i", SoftwareDevice::getPriority(reinterpret_cast<std::shared_ptr<IHandle>*>(self->handle)->get()));
+	}
+	catch(Exception& e)
+	{
+		PyErr_SetString(AUDError, e.what());
+		return nullptr;
+	}
+}
+
+static int
+Handle_set_priority(Handle* self, PyObject* args, void* nothing)
+{
+	int priority;
+
+	if(!PyArg_Parse(args, "i:priority", &priority))
+		return -1;
+
+	try
+	{
+		if(SoftwareDevice::setPriority(reinterpret_cast<std::shared_ptr<IHandle>*>(self->handle)->get(), priority))
+			return 0;
+		PyErr_SetString(AUDError, device_not_software_error);
+	}
+	catch(Exception& e)
+	{
+		PyErr_SetString(AUDError, e.what());
+	}
+
+	return -1;
+}
+
 PyDoc_STRVAR(M_aud_Handle_relative_doc,
 			 "Whether the source's location, velocity and orientation is relative or absolute to the listener.");
 
@@ -1031,6 +1075,8 @@ static PyGetSetDef Handle_properties[] = {
 	 M_aud_Handle_pitch_doc, nullptr },
 	{(char*)"position", (getter)Handle_get_position, (setter)Handle_set_position,
 	 M_aud_Handle_position_doc, nullptr },
+	{(char*)"priority", (getter)Handle_get_priority, (setter)Handle_set_priority,
+	 M_aud_Handle_priority_doc, nullptr },
 	{(char*)"relative", (getter)Handle_get_relative, (setter)Handle_set_relative,
 	 M_aud_Handle_relative_doc, nullptr },
 	{(char*)"status", (getter)Handle_get_status, nullptr,
@@ -28,9 +28,14 @@
 #include "devices/I3DHandle.h"
 #include "devices/DefaultSynchronizer.h"
 #include "util/Buffer.h"
+#include "util/CommandQueue.h"
+#include "util/ThreadPool.h"
 
+#include <future>
 #include <list>
+#include <memory>
 #include <mutex>
+#include <vector>
 
 AUD_NAMESPACE_BEGIN
 
@@ -51,8 +56,29 @@ class ChannelMapperReader;
 class AUD_API SoftwareDevice : public IDevice, public I3DDevice
 {
 protected:
+	/// Properties of a handle that the mixer applies from the command queue.
+	enum HandleProperty
+	{
+		PROPERTY_VOLUME,
+		PROPERTY_PITCH,
+		PROPERTY_PAN,
+		PROPERTY_LOCATION,
+		PROPERTY_VELOCITY,
+		PROPERTY_ORIENTATION,
+		PROPERTY_RELATIVE,
+		PROPERTY_VOLUME_MAXIMUM,
+		PROPERTY_VOLUME_MINIMUM,
+		PROPERTY_DISTANCE_MAXIMUM,
+		PROPERTY_DISTANCE_REFERENCE,
+		PROPERTY_ATTENUATION,
+		PROPERTY_CONE_ANGLE_OUTER,
+		PROPERTY_CONE_ANGLE_INNER,
+		PROPERTY_CONE_VOLUME_OUTER,
+		PROPERTY_PRIORITY
+	};
+
 	/// Saves the data for playback.
-	class AUD_API SoftwareHandle : public IHandle, public I3DHandle
+	class AUD_API SoftwareHandle : public IHandle, public I3DHandle, public std::enable_shared_from_this<SoftwareHandle>
 	{
 	private:
 		// delete copy constructor and operator=
@@ -144,6 +170,56 @@ protected:
 		/// Own device.
 		SoftwareDevice* m_device;
 
+		/// Voices with higher priority are rendered first when the number of voices is limited.
+		int m_priority;
+
+		/// Whether the voice is virtual, its position is tracked without reading it.
+		bool m_virtual;
+
+		/// The position of the reader while the voice is virtual.
+		int m_virtual_position;
+
+		/// The buffer the voice is rendered to when rendering in parallel.
+		Buffer m_render_buffer;
+
+		/// The number of samples of the last render.
+		int m_render_length;
+
+		/// Whether the end of the sound was reached during the last render.
+		bool m_render_eos;
+
+		/**
+		 * The properties as last set by the user, returned by the getters.
+		 * The mixer uses the members above, which are only changed by commands.
+		 */
+		struct
+		{
+			float pitch;
+			float volume;
+			float pan;
+			Vector3 location;
+			Vector3 velocity;
+			Quaternion orientation;
+			bool relative;
+			float volume_max;
+			float volume_min;
+			float distance_max;
+			float distance_reference;
+			float attenuation;
+			float cone_angle_outer;
+			float cone_angle_inner;
+			float cone_volume_outer;
+			int priority;
+		} m_user;
+
+		/**
+		 * Posts a property change to the mixer.
+		 * \param property The property to change.
+		 * \param value The new value, up to four floats.
+		 * \param count The number of floats in value.
+		 */
+		void post(HandleProperty property, const float* value, int count);
+
 		/**
 		 * This method is for internal use only.
 		 * @param keep Whether the sound should be marked stopped or paused.
@@ -174,6 +250,34 @@ protected:
 		 */
 		void setSpecs(Specs specs);
 
+		/**
+		 * Applies a property change, called by the mixer with the device locked.
+		 * \param property The property to change.
+		 * \param value The new value.
+		 */
+		void apply(HandleProperty property, const float* value);
+
+		/**
+		 * Reads the next samples of a real voice, looping if necessary.
+		 * The result is stored in m_render_length and m_render_eos.
+		 * \param buffer The target buffer.
+		 * \param length The length in samples to read.
+		 */
+		void render(sample_t* buffer, int length);
+
+		/**
+		 * Advances a virtual voice without reading it, looping if necessary.
+		 * The end of the sound is stored in m_render_eos.
+		 * \param length The length in samples to skip.
+		 */
+		void skip(int length);
+
+		/**
+		 * Makes the voice virtual or real.
+		 * \param virtualize Whether the voice should be virtual.
+		 */
+		void setVirtual(bool virtualize);
+
 		virtual ~SoftwareHandle() {}
 		virtual bool pause();
 		virtual bool resume();
@@ -242,6 +346,12 @@ protected:
 	 */
 	void destroy();
 
+	/**
+	 * Applies all pending handle property changes.
+	 * \warning The device has to be locked.
+	 */
+	void applyCommands();
+
 	/**
 	 * Mixes the next samples into the buffer.
 	 * \param buffer The target buffer.
@@ -283,6 +393,31 @@ private:
 	 */
 	std::list<std::shared_ptr<SoftwareHandle> > m_pausedSounds;
 
+	/**
+	 * The maximum number of voices rendered at once, 0 for no limit.
+	 */
+	int m_max_voices;
+
+	/**
+	 * Voices with a volume below are virtual.
+	 */
+	float m_virtual_volume;
+
+	/**
+	 * The thread pool to render voices in parallel, may be null.
+	 */
+	std::shared_ptr<ThreadPool> m_thread_pool;
+
+	/**
+	 * The voices of the current mix, kept to avoid allocations.
+	 */
+	std::vector<SoftwareHandle*> m_voices;
+
+	/**
+	 * The pending voice renders of the current mix.
+	 */
+	std::vector<std::future<void> > m_renders;
+
 	/**
 	 * Whether there is currently playback.
 	 */
@@ -290,9 +425,29 @@ private:
 
 	/**
 	 * The mutex for locking.
+	 * Only structural changes like playing, pausing and stopping sounds take it,
+	 * handle property changes are passed through the command queue.
 	 */
 	std::recursive_mutex m_mutex;
 
+	/// A handle property change.
+	struct HandleCommand
+	{
+		/// The handle to change, keeps it alive until the command is applied.
+		std::shared_ptr<SoftwareHandle> handle;
+
+		/// The property to change.
+		HandleProperty property;
+
+		/// The new value.
+		float value[4];
+	};
+
+	/**
+	 * Handle property changes from user threads, applied at the start of every mix.
+	 */
+	CommandQueue<HandleCommand> m_commands;
+
 	/**
 	 * The overall volume of the device.
 	 */
@@ -335,6 +490,56 @@ public:
 	 */
 	static void setPanning(IHandle* handle, float pan);
 
+	/**
+	 * Sets the priority of a specific handle.
+	 * When more voices are playing than the maximum number of voices,
+	 * the ones with the lowest priority and volume become virtual.
+	 * Handles of other devices are ignored.
+	 * \param handle The handle to set the priority from.
+	 * \param priority The new priority, the default is 0.
+	 * \return Whether the handle is a handle of a software device.
+	 */
+	static bool setPriority(IHandle* handle, int priority);
+
+	/**
+	 * Retrieves the priority of a specific handle.
+	 * \param handle The handle to get the priority from.
+	 * \return The priority, 0 for handles of other devices.
+	 */
+	static int getPriority(IHandle* handle);
+
+	/**
+	 * Sets the maximum number of voices that are rendered.
+	 * The other voices are virtual: they keep their playback position
+	 * but aren't read, decoded or mixed.
+	 * \param count The maximum number of voices, 0 for no limit.
+	 */
+	void setMaximumVoices(int count);
+
+	/**
+	 * Retrieves the maximum number of voices that are rendered.
+	 * \return The maximum number of voices, 0 for no limit.
+	 */
+	int getMaximumVoices() const;
+
+	/**
+	 * Sets the volume below which voices become virtual.
+	 * \param volume The calculated volume including distance attenuation, 0 to disable.
+	 */
+	void setVirtualVolume(float volume);
+
+	/**
+	 * Retrieves the volume below which voices become virtual.
+	 * \return The volume threshold.
+	 */
+	float getVirtualVolume() const;
+
+	/**
+	 * Sets the number of threads that render voices in parallel before they are mixed.
+	 * \param count The number of threads, 0 to render the voices while mixing.
+	 */
+	void setRenderThreads(int count);
+
 	/**
 	 * Sets the resampling quality.
 	 * \param quality Low (false) or high (true) quality.
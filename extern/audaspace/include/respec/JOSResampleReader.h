@@ -33,8 +33,6 @@ AUD_NAMESPACE_BEGIN
 class AUD_API JOSResampleReader : public ResampleReader
 {
 private:
-	typedef void (JOSResampleReader::*resample_f)(double target_factor, int length, sample_t* buffer);
-
 	/**
 	 * The half filter length.
 	 */
@@ -81,9 +79,9 @@ private:
 	int m_cache_valid;
 
 	/**
-	 * Resample function.
+	 * Double buffer for the filter weights of one wing.
 	 */
-	resample_f m_resample;
+	Buffer m_weights;
 
 	/**
 	 * Last resampling factor.
@@ -107,9 +105,13 @@ private:
 	 */
 	void AUD_LOCAL updateBuffer(int size, double factor, int samplesize);
 
+	/**
+	 * Resamples the cached input data.
+	 * \param target_factor The resampling factor to reach at the end of the buffer.
+	 * \param length The number of frames to produce.
+	 * \param buffer The output buffer.
+	 */
 	void AUD_LOCAL resample(double target_factor, int length, sample_t* buffer);
-	void AUD_LOCAL resample_mono(double target_factor, int length, sample_t* buffer);
-	void AUD_LOCAL resample_stereo(double target_factor, int length, sample_t* buffer);
 
 public:
 	/**
@@ -0,0 +1,127 @@
+/*******************************************************************************
+ * Copyright 2009-2016 Jörg Müller
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+#pragma once
+
+/**
+ * @file CommandQueue.h
+ * @ingroup util
+ * The CommandQueue class.
+ */
+
+#include "Audaspace.h"
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+AUD_NAMESPACE_BEGIN
+
+/**
+ * This class is a bounded FIFO queue of commands, passed from user threads to a
+ * consumer thread, usually the audio mixing thread.
+ *
+ * The consumer never blocks: it only reads the atomic write position to know
+ * which commands are ready. Pushing threads are serialized with a spin lock
+ * among each other, so that several user threads can post commands, but they
+ * never wait for the consumer.
+ *
+ * Only one thread at a time may pop commands.
+ */
+template <class T>
+class CommandQueue
+{
+private:
+	/// The command slots, the size is a power of two.
+	std::vector<T> m_commands;
+
+	/// Mask to wrap positions to the slot index.
+	size_t m_mask;
+
+	/// The position of the next command to pop.
+	std::atomic<size_t> m_read;
+
+	/// The position of the next command to push.
+	std::atomic<size_t> m_write;
+
+	/// Serializes pushing threads.
+	std::atomic_flag m_push_lock = ATOMIC_FLAG_INIT;
+
+	// delete copy constructor and operator=
+	CommandQueue(const CommandQueue&) = delete;
+	CommandQueue& operator=(const CommandQueue&) = delete;
+
+public:
+	/**
+	 * Creates a new command queue.
+	 * \param size The minimum number of commands the queue can hold, rounded up to a power of two.
+	 */
+	CommandQueue(size_t size) :
+		m_read(0), m_write(0)
+	{
+		size_t capacity = 1;
+		while(capacity < size)
+			capacity <<= 1;
+
+		m_commands.resize(capacity);
+		m_mask = capacity - 1;
+	}
+
+	/**
+	 * Appends a command to the queue.
+	 * \param command The command, moved into the queue on success.
+	 * \return Whether the command was added, false if the queue is full.
+	 */
+	bool push(T& command)
+	{
+		while(m_push_lock.test_and_set(std::memory_order_acquire))
+			;
+
+		size_t write = m_write.load(std::memory_order_relaxed);
+		bool pushed = write - m_read.load(std::memory_order_acquire) <= m_mask;
+
+		if(pushed)
+		{
+			m_commands[write & m_mask] = std::move(command);
+			m_write.store(write + 1, std::memory_order_release);
+		}
+
+		m_push_lock.clear(std::memory_order_release);
+
+		return pushed;
+	}
+
+	/**
+	 * Removes the oldest command from the queue.
+	 * \param command The command is moved here.
+	 * \return Whether a command was available.
+	 */
+	bool pop(T& command)
+	{
+		size_t read = m_read.load(std::memory_order_relaxed);
+
+		if(read == m_write.load(std::memory_order_acquire))
+			return false;
+
+		command = std::move(m_commands[read & m_mask]);
+		m_read.store(read + 1, std::memory_order_release);
+
+		return true;
+	}
+};
+
+AUD_NAMESPACE_END
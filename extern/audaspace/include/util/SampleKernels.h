@@ -0,0 +1,113 @@
+/*******************************************************************************
+ * Copyright 2009-2016 Jörg Müller
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+#pragma once
+
+/**
+ * @file SampleKernels.h
+ * @ingroup util
+ * The sample processing kernels used in the hot loops of mixing, conversion and resampling.
+ */
+
+#include "Audaspace.h"
+
+AUD_NAMESPACE_BEGIN
+
+/// The instruction sets sample kernels can be implemented with.
+enum SIMDLevel
+{
+	SIMD_NONE = 0,	/// Scalar C++.
+	SIMD_SSE2,		/// SSE2, always available on x86-64.
+	SIMD_AVX,		/// AVX, selected when the CPU supports it.
+	SIMD_NEON		/// NEON, always available on AArch64.
+};
+
+/**
+ * A set of sample processing kernels implemented with one instruction set.
+ * All kernels of a set give the same results as the scalar ones, except for
+ * weighted_sum, which may accumulate in a different order.
+ */
+struct AUD_API SampleKernels
+{
+	/// The instruction set of the kernels.
+	SIMDLevel level;
+
+	/**
+	 * Adds samples multiplied with a volume: target += source * volume.
+	 * \param target The target buffer.
+	 * \param source The source buffer.
+	 * \param length The number of samples (not frames).
+	 * \param volume The volume.
+	 */
+	void (*add)(sample_t* target, const sample_t* source, int length, float volume);
+
+	/**
+	 * Adds samples multiplied with a volume, that is linearly interpolated
+	 * from volume_from at the first frame towards volume_to.
+	 * \param target The target buffer.
+	 * \param source The source buffer.
+	 * \param length The number of frames.
+	 * \param channels The number of interleaved channels.
+	 * \param volume_to The volume to interpolate to.
+	 * \param volume_from The volume of the first frame.
+	 */
+	void (*add_ramp)(sample_t* target, const sample_t* source, int length, int channels, float volume_to, float volume_from);
+
+	/**
+	 * Multiplies samples with a volume.
+	 * \param buffer The buffer.
+	 * \param length The number of samples (not frames).
+	 * \param volume The volume.
+	 */
+	void (*scale)(sample_t* buffer, int length, float volume);
+
+	/// Converts float samples to signed 16 bit, see convert_float_s16.
+	void (*convert_float_s16)(data_t* target, data_t* source, int length);
+
+	/// Converts signed 16 bit samples to float, in place too, see convert_s16_float.
+	void (*convert_s16_float)(data_t* target, data_t* source, int length);
+
+	/// Converts float samples to signed 32 bit, see convert_float_s32.
+	void (*convert_float_s32)(data_t* target, data_t* source, int length);
+
+	/// Converts signed 32 bit samples to float, see convert_s32_float.
+	void (*convert_s32_float)(data_t* target, data_t* source, int length);
+
+	/**
+	 * Accumulates frames multiplied with a weight per frame: sums[c] += data[i][c] * weights[i].
+	 * \param sums The sums, one per channel.
+	 * \param data The interleaved frames.
+	 * \param weights The weights, one per frame.
+	 * \param length The number of frames.
+	 * \param channels The number of interleaved channels.
+	 */
+	void (*weighted_sum)(double* sums, const sample_t* data, const double* weights, int length, int channels);
+};
+
+/**
+ * Returns the kernels of the best instruction set the CPU supports, chosen at runtime.
+ * \return The kernels.
+ */
+AUD_API const SampleKernels& getSampleKernels();
+
+/**
+ * Returns the kernels of a specific instruction set.
+ * \param level The instruction set.
+ * \return The kernels, nullptr if the build or the CPU doesn't support the instruction set.
+ */
+AUD_API const SampleKernels* getSampleKernels(SIMDLevel level);
+
+AUD_NAMESPACE_END
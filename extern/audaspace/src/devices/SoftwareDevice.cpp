@@ -81,8 +81,39 @@ SoftwareDevice::SoftwareHandle::SoftwareHandle(SoftwareDevice* device, std::shar
 	m_reader(reader), m_pitch(pitch), m_resampler(resampler), m_mapper(mapper), m_keep(keep), m_user_pitch(1.0f), m_user_volume(1.0f), m_user_pan(0.0f), m_volume(0.0f), m_old_volume(0.0f), m_loopcount(0),
 	m_relative(true), m_volume_max(1.0f), m_volume_min(0), m_distance_max(std::numeric_limits<float>::max()),
 	m_distance_reference(1.0f), m_attenuation(1.0f), m_cone_angle_outer(M_PI), m_cone_angle_inner(M_PI), m_cone_volume_outer(0),
-	m_flags(RENDER_CONE), m_stop(nullptr), m_stop_data(nullptr), m_status(STATUS_PLAYING), m_device(device)
-{
+	m_flags(RENDER_CONE), m_stop(nullptr), m_stop_data(nullptr), m_status(STATUS_PLAYING), m_device(device),
+	m_priority(0), m_virtual(false), m_virtual_position(0), m_render_length(0), m_render_eos(false)
+{
+	m_user.pitch = m_user_pitch;
+	m_user.volume = m_user_volume;
+	m_user.pan = m_user_pan;
+	m_user.relative = m_relative;
+	m_user.volume_max = m_volume_max;
+	m_user.volume_min = m_volume_min;
+	m_user.distance_max = m_distance_max;
+	m_user.distance_reference = m_distance_reference;
+	m_user.attenuation = m_attenuation;
+	m_user.cone_angle_outer = m_cone_angle_outer;
+	m_user.cone_angle_inner = m_cone_angle_inner;
+	m_user.cone_volume_outer = m_cone_volume_outer;
+	m_user.priority = m_priority;
+}
+
+void SoftwareDevice::SoftwareHandle::post(HandleProperty property, const float* value, int count)
+{
+	HandleCommand command;
+	command.handle = shared_from_this();
+	command.property = property;
+	std::memcpy(command.value, value, count * sizeof(float));
+
+	if(!m_device->m_commands.push(command))
+	{
+		// the mixer doesn't keep up, apply the change directly
+		std::lock_guard<ILockable> lock(*m_device);
+
+		m_device->applyCommands();
+		apply(property, value);
+	}
 }
 
 void SoftwareDevice::SoftwareHandle::update()
@@ -245,6 +276,154 @@ void SoftwareDevice::SoftwareHandle::setSpecs(Specs specs)
 	m_resampler->setRate(specs.rate);
 }
 
+void SoftwareDevice::SoftwareHandle::apply(HandleProperty property, const float* value)
+{
+	switch(property)
+	{
+	case PROPERTY_VOLUME:
+		m_user_volume = value[0];
+
+		if(value[0] == 0)
+		{
+			m_old_volume = m_volume = value[0];
+			m_flags |= RENDER_VOLUME;
+		}
+		else
+			m_flags &= ~RENDER_VOLUME;
+		break;
+	case PROPERTY_PITCH:
+		m_user_pitch = value[0];
+		break;
+	case PROPERTY_PAN:
+		m_user_pan = value[0];
+		break;
+	case PROPERTY_LOCATION:
+		m_location = Vector3(value[0], value[1], value[2]);
+		break;
+	case PROPERTY_VELOCITY:
+		m_velocity = Vector3(value[0], value[1], value[2]);
+		break;
+	case PROPERTY_ORIENTATION:
+		m_orientation = Quaternion(value[0], value[1], value[2], value[3]);
+		break;
+	case PROPERTY_RELATIVE:
+		m_relative = value[0] != 0;
+		break;
+	case PROPERTY_VOLUME_MAXIMUM:
+		m_volume_max = value[0];
+		break;
+	case PROPERTY_VOLUME_MINIMUM:
+		m_volume_min = value[0];
+		break;
+	case PROPERTY_DISTANCE_MAXIMUM:
+		m_distance_max = value[0];
+		break;
+	case PROPERTY_DISTANCE_REFERENCE:
+		m_distance_reference = value[0];
+		break;
+	case PROPERTY_ATTENUATION:
+		m_attenuation = value[0];
+
+		if(value[0] == 0)
+			m_flags |= RENDER_DISTANCE;
+		else
+			m_flags &= ~RENDER_DISTANCE;
+		break;
+	case PROPERTY_CONE_ANGLE_OUTER:
+		m_cone_angle_outer = value[0];
+		break;
+	case PROPERTY_CONE_ANGLE_INNER:
+		if(value[0] >= float(M_PI))
+			m_flags |= RENDER_CONE;
+		else
+			m_flags &= ~RENDER_CONE;
+
+		m_cone_angle_inner = value[0];
+		break;
+	case PROPERTY_CONE_VOLUME_OUTER:
+		m_cone_volume_outer = value[0];
+		break;
+	case PROPERTY_PRIORITY:
+		m_priority = int(value[0]);
+		break;
+	}
+}
+
+void SoftwareDevice::SoftwareHandle::render(sample_t* buffer, int length)
+{
+	int pos = 0;
+	int len = length;
+	bool eos = false;
+
+	try
+	{
+		m_reader->read(len, eos, buffer);
+
+		// in case of looping
+		while(pos + len < length && m_loopcount && eos)
+		{
+			pos += len;
+
+			if(m_loopcount > 0)
+				m_loopcount--;
+
+			m_reader->seek(0);
+
+			len = length - pos;
+			m_reader->read(len, eos, buffer + pos * m_device->m_specs.channels);
+
+			// prevent endless loop
+			if(!len)
+				break;
+		}
+	}
+	catch(Exception& e)
+	{
+		len = 0;
+		std::cerr << "Caught exception while reading sound data during playback with software mixing: " << e.getMessage() << std::endl;
+	}
+
+	m_render_length = pos + len;
+	m_render_eos = eos;
+}
+
+void SoftwareDevice::SoftwareHandle::skip(int length)
+{
+	int reader_length = m_reader->getLength();
+
+	m_virtual_position += length;
+	m_render_eos = false;
+
+	// in case of looping, unknown lengths never end
+	while(reader_length > 0 && m_virtual_position >= reader_length)
+	{
+		if(!m_loopcount)
+		{
+			m_virtual_position = reader_length;
+			m_render_eos = true;
+			break;
+		}
+
+		if(m_loopcount > 0)
+			m_loopcount--;
+
+		m_virtual_position -= reader_length;
+	}
+}
+
+void SoftwareDevice::SoftwareHandle::setVirtual(bool virtualize)
+{
+	if(virtualize == m_virtual)
+		return;
+
+	if(virtualize)
+		m_virtual_position = m_reader->getPosition();
+	else
+		m_reader->seek(m_virtual_position);
+
+	m_virtual = virtualize;
+}
+
 bool SoftwareDevice::SoftwareHandle::pause()
 {
 	return pause(false);
@@ -360,6 +539,9 @@ bool SoftwareDevice::SoftwareHandle::seek(double position)
 	m_pitch->setPitch(m_user_pitch);
 	m_reader->seek((int)(position * m_reader->getSpecs().rate));
 
+	if(m_virtual)
+		m_virtual_position = m_reader->getPosition();
+
 	if(m_status == STATUS_STOPPED)
 		m_status = STATUS_PAUSED;
 
@@ -376,7 +558,7 @@ double SoftwareDevice::SoftwareHandle::getPosition()
 	if(!m_status)
 		return 0.0f;
 
-	double position = m_reader->getPosition() / (double)m_device->m_specs.rate;
+	double position = (m_virtual ? m_virtual_position : m_reader->getPosition()) / (double)m_device->m_specs.rate;
 
 	return position;
 }
@@ -388,37 +570,36 @@ Status SoftwareDevice::SoftwareHandle::getStatus()
 
 float SoftwareDevice::SoftwareHandle::getVolume()
 {
-	return m_user_volume;
+	return m_user.volume;
 }
 
 bool SoftwareDevice::SoftwareHandle::setVolume(float volume)
 {
 	if(!m_status)
 		return false;
-	m_user_volume = volume;
 
-	if(volume == 0)
-	{
-		m_old_volume = m_volume = volume;
-		m_flags |= RENDER_VOLUME;
-	}
-	else
-		m_flags &= ~RENDER_VOLUME;
+	m_user.volume = volume;
+	post(PROPERTY_VOLUME, &m_user.volume, 1);
 
 	return true;
 }
 
 float SoftwareDevice::SoftwareHandle::getPitch()
 {
-	return m_user_pitch;
+	return m_user.pitch;
 }
 
 bool SoftwareDevice::SoftwareHandle::setPitch(float pitch)
 {
 	if(!m_status)
 		return false;
-	if(pitch > 0.0f)
-		m_user_pitch = pitch;
+
+	if(pitch <= 0.0f)
+		return true;
+
+	m_user.pitch = pitch;
+	post(PROPERTY_PITCH, &m_user.pitch, 1);
+
 	return true;
 }
 
@@ -469,7 +650,7 @@ Vector3 SoftwareDevice::SoftwareHandle::getLocation()
 	if(!m_status)
 		return Vector3();
 
-	return m_location;
+	return m_user.location;
 }
 
 bool SoftwareDevice::SoftwareHandle::setLocation(const Vector3& location)
@@ -477,7 +658,8 @@ bool SoftwareDevice::SoftwareHandle::setLocation(const Vector3& location)
 	if(!m_status)
 		return false;
 
-	m_location = location;
+	m_user.location = location;
+	post(PROPERTY_LOCATION, m_user.location.get(), 3);
 
 	return true;
 }
@@ -487,7 +669,7 @@ Vector3 SoftwareDevice::SoftwareHandle::getVelocity()
 	if(!m_status)
 		return Vector3();
 
-	return m_velocity;
+	return m_user.velocity;
 }
 
 bool SoftwareDevice::SoftwareHandle::setVelocity(const Vector3& velocity)
@@ -495,7 +677,8 @@ bool SoftwareDevice::SoftwareHandle::setVelocity(const Vector3& velocity)
 	if(!m_status)
 		return false;
 
-	m_velocity = velocity;
+	m_user.velocity = velocity;
+	post(PROPERTY_VELOCITY, m_user.velocity.get(), 3);
 
 	return true;
 }
@@ -505,7 +688,7 @@ Quaternion SoftwareDevice::SoftwareHandle::getOrientation()
 	if(!m_status)
 		return Quaternion();
 
-	return m_orientation;
+	return m_user.orientation;
 }
 
 bool SoftwareDevice::SoftwareHandle::setOrientation(const Quaternion& orientation)
@@ -513,7 +696,8 @@ bool SoftwareDevice::SoftwareHandle::setOrientation(const Quaternion& orientatio
 	if(!m_status)
 		return false;
 
-	m_orientation = orientation;
+	m_user.orientation = orientation;
+	post(PROPERTY_ORIENTATION, m_user.orientation.get(), 4);
 
 	return true;
 }
@@ -523,7 +707,7 @@ bool SoftwareDevice::SoftwareHandle::isRelative()
 	if(!m_status)
 		return false;
 
-	return m_relative;
+	return m_user.relative;
 }
 
 bool SoftwareDevice::SoftwareHandle::setRelative(bool relative)
@@ -531,7 +715,10 @@ bool SoftwareDevice::SoftwareHandle::setRelative(bool relative)
 	if(!m_status)
 		return false;
 
-	m_relative = relative;
+	m_user.relative = relative;
+
+	float value = relative ? 1.0f : 0.0f;
+	post(PROPERTY_RELATIVE, &value, 1);
 
 	return true;
 }
@@ -541,7 +728,7 @@ float SoftwareDevice::SoftwareHandle::getVolumeMaximum()
 	if(!m_status)
 		return std::numeric_limits<float>::quiet_NaN();
 
-	return m_volume_max;
+	return m_user.volume_max;
 }
 
 bool SoftwareDevice::SoftwareHandle::setVolumeMaximum(float volume)
@@ -549,7 +736,8 @@ bool SoftwareDevice::SoftwareHandle::setVolumeMaximum(float volume)
 	if(!m_status)
 		return false;
 
-	m_volume_max = volume;
+	m_user.volume_max = volume;
+	post(PROPERTY_VOLUME_MAXIMUM, &m_user.volume_max, 1);
 
 	return true;
 }
@@ -559,7 +747,7 @@ float SoftwareDevice::SoftwareHandle::getVolumeMinimum()
 	if(!m_status)
 		return std::numeric_limits<float>::quiet_NaN();
 
-	return m_volume_min;
+	return m_user.volume_min;
 }
 
 bool SoftwareDevice::SoftwareHandle::setVolumeMinimum(float volume)
@@ -567,7 +755,8 @@ bool SoftwareDevice::SoftwareHandle::setVolumeMinimum(float volume)
 	if(!m_status)
 		return false;
 
-	m_volume_min = volume;
+	m_user.volume_min = volume;
+	post(PROPERTY_VOLUME_MINIMUM, &m_user.volume_min, 1);
 
 	return true;
 }
@@ -577,7 +766,7 @@ float SoftwareDevice::SoftwareHandle::getDistanceMaximum()
 	if(!m_status)
 		return std::numeric_limits<float>::quiet_NaN();
 
-	return m_distance_max;
+	return m_user.distance_max;
 }
 
 bool SoftwareDevice::SoftwareHandle::setDistanceMaximum(float distance)
@@ -585,7 +774,8 @@ bool SoftwareDevice::SoftwareHandle::setDistanceMaximum(float distance)
 	if(!m_status)
 		return false;
 
-	m_distance_max = distance;
+	m_user.distance_max = distance;
+	post(PROPERTY_DISTANCE_MAXIMUM, &m_user.distance_max, 1);
 
 	return true;
 }
@@ -595,7 +785,7 @@ float SoftwareDevice::SoftwareHandle::getDistanceReference()
 	if(!m_status)
 		return std::numeric_limits<float>::quiet_NaN();
 
-	return m_distance_reference;
+	return m_user.distance_reference;
 }
 
 bool SoftwareDevice::SoftwareHandle::setDistanceReference(float distance)
@@ -603,7 +793,8 @@ bool SoftwareDevice::SoftwareHandle::setDistanceReference(float distance)
 	if(!m_status)
 		return false;
 
-	m_distance_reference = distance;
+	m_user.distance_reference = distance;
+	post(PROPERTY_DISTANCE_REFERENCE, &m_user.distance_reference, 1);
 
 	return true;
 }
@@ -613,7 +804,7 @@ float SoftwareDevice::SoftwareHandle::getAttenuation()
 	if(!m_status)
 		return std::numeric_limits<float>::quiet_NaN();
 
-	return m_attenuation;
+	return m_user.attenuation;
 }
 
 bool SoftwareDevice::SoftwareHandle::setAttenuation(float factor)
@@ -621,12 +812,8 @@ bool SoftwareDevice::SoftwareHandle::setAttenuation(float factor)
 	if(!m_status)
 		return false;
 
-	m_attenuation = factor;
-
-	if(factor == 0)
-		m_flags |= RENDER_DISTANCE;
-	else
-		m_flags &= ~RENDER_DISTANCE;
+	m_user.attenuation = factor;
+	post(PROPERTY_ATTENUATION, &m_user.attenuation, 1);
 
 	return true;
 }
@@ -636,7 +823,7 @@ float SoftwareDevice::SoftwareHandle::getConeAngleOuter()
 	if(!m_status)
 		return std::numeric_limits<float>::quiet_NaN();
 
-	return m_cone_angle_outer * 360.0f / M_PI;
+	return m_user.cone_angle_outer * 360.0f / M_PI;
 }
 
 bool SoftwareDevice::SoftwareHandle::setConeAngleOuter(float angle)
@@ -644,7 +831,8 @@ bool SoftwareDevice::SoftwareHandle::setConeAngleOuter(float angle)
 	if(!m_status)
 		return false;
 
-	m_cone_angle_outer = angle * M_PI / 360.0f;
+	m_user.cone_angle_outer = angle * M_PI / 360.0f;
+	post(PROPERTY_CONE_ANGLE_OUTER, &m_user.cone_angle_outer, 1);
 
 	return true;
 }
@@ -654,7 +842,7 @@ float SoftwareDevice::SoftwareHandle::getConeAngleInner()
 	if(!m_status)
 		return std::numeric_limits<float>::quiet_NaN();
 
-	return m_cone_angle_inner * 360.0f / M_PI;
+	return m_user.cone_angle_inner * 360.0f / M_PI;
 }
 
 bool SoftwareDevice::SoftwareHandle::setConeAngleInner(float angle)
@@ -662,12 +850,8 @@ bool SoftwareDevice::SoftwareHandle::setConeAngleInner(float angle)
 	if(!m_status)
 		return false;
 
-	if(angle >= 360)
-		m_flags |= RENDER_CONE;
-	else
-		m_flags &= ~RENDER_CONE;
-
-	m_cone_angle_inner = angle * M_PI / 360.0f;
+	m_user.cone_angle_inner = angle * M_PI / 360.0f;
+	post(PROPERTY_CONE_ANGLE_INNER, &m_user.cone_angle_inner, 1);
 
 	return true;
 }
@@ -677,7 +861,7 @@ float SoftwareDevice::SoftwareHandle::getConeVolumeOuter()
 	if(!m_status)
 		return std::numeric_limits<float>::quiet_NaN();
 
-	return m_cone_volume_outer;
+	return m_user.cone_volume_outer;
 }
 
 bool SoftwareDevice::SoftwareHandle::setConeVolumeOuter(float volume)
@@ -685,7 +869,8 @@ bool SoftwareDevice::SoftwareHandle::setConeVolumeOuter(float volume)
 	if(!m_status)
 		return false;
 
-	m_cone_volume_outer = volume;
+	m_user.cone_volume_outer = volume;
+	post(PROPERTY_CONE_VOLUME_OUTER, &m_user.cone_volume_outer, 1);
 
 	return true;
 }
@@ -704,6 +889,8 @@ void SoftwareDevice::create()
 	m_distance_model = DISTANCE_MODEL_INVERSE_CLAMPED;
 	m_flags = 0;
 	m_quality = false;
+	m_max_voices = 0;
+	m_virtual_volume = 0.0f;
 }
 
 void SoftwareDevice::destroy()
@@ -718,67 +905,108 @@ void SoftwareDevice::destroy()
 		m_pausedSounds.front()->stop();
 }
 
+void SoftwareDevice::applyCommands()
+{
+	HandleCommand command;
+
+	while(m_commands.pop(command))
+	{
+		command.handle->apply(command.property, command.value);
+		command.handle.reset();
+	}
+}
+
 void SoftwareDevice::mix(data_t* buffer, int length)
 {
 	m_buffer.assureSize(length * AUD_SAMPLE_SIZE(m_specs));
 
 	std::lock_guard<std::recursive_mutex> lock(m_mutex);
 
+	applyCommands();
+
 	{
-		std::shared_ptr<SoftwareDevice::SoftwareHandle> sound;
-		int len;
-		int pos;
-		bool eos;
 		std::list<std::shared_ptr<SoftwareDevice::SoftwareHandle> > stopSounds;
 		std::list<std::shared_ptr<SoftwareDevice::SoftwareHandle> > pauseSounds;
 		sample_t* buf = m_buffer.getBuffer();
 
 		m_mixer->clear(length);
 
-		// for all sounds
+		// update 3D Info
+		m_voices.clear();
+
 		for(auto& sound : m_playingSounds)
 		{
-			// get the buffer from the source
-			pos = 0;
-			len = length;
-
-			// update 3D Info
 			sound->update();
+			m_voices.push_back(sound.get());
+		}
 
-			try
-			{
-				sound->m_reader->read(len, eos, buf);
+		// the loudest voices of the highest priority are rendered first
+		if(m_max_voices > 0 && m_voices.size() > size_t(m_max_voices))
+		{
+			std::sort(m_voices.begin(), m_voices.end(), [](const SoftwareHandle* a, const SoftwareHandle* b) {
+				if(a->m_priority != b->m_priority)
+					return a->m_priority > b->m_priority;
+				return std::max(a->m_volume, a->m_old_volume) > std::max(b->m_volume, b->m_old_volume);
+			});
+		}
 
-				// in case of looping
-				while(pos + len < length && sound->m_loopcount && eos)
-				{
-					m_mixer->mix(buf, pos, len, sound->m_volume, sound->m_old_volume);
+		// virtualize inaudible voices and voices over the limit
+		int voices = 0;
 
-					pos += len;
+		for(auto voice : m_voices)
+		{
+			bool audible = std::max(voice->m_volume, voice->m_old_volume) >= m_virtual_volume;
 
-					if(sound->m_loopcount > 0)
-						sound->m_loopcount--;
+			voice->setVirtual(!audible || (m_max_voices > 0 && voices >= m_max_voices));
 
-					sound->m_reader->seek(0);
+			if(voice->m_virtual)
+				voice->skip(length);
+			else
+				voices++;
+		}
 
-					len = length - pos;
-					sound->m_reader->read(len, eos, buf);
+		if(m_thread_pool && voices > 1)
+		{
+			int size = length * AUD_SAMPLE_SIZE(m_specs);
 
-					// prevent endless loop
-					if(!len)
-						break;
-				}
+			m_renders.clear();
+
+			for(auto voice : m_voices)
+			{
+				if(voice->m_virtual)
+					continue;
+
+				voice->m_render_buffer.assureSize(size);
+				m_renders.push_back(m_thread_pool->enqueue(&SoftwareHandle::render, voice, voice->m_render_buffer.getBuffer(), length));
 			}
-			catch(Exception& e)
+
+			for(auto& render : m_renders)
+				render.get();
+
+			m_renders.clear();
+
+			for(auto voice : m_voices)
 			{
-				len = 0;
-				std::cerr << "Caught exception while reading sound data during playback with software mixing: " << e.getMessage() << std::endl;
+				if(!voice->m_virtual)
+					m_mixer->mix(voice->m_render_buffer.getBuffer(), 0, voice->m_render_length, voice->m_volume, voice->m_old_volume);
 			}
+		}
+		else
+		{
+			for(auto voice : m_voices)
+			{
+				if(voice->m_virtual)
+					continue;
 
-			m_mixer->mix(buf, pos, len, sound->m_volume, sound->m_old_volume);
+				voice->render(buf, length);
+				m_mixer->mix(buf, 0, voice->m_render_length, voice->m_volume, voice->m_old_volume);
+			}
+		}
 
+		for(auto& sound : m_playingSounds)
+		{
 			// in case the end of the sound is reached
-			if(eos && !sound->m_loopcount)
+			if(sound->m_render_eos && !sound->m_loopcount)
 			{
 				if(sound->m_stop)
 					sound->m_stop(sound->m_stop_data);
@@ -808,7 +1036,31 @@ void SoftwareDevice::mix(data_t* buffer, int length)
 void SoftwareDevice::setPanning(IHandle* handle, float pan)
 {
 	SoftwareDevice::SoftwareHandle* h = dynamic_cast<SoftwareDevice::SoftwareHandle*>(handle);
-	h->m_user_pan = pan;
+	h->m_user.pan = pan;
+	h->post(PROPERTY_PAN, &pan, 1);
+}
+
+bool SoftwareDevice::setPriority(IHandle* handle, int priority)
+{
+	SoftwareDevice::SoftwareHandle* h = dynamic_cast<SoftwareDevice::SoftwareHandle*>(handle);
+
+	if(!h)
+		return false;
+
+	h->m_user.priority = priority;
+	float value = priority;
+	h->post(PROPERTY_PRIORITY, &value, 1);
+	return true;
+}
+
+int SoftwareDevice::getPriority(IHandle* handle)
+{
+	SoftwareDevice::SoftwareHandle* h = dynamic_cast<SoftwareDevice::SoftwareHandle*>(handle);
+
+	if(!h)
+		return 0;
+
+	return h->m_user.priority;
 }
 
 void SoftwareDevice::setQuality(bool quality)
@@ -816,6 +1068,40 @@ void SoftwareDevice::setQuality(bool quality)
 	m_quality = quality;
 }
 
+void SoftwareDevice::setMaximumVoices(int count)
+{
+	std::lock_guard<std::recursive_mutex> lock(m_mutex);
+
+	m_max_voices = std::max(count, 0);
+}
+
+int SoftwareDevice::getMaximumVoices() const
+{
+	return m_max_voices;
+}
+
+void SoftwareDevice::setVirtualVolume(float volume)
+{
+	std::lock_guard<std::recursive_mutex> lock(m_mutex);
+
+	m_virtual_volume = volume;
+}
+
+float SoftwareDevice::getVirtualVolume() const
+{
+	return m_virtual_volume;
+}
+
+void SoftwareDevice::setRenderThreads(int count)
+{
+	std::lock_guard<std::recursive_mutex> lock(m_mutex);
+
+	if(count > 0)
+		m_thread_pool = std::make_shared<ThreadPool>(count);
+	else
+		m_thread_pool.reset();
+}
+
 void SoftwareDevice::setSpecs(Specs specs)
 {
 	m_specs.specs = specs;
@@ -827,7 +1113,8 @@ void SoftwareDevice::setSpecs(Specs specs)
 	}
 }
 
-SoftwareDevice::SoftwareDevice()
+SoftwareDevice::SoftwareDevice() :
+	m_commands(4096)
 {
 }
 
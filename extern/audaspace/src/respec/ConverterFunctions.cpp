@@ -15,6 +15,7 @@
  ******************************************************************************/
 
 #include "respec/ConverterFunctions.h"
+#include "util/SampleKernels.h"
 
 #include <stdint.h>
 
@@ -121,10 +122,7 @@ void convert_s16_s32(data_t* target, data_t* source, int length)
 
 void convert_s16_float(data_t* target, data_t* source, int length)
 {
-	int16_t* s = (int16_t*) source;
-	float* t = (float*) target;
-	for(int i = length - 1; i >= 0; i--)
-		t[i] = s[i] / S16_FLT;
+	getSampleKernels().convert_s16_float(target, source, length);
 }
 
 void convert_s16_double(data_t* target, data_t* source, int length)
@@ -267,10 +265,7 @@ void convert_s32_s24_le(data_t* target, data_t* source, int length)
 
 void convert_s32_float(data_t* target, data_t* source, int length)
 {
-	int32_t* s = (int32_t*) source;
-	float* t = (float*) target;
-	for(int i = 0; i < length; i++)
-		t[i] = s[i] / S32_FLT;
+	getSampleKernels().convert_s32_float(target, source, length);
 }
 
 void convert_s32_double(data_t* target, data_t* source, int length)
@@ -299,17 +294,7 @@ void convert_float_u8(data_t* target, data_t* source, int length)
 
 void convert_float_s16(data_t* target, data_t* source, int length)
 {
-	int16_t* t = (int16_t*) target;
-	float* s = (float*) source;
-	for(int i = 0; i < length; i++)
-	{
-		if(s[i] <= FLT_MIN)
-			t[i] = S16_MIN;
-		else if(s[i] >= FLT_MAX)
-			t[i] = S16_MAX;
-		else
-			t[i] = (int16_t)(s[i] * S16_MAX);
-	}
+	getSampleKernels().convert_float_s16(target, source, length);
 }
 
 void convert_float_s24_be(data_t* target, data_t* source, int length)
@@ -350,17 +335,7 @@ void convert_float_s24_le(data_t* target, data_t* source, int length)
 
 void convert_float_s32(data_t* target, data_t* source, int length)
 {
-	int32_t* t = (int32_t*) target;
-	float* s = (float*) source;
-	for(int i = 0; i < length; i++)
-	{
-		if(s[i] <= FLT_MIN)
-			t[i] = S32_MIN;
-		else if(s[i] >= FLT_MAX)
-			t[i] = S32_MAX;
-		else
-			t[i] = (int32_t)(s[i]*S32_MAX);
-	}
+	getSampleKernels().convert_float_s32(target, source, length);
 }
 
 void convert_float_double(data_t* target, data_t* source, int length)
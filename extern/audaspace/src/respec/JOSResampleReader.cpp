@@ -15,6 +15,7 @@
  ******************************************************************************/
 
 #include "respec/JOSResampleReader.h"
+#include "util/SampleKernels.h"
 
 #include <algorithm>
 #include <cmath>
@@ -75,168 +76,162 @@ void JOSResampleReader::updateBuffer(int size, double factor, int samplesize)
 	m_buffer.assureSize((m_cache_valid + size) * samplesize, true);
 }
 
-#define RESAMPLE_METHOD(name, left, right) void JOSResampleReader::name(double target_factor, int length, sample_t* buffer)\
-{\
-	sample_t* buf = m_buffer.getBuffer();\
-\
-	unsigned int P, l;\
-	int end, channel, i;\
-	double eta, v, f_increment, factor;\
-\
-	m_sums.assureSize(m_channels * sizeof(double));\
-	double* sums = reinterpret_cast<double*>(m_sums.getBuffer());\
-	sample_t* data;\
-	const float* coeff = m_coeff;\
-\
-	unsigned int P_increment;\
-\
-	for(unsigned int t = 0; t < length; t++)\
-	{\
-		factor = (m_last_factor * (length - t - 1) + target_factor * (t + 1)) / length;\
-\
-		std::memset(sums, 0, sizeof(double) * m_channels);\
-\
-		if(factor >= 1)\
-		{\
-			P = double_to_fp(m_P * m_L);\
-\
-			end = std::floor(m_len / double(m_L) - m_P) - 1;\
-			if(m_n < end)\
-				end = m_n;\
-\
-			data = buf + (m_n - end) * m_channels;\
-			l = fp_to_int(P);\
-			eta = fp_rest_to_double(P);\
-			l += m_L * end;\
-\
-			for(i = 0; i <= end; i++)\
-			{\
-				v = coeff[l] + eta * (coeff[l+1] - coeff[l]);\
-				l -= m_L;\
-				left\
-			}\
-\
-			P = int_to_fp(m_L) - P;\
-\
-			end = std::floor((m_len - 1) / double(m_L) + m_P) - 1;\
-			if(m_cache_valid - m_n - 2 < end)\
-				end = m_cache_valid - m_n - 2;\
-\
-			data = buf + (m_n + 2 + end) * m_channels - 1;\
-			l = fp_to_int(P);\
-			eta = fp_rest_to_double(P);\
-			l += m_L * end;\
-\
-			for(i = 0; i <= end; i++)\
-			{\
-				v = coeff[l] + eta * (coeff[l+1] - coeff[l]);\
-				l -= m_L;\
-				right\
-			}\
-\
-			for(channel = 0; channel < m_channels; channel++)\
-			{\
-				*buffer = sums[channel];\
-				buffer++;\
-			}\
-		}\
-		else\
-		{\
-			f_increment = factor * m_L;\
-			P_increment = double_to_fp(f_increment);\
-			P = double_to_fp(m_P * f_increment);\
-\
-			end = (int_to_fp(m_len) - P) / P_increment - 1;\
-			if(m_n < end)\
-				end = m_n;\
-\
-			P += P_increment * end;\
-			data = buf + (m_n - end) * m_channels;\
-			l = fp_to_int(P);\
-\
-			for(i = 0; i <= end; i++)\
-			{\
-				eta = fp_rest_to_double(P);\
-				v = coeff[l] + eta * (coeff[l+1] - coeff[l]);\
-				P -= P_increment;\
-				l = fp_to_int(P);\
-				left\
-			}\
-\
-			P = 0 - P;\
-\
-			end = (int_to_fp(m_len) - P) / P_increment - 1;\
-			if(m_cache_valid - m_n - 2 < end)\
-				end = m_cache_valid - m_n - 2;\
-\
-			P += P_increment * end;\
-			data = buf + (m_n + 2 + end) * m_channels - 1;\
-			l = fp_to_int(P);\
-\
-			for(i = 0; i <= end; i++)\
-			{\
-				eta = fp_rest_to_double(P);\
-				v = coeff[l] + eta * (coeff[l+1] - coeff[l]);\
-				P -= P_increment;\
-				l = fp_to_int(P);\
-				right\
-			}\
-\
-			for(channel = 0; channel < m_channels; channel++)\
-			{\
-				*buffer = factor * sums[channel];\
-				buffer++;\
-			}\
-		}\
-\
-		m_P += std::fmod(1.0 / factor, 1.0);\
-		m_n += std::floor(1.0 / factor);\
-\
-		while(m_P >= 1.0)\
-		{\
-			m_P -= 1.0;\
-			m_n++;\
-		}\
-	}\
-}
+void JOSResampleReader::resample(double target_factor, int length, sample_t* buffer)
+{
+	sample_t* buf = m_buffer.getBuffer();
+
+	unsigned int P, l;
+	int end, channel, i;
+	double eta, f_increment, factor;
+
+	m_sums.assureSize(m_channels * sizeof(double));
+	double* sums = reinterpret_cast<double*>(m_sums.getBuffer());
+	double* weights;
+	const float* coeff = m_coeff;
+	const SampleKernels& kernels = getSampleKernels();
+
+	unsigned int P_increment;
+
+	for(unsigned int t = 0; t < length; t++)
+	{
+		factor = (m_last_factor * (length - t - 1) + target_factor * (t + 1)) / length;
+
+		std::memset(sums, 0, sizeof(double) * m_channels);
+
+		// the filter weights of both wings are calculated first, so that the
+		// weighted sum over the cached frames runs in a single kernel call;
+		// the right wing weights are stored in reverse, so that both wings
+		// read the frames in ascending order
+
+		if(factor >= 1)
+		{
+			P = double_to_fp(m_P * m_L);
+
+			end = std::floor(m_len / double(m_L) - m_P) - 1;
+			if(m_n < end)
+				end = m_n;
+
+			if(end >= 0)
+			{
+				m_weights.assureSize((end + 1) * sizeof(double));
+				weights = reinterpret_cast<double*>(m_weights.getBuffer());
+
+				l = fp_to_int(P);
+				eta = fp_rest_to_double(P);
+				l += m_L * end;
+
+				for(i = 0; i <= end; i++)
+				{
+					weights[i] = coeff[l] + eta * (coeff[l+1] - coeff[l]);
+					l -= m_L;
+				}
+
+				kernels.weighted_sum(sums, buf + (m_n - end) * m_channels, weights, end + 1, m_channels);
+			}
+
+			P = int_to_fp(m_L) - P;
+
+			end = std::floor((m_len - 1) / double(m_L) + m_P) - 1;
+			if(m_cache_valid - m_n - 2 < end)
+				end = m_cache_valid - m_n - 2;
+
+			if(end >= 0)
+			{
+				m_weights.assureSize((end + 1) * sizeof(double));
+				weights = reinterpret_cast<double*>(m_weights.getBuffer());
+
+				l = fp_to_int(P);
+				eta = fp_rest_to_double(P);
+				l += m_L * end;
+
+				for(i = 0; i <= end; i++)
+				{
+					weights[end - i] = coeff[l] + eta * (coeff[l+1] - coeff[l]);
+					l -= m_L;
+				}
+
+				kernels.weighted_sum(sums, buf + (m_n + 1) * m_channels, weights, end + 1, m_channels);
+			}
+
+			for(channel = 0; channel < m_channels; channel++)
+			{
+				*buffer = sums[channel];
+				buffer++;
+			}
+		}
+		else
+		{
+			f_increment = factor * m_L;
+			P_increment = double_to_fp(f_increment);
+			P = double_to_fp(m_P * f_increment);
+
+			end = (int_to_fp(m_len) - P) / P_increment - 1;
+			if(m_n < end)
+				end = m_n;
+
+			P += P_increment * end;
+
+			if(end >= 0)
+			{
+				m_weights.assureSize((end + 1) * sizeof(double));
+				weights = reinterpret_cast<double*>(m_weights.getBuffer());
+
+				l = fp_to_int(P);
 
-RESAMPLE_METHOD(resample, {
-				channel = 0;
-				do
+				for(i = 0; i <= end; i++)
 				{
-					sums[channel] += *data * v;
-					channel++;
-					data++;
+					eta = fp_rest_to_double(P);
+					weights[i] = coeff[l] + eta * (coeff[l+1] - coeff[l]);
+					P -= P_increment;
+					l = fp_to_int(P);
 				}
-				while(channel < m_channels);
-}, {
-				channel = m_channels;
-				do
+
+				kernels.weighted_sum(sums, buf + (m_n - end) * m_channels, weights, end + 1, m_channels);
+			}
+
+			P = 0 - P;
+
+			end = (int_to_fp(m_len) - P) / P_increment - 1;
+			if(m_cache_valid - m_n - 2 < end)
+				end = m_cache_valid - m_n - 2;
+
+			P += P_increment * end;
+
+			if(end >= 0)
+			{
+				m_weights.assureSize((end + 1) * sizeof(double));
+				weights = reinterpret_cast<double*>(m_weights.getBuffer());
+
+				l = fp_to_int(P);
+
+				for(i = 0; i <= end; i++)
 				{
-					channel--;
-					sums[channel] += *data * v;
-					data--;
+					eta = fp_rest_to_double(P);
+					weights[end - i] = coeff[l] + eta * (coeff[l+1] - coeff[l]);
+					P -= P_increment;
+					l = fp_to_int(P);
 				}
-				while(channel);
-})
-
-RESAMPLE_METHOD(resample_mono, {
-				*sums += *data * v;
-				data++;
-}, {
-				*sums += *data * v;
-				data--;
-})
-
-RESAMPLE_METHOD(resample_stereo, {
-				sums[0] += data[0] * v;
-				sums[1] += data[1] * v;
-				data+=2;
-}, {
-				data-=2;
-				sums[0] += data[1] * v;
-				sums[1] += data[2] * v;
-})
+
+				kernels.weighted_sum(sums, buf + (m_n + 1) * m_channels, weights, end + 1, m_channels);
+			}
+
+			for(channel = 0; channel < m_channels; channel++)
+			{
+				*buffer = factor * sums[channel];
+				buffer++;
+			}
+		}
+
+		m_P += std::fmod(1.0 / factor, 1.0);
+		m_n += std::floor(1.0 / factor);
+
+		while(m_P >= 1.0)
+		{
+			m_P -= 1.0;
+			m_n++;
+		}
+	}
+}
 
 void JOSResampleReader::seek(int position)
 {
@@ -280,19 +275,6 @@ void JOSResampleReader::read(int& length, bool& eos, sample_t* buffer)
 	{
 		m_channels = specs.channels;
 		reset();
-
-		switch(m_channels)
-		{
-		case CHANNELS_MONO:
-			m_resample = &JOSResampleReader::resample_mono;
-			break;
-		case CHANNELS_STEREO:
-			m_resample = &JOSResampleReader::resample_stereo;
-			break;
-		default:
-			m_resample = &JOSResampleReader::resample;
-			break;
-		}
 	}
 
 	if(m_last_factor == 0)
@@ -368,7 +350,7 @@ void JOSResampleReader::read(int& length, bool& eos, sample_t* buffer)
 		}
 	}
 
-	(this->*m_resample)(target_factor, length, buffer);
+	resample(target_factor, length, buffer);
 
 	m_last_factor = target_factor;
 
@@ -15,6 +15,7 @@
  ******************************************************************************/
 
 #include "respec/Mixer.h"
+#include "util/SampleKernels.h"
 
 #include <algorithm>
 #include <cstring>
@@ -80,8 +81,7 @@ void Mixer::mix(sample_t* buffer, int start, int length, float volume)
 	length = (std::min(m_length, length + start) - start) * m_specs.channels;
 	start *= m_specs.channels;
 
-	for(int i = 0; i < length; i++)
-		out[i + start] += buffer[i] * volume;
+	getSampleKernels().add(out + start, buffer, length, volume);
 }
 
 void Mixer::mix(sample_t* buffer, int start, int length, float volume_to, float volume_from)
@@ -90,21 +90,14 @@ void Mixer::mix(sample_t* buffer, int start, int length, float volume_to, float
 
 	length = (std::min(m_length, length + start) - start);
 
-	for(int i = 0; i < length; i++)
-	{
-		float volume = volume_from * (1.0f - i / float(length)) + volume_to * (i / float(length));
-
-		for(int c = 0; c < m_specs.channels; c++)
-			out[(i + start) * m_specs.channels + c] += buffer[i * m_specs.channels + c] * volume;
-	}
+	getSampleKernels().add_ramp(out + start * m_specs.channels, buffer, length, m_specs.channels, volume_to, volume_from);
 }
 
 void Mixer::read(data_t* buffer, float volume)
 {
 	sample_t* out = m_buffer.getBuffer();
 
-	for(int i = 0; i < m_length * m_specs.channels; i++)
-		out[i] *= volume;
+	getSampleKernels().scale(out, m_length * m_specs.channels, volume);
 
 	m_convert(buffer, (data_t*) out, m_length * m_specs.channels);
 }
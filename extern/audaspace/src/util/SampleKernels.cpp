@@ -0,0 +1,518 @@
+/*******************************************************************************
+ * Copyright 2009-2016 Jörg Müller
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+#include "util/SampleKernels.h"
+
+#include <stdint.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define AUD_SIMD_SSE2
+#include <emmintrin.h>
+#endif
+
+#if defined(AUD_SIMD_SSE2) && defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define AUD_SIMD_AVX
+#include <immintrin.h>
+#define AUD_TARGET_AVX __attribute__((target("avx")))
+#endif
+
+#if defined(__ARM_NEON) && defined(__aarch64__)
+#define AUD_SIMD_NEON
+#include <arm_neon.h>
+#endif
+
+#define S16_MAX		((int16_t)0x7FFF)
+#define S16_MIN		((int16_t)0x8000)
+#define S16_FLT		32767.0f
+#define S32_MAX		((int32_t)0x7FFFFFFF)
+#define S32_MIN		((int32_t)0x80000000)
+#define S32_FLT		2147483647.0f
+#define FLT_MAX		1.0f
+#define FLT_MIN		-1.0f
+
+AUD_NAMESPACE_BEGIN
+
+/******************************************************************************/
+/****************************** Scalar Kernels ********************************/
+/******************************************************************************/
+
+static void add_scalar(sample_t* target, const sample_t* source, int length, float volume)
+{
+	for(int i = 0; i < length; i++)
+		target[i] += source[i] * volume;
+}
+
+static void add_ramp_scalar(sample_t* target, const sample_t* source, int length, int channels, float volume_to, float volume_from)
+{
+	for(int i = 0; i < length; i++)
+	{
+		float volume = volume_from * (1.0f - i / float(length)) + volume_to * (i / float(length));
+
+		for(int c = 0; c < channels; c++)
+			target[i * channels + c] += source[i * channels + c] * volume;
+	}
+}
+
+static void scale_scalar(sample_t* buffer, int length, float volume)
+{
+	for(int i = 0; i < length; i++)
+		buffer[i] *= volume;
+}
+
+static void convert_float_s16_scalar(data_t* target, data_t* source, int length)
+{
+	int16_t* t = (int16_t*) target;
+	float* s = (float*) source;
+	for(int i = 0; i < length; i++)
+	{
+		if(s[i] <= FLT_MIN)
+			t[i] = S16_MIN;
+		else if(s[i] >= FLT_MAX)
+			t[i] = S16_MAX;
+		else
+			t[i] = (int16_t)(s[i] * S16_MAX);
+	}
+}
+
+static void convert_s16_float_scalar(data_t* target, data_t* source, int length)
+{
+	int16_t* s = (int16_t*) source;
+	float* t = (float*) target;
+	for(int i = length - 1; i >= 0; i--)
+		t[i] = s[i] / S16_FLT;
+}
+
+static void convert_float_s32_scalar(data_t* target, data_t* source, int length)
+{
+	int32_t* t = (int32_t*) target;
+	float* s = (float*) source;
+	for(int i = 0; i < length; i++)
+	{
+		if(s[i] <= FLT_MIN)
+			t[i] = S32_MIN;
+		else if(s[i] >= FLT_MAX)
+			t[i] = S32_MAX;
+		else
+			t[i] = (int32_t)(s[i]*S32_MAX);
+	}
+}
+
+static void convert_s32_float_scalar(data_t* target, data_t* source, int length)
+{
+	int32_t* s = (int32_t*) source;
+	float* t = (float*) target;
+	for(int i = 0; i < length; i++)
+		t[i] = s[i] / S32_FLT;
+}
+
+static void weighted_sum_scalar(double* sums, const sample_t* data, const double* weights, int length, int channels)
+{
+	for(int i = 0; i < length; i++)
+	{
+		for(int c = 0; c < channels; c++)
+			sums[c] += data[c] * weights[i];
+
+		data += channels;
+	}
+}
+
+static const SampleKernels kernels_scalar = {
+	SIMD_NONE,
+	add_scalar,
+	add_ramp_scalar,
+	scale_scalar,
+	convert_float_s16_scalar,
+	convert_s16_float_scalar,
+	convert_float_s32_scalar,
+	convert_s32_float_scalar,
+	weighted_sum_scalar
+};
+
+/******************************************************************************/
+/******************************* SSE2 Kernels *********************************/
+/******************************************************************************/
+
+#ifdef AUD_SIMD_SSE2
+
+static void add_sse2(sample_t* target, const sample_t* source, int length, float volume)
+{
+	__m128 v = _mm_set1_ps(volume);
+	int i = 0;
+
+	for(; i + 4 <= length; i += 4)
+		_mm_storeu_ps(target + i, _mm_add_ps(_mm_loadu_ps(target + i), _mm_mul_ps(_mm_loadu_ps(source + i), v)));
+
+	add_scalar(target + i, source + i, length - i, volume);
+}
+
+static void add_ramp_sse2(sample_t* target, const sample_t* source, int length, int channels, float volume_to, float volume_from)
+{
+	// the frame index of every lane
+	__m128 offset;
+
+	if(channels == 1)
+		offset = _mm_setr_ps(0, 1, 2, 3);
+	else if(channels == 2)
+		offset = _mm_setr_ps(0, 0, 1, 1);
+	else
+		return add_ramp_scalar(target, source, length, channels, volume_to, volume_from);
+
+	const int frames = 4 / channels;
+	__m128 flength = _mm_set1_ps(float(length));
+	__m128 from = _mm_set1_ps(volume_from);
+	__m128 to = _mm_set1_ps(volume_to);
+	__m128 one = _mm_set1_ps(1.0f);
+	int i = 0;
+
+	for(; i + frames <= length; i += frames)
+	{
+		__m128 t = _mm_div_ps(_mm_add_ps(_mm_set1_ps(float(i)), offset), flength);
+		__m128 volume = _mm_add_ps(_mm_mul_ps(from, _mm_sub_ps(one, t)), _mm_mul_ps(to, t));
+		sample_t* out = target + i * channels;
+
+		_mm_storeu_ps(out, _mm_add_ps(_mm_loadu_ps(out), _mm_mul_ps(_mm_loadu_ps(source + i * channels), volume)));
+	}
+
+	for(; i < length; i++)
+	{
+		float volume = volume_from * (1.0f - i / float(length)) + volume_to * (i / float(length));
+
+		for(int c = 0; c < channels; c++)
+			target[i * channels + c] += source[i * channels + c] * volume;
+	}
+}
+
+static void scale_sse2(sample_t* buffer, int length, float volume)
+{
+	__m128 v = _mm_set1_ps(volume);
+	int i = 0;
+
+	for(; i + 4 <= length; i += 4)
+		_mm_storeu_ps(buffer + i, _mm_mul_ps(_mm_loadu_ps(buffer + i), v));
+
+	scale_scalar(buffer + i, length - i, volume);
+}
+
+// select a where mask is set, b otherwise
+static inline __m128i select_sse2(__m128 mask, __m128i a, __m128i b)
+{
+	__m128i m = _mm_castps_si128(mask);
+	return _mm_or_si128(_mm_and_si128(m, a), _mm_andnot_si128(m, b));
+}
+
+static inline __m128i float_to_int_sse2(__m128 s, __m128 scale, __m128i min, __m128i max)
+{
+	__m128i t = _mm_cvttps_epi32(_mm_mul_ps(s, scale));
+	t = select_sse2(_mm_cmple_ps(s, _mm_set1_ps(FLT_MIN)), min, t);
+	return select_sse2(_mm_cmpge_ps(s, _mm_set1_ps(FLT_MAX)), max, t);
+}
+
+static void convert_float_s16_sse2(data_t* target, data_t* source, int length)
+{
+	int16_t* t = (int16_t*) target;
+	float* s = (float*) source;
+	__m128 scale = _mm_set1_ps(S16_MAX);
+	__m128i min = _mm_set1_epi32(S16_MIN);
+	__m128i max = _mm_set1_epi32(S16_MAX);
+	int i = 0;
+
+	for(; i + 8 <= length; i += 8)
+	{
+		__m128i a = float_to_int_sse2(_mm_loadu_ps(s + i), scale, min, max);
+		__m128i b = float_to_int_sse2(_mm_loadu_ps(s + i + 4), scale, min, max);
+		_mm_storeu_si128((__m128i*)(t + i), _mm_packs_epi32(a, b));
+	}
+
+	convert_float_s16_scalar((data_t*)(t + i), (data_t*)(s + i), length - i);
+}
+
+static void convert_s16_float_sse2(data_t* target, data_t* source, int length)
+{
+	int16_t* s = (int16_t*) source;
+	float* t = (float*) target;
+	__m128 scale = _mm_set1_ps(S16_FLT);
+	int i = length;
+
+	// backwards, so that the conversion works in place
+	while(i >= 8)
+	{
+		i -= 8;
+
+		__m128i x = _mm_loadu_si128((const __m128i*)(s + i));
+		__m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(x, x), 16);
+		__m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(x, x), 16);
+
+		_mm_storeu_ps(t + i + 4, _mm_div_ps(_mm_cvtepi32_ps(hi), scale));
+		_mm_storeu_ps(t + i, _mm_div_ps(_mm_cvtepi32_ps(lo), scale));
+	}
+
+	convert_s16_float_scalar(target, source, i);
+}
+
+static void convert_float_s32_sse2(data_t* target, data_t* source, int length)
+{
+	int32_t* t = (int32_t*) target;
+	float* s = (float*) source;
+	__m128 scale = _mm_set1_ps(S32_MAX);
+	__m128i min = _mm_set1_epi32(S32_MIN);
+	__m128i max = _mm_set1_epi32(S32_MAX);
+	int i = 0;
+
+	for(; i + 4 <= length; i += 4)
+		_mm_storeu_si128((__m128i*)(t + i), float_to_int_sse2(_mm_loadu_ps(s + i), scale, min, max));
+
+	convert_float_s32_scalar((data_t*)(t + i), (data_t*)(s + i), length - i);
+}
+
+static void convert_s32_float_sse2(data_t* target, data_t* source, int length)
+{
+	int32_t* s = (int32_t*) source;
+	float* t = (float*) target;
+	__m128 scale = _mm_set1_ps(S32_FLT);
+	int i = 0;
+
+	for(; i + 4 <= length; i += 4)
+		_mm_storeu_ps(t + i, _mm_div_ps(_mm_cvtepi32_ps(_mm_loadu_si128((const __m128i*)(s + i))), scale));
+
+	convert_s32_float_scalar((data_t*)(t + i), (data_t*)(s + i), length - i);
+}
+
+static inline __m128d load_float2_sse2(const sample_t* data)
+{
+	return _mm_cvtps_pd(_mm_castsi128_ps(_mm_loadl_epi64((const __m128i*)data)));
+}
+
+static void weighted_sum_sse2(double* sums, const sample_t* data, const double* weights, int length, int channels)
+{
+	if(channels == 2)
+	{
+		// one frame per register, accumulates in the same order as the scalar kernel
+		__m128d sum = _mm_loadu_pd(sums);
+
+		for(int i = 0; i < length; i++)
+			sum = _mm_add_pd(sum, _mm_mul_pd(load_float2_sse2(data + i * 2), _mm_set1_pd(weights[i])));
+
+		_mm_storeu_pd(sums, sum);
+	}
+	else if(channels == 1)
+	{
+		// two frames per register, even and odd frames are summed separately
+		__m128d sum = _mm_setzero_pd();
+		int i = 0;
+
+		for(; i + 2 <= length; i += 2)
+			sum = _mm_add_pd(sum, _mm_mul_pd(load_float2_sse2(data + i), _mm_loadu_pd(weights + i)));
+
+		double result[2];
+		_mm_storeu_pd(result, sum);
+		sums[0] += result[0] + result[1];
+
+		weighted_sum_scalar(sums, data + i, weights + i, length - i, 1);
+	}
+	else
+		weighted_sum_scalar(sums, data, weights, length, channels);
+}
+
+static const SampleKernels kernels_sse2 = {
+	SIMD_SSE2,
+	add_sse2,
+	add_ramp_sse2,
+	scale_sse2,
+	convert_float_s16_sse2,
+	convert_s16_float_sse2,
+	convert_float_s32_sse2,
+	convert_s32_float_sse2,
+	weighted_sum_sse2
+};
+
+#endif
+
+/******************************************************************************/
+/******************************* AVX Kernels **********************************/
+/******************************************************************************/
+
+#ifdef AUD_SIMD_AVX
+
+AUD_TARGET_AVX static void add_avx(sample_t* target, const sample_t* source, int length, float volume)
+{
+	__m256 v = _mm256_set1_ps(volume);
+	int i = 0;
+
+	for(; i + 8 <= length; i += 8)
+		_mm256_storeu_ps(target + i, _mm256_add_ps(_mm256_loadu_ps(target + i), _mm256_mul_ps(_mm256_loadu_ps(source + i), v)));
+
+	add_scalar(target + i, source + i, length - i, volume);
+}
+
+AUD_TARGET_AVX static void add_ramp_avx(sample_t* target, const sample_t* source, int length, int channels, float volume_to, float volume_from)
+{
+	// the frame index of every lane
+	__m256 offset;
+
+	if(channels == 1)
+		offset = _mm256_setr_ps(0, 1, 2, 3, 4, 5, 6, 7);
+	else if(channels == 2)
+		offset = _mm256_setr_ps(0, 0, 1, 1, 2, 2, 3, 3);
+	else
+		return add_ramp_scalar(target, source, length, channels, volume_to, volume_from);
+
+	const int frames = 8 / channels;
+	__m256 flength = _mm256_set1_ps(float(length));
+	__m256 from = _mm256_set1_ps(volume_from);
+	__m256 to = _mm256_set1_ps(volume_to);
+	__m256 one = _mm256_set1_ps(1.0f);
+	int i = 0;
+
+	for(; i + frames <= length; i += frames)
+	{
+		__m256 t = _mm256_div_ps(_mm256_add_ps(_mm256_set1_ps(float(i)), offset), flength);
+		__m256 volume = _mm256_add_ps(_mm256_mul_ps(from, _mm256_sub_ps(one, t)), _mm256_mul_ps(to, t));
+		sample_t* out = target + i * channels;
+
+		_mm256_storeu_ps(out, _mm256_add_ps(_mm256_loadu_ps(out), _mm256_mul_ps(_mm256_loadu_ps(source + i * channels), volume)));
+	}
+
+	for(; i < length; i++)
+	{
+		float volume = volume_from * (1.0f - i / float(length)) + volume_to * (i / float(length));
+
+		for(int c = 0; c < channels; c++)
+			target[i * channels + c] += source[i * channels + c] * volume;
+	}
+}
+
+AUD_TARGET_AVX static void scale_avx(sample_t* buffer, int length, float volume)
+{
+	__m256 v = _mm256_set1_ps(volume);
+	int i = 0;
+
+	for(; i + 8 <= length; i += 8)
+		_mm256_storeu_ps(buffer + i, _mm256_mul_ps(_mm256_loadu_ps(buffer + i), v));
+
+	scale_scalar(buffer + i, length - i, volume);
+}
+
+static const SampleKernels kernels_avx = {
+	SIMD_AVX,
+	add_avx,
+	add_ramp_avx,
+	scale_avx,
+	// the conversions and the resampling sums use SSE2, AVX has no integer instructions
+	convert_float_s16_sse2,
+	convert_s16_float_sse2,
+	convert_float_s32_sse2,
+	convert_s32_float_sse2,
+	weighted_sum_sse2
+};
+
+#endif
+
+/******************************************************************************/
+/******************************* NEON Kernels *********************************/
+/******************************************************************************/
+
+#ifdef AUD_SIMD_NEON
+
+static void add_neon(sample_t* target, const sample_t* source, int length, float volume)
+{
+	float32x4_t v = vdupq_n_f32(volume);
+	int i = 0;
+
+	for(; i + 4 <= length; i += 4)
+		vst1q_f32(target + i, vaddq_f32(vld1q_f32(target + i), vmulq_f32(vld1q_f32(source + i), v)));
+
+	add_scalar(target + i, source + i, length - i, volume);
+}
+
+static void scale_neon(sample_t* buffer, int length, float volume)
+{
+	float32x4_t v = vdupq_n_f32(volume);
+	int i = 0;
+
+	for(; i + 4 <= length; i += 4)
+		vst1q_f32(buffer + i, vmulq_f32(vld1q_f32(buffer + i), v));
+
+	scale_scalar(buffer + i, length - i, volume);
+}
+
+static const SampleKernels kernels_neon = {
+	SIMD_NEON,
+	add_neon,
+	add_ramp_scalar,
+	scale_neon,
+	convert_float_s16_scalar,
+	convert_s16_float_scalar,
+	convert_float_s32_scalar,
+	convert_s32_float_scalar,
+	weighted_sum_scalar
+};
+
+#endif
+
+/******************************************************************************/
+/******************************** Selection ***********************************/
+/******************************************************************************/
+
+const SampleKernels* getSampleKernels(SIMDLevel level)
+{
+	switch(level)
+	{
+	case SIMD_NONE:
+		return &kernels_scalar;
+#ifdef AUD_SIMD_SSE2
+	case SIMD_SSE2:
+		return &kernels_sse2;
+#endif
+#ifdef AUD_SIMD_AVX
+	case SIMD_AVX:
+		if(__builtin_cpu_supports("avx"))
+			return &kernels_avx;
+		break;
+#endif
+#ifdef AUD_SIMD_NEON
+	case SIMD_NEON:
+		return &kernels_neon;
+#endif
+	default:
+		break;
+	}
+
+	return nullptr;
+}
+
+static const SampleKernels* selectSampleKernels()
+{
+	const SIMDLevel levels[] = {SIMD_AVX, SIMD_SSE2, SIMD_NEON};
+
+	for(SIMDLevel level : levels)
+	{
+		const SampleKernels* kernels = getSampleKernels(level);
+
+		if(kernels)
+			return kernels;
+	}
+
+	return &kernels_scalar;
+}
+
+const SampleKernels& getSampleKernels()
+{
+	static const SampleKernels* kernels = selectSampleKernels();
+
+	return *kernels;
+}
+
+AUD_NAMESPACE_END
@@ -193,8 +193,12 @@ class DATA_PT_modifiers(ModifierButtonsPanel, Panel):
         col.prop(md, "operation", text="")
 
         col = split.column()
-        col.label(text="Object:")
-        col.prop(md, "object", text="")
+        col.label(text="Operand:")
+        col.prop(md, "operand_type", text="")
+        if md.operand_type == 'OBJECT':
+            col.prop(md, "object", text="")
+        else:
+            col.prop(md, "collection", text="")
 
         layout.prop(md, "double_threshold")
 
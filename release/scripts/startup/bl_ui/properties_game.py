@@ -375,6 +375,16 @@ class SCENE_PT_game_physics(SceneButtonsPanel, Panel):
             sub = col.row()
             sub.prop(gs, "deactivation_time", text="Time")
 
+            col = layout.column()
+            col.label(text="Culling:")
+            row = col.row()
+            row.prop(gs, "use_occlusion_culling", text="Enabled")
+            sub = row.row()
+            sub.active = gs.use_occlusion_culling
+            sub.prop(gs, "occlusion_culling_resolution", text="Resolution")
+
+            layout.prop(gs, "use_conversion_cache")
+
         else:
             split = layout.split()
 
@@ -489,6 +499,12 @@ class SCENE_PT_game_hysteresis(SceneButtonsPanel, Panel):
         row.active = gs.use_scene_hysteresis
         row.prop(gs, "scene_hysteresis_percentage", text="")
 
+        layout.prop(gs, "use_animation_lod")
+        col = layout.column()
+        col.active = gs.use_animation_lod
+        col.prop(gs, "animation_lod_distance", text="Distance")
+        col.prop(gs, "animation_lod_interval", text="Interval")
+
 class SCENE_PT_game_console(SceneButtonsPanel, Panel):
     bl_label = "Game Python Console"
     bl_options = {'DEFAULT_CLOSED'}
@@ -580,6 +596,20 @@ class OBJECT_PT_levels_of_detail(ObjectButtonsPanel, Panel):
         row.operator("object.lod_add", text="Add", icon='PLUS')
         row.menu("OBJECT_MT_lod_tools", text="", icon='TRIA_DOWN')
 
+        if ob.type == 'MESH':
+            box = col.box()
+            box.prop(ob, "use_lod_generate")
+            sub = box.column()
+            sub.active = ob.use_lod_generate and len(ob.lod_levels) <= 1
+            sub.prop(ob, "lod_generate_levels")
+            sub.prop(ob, "lod_generate_ratio")
+            sub.prop(ob, "lod_generate_distance")
+
+        if ob.type == 'ARMATURE':
+            box = col.box()
+            box.active = gs.use_animation_lod
+            box.prop(ob, "use_animation_lod")
+
 
 classes = (
     PHYSICS_PT_game_physics,
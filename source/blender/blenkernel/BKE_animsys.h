@@ -238,6 +238,22 @@ void animsys_evaluate_action_group(struct PointerRNA *ptr,
                                    struct bActionGroup *agrp,
                                    float ctime);
 
+/* ------------ Bound Action API --------------- */
+/* Pre-resolved F-Curve to property bindings, for callers evaluating the same action on the same
+ * data repeatedly (i.e. the game engine playing actions), see #animsys_evaluate_action. */
+
+struct AnimsysActionBinding;
+
+struct AnimsysActionBinding *BKE_animsys_action_binding_create(struct PointerRNA *ptr,
+                                                               struct bAction *act);
+bool BKE_animsys_action_binding_is_valid(const struct AnimsysActionBinding *binding,
+                                         const struct PointerRNA *ptr,
+                                         const struct bAction *act);
+struct AnimsysActionBinding *BKE_animsys_action_binding_ensure(
+    struct AnimsysActionBinding **r_binding, struct PointerRNA *ptr, struct bAction *act);
+void BKE_animsys_action_binding_evaluate(struct AnimsysActionBinding *binding, float ctime);
+void BKE_animsys_action_binding_free(struct AnimsysActionBinding *binding);
+
 /* ************************************* */
 
 /* ------------ Evaluation API --------------- */
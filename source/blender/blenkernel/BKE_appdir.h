@@ -35,6 +35,8 @@ const char *BKE_appdir_folder_id_ex(const int folder_id,
                                     size_t path_len);
 const char *BKE_appdir_folder_id(const int folder_id, const char *subfolder);
 const char *BKE_appdir_folder_id_create(const int folder_id, const char *subfolder);
+const char *BKE_appdir_folder_caches_create(const char *subfolder);
+bool BKE_appdir_file_is_user_owned(const char *filepath);
 const char *BKE_appdir_folder_id_user_notest(const int folder_id, const char *subfolder);
 const char *BKE_appdir_folder_id_version(const int folder_id, const int ver, const bool do_check);
 
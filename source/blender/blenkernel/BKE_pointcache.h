@@ -68,6 +68,7 @@ extern "C" {
 /* high bits reserved for flags that need to be stored in file */
 #define PTCACHE_TYPEFLAG_COMPRESS (1 << 16)
 #define PTCACHE_TYPEFLAG_EXTRADATA (1 << 17)
+#define PTCACHE_TYPEFLAG_CHUNKED (1 << 18)
 
 #define PTCACHE_TYPEFLAG_TYPEMASK 0x0000FFFF
 #define PTCACHE_TYPEFLAG_FLAGMASK 0xFFFF0000
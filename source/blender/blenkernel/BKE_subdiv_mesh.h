@@ -32,6 +32,7 @@ extern "C" {
 
 struct Mesh;
 struct Subdiv;
+struct SubdivMeshCache;
 
 typedef struct SubdivToMeshSettings {
   /* Resolution at which regular ptex (created for quad polygon) are being
@@ -50,6 +51,19 @@ struct Mesh *BKE_subdiv_to_mesh(struct Subdiv *subdiv,
                                 const SubdivToMeshSettings *settings,
                                 const struct Mesh *coarse_mesh);
 
+/* Same as BKE_subdiv_to_mesh(), but once the coarse mesh was evaluated twice with the same
+ * topology and custom data the result is kept in the cache. When only coarse vertex coordinates
+ * change afterwards, the cached result is copied and only positions and normals of its vertices
+ * are evaluated again.
+ *
+ * The cache is created when needed, and is to be freed with BKE_subdiv_mesh_cache_free(). */
+struct Mesh *BKE_subdiv_to_mesh_cached(struct Subdiv *subdiv,
+                                       const SubdivToMeshSettings *settings,
+                                       const struct Mesh *coarse_mesh,
+                                       struct SubdivMeshCache **cache_p);
+
+void BKE_subdiv_mesh_cache_free(struct SubdivMeshCache *cache);
+
 #ifdef __cplusplus
 }
 #endif
@@ -702,6 +702,148 @@ void animsys_evaluate_action(PointerRNA *ptr,
   animsys_evaluate_action_ex(ptr, act, ctime, flush_to_original);
 }
 
+/* ***************************************** */
+/* Bound Action Evaluation */
+
+/* An F-Curve of the action with its RNA path resolved against the bound pointer. */
+typedef struct AnimsysBoundChannel {
+  FCurve *fcu;
+  PathResolvedRNA anim_rna;
+  /* Keyframe segment used by the last evaluation, see #evaluate_fcurve_cursor. */
+  int key_cursor;
+} AnimsysBoundChannel;
+
+typedef struct AnimsysActionBinding {
+  /* What the binding was built for, used to detect when it has to be rebuilt. */
+  bAction *act;
+  PointerRNA ptr;
+  FCurve *fcurve_first, *fcurve_last;
+  int fcurve_len;
+  /* Pose of the owner object, channels of a pose are reallocated on rebuild. */
+  bPose *pose;
+
+  AnimsysBoundChannel *channels;
+  int channels_len;
+} AnimsysActionBinding;
+
+static bPose *animsys_binding_owner_pose(const PointerRNA *ptr)
+{
+  if (ptr->owner_id && GS(ptr->owner_id->name) == ID_OB) {
+    return ((Object *)ptr->owner_id)->pose;
+  }
+  return NULL;
+}
+
+/**
+ * Resolve the RNA paths of all the F-Curves of \a act against \a ptr once, so that the action
+ * can be evaluated many times without going through #BKE_animsys_store_rna_setting again.
+ * Curves with a path that can't be resolved are left out, as regular evaluation would skip them.
+ */
+AnimsysActionBinding *BKE_animsys_action_binding_create(PointerRNA *ptr, bAction *act)
+{
+  AnimsysActionBinding *binding = MEM_callocN(sizeof(*binding), __func__);
+  binding->act = act;
+  binding->ptr = *ptr;
+  binding->fcurve_first = act->curves.first;
+  binding->fcurve_last = act->curves.last;
+  binding->fcurve_len = BLI_listbase_count(&act->curves);
+  binding->pose = animsys_binding_owner_pose(ptr);
+
+  action_idcode_patch_check(ptr->owner_id, act);
+
+  if (binding->fcurve_len == 0) {
+    return binding;
+  }
+
+  binding->channels = MEM_malloc_arrayN(
+      binding->fcurve_len, sizeof(*binding->channels), "AnimsysBoundChannel");
+
+  LISTBASE_FOREACH (FCurve *, fcu, &act->curves) {
+    AnimsysBoundChannel *channel = &binding->channels[binding->channels_len];
+    if (fcu->driver != NULL) {
+      continue;
+    }
+    if (BKE_animsys_store_rna_setting(ptr, fcu->rna_path, fcu->array_index, &channel->anim_rna)) {
+      channel->fcu = fcu;
+      channel->key_cursor = 0;
+      binding->channels_len++;
+    }
+  }
+
+  return binding;
+}
+
+/**
+ * Check the binding still matches the action and the data it was resolved against. Changing the
+ * set of F-Curves of the action or rebuilding the pose of the owner invalidates it, other data
+ * changes invalidating resolved pointers must free the binding explicitly.
+ */
+bool BKE_animsys_action_binding_is_valid(const AnimsysActionBinding *binding,
+                                         const PointerRNA *ptr,
+                                         const bAction *act)
+{
+  if (binding->act != act || binding->ptr.owner_id != ptr->owner_id ||
+      binding->ptr.data != ptr->data) {
+    return false;
+  }
+  if (binding->fcurve_first != act->curves.first || binding->fcurve_last != act->curves.last) {
+    return false;
+  }
+  bPose *pose = animsys_binding_owner_pose(ptr);
+  if (binding->pose != pose || (pose && (pose->flag & POSE_RECALC))) {
+    return false;
+  }
+  return binding->fcurve_len == BLI_listbase_count(&act->curves);
+}
+
+void BKE_animsys_action_binding_free(AnimsysActionBinding *binding)
+{
+  MEM_SAFE_FREE(binding->channels);
+  MEM_freeN(binding);
+}
+
+/**
+ * Make sure \a r_binding holds a valid binding of \a act to \a ptr, (re)building it if needed.
+ */
+AnimsysActionBinding *BKE_animsys_action_binding_ensure(AnimsysActionBinding **r_binding,
+                                                        PointerRNA *ptr,
+                                                        bAction *act)
+{
+  if (*r_binding && !BKE_animsys_action_binding_is_valid(*r_binding, ptr, act)) {
+    BKE_animsys_action_binding_free(*r_binding);
+    *r_binding = NULL;
+  }
+  if (*r_binding == NULL) {
+    *r_binding = BKE_animsys_action_binding_create(ptr, act);
+  }
+  return *r_binding;
+}
+
+/**
+ * Equivalent of #animsys_evaluate_action for a bound action: evaluates all the bound channels
+ * in one pass over a flat array, without path lookups and with coherent keyframe lookups.
+ */
+void BKE_animsys_action_binding_evaluate(AnimsysActionBinding *binding, float ctime)
+{
+  AnimsysBoundChannel *channel = binding->channels;
+  for (int i = 0; i < binding->channels_len; i++, channel++) {
+    FCurve *fcu = channel->fcu;
+    /* Muting may change without invalidating the binding, so check it here. */
+    if ((fcu->grp != NULL) && (fcu->grp->flag & AGRP_MUTED)) {
+      continue;
+    }
+    if ((fcu->flag & (FCURVE_MUTED | FCURVE_DISABLED))) {
+      continue;
+    }
+    if (BKE_fcurve_is_empty(fcu)) {
+      continue;
+    }
+    const float curval = evaluate_fcurve_cursor(fcu, ctime, &channel->key_cursor);
+    fcu->curval = curval; /* debug display only, not thread safe! */
+    BKE_animsys_write_rna_setting(&channel->anim_rna, curval);
+  }
+}
+
 /* ***************************************** */
 /* NLA System - Evaluation */
 
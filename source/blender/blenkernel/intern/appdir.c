@@ -57,6 +57,7 @@
 #    include "binreloc.h"
 #  endif
 /* mkdtemp on OSX (and probably all *BSD?), not worth making specific check for this OS. */
+#  include <sys/stat.h>
 #  include <unistd.h>
 #endif /* WIN32 */
 
@@ -598,6 +599,42 @@ const char *BKE_appdir_folder_id_create(const int folder_id, const char *subfold
   return path;
 }
 
+/**
+ * Returns the path to a cache folder in the user configuration, creating it if it doesn't exist.
+ * Unlike the temporary directory, it is not shared with other users: the folder is only
+ * accessible by its owner, NULL is returned when it belongs to another user.
+ */
+const char *BKE_appdir_folder_caches_create(const char *subfolder)
+{
+  const char *path = BKE_appdir_folder_id_create(BLENDER_USER_CONFIG, subfolder);
+
+  if (!path || !BLI_is_dir(path) || !BKE_appdir_file_is_user_owned(path)) {
+    return NULL;
+  }
+#ifndef WIN32
+  if (chmod(path, S_IRWXU) != 0) {
+    return NULL;
+  }
+#endif
+
+  return path;
+}
+
+/**
+ * Check that a file was created by the current user, so that cached data written by another
+ * user is not trusted. Always true on Windows, where the user folders are private.
+ */
+bool BKE_appdir_file_is_user_owned(const char *filepath)
+{
+#ifdef WIN32
+  UNUSED_VARS(filepath);
+  return true;
+#else
+  BLI_stat_t st;
+  return (BLI_stat(filepath, &st) == 0) && (st.st_uid == getuid());
+#endif
+}
+
 /**
  * Returns the path of the top-level version-specific local, user or system directory.
  * If do_check, then the result will be NULL if the directory doesn't exist.
@@ -1497,18 +1497,30 @@ static float fcurve_eval_keyframes_extrapolate(
   return endpoint_bezt->vec[1][1] - (fac * dx);
 }
 
-static float fcurve_eval_keyframes_interpolate(FCurve *fcu, BezTriple *bezts, float evaltime)
+/**
+ * Check whether the segment ending at keyframe \a a (and starting at the one before it) strictly
+ * contains \a evaltime, i.e. whether the binary search would return \a a without an exact match.
+ */
+static bool fcurve_key_cursor_contains(const FCurve *fcu,
+                                       const BezTriple *bezts,
+                                       int a,
+                                       float evaltime,
+                                       float threshold)
 {
-  const float eps = 1.e-8f;
-  BezTriple *bezt, *prevbezt;
-  unsigned int a;
-
-  /* evaltime occurs somewhere in the middle of the curve */
-  bool exact = false;
+  if (a <= 0 || a >= fcu->totvert) {
+    return false;
+  }
+  return (bezts[a - 1].vec[1][0] + threshold < evaltime) &&
+         (evaltime < bezts[a].vec[1][0] - threshold);
+}
 
-  /* Use binary search to find appropriate keyframes...
-   *
-   * The threshold here has the following constraints:
+static float fcurve_eval_keyframes_interpolate(FCurve *fcu,
+                                               BezTriple *bezts,
+                                               float evaltime,
+                                               int *r_key_cursor)
+{
+  const float eps = 1.e-8f;
+  /* The threshold here has the following constraints:
    * - 0.001 is too coarse:
    *   We get artifacts with 2cm driver movements at 1BU = 1m (see T40332)
    *
@@ -1516,7 +1528,30 @@ static float fcurve_eval_keyframes_interpolate(FCurve *fcu, BezTriple *bezts, fl
    *   Weird errors, like selecting the wrong keyframe range (see T39207), occur.
    *   This lower bound was established in b888a32eee8147b028464336ad2404d8155c64dd.
    */
-  a = binarysearch_bezt_index_ex(bezts, evaltime, fcu->totvert, 0.0001, &exact);
+  const float threshold = 0.0001f;
+  BezTriple *bezt, *prevbezt;
+  unsigned int a;
+
+  /* evaltime occurs somewhere in the middle of the curve */
+  bool exact = false;
+
+  /* During playback the evaluation time moves coherently, so the segment found last time (or the
+   * one right after it) usually still contains the evaluation time. Only fall back to the binary
+   * search when the cursor misses, or when we are close enough to a key for it to be exact. */
+  if (r_key_cursor && fcurve_key_cursor_contains(fcu, bezts, *r_key_cursor, evaltime, threshold)) {
+    a = *r_key_cursor;
+  }
+  else if (r_key_cursor &&
+           fcurve_key_cursor_contains(fcu, bezts, *r_key_cursor + 1, evaltime, threshold)) {
+    a = ++(*r_key_cursor);
+  }
+  else {
+    /* Use binary search to find appropriate keyframes... */
+    a = binarysearch_bezt_index_ex(bezts, evaltime, fcu->totvert, threshold, &exact);
+    if (r_key_cursor) {
+      *r_key_cursor = a;
+    }
+  }
   bezt = bezts + a;
 
   if (exact) {
@@ -1759,7 +1794,10 @@ static float fcurve_eval_keyframes_interpolate(FCurve *fcu, BezTriple *bezts, fl
 }
 
 /* Calculate F-Curve value for 'evaltime' using BezTriple keyframes */
-static float fcurve_eval_keyframes(FCurve *fcu, BezTriple *bezts, float evaltime)
+static float fcurve_eval_keyframes(FCurve *fcu,
+                                   BezTriple *bezts,
+                                   float evaltime,
+                                   int *r_key_cursor)
 {
   if (evaltime <= bezts->vec[1][0]) {
     return fcurve_eval_keyframes_extrapolate(fcu, bezts, evaltime, 0, +1);
@@ -1770,7 +1808,7 @@ static float fcurve_eval_keyframes(FCurve *fcu, BezTriple *bezts, float evaltime
     return fcurve_eval_keyframes_extrapolate(fcu, bezts, evaltime, fcu->totvert - 1, -1);
   }
 
-  return fcurve_eval_keyframes_interpolate(fcu, bezts, evaltime);
+  return fcurve_eval_keyframes_interpolate(fcu, bezts, evaltime, r_key_cursor);
 }
 
 /* Calculate F-Curve value for 'evaltime' using FPoint samples */
@@ -1815,8 +1853,10 @@ static float fcurve_eval_samples(FCurve *fcu, FPoint *fpts, float evaltime)
 
 /* Evaluate and return the value of the given F-Curve at the specified frame ("evaltime")
  * Note: this is also used for drivers
+ *
+ * \param r_key_cursor: Optional keyframe index hint, see #evaluate_fcurve_cursor.
  */
-static float evaluate_fcurve_ex(FCurve *fcu, float evaltime, float cvalue)
+static float evaluate_fcurve_ex(FCurve *fcu, float evaltime, float cvalue, int *r_key_cursor)
 {
   float devaltime;
 
@@ -1833,7 +1873,7 @@ static float evaluate_fcurve_ex(FCurve *fcu, float evaltime, float cvalue)
    *   F-Curve modifier on the stack requested the curve to be evaluated at
    */
   if (fcu->bezt) {
-    cvalue = fcurve_eval_keyframes(fcu, fcu->bezt, devaltime);
+    cvalue = fcurve_eval_keyframes(fcu, fcu->bezt, devaltime, r_key_cursor);
   }
   else if (fcu->fpt) {
     cvalue = fcurve_eval_samples(fcu, fcu->fpt, devaltime);
@@ -1857,7 +1897,19 @@ float evaluate_fcurve(FCurve *fcu, float evaltime)
 {
   BLI_assert(fcu->driver == NULL);
 
-  return evaluate_fcurve_ex(fcu, evaltime, 0.0);
+  return evaluate_fcurve_ex(fcu, evaltime, 0.0, NULL);
+}
+
+/**
+ * Same as #evaluate_fcurve, but keeps track of the keyframe segment used by the last evaluation
+ * in \a r_key_cursor (initialize to 0). When the evaluation time moves coherently, as it does
+ * during playback, the keyframe lookup then costs O(1) instead of a binary search.
+ */
+float evaluate_fcurve_cursor(FCurve *fcu, float evaltime, int *r_key_cursor)
+{
+  BLI_assert(fcu->driver == NULL);
+
+  return evaluate_fcurve_ex(fcu, evaltime, 0.0, r_key_cursor);
 }
 
 float evaluate_fcurve_only_curve(FCurve *fcu, float evaltime)
@@ -1865,7 +1917,7 @@ float evaluate_fcurve_only_curve(FCurve *fcu, float evaltime)
   /* Can be used to evaluate the (keyframed) fcurve only.
    * Also works for driver-fcurves when the driver itself is not relevant.
    * E.g. when inserting a keyframe in a driver fcurve. */
-  return evaluate_fcurve_ex(fcu, evaltime, 0.0);
+  return evaluate_fcurve_ex(fcu, evaltime, 0.0, NULL);
 }
 
 float evaluate_fcurve_driver(PathResolvedRNA *anim_rna,
@@ -1912,7 +1964,7 @@ float evaluate_fcurve_driver(PathResolvedRNA *anim_rna,
     }
   }
 
-  return evaluate_fcurve_ex(fcu, evaltime, cvalue);
+  return evaluate_fcurve_ex(fcu, evaltime, cvalue, NULL);
 }
 
 /* Checks if the curve has valid keys, drivers or modifiers that produce an actual curve. */
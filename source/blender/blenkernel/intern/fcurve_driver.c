@@ -1051,6 +1051,14 @@ static bool driver_compile_simple_expr(ChannelDriver *driver)
   if (atomic_cas_ptr((void **)&driver->expr_simple, NULL, expr) != NULL) {
     BLI_expr_pylike_free(expr);
   }
+  else if (!BLI_expr_pylike_is_valid(expr)) {
+    /* Lists the drivers evaluated with Python once, with `--log "bke.fcurve"`. */
+    CLOG_INFO(&LOG,
+              1,
+              "driver expression requires Python: '%s' (%s)",
+              driver->expression,
+              BLI_expr_pylike_parse_error(expr));
+  }
 
   return true;
 }
@@ -1075,6 +1083,17 @@ bool BKE_driver_has_simple_expression(ChannelDriver *driver)
   return driver_compile_simple_expr(driver) && BLI_expr_pylike_is_valid(driver->expr_simple);
 }
 
+/* Return the reason the driver expression doesn't conform to the simple subset,
+ * or NULL if it does or the driver isn't a scripted expression. */
+const char *BKE_driver_simple_expression_error(ChannelDriver *driver)
+{
+  if (!driver_compile_simple_expr(driver)) {
+    return NULL;
+  }
+
+  return BLI_expr_pylike_parse_error(driver->expr_simple);
+}
+
 /* TODO(sergey): This is somewhat weak, but we don't want neither false-positive
  * time dependencies nor special exceptions in the depsgraph evaluation. */
 static bool python_driver_exression_depends_on_time(const char *expression)
@@ -57,6 +57,7 @@
 #include "DNA_packedFile_types.h"
 #include "DNA_scene_types.h"
 #include "DNA_sequence_types.h"
+#include "DNA_userdef_types.h"
 #include "DNA_world_types.h"
 
 #include "BLI_blenlib.h"
@@ -4156,6 +4157,9 @@ static ImBuf *load_movie_single(Image *ima, ImageUser *iuser, int frame, const i
     if (ima->flag & IMA_DEINTERLACE) {
       flags |= IB_animdeinterlace;
     }
+    if (U.movie_flag & USER_MOVIE_PARALLEL_DECODING) {
+      flags |= IB_animprefetch;
+    }
 
     if (iuser) {
       iuser_t = *iuser;
@@ -203,6 +203,9 @@ static void object_init_data(ID *id)
   ob->fall_speed = 55.0f;
   ob->max_jumps = 1;
   // ob->max_slope = M_PI_2;
+  ob->lod_generate_ratio = 0.5f;
+  ob->lod_generate_distance = 25.0f;
+  ob->lod_generate_levels = 3;
   ob->col_group = 0x01;
   ob->col_mask = 0xffff;
 
@@ -45,6 +45,7 @@
 #include "BLI_blenlib.h"
 #include "BLI_math.h"
 #include "BLI_string.h"
+#include "BLI_task.h"
 #include "BLI_utildefines.h"
 
 #include "BLT_translation.h"
@@ -100,6 +101,7 @@
 /* needed for directory lookup */
 #ifndef WIN32
 #  include <dirent.h>
+#  include <sys/mman.h>
 #else
 #  include "BLI_winstuff.h"
 #endif
@@ -2346,19 +2348,6 @@ static int ptcache_file_data_read(PTCacheFile *pf)
 
   return 1;
 }
-static int ptcache_file_data_write(PTCacheFile *pf)
-{
-  int i;
-
-  for (i = 0; i < BPHYS_TOT_DATA; i++) {
-    if ((pf->data_types & (1 << i)) &&
-        !ptcache_file_write(pf, pf->cur[i], 1, ptcache_data_size[i])) {
-      return 0;
-    }
-  }
-
-  return 1;
-}
 static int ptcache_file_header_begin_read(PTCacheFile *pf)
 {
   unsigned int typeflag = 0;
@@ -2625,6 +2614,447 @@ static void ptcache_find_frames_around(PTCacheID *pid, unsigned int frame, int *
   }
 }
 
+/* -------------------------------------------------------------------- */
+/** \name Chunked Frame Files
+ *
+ * Frames of point caches (soft body, particles, cloth, rigid body) store every attribute
+ * and every extra data in its own chunk, located through a table following the header.
+ * Chunks are compressed and decompressed in parallel, float attributes are byte-shuffled
+ * before compression which groups the sign/exponent bytes and compresses much better.
+ * Uncompressed chunks are copied from a mapping of the file, so reading a frame only
+ * pages in the chunks it uses.
+ * \{ */
+
+/** Chunk types from this value on store #PTCacheExtra data. */
+#define PTCACHE_CHUNK_EXTRA 0x100
+/** Chunk data was byte-shuffled before being compressed. */
+#define PTCACHE_CHUNK_SHUFFLE (1 << 0)
+/** Chunk data offsets are aligned so mapped attributes can be read as floats. */
+#define PTCACHE_CHUNK_ALIGN 16
+/** Sanity limit for the chunk table of corrupt files. */
+#define PTCACHE_CHUNK_MAX 1024
+
+#define PTCACHE_LZMA_PROPS_SIZE 5
+
+/* Stored as-is in the file. */
+typedef struct PTCacheChunk {
+  unsigned int type;
+  unsigned int totelem;
+  unsigned int compression;
+  unsigned int flag;
+  uint64_t offset;
+  uint64_t size;
+} PTCacheChunk;
+
+typedef struct PTCacheChunkData {
+  PTCacheChunk chunk;
+  /** Attribute or extra data, #PTCacheChunk.totelem elements. */
+  void *data;
+  /** Stored chunk data when different from #data, owned when #buffer is set. */
+  const unsigned char *stored;
+  unsigned char *buffer;
+  bool error;
+} PTCacheChunkData;
+
+static size_t ptcache_chunk_elem_size(unsigned int type)
+{
+  if (type < BPHYS_TOT_DATA) {
+    return (size_t)ptcache_data_size[type];
+  }
+  if ((type > PTCACHE_CHUNK_EXTRA) &&
+      (type < PTCACHE_CHUNK_EXTRA + ARRAY_SIZE(ptcache_extra_datasize))) {
+    return (size_t)ptcache_extra_datasize[type - PTCACHE_CHUNK_EXTRA];
+  }
+  return 0;
+}
+
+static bool ptcache_chunk_is_float(unsigned int type)
+{
+  return ELEM(type,
+              BPHYS_DATA_LOCATION,
+              BPHYS_DATA_VELOCITY,
+              BPHYS_DATA_ROTATION,
+              BPHYS_DATA_AVELOCITY,
+              BPHYS_DATA_SIZE,
+              BPHYS_DATA_TIMES);
+}
+
+/* Store the n-th byte of all floats together. */
+static void ptcache_byte_shuffle(unsigned char *dst, const unsigned char *src, size_t len)
+{
+  const size_t words = len / sizeof(float);
+  for (size_t b = 0; b < sizeof(float); b++) {
+    unsigned char *dst_b = dst + b * words;
+    for (size_t w = 0; w < words; w++) {
+      dst_b[w] = src[w * sizeof(float) + b];
+    }
+  }
+  memcpy(dst + words * sizeof(float), src + words * sizeof(float), len - words * sizeof(float));
+}
+
+static void ptcache_byte_unshuffle(unsigned char *dst, const unsigned char *src, size_t len)
+{
+  const size_t words = len / sizeof(float);
+  for (size_t b = 0; b < sizeof(float); b++) {
+    const unsigned char *src_b = src + b * words;
+    for (size_t w = 0; w < words; w++) {
+      dst[w * sizeof(float) + b] = src_b[w];
+    }
+  }
+  memcpy(dst + words * sizeof(float), src + words * sizeof(float), len - words * sizeof(float));
+}
+
+/**
+ * Thread-safe compression of \a in into \a out (#LZO_OUT_LEN of \a in_len bytes),
+ * LZMA properties are stored before the compressed data.
+ *
+ * \return the compression used, #PTCACHE_COMPRESS_NO when the data doesn't get smaller.
+ */
+static unsigned int ptcache_compress_buffer(
+    const unsigned char *in, size_t in_len, unsigned char *out, size_t *r_out_len, int mode)
+{
+#ifdef WITH_LZO
+  if (mode == PTCACHE_COMPRESS_LZO) {
+    LZO_HEAP_ALLOC(wrkmem, LZO1X_MEM_COMPRESS);
+    lzo_uint out_len = LZO_OUT_LEN(in_len);
+
+    if ((lzo1x_1_compress(in, (lzo_uint)in_len, out, &out_len, wrkmem) == LZO_E_OK) &&
+        (out_len < in_len)) {
+      *r_out_len = out_len;
+      return PTCACHE_COMPRESS_LZO;
+    }
+  }
+#endif
+#ifdef WITH_LZMA
+  if (mode == PTCACHE_COMPRESS_LZMA) {
+    size_t out_len = LZO_OUT_LEN(in_len) - PTCACHE_LZMA_PROPS_SIZE;
+    size_t props_len = PTCACHE_LZMA_PROPS_SIZE;
+
+    if ((LzmaCompress(out + PTCACHE_LZMA_PROPS_SIZE,
+                      &out_len,
+                      in,
+                      in_len,
+                      out,
+                      &props_len,
+                      5,
+                      1 << 24,
+                      3,
+                      0,
+                      2,
+                      32,
+                      1) == SZ_OK) &&
+        (out_len + PTCACHE_LZMA_PROPS_SIZE < in_len)) {
+      *r_out_len = out_len + PTCACHE_LZMA_PROPS_SIZE;
+      return PTCACHE_COMPRESS_LZMA;
+    }
+  }
+#endif
+
+  (void)mode; /* unused when building w/o compression */
+
+  return PTCACHE_COMPRESS_NO;
+}
+
+static bool ptcache_decompress_buffer(const unsigned char *in,
+                                      size_t in_len,
+                                      unsigned char *out,
+                                      size_t out_len,
+                                      unsigned int compression)
+{
+  if (compression == PTCACHE_COMPRESS_NO) {
+    if (in_len != out_len) {
+      return false;
+    }
+    memcpy(out, in, out_len);
+    return true;
+  }
+#ifdef WITH_LZO
+  if (compression == PTCACHE_COMPRESS_LZO) {
+    lzo_uint len = out_len;
+    return (lzo1x_decompress_safe(in, (lzo_uint)in_len, out, &len, NULL) == LZO_E_OK) &&
+           (len == out_len);
+  }
+#endif
+#ifdef WITH_LZMA
+  if (compression == PTCACHE_COMPRESS_LZMA) {
+    size_t leni, leno = out_len;
+    if (in_len < PTCACHE_LZMA_PROPS_SIZE) {
+      return false;
+    }
+    leni = in_len - PTCACHE_LZMA_PROPS_SIZE;
+    return (LzmaUncompress(out,
+                           &leno,
+                           in + PTCACHE_LZMA_PROPS_SIZE,
+                           &leni,
+                           in,
+                           PTCACHE_LZMA_PROPS_SIZE) == SZ_OK) &&
+           (leno == out_len);
+  }
+#endif
+
+  return false;
+}
+
+static void ptcache_chunk_compress_cb(void *__restrict userdata,
+                                      const int index,
+                                      const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  PTCacheChunkData *cd = &((PTCacheChunkData *)userdata)[index];
+  PTCacheChunk *chunk = &cd->chunk;
+  const size_t len = chunk->totelem * ptcache_chunk_elem_size(chunk->type);
+  const unsigned char *in = cd->data;
+  unsigned char *in_shuffled = NULL;
+  size_t out_len;
+
+  /* Requested compression, replaced by the one actually used. */
+  const int mode = (int)chunk->compression;
+
+  chunk->compression = PTCACHE_COMPRESS_NO;
+  chunk->size = len;
+
+  if (mode == PTCACHE_COMPRESS_NO || len == 0) {
+    return;
+  }
+
+  if (ptcache_chunk_is_float(chunk->type)) {
+    in_shuffled = MEM_mallocN(len, "pointcache_shuffle_buffer");
+    ptcache_byte_shuffle(in_shuffled, in, len);
+    in = in_shuffled;
+  }
+
+  cd->buffer = MEM_mallocN(LZO_OUT_LEN(len), "pointcache_chunk_buffer");
+  chunk->compression = ptcache_compress_buffer(in, len, cd->buffer, &out_len, mode);
+
+  if (chunk->compression != PTCACHE_COMPRESS_NO) {
+    chunk->flag |= in_shuffled ? PTCACHE_CHUNK_SHUFFLE : 0;
+    chunk->size = out_len;
+    cd->stored = cd->buffer;
+  }
+  else {
+    MEM_freeN(cd->buffer);
+    cd->buffer = NULL;
+  }
+
+  if (in_shuffled) {
+    MEM_freeN(in_shuffled);
+  }
+}
+
+static void ptcache_chunk_decompress_cb(void *__restrict userdata,
+                                        const int index,
+                                        const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  PTCacheChunkData *cd = &((PTCacheChunkData *)userdata)[index];
+  const PTCacheChunk *chunk = &cd->chunk;
+  const size_t len = chunk->totelem * ptcache_chunk_elem_size(chunk->type);
+
+  if (chunk->flag & PTCACHE_CHUNK_SHUFFLE) {
+    unsigned char *out_shuffled = MEM_mallocN(len, "pointcache_shuffle_buffer");
+    cd->error = !ptcache_decompress_buffer(
+        cd->stored, chunk->size, out_shuffled, len, chunk->compression);
+    if (!cd->error) {
+      ptcache_byte_unshuffle(cd->data, out_shuffled, len);
+    }
+    MEM_freeN(out_shuffled);
+  }
+  else {
+    cd->error = !ptcache_decompress_buffer(
+        cd->stored, chunk->size, cd->data, len, chunk->compression);
+  }
+}
+
+static void ptcache_chunks_parallel(PTCacheChunkData *chunks,
+                                    const unsigned int chunks_len,
+                                    TaskParallelRangeFunc func)
+{
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.use_threading = (chunks_len > 1);
+  settings.min_iter_per_thread = 1;
+  BLI_task_parallel_range(0, (int)chunks_len, chunks, func, &settings);
+}
+
+static bool ptcache_file_pad_write(PTCacheFile *pf, uint64_t *pos)
+{
+  static const unsigned char zero[PTCACHE_CHUNK_ALIGN] = {0};
+  const unsigned int pad = (unsigned int)(-*pos & (PTCACHE_CHUNK_ALIGN - 1));
+
+  *pos += pad;
+  return (pad == 0) || ptcache_file_write(pf, zero, pad, sizeof(unsigned char));
+}
+
+/* Write the chunk table and the data of \a pm, after the header. */
+static int ptcache_file_chunks_write(PTCacheFile *pf, PTCacheMem *pm, int compression)
+{
+  PTCacheChunkData *chunks;
+  unsigned int i, chunks_len = 0;
+  PTCacheExtra *extra;
+  uint64_t pos;
+  int error = 0;
+
+  chunks = MEM_calloc_arrayN(
+      BPHYS_TOT_DATA + BLI_listbase_count(&pm->extradata), sizeof(*chunks), __func__);
+
+  for (i = 0; i < BPHYS_TOT_DATA; i++) {
+    if (pm->data[i]) {
+      PTCacheChunkData *cd = &chunks[chunks_len++];
+      cd->chunk.type = i;
+      cd->chunk.totelem = pm->totpoint;
+      cd->data = pm->data[i];
+    }
+  }
+  for (extra = pm->extradata.first; extra; extra = extra->next) {
+    if (extra->data && extra->totdata) {
+      PTCacheChunkData *cd = &chunks[chunks_len++];
+      cd->chunk.type = PTCACHE_CHUNK_EXTRA + extra->type;
+      cd->chunk.totelem = extra->totdata;
+      cd->data = extra->data;
+    }
+  }
+
+  for (i = 0; i < chunks_len; i++) {
+    chunks[i].chunk.compression = compression;
+    chunks[i].stored = chunks[i].data;
+  }
+  ptcache_chunks_parallel(chunks, chunks_len, ptcache_chunk_compress_cb);
+
+  /* Lay out the chunks after the table. */
+  pos = (uint64_t)BLI_ftell(pf->fp) + sizeof(unsigned int) + chunks_len * sizeof(PTCacheChunk);
+  for (i = 0; i < chunks_len; i++) {
+    pos += -pos & (PTCACHE_CHUNK_ALIGN - 1);
+    chunks[i].chunk.offset = pos;
+    pos += chunks[i].chunk.size;
+  }
+
+  if (!ptcache_file_write(pf, &chunks_len, 1, sizeof(unsigned int))) {
+    error = 1;
+  }
+  for (i = 0; i < chunks_len && !error; i++) {
+    if (!ptcache_file_write(pf, &chunks[i].chunk, 1, sizeof(PTCacheChunk))) {
+      error = 1;
+    }
+  }
+
+  pos = (uint64_t)BLI_ftell(pf->fp);
+  for (i = 0; i < chunks_len && !error; i++) {
+    const PTCacheChunk *chunk = &chunks[i].chunk;
+    if (!ptcache_file_pad_write(pf, &pos) ||
+        (chunk->size && !ptcache_file_write(pf, chunks[i].stored, chunk->size, 1))) {
+      error = 1;
+    }
+    pos += chunk->size;
+  }
+
+  for (i = 0; i < chunks_len; i++) {
+    MEM_SAFE_FREE(chunks[i].buffer);
+  }
+  MEM_freeN(chunks);
+
+  return !error;
+}
+
+/* Read the chunk table following the header and the data of all chunks into \a pm. */
+static int ptcache_file_chunks_read(PTCacheFile *pf, PTCacheMem *pm)
+{
+  PTCacheChunkData *chunks;
+  unsigned int chunks_len = 0, data_types_read = 0;
+  const size_t file_size = BLI_file_descriptor_size(fileno(pf->fp));
+  const unsigned char *file_data = NULL;
+  unsigned int i;
+  int error = 0;
+
+  if (!ptcache_file_read(pf, &chunks_len, 1, sizeof(unsigned int)) ||
+      (chunks_len > PTCACHE_CHUNK_MAX) || (file_size == (size_t)-1)) {
+    return 0;
+  }
+
+  chunks = MEM_calloc_arrayN(MAX2(chunks_len, 1), sizeof(*chunks), __func__);
+
+  for (i = 0; i < chunks_len && !error; i++) {
+    PTCacheChunkData *cd = &chunks[i];
+    PTCacheChunk *chunk = &cd->chunk;
+    size_t elem_size;
+
+    if (!ptcache_file_read(pf, chunk, 1, sizeof(PTCacheChunk))) {
+      error = 1;
+      break;
+    }
+
+    elem_size = ptcache_chunk_elem_size(chunk->type);
+    if ((elem_size == 0) || (chunk->offset > file_size) ||
+        (chunk->size > file_size - chunk->offset)) {
+      error = 1;
+    }
+    else if (chunk->type < BPHYS_TOT_DATA) {
+      if (!(pm->data_types & (1 << chunk->type)) || (chunk->totelem != pm->totpoint) ||
+          (data_types_read & (1 << chunk->type))) {
+        error = 1;
+      }
+      else {
+        data_types_read |= (1 << chunk->type);
+        cd->data = pm->data[chunk->type];
+      }
+    }
+    else {
+      PTCacheExtra *extra = MEM_callocN(sizeof(PTCacheExtra), "Pointcache extradata");
+      extra->type = chunk->type - PTCACHE_CHUNK_EXTRA;
+      extra->totdata = chunk->totelem;
+      extra->data = MEM_callocN(extra->totdata * elem_size, "Pointcache extradata->data");
+      BLI_addtail(&pm->extradata, extra);
+      cd->data = extra->data;
+    }
+  }
+
+  if (!error && data_types_read != pm->data_types) {
+    error = 1;
+  }
+
+#ifndef WIN32
+  /* Mapping errors aren't fatal, the chunks are read from the file instead. */
+  if (!error && chunks_len && file_size) {
+    void *map = mmap(NULL, file_size, PROT_READ, MAP_PRIVATE, fileno(pf->fp), 0);
+    if (map != MAP_FAILED) {
+      file_data = map;
+    }
+  }
+#endif
+
+  for (i = 0; i < chunks_len && !error; i++) {
+    PTCacheChunkData *cd = &chunks[i];
+    if (file_data) {
+      cd->stored = file_data + cd->chunk.offset;
+    }
+    else {
+      cd->buffer = MEM_mallocN(MAX2(cd->chunk.size, 1), "pointcache_chunk_buffer");
+      cd->stored = cd->buffer;
+      if ((BLI_fseek(pf->fp, (int64_t)cd->chunk.offset, SEEK_SET) != 0) ||
+          (cd->chunk.size && !ptcache_file_read(pf, cd->buffer, cd->chunk.size, 1))) {
+        error = 1;
+      }
+    }
+  }
+
+  if (!error) {
+    ptcache_chunks_parallel(chunks, chunks_len, ptcache_chunk_decompress_cb);
+  }
+
+  for (i = 0; i < chunks_len; i++) {
+    error |= chunks[i].error;
+    MEM_SAFE_FREE(chunks[i].buffer);
+  }
+  MEM_freeN(chunks);
+
+#ifndef WIN32
+  if (file_data) {
+    munmap((void *)file_data, file_size);
+  }
+#endif
+
+  return !error;
+}
+
+/** \} */
+
 static PTCacheMem *ptcache_disk_frame_to_mem(PTCacheID *pid, int cfra)
 {
   PTCacheFile *pf = ptcache_file_open(pid, PTCACHE_FILE_READ, cfra);
@@ -2652,7 +3082,12 @@ static PTCacheMem *ptcache_disk_frame_to_mem(PTCacheID *pid, int cfra)
 
     ptcache_data_alloc(pm);
 
-    if (pf->flag & PTCACHE_TYPEFLAG_COMPRESS) {
+    if (pf->flag & PTCACHE_TYPEFLAG_CHUNKED) {
+      if (!ptcache_file_chunks_read(pf, pm)) {
+        error = 1;
+      }
+    }
+    else if (pf->flag & PTCACHE_TYPEFLAG_COMPRESS) {
       for (i = 0; i < BPHYS_TOT_DATA; i++) {
         unsigned int out_len = pm->totpoint * ptcache_data_size[i];
         if (pf->data_types & (1 << i)) {
@@ -2675,7 +3110,9 @@ static PTCacheMem *ptcache_disk_frame_to_mem(PTCacheID *pid, int cfra)
     }
   }
 
-  if (!error && pf->flag & PTCACHE_TYPEFLAG_EXTRADATA) {
+  /* Chunked files store extra data as chunks. */
+  if (!error && (pf->flag & PTCACHE_TYPEFLAG_EXTRADATA) &&
+      !(pf->flag & PTCACHE_TYPEFLAG_CHUNKED)) {
     unsigned int extratype = 0;
 
     while (ptcache_file_read(pf, &extratype, 1, sizeof(unsigned int))) {
@@ -2719,7 +3156,7 @@ static PTCacheMem *ptcache_disk_frame_to_mem(PTCacheID *pid, int cfra)
 static int ptcache_mem_frame_to_disk(PTCacheID *pid, PTCacheMem *pm)
 {
   PTCacheFile *pf = NULL;
-  unsigned int i, error = 0;
+  unsigned int error = 0;
 
   BKE_ptcache_id_clear(pid, PTCACHE_CLEAR_FRAME, pm->frame);
 
@@ -2735,7 +3172,7 @@ static int ptcache_mem_frame_to_disk(PTCacheID *pid, PTCacheMem *pm)
   pf->data_types = pm->data_types;
   pf->totpoint = pm->totpoint;
   pf->type = pid->type;
-  pf->flag = 0;
+  pf->flag = PTCACHE_TYPEFLAG_CHUNKED;
 
   if (pm->extradata.first) {
     pf->flag |= PTCACHE_TYPEFLAG_EXTRADATA;
@@ -2749,57 +3186,8 @@ static int ptcache_mem_frame_to_disk(PTCacheID *pid, PTCacheMem *pm)
     error = 1;
   }
 
-  if (!error) {
-    if (pid->cache->compression) {
-      for (i = 0; i < BPHYS_TOT_DATA; i++) {
-        if (pm->data[i]) {
-          unsigned int in_len = pm->totpoint * ptcache_data_size[i];
-          unsigned char *out = (unsigned char *)MEM_callocN(LZO_OUT_LEN(in_len) * 4,
-                                                            "pointcache_lzo_buffer");
-          ptcache_file_compressed_write(
-              pf, (unsigned char *)(pm->data[i]), in_len, out, pid->cache->compression);
-          MEM_freeN(out);
-        }
-      }
-    }
-    else {
-      BKE_ptcache_mem_pointers_init(pm);
-      ptcache_file_pointers_init(pf);
-
-      for (i = 0; i < pm->totpoint; i++) {
-        ptcache_data_copy(pm->cur, pf->cur);
-        if (!ptcache_file_data_write(pf)) {
-          error = 1;
-          break;
-        }
-        BKE_ptcache_mem_pointers_incr(pm);
-      }
-    }
-  }
-
-  if (!error && pm->extradata.first) {
-    PTCacheExtra *extra = pm->extradata.first;
-
-    for (; extra; extra = extra->next) {
-      if (extra->data == NULL || extra->totdata == 0) {
-        continue;
-      }
-
-      ptcache_file_write(pf, &extra->type, 1, sizeof(unsigned int));
-      ptcache_file_write(pf, &extra->totdata, 1, sizeof(unsigned int));
-
-      if (pid->cache->compression) {
-        unsigned int in_len = extra->totdata * ptcache_extra_datasize[extra->type];
-        unsigned char *out = (unsigned char *)MEM_callocN(LZO_OUT_LEN(in_len) * 4,
-                                                          "pointcache_lzo_buffer");
-        ptcache_file_compressed_write(
-            pf, (unsigned char *)(extra->data), in_len, out, pid->cache->compression);
-        MEM_freeN(out);
-      }
-      else {
-        ptcache_file_write(pf, extra->data, extra->totdata, ptcache_extra_datasize[extra->type]);
-      }
-    }
+  if (!error && !ptcache_file_chunks_write(pf, pm, pid->cache->compression)) {
+    error = 1;
   }
 
   ptcache_file_close(pf);
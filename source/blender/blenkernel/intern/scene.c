@@ -255,6 +255,8 @@ static void scene_init_data(ID *id)
 
   scene->gm.lodflag = SCE_LOD_USE_HYST;
   scene->gm.scehysteresis = 10;
+  scene->gm.anim_lod_distance = 30.0f;
+  scene->gm.anim_lod_interval = 4;
 
   scene->gm.pythonkeys[0] = EVT_LEFTCTRLKEY;
   scene->gm.pythonkeys[1] = EVT_LEFTSHIFTKEY;
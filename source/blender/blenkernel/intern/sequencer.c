@@ -39,6 +39,7 @@
 #include "DNA_sequence_types.h"
 #include "DNA_sound_types.h"
 #include "DNA_space_types.h"
+#include "DNA_userdef_types.h"
 #include "DNA_windowmanager_types.h"
 
 #include "BLI_fileops.h"
@@ -922,6 +923,20 @@ static void seq_multiview_name(Scene *scene,
   BLI_snprintf(r_path, r_size, "%s%s%s", prefix, suffix, ext);
 }
 
+static int seq_anim_flags(const Sequence *seq)
+{
+  int flags = IB_rect;
+
+  if (seq->flag & SEQ_FILTERY) {
+    flags |= IB_animdeinterlace;
+  }
+  if (U.movie_flag & USER_MOVIE_PARALLEL_DECODING) {
+    flags |= IB_animprefetch;
+  }
+
+  return flags;
+}
+
 /* note: caller should run BKE_sequence_calc(scene, seq) after */
 void BKE_sequence_reload_new_file(Main *bmain, Scene *scene, Sequence *seq, const bool lock_range)
 {
@@ -986,7 +1001,7 @@ void BKE_sequence_reload_new_file(Main *bmain, Scene *scene, Sequence *seq, cons
 
             seq_multiview_name(scene, i, prefix, ext, str, FILE_MAX);
             anim = openanim(str,
-                            IB_rect | ((seq->flag & SEQ_FILTERY) ? IB_animdeinterlace : 0),
+                            seq_anim_flags(seq),
                             seq->streamindex,
                             seq->strip->colorspace_settings.name);
 
@@ -1004,7 +1019,7 @@ void BKE_sequence_reload_new_file(Main *bmain, Scene *scene, Sequence *seq, cons
       if (is_multiview_loaded == false) {
         struct anim *anim;
         anim = openanim(path,
-                        IB_rect | ((seq->flag & SEQ_FILTERY) ? IB_animdeinterlace : 0),
+                        seq_anim_flags(seq),
                         seq->streamindex,
                         seq->strip->colorspace_settings.name);
         if (anim) {
@@ -1715,14 +1730,13 @@ static void seq_open_anim_file(Scene *scene, Sequence *seq, bool openfile)
 
         if (openfile) {
           sanim->anim = openanim(str,
-                                 IB_rect | ((seq->flag & SEQ_FILTERY) ? IB_animdeinterlace : 0),
+                                 seq_anim_flags(seq),
                                  seq->streamindex,
                                  seq->strip->colorspace_settings.name);
         }
         else {
           sanim->anim = openanim_noload(str,
-                                        IB_rect |
-                                            ((seq->flag & SEQ_FILTERY) ? IB_animdeinterlace : 0),
+                                        seq_anim_flags(seq),
                                         seq->streamindex,
                                         seq->strip->colorspace_settings.name);
         }
@@ -1734,14 +1748,13 @@ static void seq_open_anim_file(Scene *scene, Sequence *seq, bool openfile)
         else {
           if (openfile) {
             sanim->anim = openanim(name,
-                                   IB_rect | ((seq->flag & SEQ_FILTERY) ? IB_animdeinterlace : 0),
+                                   seq_anim_flags(seq),
                                    seq->streamindex,
                                    seq->strip->colorspace_settings.name);
           }
           else {
             sanim->anim = openanim_noload(name,
-                                          IB_rect |
-                                              ((seq->flag & SEQ_FILTERY) ? IB_animdeinterlace : 0),
+                                          seq_anim_flags(seq),
                                           seq->streamindex,
                                           seq->strip->colorspace_settings.name);
           }
@@ -1766,13 +1779,13 @@ static void seq_open_anim_file(Scene *scene, Sequence *seq, bool openfile)
 
     if (openfile) {
       sanim->anim = openanim(name,
-                             IB_rect | ((seq->flag & SEQ_FILTERY) ? IB_animdeinterlace : 0),
+                             seq_anim_flags(seq),
                              seq->streamindex,
                              seq->strip->colorspace_settings.name);
     }
     else {
       sanim->anim = openanim_noload(name,
-                                    IB_rect | ((seq->flag & SEQ_FILTERY) ? IB_animdeinterlace : 0),
+                                    seq_anim_flags(seq),
                                     seq->streamindex,
                                     seq->strip->colorspace_settings.name);
     }
@@ -23,6 +23,9 @@
 
 #include "BKE_subdiv_mesh.h"
 
+#include <stdlib.h>
+#include <string.h>
+
 #include "atomic_ops.h"
 
 #include "DNA_key_types.h"
@@ -30,10 +33,13 @@
 #include "DNA_meshdata_types.h"
 
 #include "BLI_alloca.h"
+#include "BLI_hash_mm2a.h"
 #include "BLI_math_vector.h"
+#include "BLI_task.h"
 
 #include "BKE_customdata.h"
 #include "BKE_key.h"
+#include "BKE_lib_id.h"
 #include "BKE_mesh.h"
 #include "BKE_subdiv.h"
 #include "BKE_subdiv_eval.h"
@@ -1236,3 +1242,466 @@ Mesh *BKE_subdiv_to_mesh(Subdiv *subdiv,
 }
 
 /** \} */
+
+/* -------------------------------------------------------------------- */
+/** \name Cached evaluation
+ *
+ * Deforming meshes keep the same topology and custom data between evaluations, only their
+ * vertex coordinates change. The result of a full evaluation is kept together with the limit
+ * surface samples giving position and normal of each subdivided vertex, so further evaluations
+ * only refine the evaluator and evaluate those samples, other data is copied from the cache.
+ *
+ * The cache is only filled when the coarse mesh was seen twice with the same topology and data,
+ * so meshes with changing topology don't pay for it.
+ * \{ */
+
+typedef struct SubdivMeshVertexSample {
+  int ptex_face_index;
+  float u, v;
+} SubdivMeshVertexSample;
+
+typedef struct SubdivMeshCache {
+  SubdivSettings subdiv_settings;
+  SubdivToMeshSettings settings;
+  /* Coarse mesh the cache is valid for, besides vertex coordinates. */
+  int coarse_totvert, coarse_totedge, coarse_totloop, coarse_totpoly;
+  uint32_t coarse_hash;
+  /* Result of the last full evaluation, NULL until the coarse mesh was seen twice. */
+  Mesh *mesh;
+  /* Loose geometry isn't evaluated from the limit surface, such meshes aren't cached. */
+  bool has_loose_geometry;
+  /* Sample giving the position of each vertex of #mesh. */
+  SubdivMeshVertexSample *vert_samples;
+  /* Samples averaged for normals of vertices on ptex boundaries, samples of a vertex are in
+   * [normal_sample_offset[i], normal_sample_offset[i + 1]). Vertices without samples use
+   * the normal at their position sample. */
+  int *normal_sample_offset;
+  SubdivMeshVertexSample *normal_samples;
+} SubdivMeshCache;
+
+static void subdiv_mesh_cache_clear(SubdivMeshCache *cache)
+{
+  if (cache->mesh != NULL) {
+    BKE_id_free(NULL, cache->mesh);
+    cache->mesh = NULL;
+  }
+  MEM_SAFE_FREE(cache->vert_samples);
+  MEM_SAFE_FREE(cache->normal_sample_offset);
+  MEM_SAFE_FREE(cache->normal_samples);
+}
+
+static void subdiv_mesh_hash_custom_data(BLI_HashMurmur2A *mm2,
+                                         const CustomData *data,
+                                         const int totelem,
+                                         const int skip_type,
+                                         bool *r_is_cacheable)
+{
+  for (int i = 0; i < data->totlayer; i++) {
+    const CustomDataLayer *layer = &data->layers[i];
+    if (ELEM(layer->type, skip_type, CD_NORMAL)) {
+      continue;
+    }
+    BLI_hash_mm2a_add_int(mm2, layer->type);
+    BLI_hash_mm2a_add(mm2, (const unsigned char *)layer->name, strlen(layer->name));
+    if (layer->type == CD_MDEFORMVERT) {
+      const MDeformVert *dvert = layer->data;
+      for (int j = 0; j < totelem; j++) {
+        BLI_hash_mm2a_add_int(mm2, dvert[j].totweight);
+        if (dvert[j].totweight) {
+          BLI_hash_mm2a_add(mm2,
+                            (const unsigned char *)dvert[j].dw,
+                            sizeof(*dvert[j].dw) * (size_t)dvert[j].totweight);
+        }
+      }
+    }
+    else if (ELEM(layer->type, CD_MDISPS, CD_GRID_PAINT_MASK)) {
+      /* Layers storing pointers, but also unlikely on deforming meshes. */
+      *r_is_cacheable = false;
+    }
+    else {
+      BLI_hash_mm2a_add(
+          mm2, layer->data, (size_t)CustomData_sizeof(layer->type) * (size_t)totelem);
+    }
+  }
+}
+
+/* Hash everything in the coarse mesh the result depends on, besides vertex coordinates. */
+static bool subdiv_mesh_coarse_hash(const Mesh *coarse_mesh, uint32_t *r_hash)
+{
+  BLI_HashMurmur2A mm2;
+  bool is_cacheable = true;
+  BLI_hash_mm2a_init(&mm2, 0);
+  for (int i = 0; i < coarse_mesh->totvert; i++) {
+    const MVert *mvert = &coarse_mesh->mvert[i];
+    BLI_hash_mm2a_add_int(&mm2, mvert->flag | (mvert->bweight << 8));
+  }
+  BLI_hash_mm2a_add(&mm2,
+                    (const unsigned char *)coarse_mesh->medge,
+                    sizeof(*coarse_mesh->medge) * (size_t)coarse_mesh->totedge);
+  BLI_hash_mm2a_add(&mm2,
+                    (const unsigned char *)coarse_mesh->mloop,
+                    sizeof(*coarse_mesh->mloop) * (size_t)coarse_mesh->totloop);
+  BLI_hash_mm2a_add(&mm2,
+                    (const unsigned char *)coarse_mesh->mpoly,
+                    sizeof(*coarse_mesh->mpoly) * (size_t)coarse_mesh->totpoly);
+  subdiv_mesh_hash_custom_data(
+      &mm2, &coarse_mesh->vdata, coarse_mesh->totvert, CD_MVERT, &is_cacheable);
+  subdiv_mesh_hash_custom_data(
+      &mm2, &coarse_mesh->edata, coarse_mesh->totedge, CD_MEDGE, &is_cacheable);
+  subdiv_mesh_hash_custom_data(
+      &mm2, &coarse_mesh->ldata, coarse_mesh->totloop, CD_MLOOP, &is_cacheable);
+  subdiv_mesh_hash_custom_data(
+      &mm2, &coarse_mesh->pdata, coarse_mesh->totpoly, CD_MPOLY, &is_cacheable);
+  *r_hash = BLI_hash_mm2a_end(&mm2);
+  return is_cacheable;
+}
+
+static bool subdiv_mesh_cache_matches(const SubdivMeshCache *cache,
+                                      const Subdiv *subdiv,
+                                      const SubdivToMeshSettings *settings,
+                                      const Mesh *coarse_mesh,
+                                      const uint32_t coarse_hash)
+{
+  return BKE_subdiv_settings_equal(&cache->subdiv_settings, &subdiv->settings) &&
+         (cache->settings.resolution == settings->resolution) &&
+         (cache->settings.use_optimal_display == settings->use_optimal_display) &&
+         (cache->coarse_totvert == coarse_mesh->totvert) &&
+         (cache->coarse_totedge == coarse_mesh->totedge) &&
+         (cache->coarse_totloop == coarse_mesh->totloop) &&
+         (cache->coarse_totpoly == coarse_mesh->totpoly) && (cache->coarse_hash == coarse_hash);
+}
+
+/* Recording of the vertex samples. */
+
+typedef struct SubdivMeshRecordContext {
+  SubdivMeshCache *cache;
+  int *normal_sample_fill;
+  bool has_loose;
+} SubdivMeshRecordContext;
+
+static void subdiv_mesh_record_sample(const SubdivForeachContext *foreach_context,
+                                      const int ptex_face_index,
+                                      const float u,
+                                      const float v,
+                                      const int subdiv_vertex_index)
+{
+  SubdivMeshRecordContext *ctx = foreach_context->user_data;
+  SubdivMeshVertexSample *sample = &ctx->cache->vert_samples[subdiv_vertex_index];
+  sample->ptex_face_index = ptex_face_index;
+  sample->u = u;
+  sample->v = v;
+}
+
+static void subdiv_mesh_record_normal_sample(const SubdivForeachContext *foreach_context,
+                                             const int ptex_face_index,
+                                             const float u,
+                                             const float v,
+                                             const int subdiv_vertex_index)
+{
+  SubdivMeshRecordContext *ctx = foreach_context->user_data;
+  SubdivMeshCache *cache = ctx->cache;
+  if (ctx->normal_sample_fill == NULL) {
+    /* Counting pass. */
+    atomic_add_and_fetch_int32(&cache->normal_sample_offset[subdiv_vertex_index + 1], 1);
+    return;
+  }
+  const int index = cache->normal_sample_offset[subdiv_vertex_index] +
+                    atomic_fetch_and_add_int32(&ctx->normal_sample_fill[subdiv_vertex_index], 1);
+  SubdivMeshVertexSample *sample = &cache->normal_samples[index];
+  sample->ptex_face_index = ptex_face_index;
+  sample->u = u;
+  sample->v = v;
+}
+
+static void subdiv_mesh_record_vertex_every_corner(const SubdivForeachContext *foreach_context,
+                                                   void *UNUSED(tls),
+                                                   const int ptex_face_index,
+                                                   const float u,
+                                                   const float v,
+                                                   const int UNUSED(coarse_vertex_index),
+                                                   const int UNUSED(coarse_poly_index),
+                                                   const int UNUSED(coarse_corner),
+                                                   const int subdiv_vertex_index)
+{
+  subdiv_mesh_record_normal_sample(foreach_context, ptex_face_index, u, v, subdiv_vertex_index);
+}
+
+static void subdiv_mesh_record_vertex_every_edge(const SubdivForeachContext *foreach_context,
+                                                 void *UNUSED(tls),
+                                                 const int ptex_face_index,
+                                                 const float u,
+                                                 const float v,
+                                                 const int UNUSED(coarse_edge_index),
+                                                 const int UNUSED(coarse_poly_index),
+                                                 const int UNUSED(coarse_corner),
+                                                 const int subdiv_vertex_index)
+{
+  subdiv_mesh_record_normal_sample(foreach_context, ptex_face_index, u, v, subdiv_vertex_index);
+}
+
+static void subdiv_mesh_record_vertex_corner(const SubdivForeachContext *foreach_context,
+                                             void *UNUSED(tls),
+                                             const int ptex_face_index,
+                                             const float u,
+                                             const float v,
+                                             const int UNUSED(coarse_vertex_index),
+                                             const int UNUSED(coarse_poly_index),
+                                             const int UNUSED(coarse_corner),
+                                             const int subdiv_vertex_index)
+{
+  subdiv_mesh_record_sample(foreach_context, ptex_face_index, u, v, subdiv_vertex_index);
+}
+
+static void subdiv_mesh_record_vertex_edge(const SubdivForeachContext *foreach_context,
+                                           void *UNUSED(tls),
+                                           const int ptex_face_index,
+                                           const float u,
+                                           const float v,
+                                           const int UNUSED(coarse_edge_index),
+                                           const int UNUSED(coarse_poly_index),
+                                           const int UNUSED(coarse_corner),
+                                           const int subdiv_vertex_index)
+{
+  subdiv_mesh_record_sample(foreach_context, ptex_face_index, u, v, subdiv_vertex_index);
+}
+
+static void subdiv_mesh_record_vertex_inner(const SubdivForeachContext *foreach_context,
+                                            void *UNUSED(tls),
+                                            const int ptex_face_index,
+                                            const float u,
+                                            const float v,
+                                            const int UNUSED(coarse_poly_index),
+                                            const int UNUSED(coarse_corner),
+                                            const int subdiv_vertex_index)
+{
+  subdiv_mesh_record_sample(foreach_context, ptex_face_index, u, v, subdiv_vertex_index);
+}
+
+static void subdiv_mesh_record_vertex_loose(const SubdivForeachContext *foreach_context,
+                                            void *UNUSED(tls),
+                                            const int UNUSED(coarse_vertex_index),
+                                            const int UNUSED(subdiv_vertex_index))
+{
+  SubdivMeshRecordContext *ctx = foreach_context->user_data;
+  ctx->has_loose = true;
+}
+
+static void subdiv_mesh_record_vertex_of_loose_edge(
+    const struct SubdivForeachContext *foreach_context,
+    void *UNUSED(tls),
+    const int UNUSED(coarse_edge_index),
+    const float UNUSED(u),
+    const int UNUSED(subdiv_vertex_index))
+{
+  SubdivMeshRecordContext *ctx = foreach_context->user_data;
+  ctx->has_loose = true;
+}
+
+static int subdiv_mesh_vertex_sample_cmp(const void *a_v, const void *b_v)
+{
+  const SubdivMeshVertexSample *a = a_v, *b = b_v;
+  if (a->ptex_face_index != b->ptex_face_index) {
+    return (a->ptex_face_index < b->ptex_face_index) ? -1 : 1;
+  }
+  if (a->u != b->u) {
+    return (a->u < b->u) ? -1 : 1;
+  }
+  if (a->v != b->v) {
+    return (a->v < b->v) ? -1 : 1;
+  }
+  return 0;
+}
+
+/* Record the samples of all vertices of the cached mesh, false when the mesh can't be
+ * re-evaluated from samples only (loose geometry). */
+static bool subdiv_mesh_cache_record(SubdivMeshCache *cache,
+                                     Subdiv *subdiv,
+                                     const SubdivToMeshSettings *settings,
+                                     const Mesh *coarse_mesh)
+{
+  const int num_vertices = cache->mesh->totvert;
+  SubdivMeshRecordContext ctx = {cache};
+  SubdivForeachContext foreach_context = {NULL};
+  foreach_context.user_data = &ctx;
+
+  cache->vert_samples = MEM_malloc_arrayN(
+      num_vertices, sizeof(*cache->vert_samples), "subdiv mesh cache samples");
+  cache->normal_sample_offset = MEM_calloc_arrayN(
+      num_vertices + 1, sizeof(*cache->normal_sample_offset), "subdiv mesh cache offsets");
+
+  /* Position samples, count of normal samples. */
+  foreach_context.vertex_every_corner = subdiv_mesh_record_vertex_every_corner;
+  foreach_context.vertex_every_edge = subdiv_mesh_record_vertex_every_edge;
+  foreach_context.vertex_corner = subdiv_mesh_record_vertex_corner;
+  foreach_context.vertex_edge = subdiv_mesh_record_vertex_edge;
+  foreach_context.vertex_inner = subdiv_mesh_record_vertex_inner;
+  foreach_context.vertex_loose = subdiv_mesh_record_vertex_loose;
+  foreach_context.vertex_of_loose_edge = subdiv_mesh_record_vertex_of_loose_edge;
+  BKE_subdiv_foreach_subdiv_geometry(subdiv, &foreach_context, settings, coarse_mesh);
+  if (ctx.has_loose) {
+    return false;
+  }
+
+  for (int i = 0; i < num_vertices; i++) {
+    cache->normal_sample_offset[i + 1] += cache->normal_sample_offset[i];
+  }
+  cache->normal_samples = MEM_malloc_arrayN(cache->normal_sample_offset[num_vertices],
+                                            sizeof(*cache->normal_samples),
+                                            "subdiv mesh cache normal samples");
+
+  /* Normal samples. */
+  ctx.normal_sample_fill = MEM_calloc_arrayN(
+      num_vertices, sizeof(*ctx.normal_sample_fill), "subdiv mesh cache fill");
+  memset(&foreach_context, 0, sizeof(foreach_context));
+  foreach_context.user_data = &ctx;
+  foreach_context.vertex_every_corner = subdiv_mesh_record_vertex_every_corner;
+  foreach_context.vertex_every_edge = subdiv_mesh_record_vertex_every_edge;
+  BKE_subdiv_foreach_subdiv_geometry(subdiv, &foreach_context, settings, coarse_mesh);
+  MEM_freeN(ctx.normal_sample_fill);
+
+  /* Samples are added from threads, sort them so normals are summed in a stable order. */
+  for (int i = 0; i < num_vertices; i++) {
+    const int start = cache->normal_sample_offset[i];
+    const int len = cache->normal_sample_offset[i + 1] - start;
+    if (len > 1) {
+      qsort(&cache->normal_samples[start],
+            len,
+            sizeof(*cache->normal_samples),
+            subdiv_mesh_vertex_sample_cmp);
+    }
+  }
+  return true;
+}
+
+/* Re-evaluation of the vertices. */
+
+typedef struct SubdivMeshCacheEvalData {
+  const SubdivMeshCache *cache;
+  Subdiv *subdiv;
+  MVert *mvert;
+} SubdivMeshCacheEvalData;
+
+static void subdiv_mesh_cache_eval_vertex_cb(void *__restrict userdata,
+                                             const int vertex_index,
+                                             const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  const SubdivMeshCacheEvalData *data = userdata;
+  const SubdivMeshCache *cache = data->cache;
+  Subdiv *subdiv = data->subdiv;
+  const SubdivMeshVertexSample *sample = &cache->vert_samples[vertex_index];
+  MVert *mvert = &data->mvert[vertex_index];
+  const int start = cache->normal_sample_offset[vertex_index];
+  const int end = cache->normal_sample_offset[vertex_index + 1];
+
+  if (start == end) {
+    BKE_subdiv_eval_limit_point_and_short_normal(
+        subdiv, sample->ptex_face_index, sample->u, sample->v, mvert->co, mvert->no);
+    return;
+  }
+
+  /* Same averaging as #subdiv_accumulate_vertex_normal_and_displacement. */
+  float N[3] = {0.0f, 0.0f, 0.0f};
+  for (int i = start; i < end; i++) {
+    const SubdivMeshVertexSample *normal_sample = &cache->normal_samples[i];
+    float dummy_P[3], dPdu[3], dPdv[3], sample_N[3];
+    BKE_subdiv_eval_limit_point_and_derivatives(subdiv,
+                                                normal_sample->ptex_face_index,
+                                                normal_sample->u,
+                                                normal_sample->v,
+                                                dummy_P,
+                                                dPdu,
+                                                dPdv);
+    cross_v3_v3v3(sample_N, dPdu, dPdv);
+    normalize_v3(sample_N);
+    add_v3_v3(N, sample_N);
+  }
+  normalize_v3(N);
+  normal_float_to_short_v3(mvert->no, N);
+  BKE_subdiv_eval_limit_point(subdiv, sample->ptex_face_index, sample->u, sample->v, mvert->co);
+}
+
+static Mesh *subdiv_mesh_cache_eval(const SubdivMeshCache *cache,
+                                    Subdiv *subdiv,
+                                    const Mesh *coarse_mesh)
+{
+  if (!BKE_subdiv_eval_begin_from_mesh(subdiv, coarse_mesh, NULL)) {
+    return NULL;
+  }
+  Mesh *result = BKE_mesh_copy_for_eval(cache->mesh, false);
+  SubdivMeshCacheEvalData data = {
+      .cache = cache,
+      .subdiv = subdiv,
+      .mvert = result->mvert,
+  };
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = 1024;
+  BLI_task_parallel_range(0, result->totvert, &data, subdiv_mesh_cache_eval_vertex_cb, &settings);
+  return result;
+}
+
+Mesh *BKE_subdiv_to_mesh_cached(Subdiv *subdiv,
+                                const SubdivToMeshSettings *settings,
+                                const Mesh *coarse_mesh,
+                                SubdivMeshCache **cache_p)
+{
+  SubdivMeshCache *cache = *cache_p;
+  uint32_t coarse_hash;
+  const bool is_cacheable = (subdiv->displacement_evaluator == NULL) &&
+                            subdiv_mesh_coarse_hash(coarse_mesh, &coarse_hash);
+
+  if (!is_cacheable) {
+    BKE_subdiv_mesh_cache_free(cache);
+    *cache_p = NULL;
+    return BKE_subdiv_to_mesh(subdiv, settings, coarse_mesh);
+  }
+
+  const bool is_cache_valid = (cache != NULL) &&
+                              subdiv_mesh_cache_matches(
+                                  cache, subdiv, settings, coarse_mesh, coarse_hash);
+  if (is_cache_valid && cache->mesh != NULL) {
+    BKE_subdiv_stats_begin(&subdiv->stats, SUBDIV_STATS_SUBDIV_TO_MESH);
+    Mesh *result = subdiv_mesh_cache_eval(cache, subdiv, coarse_mesh);
+    BKE_subdiv_stats_end(&subdiv->stats, SUBDIV_STATS_SUBDIV_TO_MESH);
+    return result;
+  }
+
+  Mesh *result = BKE_subdiv_to_mesh(subdiv, settings, coarse_mesh);
+  const bool has_loose_geometry = is_cache_valid && cache->has_loose_geometry;
+
+  if (cache == NULL) {
+    cache = MEM_callocN(sizeof(*cache), "subdiv mesh cache");
+    *cache_p = cache;
+  }
+  else {
+    subdiv_mesh_cache_clear(cache);
+  }
+  cache->has_loose_geometry = has_loose_geometry;
+  /* Second evaluation of the same coarse mesh, keep the result. */
+  if (is_cache_valid && !has_loose_geometry && result != NULL) {
+    cache->mesh = BKE_mesh_copy_for_eval(result, false);
+    if (!subdiv_mesh_cache_record(cache, subdiv, settings, coarse_mesh)) {
+      subdiv_mesh_cache_clear(cache);
+      cache->has_loose_geometry = true;
+    }
+  }
+  cache->subdiv_settings = subdiv->settings;
+  cache->settings = *settings;
+  cache->coarse_totvert = coarse_mesh->totvert;
+  cache->coarse_totedge = coarse_mesh->totedge;
+  cache->coarse_totloop = coarse_mesh->totloop;
+  cache->coarse_totpoly = coarse_mesh->totpoly;
+  cache->coarse_hash = coarse_hash;
+  return result;
+}
+
+void BKE_subdiv_mesh_cache_free(SubdivMeshCache *cache)
+{
+  if (cache == NULL) {
+    return;
+  }
+  subdiv_mesh_cache_clear(cache);
+  MEM_freeN(cache);
+}
+
+/** \} */
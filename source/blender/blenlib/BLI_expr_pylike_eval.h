@@ -46,6 +46,7 @@ void BLI_expr_pylike_free(struct ExprPyLike_Parsed *expr);
 bool BLI_expr_pylike_is_valid(struct ExprPyLike_Parsed *expr);
 bool BLI_expr_pylike_is_constant(struct ExprPyLike_Parsed *expr);
 bool BLI_expr_pylike_is_using_param(struct ExprPyLike_Parsed *expr, int index);
+const char *BLI_expr_pylike_parse_error(struct ExprPyLike_Parsed *expr);
 ExprPyLike_Parsed *BLI_expr_pylike_parse(const char *expression,
                                          const char **param_names,
                                          int param_names_len);
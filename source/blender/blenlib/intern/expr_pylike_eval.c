@@ -29,22 +29,29 @@
  *  - Literals:
  *      floating point and decimal integer.
  *  - Constants:
- *      pi, True, False
+ *      pi, tau, e, True, False
  *  - Operators:
- *      +, -, *, /, ==, !=, <, <=, >, >=, and, or, not, ternary if
+ *      +, -, *, /, //, %, **, ==, !=, <, <=, >, >=, and, or, not, ternary if
  *  - Functions:
  *      min, max, radians, degrees,
- *      abs, fabs, floor, ceil, trunc, int,
- *      sin, cos, tan, asin, acos, atan, atan2,
- *      exp, log, sqrt, pow, fmod
+ *      abs, fabs, floor, ceil, trunc, int, round,
+ *      sin, cos, tan, asin, acos, atan, atan2, sinh, cosh, tanh,
+ *      exp, log, log2, log10, sqrt, pow, fmod, hypot, copysign,
+ *      clamp, lerp, smoothstep
+ *
+ * The functions match the Python math module and the driver namespace, so an expression
+ * evaluates to the same value with or without Python. When an expression can't be parsed,
+ * the reason is kept in the result for reporting.
  *
  * The implementation has no global state and can be used multi-threaded.
+ * Evaluation doesn't allocate memory.
  */
 
 #include <ctype.h>
 #include <fenv.h>
 #include <float.h>
 #include <math.h>
+#include <stdarg.h>
 #include <stddef.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -55,6 +62,7 @@
 #include "BLI_alloca.h"
 #include "BLI_expr_pylike_eval.h"
 #include "BLI_math_base.h"
+#include "BLI_string.h"
 #include "BLI_utildefines.h"
 
 #ifdef _MSC_VER
@@ -72,6 +80,8 @@ typedef enum eOpCode {
   OPCODE_FUNC1,
   /* 2 argument function call: (a b -> func2(a,b)) */
   OPCODE_FUNC2,
+  /* 3 argument function call: (a b c -> func3(a,b,c)) */
+  OPCODE_FUNC3,
   /* Parameter access: (-> params[ival]) */
   OPCODE_PARAMETER,
   /* Minimum of multiple inputs: (a b c... -> min); ival = arg count */
@@ -92,6 +102,7 @@ typedef enum eOpCode {
 
 typedef double (*UnaryOpFunc)(double);
 typedef double (*BinaryOpFunc)(double, double);
+typedef double (*TernaryOpFunc)(double, double, double);
 
 typedef struct ExprOp {
   eOpCode opcode;
@@ -104,6 +115,7 @@ typedef struct ExprOp {
     void *ptr;
     UnaryOpFunc func1;
     BinaryOpFunc func2;
+    TernaryOpFunc func3;
   } arg;
 } ExprOp;
 
@@ -111,6 +123,9 @@ struct ExprPyLike_Parsed {
   int ops_count;
   int max_stack;
 
+  /* Reason the expression couldn't be parsed, NULL on success. */
+  const char *error;
+
   ExprOp ops[];
 };
 
@@ -140,6 +155,19 @@ bool BLI_expr_pylike_is_constant(ExprPyLike_Parsed *expr)
   return expr != NULL && expr->ops_count == 1 && expr->ops[0].opcode == OPCODE_CONST;
 }
 
+/**
+ * Return the reason the expression couldn't be parsed, or NULL if it is valid.
+ * The string is owned by the parsed data.
+ */
+const char *BLI_expr_pylike_parse_error(ExprPyLike_Parsed *expr)
+{
+  if (expr == NULL) {
+    return "no expression";
+  }
+
+  return BLI_expr_pylike_is_valid(expr) ? NULL : expr->error;
+}
+
 /** Check if the parsed expression uses the parameter with the given index. */
 bool BLI_expr_pylike_is_using_param(ExprPyLike_Parsed *expr, int index)
 {
@@ -216,6 +244,11 @@ eExprPyLike_EvalStatus BLI_expr_pylike_eval(ExprPyLike_Parsed *expr,
         stack[sp - 2] = ops[pc].arg.func2(stack[sp - 2], stack[sp - 1]);
         sp--;
         break;
+      case OPCODE_FUNC3:
+        FAIL_IF(sp < 3);
+        stack[sp - 3] = ops[pc].arg.func3(stack[sp - 3], stack[sp - 2], stack[sp - 1]);
+        sp -= 2;
+        break;
       case OPCODE_MIN:
         FAIL_IF(sp < ops[pc].arg.ival);
         for (int j = 1; j < ops[pc].arg.ival; j++, sp--) {
@@ -316,6 +349,43 @@ static double op_sub(double a, double b)
   return a - b;
 }
 
+/* Python modulo, the result has the sign of the divisor. */
+static double op_mod(double a, double b)
+{
+  double result = fmod(a, b);
+
+  if (result != 0.0 && (result < 0.0) != (b < 0.0)) {
+    result += b;
+  }
+
+  return result;
+}
+
+/* Same as float_floor_div in CPython: floor(a / b) is off by one when the division rounds up
+ * to an integer, e.g. 1 // 0.1. */
+static double op_floordiv(double a, double b)
+{
+  double mod = fmod(a, b);
+  double div = (a - mod) / b;
+  double result;
+
+  if (mod != 0.0 && (b < 0.0) != (mod < 0.0)) {
+    div -= 1.0;
+  }
+
+  if (div != 0.0) {
+    result = floor(div);
+    if (div - result > 0.5) {
+      result += 1.0;
+    }
+  }
+  else {
+    result = copysign(0.0, a / b);
+  }
+
+  return result;
+}
+
 static double op_radians(double arg)
 {
   return arg * M_PI / 180.0;
@@ -326,6 +396,42 @@ static double op_degrees(double arg)
   return arg * 180.0 / M_PI;
 }
 
+/* Python rounds halfway cases to even, like the default floating point rounding mode. */
+static double op_round(double arg)
+{
+  return nearbyint(arg);
+}
+
+static double op_clamp(double arg, double min, double max)
+{
+  CLAMP(arg, min, max);
+  return arg;
+}
+
+static double op_clamp01(double arg)
+{
+  return op_clamp(arg, 0.0, 1.0);
+}
+
+static double op_lerp(double a, double b, double x)
+{
+  return a * (1.0 - x) + b * x;
+}
+
+static double op_smoothstep(double a, double b, double x)
+{
+  double t = (x - a) / (b - a);
+
+  CLAMP(t, 0.0, 1.0);
+
+  return t * t * (3.0 - 2.0 * t);
+}
+
+static double op_log_base(double arg, double base)
+{
+  return log(arg) / log(base);
+}
+
 static double op_not(double a)
 {
   return a ? 0.0 : 1.0;
@@ -367,7 +473,13 @@ typedef struct BuiltinConstDef {
 } BuiltinConstDef;
 
 static BuiltinConstDef builtin_consts[] = {
-    {"pi", M_PI}, {"True", 1.0}, {"False", 0.0}, {NULL, 0.0}};
+    {"pi", M_PI},
+    {"tau", 2.0 * M_PI},
+    {"e", M_E},
+    {"True", 1.0},
+    {"False", 0.0},
+    {NULL, 0.0},
+};
 
 typedef struct BuiltinOpDef {
   const char *name;
@@ -391,6 +503,7 @@ static BuiltinOpDef builtin_ops[] = {
     {"ceil", OPCODE_FUNC1, ceil},
     {"trunc", OPCODE_FUNC1, trunc},
     {"int", OPCODE_FUNC1, trunc},
+    {"round", OPCODE_FUNC1, op_round},
     {"sin", OPCODE_FUNC1, sin},
     {"cos", OPCODE_FUNC1, cos},
     {"tan", OPCODE_FUNC1, tan},
@@ -398,11 +511,19 @@ static BuiltinOpDef builtin_ops[] = {
     {"acos", OPCODE_FUNC1, acos},
     {"atan", OPCODE_FUNC1, atan},
     {"atan2", OPCODE_FUNC2, atan2},
+    {"sinh", OPCODE_FUNC1, sinh},
+    {"cosh", OPCODE_FUNC1, cosh},
+    {"tanh", OPCODE_FUNC1, tanh},
     {"exp", OPCODE_FUNC1, exp},
-    {"log", OPCODE_FUNC1, log},
+    {"log2", OPCODE_FUNC1, log2},
+    {"log10", OPCODE_FUNC1, log10},
     {"sqrt", OPCODE_FUNC1, sqrt},
     {"pow", OPCODE_FUNC2, pow},
     {"fmod", OPCODE_FUNC2, fmod},
+    {"hypot", OPCODE_FUNC2, hypot},
+    {"copysign", OPCODE_FUNC2, copysign},
+    {"lerp", OPCODE_FUNC3, op_lerp},
+    {"smoothstep", OPCODE_FUNC3, op_smoothstep},
     {NULL, OPCODE_CONST, NULL},
 };
 
@@ -428,6 +549,8 @@ static BuiltinOpDef builtin_ops[] = {
 #define TOKEN_LE MAKE_CHAR2('<', '=')
 #define TOKEN_NE MAKE_CHAR2('!', '=')
 #define TOKEN_EQ MAKE_CHAR2('=', '=')
+#define TOKEN_POW MAKE_CHAR2('*', '*')
+#define TOKEN_FLOORDIV MAKE_CHAR2('/', '/')
 #define TOKEN_AND MAKE_CHAR2('A', 'N')
 #define TOKEN_OR MAKE_CHAR2('O', 'R')
 #define TOKEN_NOT MAKE_CHAR2('N', 'O')
@@ -460,6 +583,7 @@ typedef struct ExprParseState {
   const char *cur;
 
   /* Current token */
+  const char *token_start;
   short token;
   char *tokenbuf;
   double tokenval;
@@ -470,8 +594,41 @@ typedef struct ExprParseState {
 
   /* Stack space requirement tracking */
   int stack_ptr, max_stack;
+
+  /* Reason of the parse failure */
+  char error[128];
 } ExprParseState;
 
+/* Record the reason of a parse failure and return false. The innermost error is
+ * the most specific one, so later calls don't overwrite it. */
+static bool parse_error(ExprParseState *state, const char *format, ...)
+    ATTR_PRINTF_FORMAT(2, 3);
+
+static bool parse_error(ExprParseState *state, const char *format, ...)
+{
+  if (state->error[0] == '\0') {
+    va_list args;
+    va_start(args, format);
+    BLI_vsnprintf(state->error, sizeof(state->error), format, args);
+    va_end(args);
+  }
+
+  return false;
+}
+
+/* Report the current token as unsupported. */
+static bool parse_error_token(ExprParseState *state)
+{
+  if (state->token == 0) {
+    return parse_error(state, "unexpected end of expression");
+  }
+
+  return parse_error(state,
+                     "unsupported syntax at column %d: '%.16s'",
+                     (int)(state->token_start - state->expr) + 1,
+                     state->token_start);
+}
+
 /* Reserve space for the specified number of operations in the buffer. */
 static ExprOp *parse_alloc_ops(ExprParseState *state, int count)
 {
@@ -560,6 +717,27 @@ static bool parse_add_func(ExprParseState *state, eOpCode code, int args, void *
       }
       break;
 
+    case OPCODE_FUNC3:
+      CHECK_ERROR(args == 3);
+
+      if (jmp_gap >= 3 && prev_ops[-3].opcode == OPCODE_CONST &&
+          prev_ops[-2].opcode == OPCODE_CONST && prev_ops[-1].opcode == OPCODE_CONST) {
+        TernaryOpFunc func = funcptr;
+
+        /* volatile because some compilers overly aggressive optimize this call out.
+         * see D6012 for details. */
+        volatile double result = func(
+            prev_ops[-3].arg.dval, prev_ops[-2].arg.dval, prev_ops[-1].arg.dval);
+
+        if (fetestexcept(FE_DIVBYZERO | FE_INVALID) == 0) {
+          prev_ops[-3].arg.dval = result;
+          state->ops_count -= 2;
+          state->stack_ptr -= 2;
+          return true;
+        }
+      }
+      break;
+
     default:
       BLI_assert(false);
       return false;
@@ -577,6 +755,8 @@ static bool parse_next_token(ExprParseState *state)
     state->cur++;
   }
 
+  state->token_start = state->cur;
+
   /* End of string. */
   if (*state->cur == 0) {
     state->token = 0;
@@ -609,7 +789,10 @@ static bool parse_next_token(ExprParseState *state)
         *out++ = *state->cur++;
       }
 
-      CHECK_ERROR(isdigit(*state->cur));
+      if (!isdigit(*state->cur)) {
+        return parse_error(
+            state, "invalid number at column %d", (int)(state->token_start - state->expr) + 1);
+      }
 
       while (isdigit(*state->cur)) {
         *out++ = *state->cur++;
@@ -622,14 +805,19 @@ static bool parse_next_token(ExprParseState *state)
     if (!is_float && state->tokenbuf[0] == '0') {
       for (char *p = state->tokenbuf + 1; *p; p++) {
         if (*p != '0') {
-          return false;
+          return parse_error(state, "octal number '%s' is not supported", state->tokenbuf);
         }
       }
     }
 
     state->token = TOKEN_NUMBER;
     state->tokenval = strtod(state->tokenbuf, &end);
-    return (end == out);
+
+    if (end != out) {
+      return parse_error(state, "invalid number '%s'", state->tokenbuf);
+    }
+
+    return true;
   }
 
   /* ?= tokens */
@@ -639,6 +827,13 @@ static bool parse_next_token(ExprParseState *state)
     return true;
   }
 
+  /* ** and // tokens */
+  if (ELEM(state->cur[0], '*', '/') && state->cur[1] == state->cur[0]) {
+    state->token = MAKE_CHAR2(state->cur[0], state->cur[1]);
+    state->cur += 2;
+    return true;
+  }
+
   /* Special characters (single character tokens) */
   if (strchr(token_characters, *state->cur)) {
     state->token = *state->cur++;
@@ -666,7 +861,10 @@ static bool parse_next_token(ExprParseState *state)
     return true;
   }
 
-  return false;
+  return parse_error(state,
+                     "unsupported character at column %d: '%c'",
+                     (int)(state->token_start - state->expr) + 1,
+                     *state->cur);
 }
 
 /** \} */
@@ -676,10 +874,20 @@ static bool parse_next_token(ExprParseState *state)
  * \{ */
 
 static bool parse_expr(ExprParseState *state);
+static bool parse_unary(ExprParseState *state);
 
 static int parse_function_args(ExprParseState *state)
 {
-  if (!parse_next_token(state) || state->token != '(' || !parse_next_token(state)) {
+  if (!parse_next_token(state)) {
+    return -1;
+  }
+
+  if (state->token != '(') {
+    parse_error_token(state);
+    return -1;
+  }
+
+  if (!parse_next_token(state)) {
     return -1;
   }
 
@@ -706,27 +914,46 @@ static int parse_function_args(ExprParseState *state)
         return arg_count;
 
       default:
+        parse_error_token(state);
         return -1;
     }
   }
 }
 
-static bool parse_unary(ExprParseState *state)
+/* Number of arguments taken by a function call opcode. */
+static int parse_func_arg_count(eOpCode code)
+{
+  switch (code) {
+    case OPCODE_FUNC1:
+      return 1;
+    case OPCODE_FUNC2:
+      return 2;
+    case OPCODE_FUNC3:
+      return 3;
+    default:
+      BLI_assert(false);
+      return 0;
+  }
+}
+
+static bool parse_error_arg_count(ExprParseState *state, const char *name, int args)
+{
+  return parse_error(state, "wrong number of arguments (%d) to function '%s'", args, name);
+}
+
+static bool parse_primary(ExprParseState *state)
 {
   int i;
 
   switch (state->token) {
-    case '+':
-      return parse_next_token(state) && parse_unary(state);
+    case '(':
+      CHECK_ERROR(parse_next_token(state) && parse_expr(state));
 
-    case '-':
-      CHECK_ERROR(parse_next_token(state) && parse_unary(state));
-      parse_add_func(state, OPCODE_FUNC1, 1, op_negate);
-      return true;
+      if (state->token != ')') {
+        return parse_error_token(state);
+      }
 
-    case '(':
-      return parse_next_token(state) && parse_expr(state) && state->token == ')' &&
-             parse_next_token(state);
+      return parse_next_token(state);
 
     case TOKEN_NUMBER:
       parse_add_op(state, OPCODE_CONST, 1)->arg.dval = state->tokenval;
@@ -754,6 +981,11 @@ static bool parse_unary(ExprParseState *state)
       for (i = 0; builtin_ops[i].name; i++) {
         if (STREQ(state->tokenbuf, builtin_ops[i].name)) {
           int args = parse_function_args(state);
+          CHECK_ERROR(args >= 0);
+
+          if (args != parse_func_arg_count(builtin_ops[i].op)) {
+            return parse_error_arg_count(state, builtin_ops[i].name, args);
+          }
 
           return parse_add_func(state, builtin_ops[i].op, args, builtin_ops[i].funcptr);
         }
@@ -776,10 +1008,74 @@ static bool parse_unary(ExprParseState *state)
         return true;
       }
 
-      return false;
+      /* clamp(x) clamps to the 0..1 range, like the driver namespace version. */
+      if (STREQ(state->tokenbuf, "clamp")) {
+        int cnt = parse_function_args(state);
+        CHECK_ERROR(cnt >= 0);
+
+        switch (cnt) {
+          case 1:
+            return parse_add_func(state, OPCODE_FUNC1, 1, op_clamp01);
+          case 3:
+            return parse_add_func(state, OPCODE_FUNC3, 3, op_clamp);
+          default:
+            return parse_error_arg_count(state, "clamp", cnt);
+        }
+      }
+
+      /* log(x) and log(x, base) */
+      if (STREQ(state->tokenbuf, "log")) {
+        int cnt = parse_function_args(state);
+        CHECK_ERROR(cnt >= 0);
+
+        switch (cnt) {
+          case 1:
+            return parse_add_func(state, OPCODE_FUNC1, 1, log);
+          case 2:
+            return parse_add_func(state, OPCODE_FUNC2, 2, op_log_base);
+          default:
+            return parse_error_arg_count(state, "log", cnt);
+        }
+      }
+
+      if (*state->cur == '(') {
+        return parse_error(state, "unsupported function '%s'", state->tokenbuf);
+      }
+
+      return parse_error(state, "unknown name '%s'", state->tokenbuf);
 
     default:
-      return false;
+      return parse_error_token(state);
+  }
+}
+
+/* The power operator binds tighter than a unary operator on its left,
+ * and its right operand may have unary operators: -a ** -b == -(a ** (-b)). */
+static bool parse_power(ExprParseState *state)
+{
+  CHECK_ERROR(parse_primary(state));
+
+  if (state->token == TOKEN_POW) {
+    CHECK_ERROR(parse_next_token(state) && parse_unary(state));
+    parse_add_func(state, OPCODE_FUNC2, 2, pow);
+  }
+
+  return true;
+}
+
+static bool parse_unary(ExprParseState *state)
+{
+  switch (state->token) {
+    case '+':
+      return parse_next_token(state) && parse_unary(state);
+
+    case '-':
+      CHECK_ERROR(parse_next_token(state) && parse_unary(state));
+      parse_add_func(state, OPCODE_FUNC1, 1, op_negate);
+      return true;
+
+    default:
+      return parse_power(state);
   }
 }
 
@@ -799,6 +1095,16 @@ static bool parse_mul(ExprParseState *state)
         parse_add_func(state, OPCODE_FUNC2, 2, op_div);
         break;
 
+      case TOKEN_FLOORDIV:
+        CHECK_ERROR(parse_next_token(state) && parse_unary(state));
+        parse_add_func(state, OPCODE_FUNC2, 2, op_floordiv);
+        break;
+
+      case '%':
+        CHECK_ERROR(parse_next_token(state) && parse_unary(state));
+        parse_add_func(state, OPCODE_FUNC2, 2, op_mod);
+        break;
+
       default:
         return true;
     }
@@ -1008,7 +1314,13 @@ ExprPyLike_Parsed *BLI_expr_pylike_parse(const char *expression,
   /* Parse the expression. */
   ExprPyLike_Parsed *expr;
 
-  if (parse_next_token(&state) && parse_expr(&state) && state.token == 0) {
+  bool ok = parse_next_token(&state) && parse_expr(&state);
+
+  if (ok && state.token != 0) {
+    ok = parse_error_token(&state);
+  }
+
+  if (ok) {
     BLI_assert(state.stack_ptr == 1);
 
     int bytesize = sizeof(ExprPyLike_Parsed) + state.ops_count * sizeof(ExprOp);
@@ -1016,12 +1328,23 @@ ExprPyLike_Parsed *BLI_expr_pylike_parse(const char *expression,
     expr = MEM_mallocN(bytesize, "ExprPyLike_Parsed");
     expr->ops_count = state.ops_count;
     expr->max_stack = state.max_stack;
+    expr->error = NULL;
 
     memcpy(expr->ops, state.ops, state.ops_count * sizeof(ExprOp));
   }
   else {
-    /* Always return a non-NULL object so that parse failure can be cached. */
-    expr = MEM_callocN(sizeof(ExprPyLike_Parsed), "ExprPyLike_Parsed(empty)");
+    /* Always return a non-NULL object so that parse failure can be cached.
+     * The error message is stored right after it. */
+    if (state.error[0] == '\0') {
+      STRNCPY(state.error, "syntax error");
+    }
+
+    size_t error_len = strlen(state.error) + 1;
+    expr = MEM_callocN(sizeof(ExprPyLike_Parsed) + error_len, "ExprPyLike_Parsed(empty)");
+
+    char *error = (char *)(expr + 1);
+    memcpy(error, state.error, error_len);
+    expr->error = error;
   }
 
   MEM_freeN(state.tokenbuf);
@@ -426,6 +426,8 @@ void BLO_update_defaults_startup_blend(Main *bmain, const char *app_template)
 
     sce->gm.lodflag = SCE_LOD_USE_HYST;
     sce->gm.scehysteresis = 10;
+    sce->gm.anim_lod_distance = 30.0f;
+    sce->gm.anim_lod_interval = 4;
 
 	sce->gm.pythonkeys[0] = EVT_LEFTCTRLKEY;
 	sce->gm.pythonkeys[1] = EVT_LEFTSHIFTKEY;
@@ -196,4 +196,19 @@ void blo_do_versions_upbge(FileData *fd, Library *lib, Main *main)
 		}
 	}
   }
+
+  if (!DNA_struct_elem_find(fd->filesdna, "Object", "short", "lod_generate_levels")) {
+    for (Object *ob = main->objects.first; ob; ob = ob->id.next) {
+      ob->lod_generate_ratio = 0.5f;
+      ob->lod_generate_distance = 25.0f;
+      ob->lod_generate_levels = 3;
+    }
+  }
+
+  if (!DNA_struct_elem_find(fd->filesdna, "GameData", "float", "anim_lod_distance")) {
+    for (Scene *scene = main->scenes.first; scene; scene = scene->id.next) {
+      scene->gm.anim_lod_distance = 30.0f;
+      scene->gm.anim_lod_interval = 4;
+    }
+  }
 }
@@ -28,6 +28,10 @@ void BM_mesh_decimate_collapse(BMesh *bm,
                                const bool do_triangulate,
                                const int symmetry_axis,
                                const float symmetry_eps);
+void BM_mesh_decimate_collapse_regions(BMesh *bm,
+                                       const float factor,
+                                       const bool do_triangulate,
+                                       const int region_face_len);
 
 void BM_mesh_decimate_unsubdivide_ex(BMesh *bm, const int iterations, const bool tag_only);
 void BM_mesh_decimate_unsubdivide(BMesh *bm, const int iterations);
@@ -32,6 +32,8 @@
 #include "BLI_polyfill_2d.h"
 #include "BLI_polyfill_2d_beautify.h"
 #include "BLI_quadric.h"
+#include "BLI_sort.h"
+#include "BLI_task.h"
 #include "BLI_utildefines_stack.h"
 
 #include "BKE_customdata.h"
@@ -1540,3 +1542,326 @@ void BM_mesh_decimate_collapse(BMesh *bm,
   /* quiet release build warning */
   (void)tot_edge_orig;
 }
+
+/* -------------------------------------------------------------------- */
+/** \name Decimate Collapse (Regions)
+ *
+ * The edge-collapse heap is global to the mesh, so #BM_mesh_decimate_collapse can't be
+ * threaded as-is. Instead the faces are split into spatially coherent regions
+ * (recursive median split of face centers), each region is copied into its own #BMesh
+ * and decimated in parallel. Vertices shared by several regions are given a zero weight
+ * so they are never collapsed, which allows the regions to be stitched back together.
+ * \{ */
+
+/* Name of the vertex layer storing the index of shared (locked) vertices in the source mesh. */
+#define REGION_SHARED_INDEX_LAYER "__decimate_region_shared_index"
+
+static int bm_decim_region_shared_index_offset(BMesh *bm)
+{
+  const int layer_index = CustomData_get_named_layer_index(
+      &bm->vdata, CD_PROP_INT, REGION_SHARED_INDEX_LAYER);
+  return bm->vdata.layers[layer_index].offset;
+}
+
+typedef struct DecimRegionSortData {
+  const float (*face_centers)[3];
+  int axis;
+} DecimRegionSortData;
+
+static int bm_decim_region_face_cmp(const void *a, const void *b, void *thunk)
+{
+  const DecimRegionSortData *data = thunk;
+  const float fa = data->face_centers[*(const int *)a][data->axis];
+  const float fb = data->face_centers[*(const int *)b][data->axis];
+  return (fa > fb) - (fa < fb);
+}
+
+/**
+ * Assign a region to each face, splitting the longest axis at the median
+ * until regions contain at most \a region_face_len faces.
+ */
+static void bm_decim_region_split(const float (*face_centers)[3],
+                                  int *faces,
+                                  const int faces_len,
+                                  const int region_face_len,
+                                  int *face_region,
+                                  int *r_regions_len)
+{
+  if (faces_len <= region_face_len) {
+    const int region = (*r_regions_len)++;
+    for (int i = 0; i < faces_len; i++) {
+      face_region[faces[i]] = region;
+    }
+    return;
+  }
+
+  float min[3], max[3], size[3];
+  INIT_MINMAX(min, max);
+  for (int i = 0; i < faces_len; i++) {
+    minmax_v3v3_v3(min, max, face_centers[faces[i]]);
+  }
+  sub_v3_v3v3(size, max, min);
+
+  DecimRegionSortData data = {
+      .face_centers = face_centers,
+      .axis = axis_dominant_v3_single(size),
+  };
+  BLI_qsort_r(faces, (size_t)faces_len, sizeof(*faces), bm_decim_region_face_cmp, &data);
+
+  const int half = faces_len / 2;
+  bm_decim_region_split(
+      face_centers, faces, half, region_face_len, face_region, r_regions_len);
+  bm_decim_region_split(face_centers,
+                        faces + half,
+                        faces_len - half,
+                        region_face_len,
+                        face_region,
+                        r_regions_len);
+}
+
+/**
+ * Create a face in \a bm_dst from \a f_src using the already mapped \a verts,
+ * copying face, loop and edge attributes.
+ */
+static BMFace *bm_decim_region_face_copy(BMesh *bm_dst, BMesh *bm_src, BMVert **verts, BMFace *f_src)
+{
+  BMFace *f_dst = BM_face_create_verts(bm_dst, verts, f_src->len, NULL, BM_CREATE_SKIP_CD, true);
+  if (UNLIKELY(f_dst == NULL)) {
+    return NULL;
+  }
+  BM_elem_attrs_copy(bm_src, bm_dst, f_src, f_dst);
+
+  BMLoop *l_src = BM_FACE_FIRST_LOOP(f_src);
+  BMLoop *l_iter, *l_first;
+  l_iter = l_first = BM_FACE_FIRST_LOOP(f_dst);
+  do {
+    BM_elem_attrs_copy(bm_src, bm_dst, l_src, l_iter);
+    BM_elem_attrs_copy(bm_src, bm_dst, l_src->e, l_iter->e);
+    l_src = l_src->next;
+  } while ((l_iter = l_iter->next) != l_first);
+
+  return f_dst;
+}
+
+typedef struct DecimRegion {
+  BMesh *bm;
+  float *vweights;
+} DecimRegion;
+
+typedef struct DecimRegionData {
+  DecimRegion *regions;
+  float factor;
+  bool do_triangulate;
+} DecimRegionData;
+
+static void bm_decim_region_cb(void *__restrict userdata,
+                               const int index,
+                               const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  DecimRegionData *data = userdata;
+  DecimRegion *region = &data->regions[index];
+
+  BM_mesh_decimate_collapse(
+      region->bm, data->factor, region->vweights, 1.0f, data->do_triangulate, -1, 0.0f);
+}
+
+/**
+ * \brief BM_mesh_decimate_collapse_regions
+ *
+ * Multi-threaded variant of #BM_mesh_decimate_collapse for large meshes,
+ * faces along region borders are kept at their original density.
+ * Loose vertices and edges are removed.
+ *
+ * \param factor: face count multiplier [0 - 1]
+ * \param region_face_len: Maximum number of faces decimated by a single task,
+ * meshes with fewer faces are decimated directly.
+ */
+void BM_mesh_decimate_collapse_regions(BMesh *bm,
+                                       const float factor,
+                                       const bool do_triangulate,
+                                       const int region_face_len)
+{
+  if ((region_face_len <= 0) || (bm->totface <= region_face_len)) {
+    BM_mesh_decimate_collapse(bm, factor, NULL, 1.0f, do_triangulate, -1, 0.0f);
+    return;
+  }
+
+  BMIter iter, liter;
+  BMVert *v;
+  BMFace *f;
+  BMLoop *l;
+  int i;
+
+  BM_mesh_elem_index_ensure(bm, BM_VERT | BM_FACE);
+  BM_mesh_elem_table_ensure(bm, BM_FACE);
+
+  /* Split the faces into regions. */
+  float(*face_centers)[3] = MEM_malloc_arrayN(bm->totface, sizeof(*face_centers), __func__);
+  int *faces = MEM_malloc_arrayN(bm->totface, sizeof(*faces), __func__);
+  int *face_region = MEM_malloc_arrayN(bm->totface, sizeof(*face_region), __func__);
+  int regions_len = 0;
+
+  BM_ITER_MESH_INDEX (f, &iter, bm, BM_FACES_OF_MESH, i) {
+    BM_face_calc_center_median(f, face_centers[i]);
+    faces[i] = i;
+  }
+  bm_decim_region_split(
+      face_centers, faces, bm->totface, region_face_len, face_region, &regions_len);
+  MEM_freeN(face_centers);
+
+  /* Vertices used by faces of more than one region are shared and can't be collapsed. */
+  enum { VERT_REGION_UNUSED = -1, VERT_REGION_SHARED = -2 };
+  int *vert_region = MEM_malloc_arrayN(bm->totvert, sizeof(*vert_region), __func__);
+  copy_vn_i(vert_region, bm->totvert, VERT_REGION_UNUSED);
+  BM_ITER_MESH_INDEX (f, &iter, bm, BM_FACES_OF_MESH, i) {
+    BM_ITER_ELEM (l, &liter, f, BM_LOOPS_OF_FACE) {
+      int *r = &vert_region[BM_elem_index_get(l->v)];
+      if (*r == VERT_REGION_UNUSED) {
+        *r = face_region[i];
+      }
+      else if (*r != face_region[i]) {
+        *r = VERT_REGION_SHARED;
+      }
+    }
+  }
+
+  /* Bucket faces by region (#faces is re-used, ordered by region). */
+  int *region_offset = MEM_calloc_arrayN(regions_len + 1, sizeof(*region_offset), __func__);
+  for (i = 0; i < bm->totface; i++) {
+    region_offset[face_region[i] + 1]++;
+  }
+  for (i = 0; i < regions_len; i++) {
+    region_offset[i + 1] += region_offset[i];
+  }
+  {
+    int *region_fill = MEM_dupallocN(region_offset);
+    for (i = 0; i < bm->totface; i++) {
+      faces[region_fill[face_region[i]]++] = i;
+    }
+    MEM_freeN(region_fill);
+  }
+  MEM_freeN(face_region);
+
+  /* Copy each region into its own mesh. */
+  DecimRegion *regions = MEM_calloc_arrayN(regions_len, sizeof(*regions), __func__);
+  BMVert **vtable = MEM_calloc_arrayN(bm->totvert, sizeof(*vtable), __func__);
+  int verts_len_max = 0;
+
+  for (int r = 0; r < regions_len; r++) {
+    DecimRegion *region = &regions[r];
+    const int faces_len = region_offset[r + 1] - region_offset[r];
+    const int *region_faces = &faces[region_offset[r]];
+    int verts_len = 0;
+
+    /* Upper bound, vertices are shared between faces. */
+    int loops_len = 0;
+    for (i = 0; i < faces_len; i++) {
+      loops_len += BM_face_at_index(bm, region_faces[i])->len;
+    }
+
+    region->bm = BM_mesh_create(&bm_mesh_allocsize_default,
+                                &((struct BMeshCreateParams){
+                                    .use_toolflags = false,
+                                }));
+    BM_mesh_copy_init_customdata(region->bm, bm, &bm_mesh_allocsize_default);
+    BM_data_layer_add_named(
+        region->bm, &region->bm->vdata, CD_PROP_INT, REGION_SHARED_INDEX_LAYER);
+    const int cd_shared_index = bm_decim_region_shared_index_offset(region->bm);
+
+    region->vweights = MEM_malloc_arrayN(loops_len, sizeof(*region->vweights), __func__);
+
+    for (i = 0; i < faces_len; i++) {
+      f = BM_face_at_index(bm, region_faces[i]);
+      BMVert **verts = BLI_array_alloca(verts, f->len);
+      int j = 0;
+      BM_ITER_ELEM (l, &liter, f, BM_LOOPS_OF_FACE) {
+        const int v_index = BM_elem_index_get(l->v);
+        if (vtable[v_index] == NULL) {
+          const bool is_shared = (vert_region[v_index] == VERT_REGION_SHARED);
+          v = BM_vert_create(region->bm, l->v->co, NULL, BM_CREATE_SKIP_CD);
+          BM_elem_attrs_copy(bm, region->bm, l->v, v);
+          BM_ELEM_CD_SET_INT(v, cd_shared_index, is_shared ? v_index : -1);
+          BM_elem_index_set(v, verts_len); /* set_ok */
+          region->vweights[verts_len++] = is_shared ? 0.0f : 1.0f;
+          vtable[v_index] = v;
+        }
+        verts[j++] = vtable[v_index];
+      }
+      bm_decim_region_face_copy(region->bm, bm, verts, f);
+    }
+    region->bm->elem_index_dirty &= ~BM_VERT;
+
+    /* Clear the table for the next region. */
+    for (i = 0; i < faces_len; i++) {
+      f = BM_face_at_index(bm, region_faces[i]);
+      BM_ITER_ELEM (l, &liter, f, BM_LOOPS_OF_FACE) {
+        vtable[BM_elem_index_get(l->v)] = NULL;
+      }
+    }
+    verts_len_max = max_ii(verts_len_max, verts_len);
+  }
+  MEM_freeN(region_offset);
+  MEM_freeN(faces);
+  MEM_freeN(vert_region);
+
+  /* Decimate the regions. */
+  {
+    DecimRegionData data = {
+        .regions = regions,
+        .factor = factor,
+        .do_triangulate = do_triangulate,
+    };
+    TaskParallelSettings settings;
+    BLI_parallel_range_settings_defaults(&settings);
+    settings.min_iter_per_thread = 1;
+    BLI_task_parallel_range(0, regions_len, &data, bm_decim_region_cb, &settings);
+  }
+
+  /* Replace the faces of the source mesh with the decimated regions. */
+  {
+    BMIter iter_mutable;
+    BMVert *v_next;
+    BM_ITER_MESH_MUTABLE (v, v_next, &iter_mutable, bm, BM_VERTS_OF_MESH) {
+      BM_vert_kill(bm, v);
+    }
+  }
+
+  BMVert **vtable_region = MEM_malloc_arrayN(verts_len_max, sizeof(*vtable_region), __func__);
+  for (int r = 0; r < regions_len; r++) {
+    DecimRegion *region = &regions[r];
+    const int cd_shared_index = bm_decim_region_shared_index_offset(region->bm);
+
+    BM_ITER_MESH_INDEX (v, &iter, region->bm, BM_VERTS_OF_MESH, i) {
+      const int shared_index = BM_ELEM_CD_GET_INT(v, cd_shared_index);
+      BMVert **v_dst_p = (shared_index != -1) ? &vtable[shared_index] : &vtable_region[i];
+      if (shared_index == -1 || *v_dst_p == NULL) {
+        *v_dst_p = BM_vert_create(bm, v->co, NULL, BM_CREATE_SKIP_CD);
+        BM_elem_attrs_copy(region->bm, bm, v, *v_dst_p);
+      }
+      vtable_region[i] = *v_dst_p;
+      BM_elem_index_set(v, i); /* set_inline */
+    }
+    region->bm->elem_index_dirty &= ~BM_VERT;
+
+    BM_ITER_MESH (f, &iter, region->bm, BM_FACES_OF_MESH) {
+      BMVert **verts = BLI_array_alloca(verts, f->len);
+      int j = 0;
+      BM_ITER_ELEM (l, &liter, f, BM_LOOPS_OF_FACE) {
+        verts[j++] = vtable_region[BM_elem_index_get(l->v)];
+      }
+      bm_decim_region_face_copy(bm, region->bm, verts, f);
+    }
+
+    BM_mesh_free(region->bm);
+    MEM_freeN(region->vweights);
+  }
+
+  MEM_freeN(vtable_region);
+  MEM_freeN(vtable);
+  MEM_freeN(regions);
+
+  bm->elem_index_dirty |= BM_ALL;
+  bm->elem_table_dirty |= BM_ALL;
+}
+
+/** \} */
@@ -46,6 +46,7 @@
 
 #include "BLI_buffer.h"
 #include "BLI_kdopbvh.h"
+#include "BLI_task.h"
 
 #include "bmesh.h"
 #include "intern/bmesh_private.h"
@@ -947,29 +948,170 @@ static int isect_bvhtree_point_v3(BVHTree *tree, const float **looptris, const f
   return num_isect;
 }
 
+/* -------------------------------------------------------------------- */
+/** \name N-ary Boolean Support
+ *
+ * All operands share a single BVH, pairs of triangles from the same operand are rejected
+ * by the overlap callback, the remaining pairs are culled in parallel before the
+ * (non thread-safe) cutting runs on the pairs that may actually intersect.
+ * \{ */
+
+static bool bm_isect_overlap_operand_cb(void *userdata,
+                                        int index_a,
+                                        int index_b,
+                                        int UNUSED(thread))
+{
+  const int *tri_operand = userdata;
+  /* Self overlap reports both orders, only keep one. */
+  return (index_a < index_b) && (tri_operand[index_a] != tri_operand[index_b]);
+}
+
+/**
+ * Conservative test, false when all points of one triangle are on the same side
+ * of the other triangles plane (outside of the epsilon used for cutting).
+ */
+static bool isect_tri_tri_plane_overlap(const float *t_a[3], const float *t_b[3], const float eps)
+{
+  const float **tri_pair[2] = {t_a, t_b};
+  for (int i = 0; i < 2; i++) {
+    const float **t_plane = tri_pair[i];
+    const float **t_test = tri_pair[!i];
+    float no[3], plane[4];
+    if (normal_tri_v3(no, t_plane[0], t_plane[1], t_plane[2]) == 0.0f) {
+      continue;
+    }
+    plane_from_point_normal_v3(plane, t_plane[0], no);
+    const float side[3] = {
+        plane_point_side_v3(plane, t_test[0]),
+        plane_point_side_v3(plane, t_test[1]),
+        plane_point_side_v3(plane, t_test[2]),
+    };
+    if ((side[0] > eps && side[1] > eps && side[2] > eps) ||
+        (side[0] < -eps && side[1] < -eps && side[2] < -eps)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+struct OverlapCullData {
+  BMLoop *(*looptris)[3];
+  const BVHTreeOverlap *overlap;
+  bool *overlap_test;
+  float eps;
+};
+
+static void bm_isect_overlap_cull_cb(void *__restrict userdata,
+                                     const int i,
+                                     const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  struct OverlapCullData *data = userdata;
+  BMLoop **l_a = data->looptris[data->overlap[i].indexA];
+  BMLoop **l_b = data->looptris[data->overlap[i].indexB];
+  const float *t_a[3] = {l_a[0]->v->co, l_a[1]->v->co, l_a[2]->v->co};
+  const float *t_b[3] = {l_b[0]->v->co, l_b[1]->v->co, l_b[2]->v->co};
+  data->overlap_test[i] = isect_tri_tri_plane_overlap(t_a, t_b, data->eps);
+}
+
+enum {
+  ISECT_GROUP_REMOVE = (1 << 0),
+  ISECT_GROUP_FLIP = (1 << 1),
+};
+
+struct GroupClassifyData {
+  BMFace **ftable;
+  const int *groups_array;
+  const int (*group_index)[2];
+  int (*test_fn)(BMFace *f, void *user_data);
+  void *user_data;
+  BVHTree **tree_operands;
+  const float **looptri_coords;
+  int operands_len;
+  int boolean_mode;
+  char *group_flag;
+};
+
+/**
+ * Classify a face-group against every other operand,
+ * operand zero is the mesh being cut (only relevant for difference).
+ */
+static void bm_isect_group_classify_cb(void *__restrict userdata,
+                                       const int i,
+                                       const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  struct GroupClassifyData *data = userdata;
+  /* for now assume this is an OK face to test with (not degenerate!) */
+  BMFace *f = data->ftable[data->groups_array[data->group_index[i][0]]];
+  const int operand = data->test_fn(f, data->user_data);
+  char flag = 0;
+  float co[3];
+
+  if (operand == -1) {
+    data->group_flag[i] = 0;
+    return;
+  }
+
+  BM_face_calc_point_in_face(f, co);
+
+  for (int j = 0; j < data->operands_len; j++) {
+    if ((j == operand) || (data->tree_operands[j] == NULL)) {
+      continue;
+    }
+    const bool is_inside = (isect_bvhtree_point_v3(
+                                data->tree_operands[j], data->looptri_coords, co) &
+                            1) == 1;
+    switch (data->boolean_mode) {
+      case BMESH_ISECT_BOOLEAN_ISECT:
+        if (!is_inside) {
+          flag |= ISECT_GROUP_REMOVE;
+        }
+        break;
+      case BMESH_ISECT_BOOLEAN_UNION:
+        if (is_inside) {
+          flag |= ISECT_GROUP_REMOVE;
+        }
+        break;
+      case BMESH_ISECT_BOOLEAN_DIFFERENCE:
+        /* Keep the base outside all cutters, keep cutters inside the base
+         * but outside of the other cutters. */
+        if ((j == 0) ? !is_inside : is_inside) {
+          flag |= ISECT_GROUP_REMOVE;
+        }
+        break;
+    }
+    if (flag & ISECT_GROUP_REMOVE) {
+      break;
+    }
+  }
+
+  if ((data->boolean_mode == BMESH_ISECT_BOOLEAN_DIFFERENCE) && (operand != 0)) {
+    flag |= ISECT_GROUP_FLIP;
+  }
+  data->group_flag[i] = flag;
+}
+
+/** \} */
+
 #endif /* USE_BVH */
 
 /**
- * Intersect tessellated faces
- * leaving the resulting edges tagged.
- *
- * \param test_fn: Return value: -1: skip, 0: tree_a, 1: tree_b (use_self == false)
- * \param boolean_mode: -1: no-boolean, 0: intersection... see #BMESH_ISECT_BOOLEAN_ISECT.
- * \return true if the mesh is changed (intersections cut or faces removed from boolean).
+ * \param operands_len: When non-zero, \a test_fn returns an operand index
+ * (see #BM_mesh_intersect_nary), otherwise see #BM_mesh_intersect.
  */
-bool BM_mesh_intersect(BMesh *bm,
-                       struct BMLoop *(*looptris)[3],
-                       const int looptris_tot,
-                       int (*test_fn)(BMFace *f, void *user_data),
-                       void *user_data,
-                       const bool use_self,
-                       const bool use_separate,
-                       const bool use_dissolve,
-                       const bool use_island_connect,
-                       const bool use_partial_connect,
-                       const bool use_edge_tag,
-                       const int boolean_mode,
-                       const float eps)
+static bool bm_mesh_intersect_impl(BMesh *bm,
+                                   struct BMLoop *(*looptris)[3],
+                                   const int looptris_tot,
+                                   int (*test_fn)(BMFace *f, void *user_data),
+                                   void *user_data,
+                                   const int operands_len,
+                                   const bool use_self,
+                                   const bool use_separate,
+                                   const bool use_dissolve,
+                                   const bool use_island_connect,
+                                   const bool use_partial_connect,
+                                   const bool use_edge_tag,
+                                   const int boolean_mode,
+                                   const float eps)
 {
   struct ISectState s;
   const int totface_orig = bm->totface;
@@ -984,6 +1126,10 @@ bool BM_mesh_intersect(BMesh *bm,
   BVHTree *tree_a, *tree_b;
   uint tree_overlap_tot;
   BVHTreeOverlap *overlap;
+
+  /* n-ary only */
+  int *tri_operand = NULL;
+  BVHTree **tree_operands = NULL;
 #else
   int i_a, i_b;
 #endif
@@ -1052,7 +1198,56 @@ bool BM_mesh_intersect(BMesh *bm,
   }
 
 #ifdef USE_BVH
-  {
+  if (operands_len != 0) {
+    /* One tree over all operands for the overlap,
+     * one tree per operand for the inside/outside classification. */
+    int *operand_tot = MEM_callocN(sizeof(*operand_tot) * (size_t)operands_len, __func__);
+    int i;
+
+    tri_operand = MEM_mallocN(sizeof(*tri_operand) * (size_t)looptris_tot, __func__);
+    for (i = 0; i < looptris_tot; i++) {
+      tri_operand[i] = test_fn(looptris[i][0]->f, user_data);
+      BLI_assert(tri_operand[i] < operands_len);
+      if (tri_operand[i] != -1) {
+        operand_tot[tri_operand[i]] += 1;
+      }
+    }
+
+    if (boolean_mode != BMESH_ISECT_BOOLEAN_NONE) {
+      tree_operands = MEM_callocN(sizeof(*tree_operands) * (size_t)operands_len, __func__);
+      for (i = 0; i < operands_len; i++) {
+        if (operand_tot[i] != 0) {
+          tree_operands[i] = BLI_bvhtree_new(operand_tot[i], s.epsilon.eps_margin, 8, 8);
+        }
+      }
+    }
+    MEM_freeN(operand_tot);
+
+    tree_a = BLI_bvhtree_new(looptris_tot, s.epsilon.eps_margin, 8, 8);
+    for (i = 0; i < looptris_tot; i++) {
+      if (tri_operand[i] != -1) {
+        const float t_cos[3][3] = {
+            {UNPACK3(looptris[i][0]->v->co)},
+            {UNPACK3(looptris[i][1]->v->co)},
+            {UNPACK3(looptris[i][2]->v->co)},
+        };
+
+        BLI_bvhtree_insert(tree_a, i, (const float *)t_cos, 3);
+        if (tree_operands) {
+          BLI_bvhtree_insert(tree_operands[tri_operand[i]], i, (const float *)t_cos, 3);
+        }
+      }
+    }
+    BLI_bvhtree_balance(tree_a);
+    if (tree_operands) {
+      for (i = 0; i < operands_len; i++) {
+        if (tree_operands[i]) {
+          BLI_bvhtree_balance(tree_operands[i]);
+        }
+      }
+    }
+  }
+  else {
     int i;
     tree_a = BLI_bvhtree_new(looptris_tot, s.epsilon.eps_margin, 8, 8);
     for (i = 0; i < looptris_tot; i++) {
@@ -1069,7 +1264,7 @@ bool BM_mesh_intersect(BMesh *bm,
     BLI_bvhtree_balance(tree_a);
   }
 
-  if (use_self == false) {
+  if ((use_self == false) && (operands_len == 0)) {
     int i;
     tree_b = BLI_bvhtree_new(looptris_tot, s.epsilon.eps_margin, 8, 8);
     for (i = 0; i < looptris_tot; i++) {
@@ -1103,12 +1298,41 @@ bool BM_mesh_intersect(BMesh *bm,
     flag &= ~BVH_OVERLAP_USE_THREADING;
   }
 #  endif
-  overlap = BLI_bvhtree_overlap_ex(tree_b, tree_a, &tree_overlap_tot, NULL, NULL, 0, flag);
+  overlap = BLI_bvhtree_overlap_ex(tree_b,
+                                   tree_a,
+                                   &tree_overlap_tot,
+                                   operands_len ? bm_isect_overlap_operand_cb : NULL,
+                                   tri_operand,
+                                   0,
+                                   flag);
 
   if (overlap) {
+    bool *overlap_test = NULL;
     uint i;
 
+    if (operands_len != 0) {
+      /* Cull pairs whose bounds overlap but can't intersect,
+       * this is read-only so it runs in parallel, unlike the cutting below. */
+      struct OverlapCullData cull_data = {
+          .looptris = looptris,
+          .overlap = overlap,
+          .eps = s.epsilon.eps_margin,
+      };
+      overlap_test = MEM_mallocN(sizeof(*overlap_test) * tree_overlap_tot, __func__);
+      cull_data.overlap_test = overlap_test;
+
+      TaskParallelSettings settings;
+      BLI_parallel_range_settings_defaults(&settings);
+      settings.use_threading = (flag & BVH_OVERLAP_USE_THREADING) != 0;
+      settings.min_iter_per_thread = 1024;
+      BLI_task_parallel_range(
+          0, (int)tree_overlap_tot, &cull_data, bm_isect_overlap_cull_cb, &settings);
+    }
+
     for (i = 0; i < tree_overlap_tot; i++) {
+      if (overlap_test && !overlap_test[i]) {
+        continue;
+      }
 #  ifdef USE_DUMP
       printf("  ((%d, %d), (\n", overlap[i].indexA, overlap[i].indexB);
 #  endif
@@ -1122,9 +1346,16 @@ bool BM_mesh_intersect(BMesh *bm,
       printf(")),\n");
 #  endif
     }
+    if (overlap_test) {
+      MEM_freeN(overlap_test);
+    }
     MEM_freeN(overlap);
   }
 
+  if (tri_operand) {
+    MEM_freeN(tri_operand);
+  }
+
   if (boolean_mode == BMESH_ISECT_BOOLEAN_NONE) {
     /* no booleans, just free immediate */
     BLI_bvhtree_free(tree_a);
@@ -1543,12 +1774,43 @@ bool BM_mesh_intersect(BMesh *bm,
     printf("%s: Total face-groups: %d\n", __func__, group_tot);
 #endif
 
+#ifdef USE_BVH
+    char *group_flag = NULL;
+    if (operands_len != 0) {
+      struct GroupClassifyData classify_data = {
+          .ftable = ftable,
+          .groups_array = groups_array,
+          .group_index = (const int(*)[2])group_index,
+          .test_fn = test_fn,
+          .user_data = user_data,
+          .tree_operands = tree_operands,
+          .looptri_coords = looptri_coords,
+          .operands_len = operands_len,
+          .boolean_mode = boolean_mode,
+      };
+      group_flag = MEM_mallocN(sizeof(*group_flag) * (size_t)max_ii(group_tot, 1), __func__);
+      classify_data.group_flag = group_flag;
+
+      TaskParallelSettings settings;
+      BLI_parallel_range_settings_defaults(&settings);
+      settings.min_iter_per_thread = 16;
+      BLI_task_parallel_range(0, group_tot, &classify_data, bm_isect_group_classify_cb, &settings);
+    }
+#endif
+
     /* Check if island is inside/outside */
     for (i = 0; i < group_tot; i++) {
       int fg = group_index[i][0];
       int fg_end = group_index[i][1] + fg;
       bool do_remove, do_flip;
 
+#ifdef USE_BVH
+      if (group_flag) {
+        do_remove = (group_flag[i] & ISECT_GROUP_REMOVE) != 0;
+        do_flip = (group_flag[i] & ISECT_GROUP_FLIP) != 0;
+      }
+      else
+#endif
       {
         /* for now assyme this is an OK face to test with (not degenerate!) */
         BMFace *f = ftable[groups_array[fg]];
@@ -1599,6 +1861,11 @@ bool BM_mesh_intersect(BMesh *bm,
       has_edit_boolean |= (do_flip || do_remove);
     }
 
+#ifdef USE_BVH
+    if (group_flag) {
+      MEM_freeN(group_flag);
+    }
+#endif
     MEM_freeN(groups_array);
     MEM_freeN(group_index);
 
@@ -1653,6 +1920,17 @@ bool BM_mesh_intersect(BMesh *bm,
     }
   }
 
+#ifdef USE_BVH
+  if (tree_operands) {
+    for (int i = 0; i < operands_len; i++) {
+      if (tree_operands[i]) {
+        BLI_bvhtree_free(tree_operands[i]);
+      }
+    }
+    MEM_freeN(tree_operands);
+  }
+#endif
+
   has_edit_isect = (BLI_ghash_len(s.face_edges) != 0);
 
   /* cleanup */
@@ -1666,3 +1944,79 @@ bool BM_mesh_intersect(BMesh *bm,
 
   return (has_edit_isect || has_edit_boolean);
 }
+
+/**
+ * Intersect tessellated faces
+ * leaving the resulting edges tagged.
+ *
+ * \param test_fn: Return value: -1: skip, 0: tree_a, 1: tree_b (use_self == false)
+ * \param boolean_mode: -1: no-boolean, 0: intersection... see #BMESH_ISECT_BOOLEAN_ISECT.
+ * \return true if the mesh is changed (intersections cut or faces removed from boolean).
+ */
+bool BM_mesh_intersect(BMesh *bm,
+                       struct BMLoop *(*looptris)[3],
+                       const int looptris_tot,
+                       int (*test_fn)(BMFace *f, void *user_data),
+                       void *user_data,
+                       const bool use_self,
+                       const bool use_separate,
+                       const bool use_dissolve,
+                       const bool use_island_connect,
+                       const bool use_partial_connect,
+                       const bool use_edge_tag,
+                       const int boolean_mode,
+                       const float eps)
+{
+  return bm_mesh_intersect_impl(bm,
+                                looptris,
+                                looptris_tot,
+                                test_fn,
+                                user_data,
+                                0,
+                                use_self,
+                                use_separate,
+                                use_dissolve,
+                                use_island_connect,
+                                use_partial_connect,
+                                use_edge_tag,
+                                boolean_mode,
+                                eps);
+}
+
+/**
+ * Intersect any number of operands in a single pass,
+ * sharing one overlap test and one inside/outside classification.
+ *
+ * \param test_fn: Return value: -1: skip, otherwise the operand index (less than \a operands_len).
+ * Operand zero is the base mesh, for difference all other operands are subtracted from it.
+ * \param boolean_mode: See #BMESH_ISECT_BOOLEAN_ISECT.
+ * \return true if the mesh is changed (intersections cut or faces removed from boolean).
+ */
+bool BM_mesh_intersect_nary(BMesh *bm,
+                            struct BMLoop *(*looptris)[3],
+                            const int looptris_tot,
+                            int (*test_fn)(BMFace *f, void *user_data),
+                            void *user_data,
+                            const int operands_len,
+                            const bool use_dissolve,
+                            const bool use_island_connect,
+                            const int boolean_mode,
+                            const float eps)
+{
+  BLI_assert(operands_len > 0);
+  BLI_assert(boolean_mode != BMESH_ISECT_BOOLEAN_NONE);
+  return bm_mesh_intersect_impl(bm,
+                                looptris,
+                                looptris_tot,
+                                test_fn,
+                                user_data,
+                                operands_len,
+                                false,
+                                false,
+                                use_dissolve,
+                                use_island_connect,
+                                false,
+                                false,
+                                boolean_mode,
+                                eps);
+}
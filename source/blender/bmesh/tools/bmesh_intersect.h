@@ -35,6 +35,17 @@ bool BM_mesh_intersect(BMesh *bm,
                        const int boolean_mode,
                        const float eps);
 
+bool BM_mesh_intersect_nary(BMesh *bm,
+                            struct BMLoop *(*looptris)[3],
+                            const int looptris_tot,
+                            int (*test_fn)(BMFace *f, void *user_data),
+                            void *user_data,
+                            const int operands_len,
+                            const bool use_dissolve,
+                            const bool use_island_connect,
+                            const int boolean_mode,
+                            const float eps);
+
 enum {
   BMESH_ISECT_BOOLEAN_NONE = -1,
   /* aligned with BooleanModifierOp */
@@ -268,6 +268,10 @@ class CompositorContext {
   {
     return (this->getbNodeTree()->flag & NTREE_COM_GROUPNODE_BUFFER) != 0;
   }
+  bool isFullFrameEnabled() const
+  {
+    return (this->getbNodeTree()->flag & NTREE_COM_FULL_FRAME) != 0;
+  }
 };
 
 #endif
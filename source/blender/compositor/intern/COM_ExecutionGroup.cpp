@@ -35,6 +35,7 @@
 
 #include "BLI_math.h"
 #include "BLI_string.h"
+#include "BLI_task.h"
 #include "BLT_translation.h"
 #include "MEM_guardedalloc.h"
 #include "PIL_time.h"
@@ -161,6 +162,7 @@ void ExecutionGroup::deinitExecution()
   this->m_numberOfYChunks = 0;
   this->m_cachedReadOperations.clear();
   this->m_bTree = NULL;
+  freeBufferOperations();
 }
 void ExecutionGroup::determineResolution(unsigned int resolution[2])
 {
@@ -211,6 +213,17 @@ void ExecutionGroup::execute(ExecutionSystem *graph)
 
   this->m_chunksFinished = 0;
   this->m_bTree = bTree;
+
+  if (context.isFullFrameEnabled()) {
+    DebugInfo::execution_group_started(this);
+    executeFullFrame(graph);
+    if (bTree->update_draw) {
+      bTree->update_draw(bTree->udh);
+    }
+    DebugInfo::execution_group_finished(this);
+    return;
+  }
+
   unsigned int index;
   unsigned int *chunkOrder = (unsigned int *)MEM_mallocN(
       sizeof(unsigned int) * this->m_numberOfChunks, __func__);
@@ -371,6 +384,187 @@ void ExecutionGroup::execute(ExecutionSystem *graph)
   MEM_freeN(chunkOrder);
 }
 
+/* -------------------------------------------------------------------- */
+/** \name Full-Frame Execution
+ *
+ * Instead of pulling every pixel through the operations per chunk, groups are executed in
+ * dependency order and operations implementing NodeOperation.executeBuffer calculate their
+ * whole output at once, in parallel over rows. The chunks of the group then read these buffers,
+ * operations that aren't ported are still executed per pixel.
+ * \{ */
+
+bool ExecutionGroup::executeFullFrame(ExecutionSystem *graph)
+{
+  const bNodeTree *bTree = graph->getContext().getbNodeTree();
+  if (this->m_width == 0 || this->m_height == 0 || this->m_numberOfChunks == 0) {
+    return true;
+  }
+
+  /* The groups this one reads from are executed completely first. */
+  for (unsigned int index = 0; index < this->m_cachedReadOperations.size(); index++) {
+    ReadBufferOperation *readOperation =
+        (ReadBufferOperation *)this->m_cachedReadOperations[index];
+    ExecutionGroup *group = readOperation->getMemoryProxy()->getExecutor();
+    if (group != NULL && group != this && !group->executeFullFrame(graph)) {
+      return false;
+    }
+  }
+
+  bool is_executed = true;
+  for (unsigned int chunkNumber = 0; chunkNumber < this->m_numberOfChunks; chunkNumber++) {
+    if (this->m_chunkExecutionStates[chunkNumber] != COM_ES_EXECUTED) {
+      is_executed = false;
+      break;
+    }
+  }
+  if (is_executed) {
+    return true;
+  }
+
+  if (bTree->test_break && bTree->test_break(bTree->tbh)) {
+    return false;
+  }
+
+  /* Complex operations need their per chunk tile data, OpenCL groups run on the device. */
+  if (!this->m_complex && !this->m_openCL) {
+    executeBufferOperations(bTree);
+  }
+
+  for (unsigned int chunkNumber = 0; chunkNumber < this->m_numberOfChunks; chunkNumber++) {
+    scheduleChunk(chunkNumber);
+  }
+  WorkScheduler::finish();
+
+  freeBufferOperations();
+
+  return !(bTree->test_break && bTree->test_break(bTree->tbh));
+}
+
+void ExecutionGroup::executeBufferOperations(const bNodeTree *bTree)
+{
+  for (unsigned int index = 0; index < this->m_operations.size(); index++) {
+    NodeOperation *operation = this->m_operations[index];
+    if (operation->isBufferOperation() && canExecuteBuffer(operation)) {
+      executeBufferOperation(operation);
+    }
+    if (bTree->test_break && bTree->test_break(bTree->tbh)) {
+      break;
+    }
+  }
+}
+
+bool ExecutionGroup::canExecuteBuffer(NodeOperation *operation) const
+{
+  if (operation->isComplex() || operation->getNumberOfOutputSockets() == 0) {
+    return false;
+  }
+  /* Inputs are read at the same coordinates, so they need to match in size. */
+  for (unsigned int index = 0; index < operation->getNumberOfInputSockets(); index++) {
+    NodeOperationInput *socket = operation->getInputSocket(index);
+    if (!socket->isConnected()) {
+      return false;
+    }
+    NodeOperation &input = socket->getLink()->getOperation();
+    if (input.isComplex() || input.getNumberOfOutputSockets() == 0 ||
+        input.getWidth() != operation->getWidth() || input.getHeight() != operation->getHeight()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+struct ExecuteBufferData {
+  NodeOperation *operation;
+  MemoryBuffer *output;
+  /** NULL when the operation is executed per pixel. */
+  MemoryBuffer **inputs;
+};
+
+static void execute_buffer_row(void *__restrict userdata,
+                               const int y,
+                               const TaskParallelTLS *__restrict /*tls*/)
+{
+  ExecuteBufferData *data = (ExecuteBufferData *)userdata;
+  MemoryBuffer *output = data->output;
+  const int width = output->getWidth();
+
+  if (data->inputs) {
+    rcti rect;
+    BLI_rcti_init(&rect, 0, width, y, y + 1);
+    data->operation->executeBuffer(output, &rect, data->inputs);
+  }
+  else {
+    const size_t elem_size = sizeof(float) * output->get_num_channels();
+    float color[4];
+    for (int x = 0; x < width; x++) {
+      data->operation->readSampled(color, x, y, COM_PS_NEAREST);
+      memcpy(output->getElem(x, y), color, elem_size);
+    }
+  }
+}
+
+MemoryBuffer *ExecutionGroup::executeBufferOperation(NodeOperation *operation)
+{
+  MemoryBuffer *buffer = operation->getExecutedBuffer();
+  if (buffer != NULL) {
+    return buffer;
+  }
+
+  rcti rect;
+  BLI_rcti_init(&rect, 0, operation->getWidth(), 0, operation->getHeight());
+  const DataType datatype = operation->getOutputSocket()->getDataType();
+
+  if (operation->isSetOperation()) {
+    /* Constant, a single element is enough. */
+    float color[4];
+    buffer = new MemoryBuffer(datatype, &rect, true);
+    operation->readSampled(color, 0.0f, 0.0f, COM_PS_NEAREST);
+    memcpy(buffer->getBuffer(), color, sizeof(float) * buffer->get_num_channels());
+  }
+  else {
+    const unsigned int inputs_len = operation->getNumberOfInputSockets();
+    vector<MemoryBuffer *> inputs;
+    bool use_buffers = operation->isBufferOperation() && canExecuteBuffer(operation);
+
+    if (use_buffers) {
+      for (unsigned int index = 0; index < inputs_len; index++) {
+        NodeOperation &input = operation->getInputSocket(index)->getLink()->getOperation();
+        inputs.push_back(executeBufferOperation(&input));
+      }
+      /* Avoid a NULL pointer for operations without inputs. */
+      inputs.push_back(NULL);
+    }
+
+    buffer = new MemoryBuffer(datatype, &rect);
+
+    ExecuteBufferData data;
+    data.operation = operation;
+    data.output = buffer;
+    data.inputs = use_buffers ? &inputs[0] : NULL;
+
+    TaskParallelSettings settings;
+    BLI_parallel_range_settings_defaults(&settings);
+    settings.min_iter_per_thread = 8;
+    BLI_task_parallel_range(0, operation->getHeight(), &data, execute_buffer_row, &settings);
+  }
+
+  operation->setExecutedBuffer(buffer);
+  this->m_executedBufferOperations.push_back(operation);
+  return buffer;
+}
+
+void ExecutionGroup::freeBufferOperations()
+{
+  for (unsigned int index = 0; index < this->m_executedBufferOperations.size(); index++) {
+    NodeOperation *operation = this->m_executedBufferOperations[index];
+    delete operation->getExecutedBuffer();
+    operation->setExecutedBuffer(NULL);
+  }
+  this->m_executedBufferOperations.clear();
+}
+
+/** \} */
+
 MemoryBuffer **ExecutionGroup::getInputBuffersOpenCL(int chunkNumber)
 {
   rcti rect;
@@ -601,6 +795,26 @@ bool ExecutionGroup::isOpenCL()
   return this->m_openCL;
 }
 
+bool ExecutionGroup::isExecuted() const
+{
+  if (this->m_chunkExecutionStates == NULL) {
+    return false;
+  }
+  for (unsigned int index = 0; index < this->m_numberOfChunks; index++) {
+    if (this->m_chunkExecutionStates[index] != COM_ES_EXECUTED) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void ExecutionGroup::setExecuted()
+{
+  for (unsigned int index = 0; index < this->m_numberOfChunks; index++) {
+    this->m_chunkExecutionStates[index] = COM_ES_EXECUTED;
+  }
+}
+
 void ExecutionGroup::setViewerBorder(float xmin, float xmax, float ymin, float ymax)
 {
   NodeOperation *operation = this->getOutputOperation();
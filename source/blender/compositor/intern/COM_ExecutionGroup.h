@@ -182,6 +182,12 @@ class ExecutionGroup {
    */
   double m_executionStartTime;
 
+  /**
+   * \brief operations holding an executed buffer during full-frame execution.
+   * \see executeBufferOperations
+   */
+  Operations m_executedBufferOperations;
+
   // methods
   /**
    * \brief check whether parameter operation can be added to the execution group
@@ -252,6 +258,36 @@ class ExecutionGroup {
                                         ReadBufferOperation *readOperation,
                                         rcti *output);
 
+  /**
+   * \brief execute all chunks of this group at once, after the groups it reads from.
+   * \note used instead of the chunk scheduling when full-frame execution is enabled.
+   * \return false when the execution has been breaked (by user)
+   */
+  bool executeFullFrame(ExecutionSystem *graph);
+
+  /**
+   * \brief calculate whole buffers of the operations supporting it
+   * before the chunks of this group are executed.
+   * \see NodeOperation.executeBuffer
+   */
+  void executeBufferOperations(const bNodeTree *bTree);
+
+  /**
+   * \brief can \a operation be calculated by NodeOperation.executeBuffer
+   */
+  bool canExecuteBuffer(NodeOperation *operation) const;
+
+  /**
+   * \brief calculate the whole buffer of \a operation, including the buffers of its inputs.
+   * Operations not supporting NodeOperation.executeBuffer are calculated pixel by pixel.
+   */
+  MemoryBuffer *executeBufferOperation(NodeOperation *operation);
+
+  /**
+   * \brief free the buffers created by executeBufferOperations
+   */
+  void freeBufferOperations();
+
  public:
   // constructors
   ExecutionGroup();
@@ -440,6 +476,18 @@ class ExecutionGroup {
 
   void setRenderBorder(float xmin, float xmax, float ymin, float ymax);
 
+  /**
+   * \brief are all chunks of this ExecutionGroup executed
+   * \note only valid between initExecution and deinitExecution
+   */
+  bool isExecuted() const;
+
+  /**
+   * \brief mark all chunks as executed, when the result is provided by the ResultCache
+   * \note only valid between initExecution and deinitExecution
+   */
+  void setExecuted();
+
   /* allow the DebugInfo class to look at internals */
   friend class DebugInfo;
 
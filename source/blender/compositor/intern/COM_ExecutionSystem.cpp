@@ -31,6 +31,7 @@
 #include "COM_NodeOperation.h"
 #include "COM_NodeOperationBuilder.h"
 #include "COM_ReadBufferOperation.h"
+#include "COM_ResultCache.h"
 #include "COM_WorkScheduler.h"
 
 #ifdef WITH_CXX_GUARDEDALLOC
@@ -177,6 +178,9 @@ void ExecutionSystem::execute()
     executionGroup->initExecution();
   }
 
+  /* groups with unchanged results don't need to be executed again */
+  ResultCache::restore(this->m_groups);
+
   WorkScheduler::start(this->m_context);
 
   executeGroups(COM_PRIORITY_HIGH);
@@ -188,6 +192,10 @@ void ExecutionSystem::execute()
   WorkScheduler::finish();
   WorkScheduler::stop();
 
+  if (!(editingtree->test_break && editingtree->test_break(editingtree->tbh))) {
+    ResultCache::store(this->m_groups);
+  }
+
   editingtree->stats_draw(editingtree->sdh, TIP_("Compositing | De-initializing execution"));
   for (index = 0; index < this->m_operations.size(); index++) {
     NodeOperation *operation = this->m_operations[index];
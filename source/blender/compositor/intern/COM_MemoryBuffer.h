@@ -92,6 +92,11 @@ class MemoryBuffer {
    */
   unsigned int m_num_channels;
 
+  /**
+   * \brief a single element is stored and used for the whole area (constant values).
+   */
+  bool m_is_single_elem;
+
   int m_width;
   int m_height;
 
@@ -108,8 +113,9 @@ class MemoryBuffer {
 
   /**
    * \brief construct new temporarily MemoryBuffer for an area
+   * \param is_single_elem: store one element for the whole area, see #getElemStride.
    */
-  MemoryBuffer(DataType datatype, rcti *rect);
+  MemoryBuffer(DataType datatype, rcti *rect, bool is_single_elem = false);
 
   /**
    * \brief destructor
@@ -138,6 +144,34 @@ class MemoryBuffer {
     return this->m_buffer;
   }
 
+  bool isSingleElem() const
+  {
+    return this->m_is_single_elem;
+  }
+
+  /**
+   * \brief number of floats between two horizontally adjacent elements,
+   * zero for single element buffers so they can be iterated like any other buffer.
+   */
+  int getElemStride() const
+  {
+    return this->m_is_single_elem ? 0 : this->m_num_channels;
+  }
+
+  /**
+   * \brief get the element at image coordinates \a x, \a y
+   * \note the coordinates must be inside the rect of this buffer
+   */
+  float *getElem(int x, int y)
+  {
+    if (this->m_is_single_elem) {
+      return this->m_buffer;
+    }
+    BLI_assert(x >= m_rect.xmin && x < m_rect.xmax && y >= m_rect.ymin && y < m_rect.ymax);
+    return &this->m_buffer[((y - m_rect.ymin) * this->m_width + (x - m_rect.xmin)) *
+                           this->m_num_channels];
+  }
+
   /**
    * \brief after execution the state will be set to available by calling this method
    */
@@ -103,6 +103,12 @@ class NodeOperation : public SocketReader {
    */
   bool m_openCL;
 
+  /**
+   * \brief can this operation calculate whole buffers at once (full-frame execution).
+   * \see executeBuffer
+   */
+  bool m_bufferOperation;
+
   /**
    * \brief mutex reference for very special node initializations
    * \note only use when you really know what you are doing.
@@ -201,6 +207,22 @@ class NodeOperation : public SocketReader {
   {
   }
 
+  /**
+   * \brief calculate an area of the output at once, used by the full-frame execution
+   * \ingroup execution
+   * \note only called when isBufferOperation is set, may be called from multiple threads
+   * for different rows of the same output.
+   * \param output: the buffer to write to, covering the whole resolution of this operation
+   * \param rect: the area to calculate
+   * \param inputs: results of the operations connected to the input sockets (in socket order),
+   * with the resolution of this operation. Constant inputs are single element buffers.
+   */
+  virtual void executeBuffer(MemoryBuffer * /*output*/,
+                             const rcti * /*rect*/,
+                             MemoryBuffer ** /*inputs*/)
+  {
+  }
+
   /**
    * \brief when a chunk is executed by an OpenCLDevice, this method is called
    * \ingroup execution
@@ -344,6 +366,15 @@ class NodeOperation : public SocketReader {
     return this->m_openCL;
   }
 
+  /**
+   * \brief does this NodeOperation implement executeBuffer
+   * \see ExecutionGroup.executeBufferOperations
+   */
+  bool isBufferOperation() const
+  {
+    return this->m_bufferOperation;
+  }
+
   virtual bool isViewerOperation() const
   {
     return false;
@@ -421,6 +452,14 @@ class NodeOperation : public SocketReader {
     this->m_openCL = openCL;
   }
 
+  /**
+   * \brief set if this NodeOperation implements executeBuffer
+   */
+  void setBufferOperation(bool bufferOperation)
+  {
+    this->m_bufferOperation = bufferOperation;
+  }
+
   /* allow the DebugInfo class to look at internals */
   friend class DebugInfo;
 
@@ -38,7 +38,10 @@
 #include "COM_NodeOperationBuilder.h" /* own include */
 
 NodeOperationBuilder::NodeOperationBuilder(const CompositorContext *context, bNodeTree *b_nodetree)
-    : m_context(context), m_current_node(NULL), m_active_viewer(NULL)
+    : m_context(context),
+      m_current_node(NULL),
+      m_current_node_operations_len(0),
+      m_active_viewer(NULL)
 {
   m_graph.from_bNodeTree(*context, b_nodetree);
 }
@@ -56,6 +59,8 @@ void NodeOperationBuilder::convertToOperations(ExecutionSystem *system)
     Node *node = (Node *)m_graph.nodes()[index];
 
     m_current_node = node;
+    m_current_node_key = ResultCache::node_key(*m_context, node);
+    m_current_node_operations_len = 0;
 
     DebugInfo::node_to_operations(node);
     node->convertToOperations(converter, *m_context);
@@ -107,6 +112,10 @@ void NodeOperationBuilder::convertToOperations(ExecutionSystem *system)
   /* surround complex ops with read/write buffer */
   add_complex_operation_buffers();
 
+  /* identify the buffered results, so unchanged ones can be reused from the last execution */
+  ResultCache::calculate_keys(m_operations, m_node_operation_keys);
+  m_node_operation_keys.clear();
+
   /* links not available from here on */
   /* XXX make m_links a local variable to avoid confusion! */
   m_links.clear();
@@ -126,6 +135,11 @@ void NodeOperationBuilder::convertToOperations(ExecutionSystem *system)
 void NodeOperationBuilder::addOperation(NodeOperation *operation)
 {
   m_operations.push_back(operation);
+
+  if (m_current_node) {
+    m_node_operation_keys[operation] = ResultCache::node_operation_key(
+        m_current_node_key, m_current_node_operations_len++);
+  }
 }
 
 void NodeOperationBuilder::mapInputSocket(NodeInput *node_socket,
@@ -24,6 +24,7 @@
 #include <vector>
 
 #include "COM_NodeGraph.h"
+#include "COM_ResultCache.h"
 
 using std::vector;
 
@@ -90,6 +91,12 @@ class NodeOperationBuilder {
 
   Node *m_current_node;
 
+  /** ResultCache key of the current node and the number of operations it added so far */
+  ResultCacheKey m_current_node_key;
+  int m_current_node_operations_len;
+  /** ResultCache keys of all operations added by nodes */
+  ResultCache::OperationKeys m_node_operation_keys;
+
   /** Operation that will be writing to the viewer image
    *  Only one operation can occupy this place at a time,
    *  to avoid race conditions
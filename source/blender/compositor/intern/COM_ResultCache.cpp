@@ -0,0 +1,501 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Copyright 2020, Blender Foundation.
+ */
+
+#include <string.h>
+#include <typeinfo>
+
+#include "COM_CompositorContext.h"
+#include "COM_ExecutionGroup.h"
+#include "COM_MemoryProxy.h"
+#include "COM_Node.h"
+#include "COM_NodeOperation.h"
+#include "COM_ReadBufferOperation.h"
+#include "COM_WriteBufferOperation.h"
+
+#include "COM_ResultCache.h" /* own include */
+
+#include "BLI_hash_mm2a.h"
+#include "BLI_utildefines.h"
+
+#include "BKE_node.h"
+
+#include "DNA_color_types.h"
+#include "DNA_genfile.h"
+#include "DNA_node_types.h"
+#include "DNA_scene_types.h"
+#include "DNA_sdna_types.h"
+
+#include "IMB_imbuf.h"
+#include "IMB_imbuf_types.h"
+#include "IMB_moviecache.h"
+
+#include "MEM_guardedalloc.h"
+
+#include "RE_pipeline.h"
+
+static struct MovieCache *s_cache = NULL;
+
+/* -------------------------------------------------------------------- */
+/** \name Hashing
+ * \{ */
+
+namespace {
+
+/** Two murmur hashes with different seeds, combined into a #ResultCacheKey. */
+class KeyHasher {
+ private:
+  BLI_HashMurmur2A m_mm2[2];
+
+ public:
+  KeyHasher()
+  {
+    BLI_hash_mm2a_init(&m_mm2[0], 0);
+    BLI_hash_mm2a_init(&m_mm2[1], 0x9e3779b9);
+  }
+
+  void add(const void *data, size_t len)
+  {
+    BLI_hash_mm2a_add(&m_mm2[0], (const unsigned char *)data, len);
+    BLI_hash_mm2a_add(&m_mm2[1], (const unsigned char *)data, len);
+  }
+
+  void add_int(int value)
+  {
+    add(&value, sizeof(value));
+  }
+
+  void add_float(float value)
+  {
+    add(&value, sizeof(value));
+  }
+
+  void add_string(const char *str)
+  {
+    if (str) {
+      add(str, strlen(str) + 1);
+    }
+    else {
+      add_int(0);
+    }
+  }
+
+  void add_key(const ResultCacheKey &key)
+  {
+    add(key.hash, sizeof(key.hash));
+  }
+
+  ResultCacheKey end()
+  {
+    ResultCacheKey key;
+    key.hash[0] = BLI_hash_mm2a_end(&m_mm2[0]);
+    key.hash[1] = BLI_hash_mm2a_end(&m_mm2[1]);
+    key.is_valid = true;
+    return key;
+  }
+};
+
+}  // namespace
+
+static ResultCacheKey invalid_key()
+{
+  ResultCacheKey key;
+  key.hash[0] = key.hash[1] = 0;
+  key.is_valid = false;
+  return key;
+}
+
+/**
+ * Add the members of a DNA struct that hold values. The tree is copied for every execution, so
+ * pointers change every time and would prevent any cache hit.
+ */
+static void hash_dna_struct(KeyHasher &hasher, const SDNA *sdna, int struct_nr, const char *data)
+{
+  const short *sp = sdna->structs[struct_nr];
+  const int members_len = sp[1];
+  const short *member = sp + 2;
+
+  for (int i = 0; i < members_len; i++, member += 2) {
+    const short type = member[0];
+    const short name = member[1];
+    const char *member_name = sdna->names[name];
+    const int size = DNA_elem_size_nr(sdna, type, name);
+
+    /* Pointers and function pointers. */
+    if (!ELEM(member_name[0], '*', '(')) {
+      const int member_struct_nr = DNA_struct_find_nr(sdna, sdna->types[type]);
+      if (member_struct_nr != -1) {
+        for (int j = 0; j < sdna->names_array_len[name]; j++) {
+          hash_dna_struct(hasher, sdna, member_struct_nr, data + j * sdna->types_size[type]);
+        }
+      }
+      else {
+        hasher.add(data, size);
+      }
+    }
+
+    data += size;
+  }
+}
+
+/** Hash the struct named \a struct_name, returns false when it isn't found in DNA. */
+static bool hash_dna_struct(KeyHasher &hasher, const char *struct_name, const void *data)
+{
+  const SDNA *sdna = DNA_sdna_current_get();
+  const int struct_nr = DNA_struct_find_nr(sdna, struct_name);
+  if (struct_nr == -1) {
+    return false;
+  }
+  hash_dna_struct(hasher, sdna, struct_nr, (const char *)data);
+  return true;
+}
+
+static void hash_curvemapping(KeyHasher &hasher, const CurveMapping *cumap)
+{
+  hash_dna_struct(hasher, "CurveMapping", cumap);
+  for (int i = 0; i < CM_TOT; i++) {
+    const CurveMap *cuma = &cumap->cm[i];
+    if (cuma->curve) {
+      hasher.add(cuma->curve, sizeof(*cuma->curve) * cuma->totpoint);
+    }
+  }
+}
+
+/** Returns false when the storage can't be hashed, the node result is then never cached. */
+static bool hash_node_storage(KeyHasher &hasher, const bNode *b_node)
+{
+  switch (b_node->type) {
+    case CMP_NODE_TIME:
+    case CMP_NODE_CURVE_VEC:
+    case CMP_NODE_CURVE_RGB:
+    case CMP_NODE_HUECORRECT:
+      hash_curvemapping(hasher, (const CurveMapping *)b_node->storage);
+      return true;
+    case CMP_NODE_CRYPTOMATTE: {
+      const NodeCryptomatte *data = (const NodeCryptomatte *)b_node->storage;
+      hasher.add(data->add, sizeof(data->add));
+      hasher.add(data->remove, sizeof(data->remove));
+      hasher.add_string(data->matte_id);
+      hasher.add_int(data->num_inputs);
+      return true;
+    }
+    default:
+      return hash_dna_struct(hasher, b_node->typeinfo->storagename, b_node->storage);
+  }
+}
+
+/** The result the render layers node reads, render slots swap it without a new render. */
+static void hash_render_result(KeyHasher &hasher, const Scene *scene)
+{
+  Render *re = (scene) ? RE_GetSceneRender(scene) : NULL;
+  RenderResult *rr = NULL;
+  if (re) {
+    rr = RE_AcquireResultRead(re);
+    RE_ReleaseResult(re);
+  }
+  hasher.add(&rr, sizeof(rr));
+}
+
+static void hash_node_socket_value(KeyHasher &hasher, const bNodeSocket *b_socket)
+{
+  hasher.add_int(b_socket->type);
+  if (b_socket->default_value == NULL) {
+    return;
+  }
+  switch (b_socket->type) {
+    case SOCK_FLOAT:
+      hasher.add_float(((const bNodeSocketValueFloat *)b_socket->default_value)->value);
+      break;
+    case SOCK_INT:
+      hasher.add_int(((const bNodeSocketValueInt *)b_socket->default_value)->value);
+      break;
+    case SOCK_BOOLEAN:
+      hasher.add_int(((const bNodeSocketValueBoolean *)b_socket->default_value)->value);
+      break;
+    case SOCK_VECTOR: {
+      const bNodeSocketValueVector *data = (const bNodeSocketValueVector *)
+                                               b_socket->default_value;
+      hasher.add(data->value, sizeof(data->value));
+      break;
+    }
+    case SOCK_RGBA: {
+      const bNodeSocketValueRGBA *data = (const bNodeSocketValueRGBA *)b_socket->default_value;
+      hasher.add(data->value, sizeof(data->value));
+      break;
+    }
+  }
+}
+
+/** \} */
+
+/* -------------------------------------------------------------------- */
+/** \name Keys
+ * \{ */
+
+ResultCacheKey ResultCache::node_key(const CompositorContext &context, Node *node)
+{
+  const bNode *b_node = node->getbNode();
+  KeyHasher hasher;
+
+  if (b_node != NULL) {
+    /* Images, movie clips, masks and textures can change without the node changing.
+     * A new render clears the cache, the render result is hashed for render slot changes. */
+    if (b_node->id != NULL && b_node->type != CMP_NODE_R_LAYERS) {
+      return invalid_key();
+    }
+    /* Uses the camera of the scene. */
+    if (b_node->type == CMP_NODE_DEFOCUS) {
+      return invalid_key();
+    }
+
+    hasher.add_int(b_node->type);
+    hasher.add(&b_node->id, sizeof(b_node->id));
+    hasher.add_int(b_node->custom1);
+    hasher.add_int(b_node->custom2);
+    hasher.add_float(b_node->custom3);
+    hasher.add_float(b_node->custom4);
+    if (b_node->storage && !hash_node_storage(hasher, b_node)) {
+      return invalid_key();
+    }
+    if (b_node->type == CMP_NODE_R_LAYERS) {
+      hash_render_result(hasher, (b_node->id) ? (Scene *)b_node->id : context.getScene());
+    }
+  }
+
+  for (unsigned int index = 0; index < node->getNumberOfInputSockets(); index++) {
+    const bNodeSocket *b_socket = node->getInputSocket(index)->getbNodeSocket();
+    if (b_socket) {
+      hash_node_socket_value(hasher, b_socket);
+    }
+  }
+
+  /* Settings of the execution used by the operations. */
+  const RenderData *rd = context.getRenderData();
+  hasher.add_int(context.getFramenumber());
+  hasher.add_int(context.getQuality());
+  hasher.add_int(context.isRendering());
+  hasher.add_int(context.isFastCalculation());
+  hasher.add_string(context.getViewName());
+  hasher.add_int(rd->xsch);
+  hasher.add_int(rd->ysch);
+  hasher.add_int(rd->size);
+
+  return hasher.end();
+}
+
+ResultCacheKey ResultCache::node_operation_key(const ResultCacheKey &node_key, int index)
+{
+  if (!node_key.is_valid) {
+    return node_key;
+  }
+  KeyHasher hasher;
+  hasher.add_key(node_key);
+  hasher.add_int(index);
+  return hasher.end();
+}
+
+static ResultCacheKey operation_key(NodeOperation *operation,
+                                    const ResultCache::OperationKeys &node_operation_keys,
+                                    ResultCache::OperationKeys &keys)
+{
+  ResultCache::OperationKeys::const_iterator it = keys.find(operation);
+  if (it != keys.end()) {
+    return it->second;
+  }
+
+  /* Mark as invalid while calculating, in case of cycles. */
+  keys[operation] = invalid_key();
+
+  KeyHasher hasher;
+  hasher.add_string(typeid(*operation).name());
+  hasher.add_int(operation->getWidth());
+  hasher.add_int(operation->getHeight());
+
+  it = node_operation_keys.find(operation);
+  if (it != node_operation_keys.end()) {
+    if (!it->second.is_valid) {
+      return invalid_key();
+    }
+    hasher.add_key(it->second);
+  }
+
+  if (operation->isSetOperation()) {
+    float value[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+    operation->readSampled(value, 0.0f, 0.0f, COM_PS_NEAREST);
+    hasher.add(value, sizeof(value));
+  }
+
+  if (operation->isReadBufferOperation()) {
+    MemoryProxy *proxy = ((ReadBufferOperation *)operation)->getMemoryProxy();
+    NodeOperation *write_operation = proxy->getWriteBufferOperation();
+    ResultCacheKey input_key = operation_key(write_operation, node_operation_keys, keys);
+    if (!input_key.is_valid) {
+      return input_key;
+    }
+    hasher.add_key(input_key);
+  }
+
+  for (unsigned int index = 0; index < operation->getNumberOfInputSockets(); index++) {
+    NodeOperationInput *socket = operation->getInputSocket(index);
+    hasher.add_int(socket->getResizeMode());
+    if (socket->isConnected()) {
+      NodeOperation &input = socket->getLink()->getOperation();
+      ResultCacheKey input_key = operation_key(&input, node_operation_keys, keys);
+      if (!input_key.is_valid) {
+        return input_key;
+      }
+      hasher.add_key(input_key);
+    }
+  }
+
+  ResultCacheKey key = hasher.end();
+  keys[operation] = key;
+  return key;
+}
+
+void ResultCache::calculate_keys(const Operations &operations,
+                                 const OperationKeys &node_operation_keys)
+{
+  OperationKeys keys;
+  for (Operations::const_iterator it = operations.begin(); it != operations.end(); ++it) {
+    NodeOperation *operation = *it;
+    if (operation->isWriteBufferOperation()) {
+      WriteBufferOperation *write_operation = (WriteBufferOperation *)operation;
+      write_operation->setCacheKey(operation_key(operation, node_operation_keys, keys));
+    }
+  }
+}
+
+/** \} */
+
+/* -------------------------------------------------------------------- */
+/** \name Cache
+ * \{ */
+
+static unsigned int resultcache_hashhash(const void *key_v)
+{
+  const ResultCacheKey *key = (const ResultCacheKey *)key_v;
+  return key->hash[0];
+}
+
+static bool resultcache_hashcmp(const void *a_v, const void *b_v)
+{
+  const ResultCacheKey *a = (const ResultCacheKey *)a_v;
+  const ResultCacheKey *b = (const ResultCacheKey *)b_v;
+  return (a->hash[0] != b->hash[0]) || (a->hash[1] != b->hash[1]);
+}
+
+/** The buffer a group writes to, NULL when the group result can't be cached. */
+static MemoryBuffer *group_cache_buffer(ExecutionGroup *group, ResultCacheKey *r_key)
+{
+  NodeOperation *operation = group->getOutputOperation();
+  if (!operation->isWriteBufferOperation()) {
+    return NULL;
+  }
+  WriteBufferOperation *write_operation = (WriteBufferOperation *)operation;
+  const ResultCacheKey &key = write_operation->getCacheKey();
+  if (!key.is_valid) {
+    return NULL;
+  }
+  MemoryBuffer *buffer = write_operation->getMemoryProxy()->getBuffer();
+  if (buffer == NULL) {
+    return NULL;
+  }
+  *r_key = key;
+  return buffer;
+}
+
+static size_t buffer_size_in_floats(MemoryBuffer *buffer)
+{
+  return (size_t)buffer->getWidth() * buffer->getHeight() * buffer->get_num_channels();
+}
+
+void ResultCache::restore(const Groups &groups)
+{
+  if (s_cache == NULL) {
+    return;
+  }
+
+  for (Groups::const_iterator it = groups.begin(); it != groups.end(); ++it) {
+    ExecutionGroup *group = *it;
+    ResultCacheKey key;
+    MemoryBuffer *buffer = group_cache_buffer(group, &key);
+    if (buffer == NULL) {
+      continue;
+    }
+
+    ImBuf *ibuf = IMB_moviecache_get(s_cache, &key);
+    if (ibuf == NULL) {
+      continue;
+    }
+    if (ibuf->x == buffer->getWidth() && ibuf->y == buffer->getHeight() &&
+        ibuf->channels == (int)buffer->get_num_channels()) {
+      memcpy(buffer->getBuffer(), ibuf->rect_float, sizeof(float) * buffer_size_in_floats(buffer));
+      group->setExecuted();
+    }
+    IMB_freeImBuf(ibuf);
+  }
+}
+
+void ResultCache::store(const Groups &groups)
+{
+  for (Groups::const_iterator it = groups.begin(); it != groups.end(); ++it) {
+    ExecutionGroup *group = *it;
+    ResultCacheKey key;
+    MemoryBuffer *buffer = group_cache_buffer(group, &key);
+    /* Partially executed groups (borders, fast calculation) are not stored. */
+    if (buffer == NULL || !group->isExecuted()) {
+      continue;
+    }
+
+    if (s_cache == NULL) {
+      s_cache = IMB_moviecache_create("Compositor Result Cache",
+                                      sizeof(ResultCacheKey),
+                                      resultcache_hashhash,
+                                      resultcache_hashcmp);
+    }
+    else {
+      /* Restored or unchanged since the last execution. */
+      ImBuf *cached_ibuf = IMB_moviecache_get(s_cache, &key);
+      if (cached_ibuf) {
+        IMB_freeImBuf(cached_ibuf);
+        continue;
+      }
+    }
+
+    const size_t size = buffer_size_in_floats(buffer);
+    ImBuf *ibuf = IMB_allocImBuf(buffer->getWidth(), buffer->getHeight(), 32, 0);
+    ibuf->channels = buffer->get_num_channels();
+    ibuf->rect_float = (float *)MEM_mallocN(sizeof(float) * size, __func__);
+    ibuf->mall |= IB_rectfloat;
+    ibuf->flags |= IB_rectfloat;
+    memcpy(ibuf->rect_float, buffer->getBuffer(), sizeof(float) * size);
+
+    IMB_moviecache_put(s_cache, &key, ibuf);
+    IMB_freeImBuf(ibuf);
+  }
+}
+
+void ResultCache::clear()
+{
+  if (s_cache) {
+    IMB_moviecache_free(s_cache);
+    s_cache = NULL;
+  }
+}
+
+/** \} */
@@ -0,0 +1,96 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Copyright 2020, Blender Foundation.
+ */
+
+#ifndef __COM_RESULTCACHE_H__
+#define __COM_RESULTCACHE_H__
+
+#include <map>
+#include <vector>
+
+class CompositorContext;
+class ExecutionGroup;
+class Node;
+class NodeOperation;
+
+/**
+ * \brief identifies the result of an operation between executions
+ * \see ResultCache
+ */
+typedef struct ResultCacheKey {
+  /** Two independent hashes, to make collisions practically impossible. */
+  unsigned int hash[2];
+  /** False when the result depends on data that isn't hashed (images, masks, ...). */
+  bool is_valid;
+} ResultCacheKey;
+
+/**
+ * \brief keeps the results of buffered operations between compositor executions
+ * \ingroup execution
+ *
+ * Every operation gets a key from the settings of the node it was created for, its size and
+ * the keys of the operations connected to its inputs. Groups writing to a MemoryProxy store
+ * their buffer under the key of their WriteBufferOperation. When the tree is executed again
+ * with only downstream changes, these groups aren't executed and their buffers are restored
+ * from the cache instead.
+ *
+ * The buffers are kept in an IMB_moviecache, so the memory cache limit from the preferences
+ * applies. The cache is cleared when a new render starts, see COM_clearCaches.
+ */
+class ResultCache {
+ public:
+  typedef std::map<NodeOperation *, ResultCacheKey> OperationKeys;
+  typedef std::vector<NodeOperation *> Operations;
+  typedef std::vector<ExecutionGroup *> Groups;
+
+  /**
+   * \brief key of the settings of a node, invalid when the node reads data that isn't hashed
+   */
+  static ResultCacheKey node_key(const CompositorContext &context, Node *node);
+
+  /**
+   * \brief key of the \a index th operation that was created for the node with \a node_key
+   */
+  static ResultCacheKey node_operation_key(const ResultCacheKey &node_key, int index);
+
+  /**
+   * \brief calculate the keys of all write buffer operations
+   * \param node_operation_keys: keys of the operations created by nodes,
+   * other operations only depend on their type, size and inputs.
+   */
+  static void calculate_keys(const Operations &operations,
+                             const OperationKeys &node_operation_keys);
+
+  /**
+   * \brief fill the buffers of groups that have a cached result and mark them executed
+   * \note call after the groups are initialized
+   */
+  static void restore(const Groups &groups);
+
+  /**
+   * \brief store the buffers of all completely executed groups
+   * \note call before the groups are deinitialized
+   */
+  static void store(const Groups &groups);
+
+  /**
+   * \brief free all cached results
+   */
+  static void clear();
+};
+
+#endif /* __COM_RESULTCACHE_H__ */
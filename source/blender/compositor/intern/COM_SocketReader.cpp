@@ -17,3 +17,26 @@
  */
 
 #include "COM_SocketReader.h"
+#include "COM_MemoryBuffer.h"
+
+bool SocketReader::readExecutedBuffer(float result[4], float x, float y, PixelSampler sampler)
+{
+  MemoryBuffer *buffer = this->m_executedBuffer;
+  if (buffer->isSingleElem()) {
+    memcpy(result, buffer->getBuffer(), sizeof(float) * buffer->get_num_channels());
+    return true;
+  }
+
+  /* Only whole pixels are stored, sampling in between could differ from executing. */
+  if (sampler != COM_PS_NEAREST || x != floorf(x) || y != floorf(y)) {
+    return false;
+  }
+  const int ix = (int)x;
+  const int iy = (int)y;
+  const rcti *rect = buffer->getRect();
+  if (ix < rect->xmin || ix >= rect->xmax || iy < rect->ymin || iy >= rect->ymax) {
+    return false;
+  }
+  memcpy(result, buffer->getElem(ix, iy), sizeof(float) * buffer->get_num_channels());
+  return true;
+}
@@ -50,6 +50,17 @@ class SocketReader {
    */
   unsigned int m_height;
 
+  /**
+   * \brief Result of the full-frame execution of this operation.
+   * When set, nearest reads inside its area are taken from the buffer.
+   * \see ExecutionGroup.executeBufferOperations
+   */
+  MemoryBuffer *m_executedBuffer;
+
+  SocketReader() : m_executedBuffer(0)
+  {
+  }
+
   /**
    * \brief calculate a single pixel
    * \note this method is called for non-complex
@@ -94,13 +105,27 @@ class SocketReader {
   {
   }
 
+ private:
+  /**
+   * \brief read a pixel from m_executedBuffer
+   * \return false when the buffer can't give the exact result (sampled between pixels or
+   * outside of its area), the operation is executed instead.
+   */
+  bool readExecutedBuffer(float result[4], float x, float y, PixelSampler sampler);
+
  public:
   inline void readSampled(float result[4], float x, float y, PixelSampler sampler)
   {
+    if (m_executedBuffer && readExecutedBuffer(result, x, y, sampler)) {
+      return;
+    }
     executePixelSampled(result, x, y, sampler);
   }
   inline void read(float result[4], int x, int y, void *chunkData)
   {
+    if (m_executedBuffer && readExecutedBuffer(result, x, y, COM_PS_NEAREST)) {
+      return;
+    }
     executePixel(result, x, y, chunkData);
   }
   inline void readFiltered(float result[4], float x, float y, float dx[2], float dy[2])
@@ -125,6 +150,15 @@ class SocketReader {
     return 0;
   }
 
+  void setExecutedBuffer(MemoryBuffer *buffer)
+  {
+    this->m_executedBuffer = buffer;
+  }
+  MemoryBuffer *getExecutedBuffer() const
+  {
+    return this->m_executedBuffer;
+  }
+
   inline unsigned int getWidth() const
   {
     return this->m_width;
@@ -25,6 +25,7 @@
 
 #include "COM_ExecutionSystem.h"
 #include "COM_MovieDistortionOperation.h"
+#include "COM_ResultCache.h"
 #include "COM_WorkScheduler.h"
 #include "COM_compositor.h"
 #include "clew.h"
@@ -112,9 +113,19 @@ void COM_deinitialize()
 {
   if (is_compositorMutex_init) {
     BLI_mutex_lock(&s_compositorMutex);
+    ResultCache::clear();
     WorkScheduler::deinitialize();
     is_compositorMutex_init = false;
     BLI_mutex_unlock(&s_compositorMutex);
     BLI_mutex_end(&s_compositorMutex);
   }
 }
+
+void COM_clearCaches()
+{
+  if (is_compositorMutex_init) {
+    BLI_mutex_lock(&s_compositorMutex);
+    ResultCache::clear();
+    BLI_mutex_unlock(&s_compositorMutex);
+  }
+}
@@ -41,6 +41,7 @@ ConvertValueToColorOperation::ConvertValueToColorOperation() : ConvertBaseOperat
 {
   this->addInputSocket(COM_DT_VALUE);
   this->addOutputSocket(COM_DT_COLOR);
+  this->setBufferOperation(true);
 }
 
 void ConvertValueToColorOperation::executePixelSampled(float output[4],
@@ -54,12 +55,30 @@ void ConvertValueToColorOperation::executePixelSampled(float output[4],
   output[3] = 1.0f;
 }
 
+void ConvertValueToColorOperation::executeBuffer(MemoryBuffer *output,
+                                                 const rcti *rect,
+                                                 MemoryBuffer **inputs)
+{
+  const int stride = inputs[0]->getElemStride();
+  for (int y = rect->ymin; y < rect->ymax; y++) {
+    float *out = output->getElem(rect->xmin, y);
+    const float *value = inputs[0]->getElem(rect->xmin, y);
+    for (int x = rect->xmin; x < rect->xmax; x++) {
+      out[0] = out[1] = out[2] = *value;
+      out[3] = 1.0f;
+      out += COM_NUM_CHANNELS_COLOR;
+      value += stride;
+    }
+  }
+}
+
 /* ******** Color to Value ******** */
 
 ConvertColorToValueOperation::ConvertColorToValueOperation() : ConvertBaseOperation()
 {
   this->addInputSocket(COM_DT_COLOR);
   this->addOutputSocket(COM_DT_VALUE);
+  this->setBufferOperation(true);
 }
 
 void ConvertColorToValueOperation::executePixelSampled(float output[4],
@@ -72,12 +91,29 @@ void ConvertColorToValueOperation::executePixelSampled(float output[4],
   output[0] = (inputColor[0] + inputColor[1] + inputColor[2]) / 3.0f;
 }
 
+void ConvertColorToValueOperation::executeBuffer(MemoryBuffer *output,
+                                                 const rcti *rect,
+                                                 MemoryBuffer **inputs)
+{
+  const int stride = inputs[0]->getElemStride();
+  for (int y = rect->ymin; y < rect->ymax; y++) {
+    float *out = output->getElem(rect->xmin, y);
+    const float *color = inputs[0]->getElem(rect->xmin, y);
+    for (int x = rect->xmin; x < rect->xmax; x++) {
+      *out = (color[0] + color[1] + color[2]) / 3.0f;
+      out++;
+      color += stride;
+    }
+  }
+}
+
 /* ******** Color to BW ******** */
 
 ConvertColorToBWOperation::ConvertColorToBWOperation() : ConvertBaseOperation()
 {
   this->addInputSocket(COM_DT_COLOR);
   this->addOutputSocket(COM_DT_VALUE);
+  this->setBufferOperation(true);
 }
 
 void ConvertColorToBWOperation::executePixelSampled(float output[4],
@@ -90,6 +126,22 @@ void ConvertColorToBWOperation::executePixelSampled(float output[4],
   output[0] = IMB_colormanagement_get_luminance(inputColor);
 }
 
+void ConvertColorToBWOperation::executeBuffer(MemoryBuffer *output,
+                                              const rcti *rect,
+                                              MemoryBuffer **inputs)
+{
+  const int stride = inputs[0]->getElemStride();
+  for (int y = rect->ymin; y < rect->ymax; y++) {
+    float *out = output->getElem(rect->xmin, y);
+    const float *color = inputs[0]->getElem(rect->xmin, y);
+    for (int x = rect->xmin; x < rect->xmax; x++) {
+      *out = IMB_colormanagement_get_luminance(color);
+      out++;
+      color += stride;
+    }
+  }
+}
+
 /* ******** Color to Vector ******** */
 
 ConvertColorToVectorOperation::ConvertColorToVectorOperation() : ConvertBaseOperation()
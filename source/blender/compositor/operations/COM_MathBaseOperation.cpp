@@ -20,6 +20,39 @@
 
 #include "BLI_math.h"
 
+/* Functions shared by the per pixel and the full-frame (buffer) execution. */
+
+BLI_INLINE float math_add(float a, float b)
+{
+  return a + b;
+}
+
+BLI_INLINE float math_subtract(float a, float b)
+{
+  return a - b;
+}
+
+BLI_INLINE float math_multiply(float a, float b)
+{
+  return a * b;
+}
+
+BLI_INLINE float math_divide(float a, float b)
+{
+  /* We don't want to divide by zero. */
+  return (b == 0) ? 0.0f : a / b;
+}
+
+BLI_INLINE float math_minimum(float a, float b)
+{
+  return min(a, b);
+}
+
+BLI_INLINE float math_maximum(float a, float b)
+{
+  return max(a, b);
+}
+
 MathBaseOperation::MathBaseOperation() : NodeOperation()
 {
   this->addInputSocket(COM_DT_VALUE);
@@ -79,11 +112,16 @@ void MathAddOperation::executePixelSampled(float output[4], float x, float y, Pi
   this->m_inputValue1Operation->readSampled(inputValue1, x, y, sampler);
   this->m_inputValue2Operation->readSampled(inputValue2, x, y, sampler);
 
-  output[0] = inputValue1[0] + inputValue2[0];
+  output[0] = math_add(inputValue1[0], inputValue2[0]);
 
   clampIfNeeded(output);
 }
 
+void MathAddOperation::executeBuffer(MemoryBuffer *output, const rcti *rect, MemoryBuffer **inputs)
+{
+  executeBufferBinary(output, rect, inputs, math_add);
+}
+
 void MathSubtractOperation::executePixelSampled(float output[4],
                                                 float x,
                                                 float y,
@@ -95,11 +133,18 @@ void MathSubtractOperation::executePixelSampled(float output[4],
   this->m_inputValue1Operation->readSampled(inputValue1, x, y, sampler);
   this->m_inputValue2Operation->readSampled(inputValue2, x, y, sampler);
 
-  output[0] = inputValue1[0] - inputValue2[0];
+  output[0] = math_subtract(inputValue1[0], inputValue2[0]);
 
   clampIfNeeded(output);
 }
 
+void MathSubtractOperation::executeBuffer(MemoryBuffer *output,
+                                          const rcti *rect,
+                                          MemoryBuffer **inputs)
+{
+  executeBufferBinary(output, rect, inputs, math_subtract);
+}
+
 void MathMultiplyOperation::executePixelSampled(float output[4],
                                                 float x,
                                                 float y,
@@ -111,11 +156,18 @@ void MathMultiplyOperation::executePixelSampled(float output[4],
   this->m_inputValue1Operation->readSampled(inputValue1, x, y, sampler);
   this->m_inputValue2Operation->readSampled(inputValue2, x, y, sampler);
 
-  output[0] = inputValue1[0] * inputValue2[0];
+  output[0] = math_multiply(inputValue1[0], inputValue2[0]);
 
   clampIfNeeded(output);
 }
 
+void MathMultiplyOperation::executeBuffer(MemoryBuffer *output,
+                                          const rcti *rect,
+                                          MemoryBuffer **inputs)
+{
+  executeBufferBinary(output, rect, inputs, math_multiply);
+}
+
 void MathDivideOperation::executePixelSampled(float output[4],
                                               float x,
                                               float y,
@@ -127,16 +179,18 @@ void MathDivideOperation::executePixelSampled(float output[4],
   this->m_inputValue1Operation->readSampled(inputValue1, x, y, sampler);
   this->m_inputValue2Operation->readSampled(inputValue2, x, y, sampler);
 
-  if (inputValue2[0] == 0) { /* We don't want to divide by zero. */
-    output[0] = 0.0;
-  }
-  else {
-    output[0] = inputValue1[0] / inputValue2[0];
-  }
+  output[0] = math_divide(inputValue1[0], inputValue2[0]);
 
   clampIfNeeded(output);
 }
 
+void MathDivideOperation::executeBuffer(MemoryBuffer *output,
+                                        const rcti *rect,
+                                        MemoryBuffer **inputs)
+{
+  executeBufferBinary(output, rect, inputs, math_divide);
+}
+
 void MathSineOperation::executePixelSampled(float output[4],
                                             float x,
                                             float y,
@@ -351,11 +405,18 @@ void MathMinimumOperation::executePixelSampled(float output[4],
   this->m_inputValue1Operation->readSampled(inputValue1, x, y, sampler);
   this->m_inputValue2Operation->readSampled(inputValue2, x, y, sampler);
 
-  output[0] = min(inputValue1[0], inputValue2[0]);
+  output[0] = math_minimum(inputValue1[0], inputValue2[0]);
 
   clampIfNeeded(output);
 }
 
+void MathMinimumOperation::executeBuffer(MemoryBuffer *output,
+                                         const rcti *rect,
+                                         MemoryBuffer **inputs)
+{
+  executeBufferBinary(output, rect, inputs, math_minimum);
+}
+
 void MathMaximumOperation::executePixelSampled(float output[4],
                                                float x,
                                                float y,
@@ -367,11 +428,18 @@ void MathMaximumOperation::executePixelSampled(float output[4],
   this->m_inputValue1Operation->readSampled(inputValue1, x, y, sampler);
   this->m_inputValue2Operation->readSampled(inputValue2, x, y, sampler);
 
-  output[0] = max(inputValue1[0], inputValue2[0]);
+  output[0] = math_maximum(inputValue1[0], inputValue2[0]);
 
   clampIfNeeded(output);
 }
 
+void MathMaximumOperation::executeBuffer(MemoryBuffer *output,
+                                         const rcti *rect,
+                                         MemoryBuffer **inputs)
+{
+  executeBufferBinary(output, rect, inputs, math_maximum);
+}
+
 void MathRoundOperation::executePixelSampled(float output[4],
                                              float x,
                                              float y,
@@ -43,6 +43,47 @@ class MathBaseOperation : public NodeOperation {
 
   void clampIfNeeded(float color[4]);
 
+  /**
+   * Full-frame execution of operations only using the first two inputs,
+   * calls \a math_fn(value1, value2) for every pixel of \a rect.
+   */
+  template<typename MathFunc>
+  void executeBufferBinary(MemoryBuffer *output,
+                           const rcti *rect,
+                           MemoryBuffer **inputs,
+                           MathFunc math_fn)
+  {
+    const int width = BLI_rcti_size_x(rect);
+    const int value1_stride = inputs[0]->getElemStride();
+    const int value2_stride = inputs[1]->getElemStride();
+
+    for (int y = rect->ymin; y < rect->ymax; y++) {
+      float *out = output->getElem(rect->xmin, y);
+      const float *value1 = inputs[0]->getElem(rect->xmin, y);
+      const float *value2 = inputs[1]->getElem(rect->xmin, y);
+
+      if (value1_stride == 1 && value2_stride == 1) {
+        /* Both inputs are images, keep the loop simple so it can be vectorized. */
+        for (int x = 0; x < width; x++) {
+          out[x] = math_fn(value1[x], value2[x]);
+        }
+      }
+      else {
+        for (int x = 0; x < width; x++) {
+          out[x] = math_fn(*value1, *value2);
+          value1 += value1_stride;
+          value2 += value2_stride;
+        }
+      }
+
+      if (this->m_useClamp) {
+        for (int x = 0; x < width; x++) {
+          CLAMP(out[x], 0.0f, 1.0f);
+        }
+      }
+    }
+  }
+
  public:
   /**
    * the inner loop of this program
@@ -74,29 +115,37 @@ class MathAddOperation : public MathBaseOperation {
  public:
   MathAddOperation() : MathBaseOperation()
   {
+    this->setBufferOperation(true);
   }
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void executeBuffer(MemoryBuffer *output, const rcti *rect, MemoryBuffer **inputs);
 };
 class MathSubtractOperation : public MathBaseOperation {
  public:
   MathSubtractOperation() : MathBaseOperation()
   {
+    this->setBufferOperation(true);
   }
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void executeBuffer(MemoryBuffer *output, const rcti *rect, MemoryBuffer **inputs);
 };
 class MathMultiplyOperation : public MathBaseOperation {
  public:
   MathMultiplyOperation() : MathBaseOperation()
   {
+    this->setBufferOperation(true);
   }
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void executeBuffer(MemoryBuffer *output, const rcti *rect, MemoryBuffer **inputs);
 };
 class MathDivideOperation : public MathBaseOperation {
  public:
   MathDivideOperation() : MathBaseOperation()
   {
+    this->setBufferOperation(true);
   }
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void executeBuffer(MemoryBuffer *output, const rcti *rect, MemoryBuffer **inputs);
 };
 class MathSineOperation : public MathBaseOperation {
  public:
@@ -181,15 +230,19 @@ class MathMinimumOperation : public MathBaseOperation {
  public:
   MathMinimumOperation() : MathBaseOperation()
   {
+    this->setBufferOperation(true);
   }
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void executeBuffer(MemoryBuffer *output, const rcti *rect, MemoryBuffer **inputs);
 };
 class MathMaximumOperation : public MathBaseOperation {
  public:
   MathMaximumOperation() : MathBaseOperation()
   {
+    this->setBufferOperation(true);
   }
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void executeBuffer(MemoryBuffer *output, const rcti *rect, MemoryBuffer **inputs);
 };
 class MathRoundOperation : public MathBaseOperation {
  public:
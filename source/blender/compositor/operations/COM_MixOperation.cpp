@@ -20,6 +20,179 @@
 
 #include "BLI_math.h"
 
+#ifdef __SSE2__
+#  include <emmintrin.h>
+#endif
+
+/* -------------------------------------------------------------------- */
+/** \name Mix Functions
+ *
+ * Shared by the per pixel and the full-frame (buffer) execution, so both give the same result.
+ * The alpha of the output is always the alpha of the first color.
+ * \{ */
+
+#ifdef __SSE2__
+BLI_INLINE void mix_store(float output[4], __m128 rgb, const float color1[4])
+{
+  _mm_storeu_ps(output, rgb);
+  output[3] = color1[3];
+}
+#endif
+
+BLI_INLINE void mix_add(float output[4], float value, const float color1[4], const float color2[4])
+{
+#ifdef __SSE2__
+  const __m128 c1 = _mm_loadu_ps(color1);
+  const __m128 c2 = _mm_loadu_ps(color2);
+  mix_store(output, _mm_add_ps(c1, _mm_mul_ps(_mm_set1_ps(value), c2)), color1);
+#else
+  output[0] = color1[0] + value * color2[0];
+  output[1] = color1[1] + value * color2[1];
+  output[2] = color1[2] + value * color2[2];
+  output[3] = color1[3];
+#endif
+}
+
+BLI_INLINE void mix_blend(float output[4],
+                          float value,
+                          const float color1[4],
+                          const float color2[4])
+{
+  const float valuem = 1.0f - value;
+#ifdef __SSE2__
+  const __m128 c1 = _mm_loadu_ps(color1);
+  const __m128 c2 = _mm_loadu_ps(color2);
+  mix_store(output,
+            _mm_add_ps(_mm_mul_ps(_mm_set1_ps(valuem), c1), _mm_mul_ps(_mm_set1_ps(value), c2)),
+            color1);
+#else
+  output[0] = valuem * (color1[0]) + value * (color2[0]);
+  output[1] = valuem * (color1[1]) + value * (color2[1]);
+  output[2] = valuem * (color1[2]) + value * (color2[2]);
+  output[3] = color1[3];
+#endif
+}
+
+BLI_INLINE void mix_darken(float output[4],
+                           float value,
+                           const float color1[4],
+                           const float color2[4])
+{
+  const float valuem = 1.0f - value;
+#ifdef __SSE2__
+  const __m128 c1 = _mm_loadu_ps(color1);
+  const __m128 c2 = _mm_loadu_ps(color2);
+  mix_store(output,
+            _mm_add_ps(_mm_mul_ps(_mm_min_ps(c1, c2), _mm_set1_ps(value)),
+                       _mm_mul_ps(c1, _mm_set1_ps(valuem))),
+            color1);
+#else
+  output[0] = min_ff(color1[0], color2[0]) * value + color1[0] * valuem;
+  output[1] = min_ff(color1[1], color2[1]) * value + color1[1] * valuem;
+  output[2] = min_ff(color1[2], color2[2]) * value + color1[2] * valuem;
+  output[3] = color1[3];
+#endif
+}
+
+BLI_INLINE void mix_difference(float output[4],
+                               float value,
+                               const float color1[4],
+                               const float color2[4])
+{
+  const float valuem = 1.0f - value;
+#ifdef __SSE2__
+  const __m128 c1 = _mm_loadu_ps(color1);
+  const __m128 c2 = _mm_loadu_ps(color2);
+  const __m128 diff = _mm_andnot_ps(_mm_set1_ps(-0.0f), _mm_sub_ps(c1, c2));
+  mix_store(output,
+            _mm_add_ps(_mm_mul_ps(_mm_set1_ps(valuem), c1), _mm_mul_ps(_mm_set1_ps(value), diff)),
+            color1);
+#else
+  output[0] = valuem * color1[0] + value * fabsf(color1[0] - color2[0]);
+  output[1] = valuem * color1[1] + value * fabsf(color1[1] - color2[1]);
+  output[2] = valuem * color1[2] + value * fabsf(color1[2] - color2[2]);
+  output[3] = color1[3];
+#endif
+}
+
+BLI_INLINE void mix_lighten(float output[4],
+                            float value,
+                            const float color1[4],
+                            const float color2[4])
+{
+#ifdef __SSE2__
+  const __m128 c1 = _mm_loadu_ps(color1);
+  const __m128 c2 = _mm_loadu_ps(color2);
+  mix_store(output, _mm_max_ps(_mm_mul_ps(_mm_set1_ps(value), c2), c1), color1);
+#else
+  for (int i = 0; i < 3; i++) {
+    const float tmp = value * color2[i];
+    output[i] = (tmp > color1[i]) ? tmp : color1[i];
+  }
+  output[3] = color1[3];
+#endif
+}
+
+BLI_INLINE void mix_multiply(float output[4],
+                             float value,
+                             const float color1[4],
+                             const float color2[4])
+{
+  const float valuem = 1.0f - value;
+#ifdef __SSE2__
+  const __m128 c1 = _mm_loadu_ps(color1);
+  const __m128 c2 = _mm_loadu_ps(color2);
+  mix_store(output,
+            _mm_mul_ps(c1, _mm_add_ps(_mm_set1_ps(valuem), _mm_mul_ps(_mm_set1_ps(value), c2))),
+            color1);
+#else
+  output[0] = color1[0] * (valuem + value * color2[0]);
+  output[1] = color1[1] * (valuem + value * color2[1]);
+  output[2] = color1[2] * (valuem + value * color2[2]);
+  output[3] = color1[3];
+#endif
+}
+
+BLI_INLINE void mix_screen(float output[4],
+                           float value,
+                           const float color1[4],
+                           const float color2[4])
+{
+  const float valuem = 1.0f - value;
+#ifdef __SSE2__
+  const __m128 one = _mm_set1_ps(1.0f);
+  const __m128 c1 = _mm_loadu_ps(color1);
+  const __m128 c2 = _mm_loadu_ps(color2);
+  const __m128 fac = _mm_add_ps(_mm_set1_ps(valuem),
+                                _mm_mul_ps(_mm_set1_ps(value), _mm_sub_ps(one, c2)));
+  mix_store(output, _mm_sub_ps(one, _mm_mul_ps(fac, _mm_sub_ps(one, c1))), color1);
+#else
+  output[0] = 1.0f - (valuem + value * (1.0f - color2[0])) * (1.0f - color1[0]);
+  output[1] = 1.0f - (valuem + value * (1.0f - color2[1])) * (1.0f - color1[1]);
+  output[2] = 1.0f - (valuem + value * (1.0f - color2[2])) * (1.0f - color1[2]);
+  output[3] = color1[3];
+#endif
+}
+
+BLI_INLINE void mix_subtract(float output[4],
+                             float value,
+                             const float color1[4],
+                             const float color2[4])
+{
+#ifdef __SSE2__
+  const __m128 c1 = _mm_loadu_ps(color1);
+  const __m128 c2 = _mm_loadu_ps(color2);
+  mix_store(output, _mm_sub_ps(c1, _mm_mul_ps(_mm_set1_ps(value), c2)), color1);
+#else
+  output[0] = color1[0] - value * (color2[0]);
+  output[1] = color1[1] - value * (color2[1]);
+  output[2] = color1[2] - value * (color2[2]);
+  output[3] = color1[3];
+#endif
+}
+
+/** \} */
+
 /* ******** Mix Base Operation ******** */
 
 MixBaseOperation::MixBaseOperation() : NodeOperation()
@@ -99,7 +272,7 @@ void MixBaseOperation::deinitExecution()
 
 MixAddOperation::MixAddOperation() : MixBaseOperation()
 {
-  /* pass */
+  this->setBufferOperation(true);
 }
 
 void MixAddOperation::executePixelSampled(float output[4], float x, float y, PixelSampler sampler)
@@ -116,19 +289,21 @@ void MixAddOperation::executePixelSampled(float output[4], float x, float y, Pix
   if (this->useValueAlphaMultiply()) {
     value *= inputColor2[3];
   }
-  output[0] = inputColor1[0] + value * inputColor2[0];
-  output[1] = inputColor1[1] + value * inputColor2[1];
-  output[2] = inputColor1[2] + value * inputColor2[2];
-  output[3] = inputColor1[3];
+  mix_add(output, value, inputColor1, inputColor2);
 
   clampIfNeeded(output);
 }
 
+void MixAddOperation::executeBuffer(MemoryBuffer *output, const rcti *rect, MemoryBuffer **inputs)
+{
+  executeBufferMix(output, rect, inputs, mix_add);
+}
+
 /* ******** Mix Blend Operation ******** */
 
 MixBlendOperation::MixBlendOperation() : MixBaseOperation()
 {
-  /* pass */
+  this->setBufferOperation(true);
 }
 
 void MixBlendOperation::executePixelSampled(float output[4],
@@ -149,15 +324,18 @@ void MixBlendOperation::executePixelSampled(float output[4],
   if (this->useValueAlphaMultiply()) {
     value *= inputColor2[3];
   }
-  float valuem = 1.0f - value;
-  output[0] = valuem * (inputColor1[0]) + value * (inputColor2[0]);
-  output[1] = valuem * (inputColor1[1]) + value * (inputColor2[1]);
-  output[2] = valuem * (inputColor1[2]) + value * (inputColor2[2]);
-  output[3] = inputColor1[3];
+  mix_blend(output, value, inputColor1, inputColor2);
 
   clampIfNeeded(output);
 }
 
+void MixBlendOperation::executeBuffer(MemoryBuffer *output,
+                                      const rcti *rect,
+                                      MemoryBuffer **inputs)
+{
+  executeBufferMix(output, rect, inputs, mix_blend);
+}
+
 /* ******** Mix Burn Operation ******** */
 
 MixColorBurnOperation::MixColorBurnOperation() : MixBaseOperation()
@@ -290,7 +468,7 @@ void MixColorOperation::executePixelSampled(float output[4],
 
 MixDarkenOperation::MixDarkenOperation() : MixBaseOperation()
 {
-  /* pass */
+  this->setBufferOperation(true);
 }
 
 void MixDarkenOperation::executePixelSampled(float output[4],
@@ -310,20 +488,23 @@ void MixDarkenOperation::executePixelSampled(float output[4],
   if (this->useValueAlphaMultiply()) {
     value *= inputColor2[3];
   }
-  float valuem = 1.0f - value;
-  output[0] = min_ff(inputColor1[0], inputColor2[0]) * value + inputColor1[0] * valuem;
-  output[1] = min_ff(inputColor1[1], inputColor2[1]) * value + inputColor1[1] * valuem;
-  output[2] = min_ff(inputColor1[2], inputColor2[2]) * value + inputColor1[2] * valuem;
-  output[3] = inputColor1[3];
+  mix_darken(output, value, inputColor1, inputColor2);
 
   clampIfNeeded(output);
 }
 
+void MixDarkenOperation::executeBuffer(MemoryBuffer *output,
+                                       const rcti *rect,
+                                       MemoryBuffer **inputs)
+{
+  executeBufferMix(output, rect, inputs, mix_darken);
+}
+
 /* ******** Mix Difference Operation ******** */
 
 MixDifferenceOperation::MixDifferenceOperation() : MixBaseOperation()
 {
-  /* pass */
+  this->setBufferOperation(true);
 }
 
 void MixDifferenceOperation::executePixelSampled(float output[4],
@@ -343,15 +524,18 @@ void MixDifferenceOperation::executePixelSampled(float output[4],
   if (this->useValueAlphaMultiply()) {
     value *= inputColor2[3];
   }
-  float valuem = 1.0f - value;
-  output[0] = valuem * inputColor1[0] + value * fabsf(inputColor1[0] - inputColor2[0]);
-  output[1] = valuem * inputColor1[1] + value * fabsf(inputColor1[1] - inputColor2[1]);
-  output[2] = valuem * inputColor1[2] + value * fabsf(inputColor1[2] - inputColor2[2]);
-  output[3] = inputColor1[3];
+  mix_difference(output, value, inputColor1, inputColor2);
 
   clampIfNeeded(output);
 }
 
+void MixDifferenceOperation::executeBuffer(MemoryBuffer *output,
+                                           const rcti *rect,
+                                           MemoryBuffer **inputs)
+{
+  executeBufferMix(output, rect, inputs, mix_difference);
+}
+
 /* ******** Mix Difference Operation ******** */
 
 MixDivideOperation::MixDivideOperation() : MixBaseOperation()
@@ -577,7 +761,7 @@ void MixHueOperation::executePixelSampled(float output[4], float x, float y, Pix
 
 MixLightenOperation::MixLightenOperation() : MixBaseOperation()
 {
-  /* pass */
+  this->setBufferOperation(true);
 }
 
 void MixLightenOperation::executePixelSampled(float output[4],
@@ -597,33 +781,18 @@ void MixLightenOperation::executePixelSampled(float output[4],
   if (this->useValueAlphaMultiply()) {
     value *= inputColor2[3];
   }
-  float tmp;
-  tmp = value * inputColor2[0];
-  if (tmp > inputColor1[0]) {
-    output[0] = tmp;
-  }
-  else {
-    output[0] = inputColor1[0];
-  }
-  tmp = value * inputColor2[1];
-  if (tmp > inputColor1[1]) {
-    output[1] = tmp;
-  }
-  else {
-    output[1] = inputColor1[1];
-  }
-  tmp = value * inputColor2[2];
-  if (tmp > inputColor1[2]) {
-    output[2] = tmp;
-  }
-  else {
-    output[2] = inputColor1[2];
-  }
-  output[3] = inputColor1[3];
+  mix_lighten(output, value, inputColor1, inputColor2);
 
   clampIfNeeded(output);
 }
 
+void MixLightenOperation::executeBuffer(MemoryBuffer *output,
+                                        const rcti *rect,
+                                        MemoryBuffer **inputs)
+{
+  executeBufferMix(output, rect, inputs, mix_lighten);
+}
+
 /* ******** Mix Linear Light Operation ******** */
 
 MixLinearLightOperation::MixLinearLightOperation() : MixBaseOperation()
@@ -676,7 +845,7 @@ void MixLinearLightOperation::executePixelSampled(float output[4],
 
 MixMultiplyOperation::MixMultiplyOperation() : MixBaseOperation()
 {
-  /* pass */
+  this->setBufferOperation(true);
 }
 
 void MixMultiplyOperation::executePixelSampled(float output[4],
@@ -696,15 +865,18 @@ void MixMultiplyOperation::executePixelSampled(float output[4],
   if (this->useValueAlphaMultiply()) {
     value *= inputColor2[3];
   }
-  float valuem = 1.0f - value;
-  output[0] = inputColor1[0] * (valuem + value * inputColor2[0]);
-  output[1] = inputColor1[1] * (valuem + value * inputColor2[1]);
-  output[2] = inputColor1[2] * (valuem + value * inputColor2[2]);
-  output[3] = inputColor1[3];
+  mix_multiply(output, value, inputColor1, inputColor2);
 
   clampIfNeeded(output);
 }
 
+void MixMultiplyOperation::executeBuffer(MemoryBuffer *output,
+                                         const rcti *rect,
+                                         MemoryBuffer **inputs)
+{
+  executeBufferMix(output, rect, inputs, mix_multiply);
+}
+
 /* ******** Mix Ovelray Operation ******** */
 
 MixOverlayOperation::MixOverlayOperation() : MixBaseOperation()
@@ -801,7 +973,7 @@ void MixSaturationOperation::executePixelSampled(float output[4],
 
 MixScreenOperation::MixScreenOperation() : MixBaseOperation()
 {
-  /* pass */
+  this->setBufferOperation(true);
 }
 
 void MixScreenOperation::executePixelSampled(float output[4],
@@ -821,16 +993,18 @@ void MixScreenOperation::executePixelSampled(float output[4],
   if (this->useValueAlphaMultiply()) {
     value *= inputColor2[3];
   }
-  float valuem = 1.0f - value;
-
-  output[0] = 1.0f - (valuem + value * (1.0f - inputColor2[0])) * (1.0f - inputColor1[0]);
-  output[1] = 1.0f - (valuem + value * (1.0f - inputColor2[1])) * (1.0f - inputColor1[1]);
-  output[2] = 1.0f - (valuem + value * (1.0f - inputColor2[2])) * (1.0f - inputColor1[2]);
-  output[3] = inputColor1[3];
+  mix_screen(output, value, inputColor1, inputColor2);
 
   clampIfNeeded(output);
 }
 
+void MixScreenOperation::executeBuffer(MemoryBuffer *output,
+                                       const rcti *rect,
+                                       MemoryBuffer **inputs)
+{
+  executeBufferMix(output, rect, inputs, mix_screen);
+}
+
 /* ******** Mix Soft Light Operation ******** */
 
 MixSoftLightOperation::MixSoftLightOperation() : MixBaseOperation()
@@ -881,7 +1055,7 @@ void MixSoftLightOperation::executePixelSampled(float output[4],
 
 MixSubtractOperation::MixSubtractOperation() : MixBaseOperation()
 {
-  /* pass */
+  this->setBufferOperation(true);
 }
 
 void MixSubtractOperation::executePixelSampled(float output[4],
@@ -901,14 +1075,18 @@ void MixSubtractOperation::executePixelSampled(float output[4],
   if (this->useValueAlphaMultiply()) {
     value *= inputColor2[3];
   }
-  output[0] = inputColor1[0] - value * (inputColor2[0]);
-  output[1] = inputColor1[1] - value * (inputColor2[1]);
-  output[2] = inputColor1[2] - value * (inputColor2[2]);
-  output[3] = inputColor1[3];
+  mix_subtract(output, value, inputColor1, inputColor2);
 
   clampIfNeeded(output);
 }
 
+void MixSubtractOperation::executeBuffer(MemoryBuffer *output,
+                                         const rcti *rect,
+                                         MemoryBuffer **inputs)
+{
+  executeBufferMix(output, rect, inputs, mix_subtract);
+}
+
 /* ******** Mix Value Operation ******** */
 
 MixValueOperation::MixValueOperation() : MixBaseOperation()
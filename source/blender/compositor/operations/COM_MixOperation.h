@@ -43,6 +43,38 @@ class MixBaseOperation : public NodeOperation {
     }
   }
 
+  /**
+   * Full-frame execution, calls \a mix_fn(output, value, color1, color2) for every pixel of
+   * \a rect. The value is already multiplied with the alpha of color2 when needed.
+   */
+  template<typename MixFunc>
+  void executeBufferMix(MemoryBuffer *output,
+                        const rcti *rect,
+                        MemoryBuffer **inputs,
+                        MixFunc mix_fn)
+  {
+    const int value_stride = inputs[0]->getElemStride();
+    const int color1_stride = inputs[1]->getElemStride();
+    const int color2_stride = inputs[2]->getElemStride();
+    const bool value_alpha_multiply = this->m_valueAlphaMultiply;
+
+    for (int y = rect->ymin; y < rect->ymax; y++) {
+      float *out = output->getElem(rect->xmin, y);
+      const float *value = inputs[0]->getElem(rect->xmin, y);
+      const float *color1 = inputs[1]->getElem(rect->xmin, y);
+      const float *color2 = inputs[2]->getElem(rect->xmin, y);
+      for (int x = rect->xmin; x < rect->xmax; x++) {
+        const float fac = value_alpha_multiply ? value[0] * color2[3] : value[0];
+        mix_fn(out, fac, color1, color2);
+        clampIfNeeded(out);
+        out += COM_NUM_CHANNELS_COLOR;
+        value += value_stride;
+        color1 += color1_stride;
+        color2 += color2_stride;
+      }
+    }
+  }
+
  public:
   /**
    * Default constructor
@@ -84,12 +116,14 @@ class MixAddOperation : public MixBaseOperation {
  public:
   MixAddOperation();
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void executeBuffer(MemoryBuffer *output, const rcti *rect, MemoryBuffer **inputs);
 };
 
 class MixBlendOperation : public MixBaseOperation {
  public:
   MixBlendOperation();
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void executeBuffer(MemoryBuffer *output, const rcti *rect, MemoryBuffer **inputs);
 };
 
 class MixColorBurnOperation : public MixBaseOperation {
@@ -108,12 +142,14 @@ class MixDarkenOperation : public MixBaseOperation {
  public:
   MixDarkenOperation();
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void executeBuffer(MemoryBuffer *output, const rcti *rect, MemoryBuffer **inputs);
 };
 
 class MixDifferenceOperation : public MixBaseOperation {
  public:
   MixDifferenceOperation();
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void executeBuffer(MemoryBuffer *output, const rcti *rect, MemoryBuffer **inputs);
 };
 
 class MixDivideOperation : public MixBaseOperation {
@@ -144,6 +180,7 @@ class MixLightenOperation : public MixBaseOperation {
  public:
   MixLightenOperation();
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void executeBuffer(MemoryBuffer *output, const rcti *rect, MemoryBuffer **inputs);
 };
 
 class MixLinearLightOperation : public MixBaseOperation {
@@ -156,6 +193,7 @@ class MixMultiplyOperation : public MixBaseOperation {
  public:
   MixMultiplyOperation();
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void executeBuffer(MemoryBuffer *output, const rcti *rect, MemoryBuffer **inputs);
 };
 
 class MixOverlayOperation : public MixBaseOperation {
@@ -174,6 +212,7 @@ class MixScreenOperation : public MixBaseOperation {
  public:
   MixScreenOperation();
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void executeBuffer(MemoryBuffer *output, const rcti *rect, MemoryBuffer **inputs);
 };
 
 class MixSoftLightOperation : public MixBaseOperation {
@@ -186,6 +225,7 @@ class MixSubtractOperation : public MixBaseOperation {
  public:
   MixSubtractOperation();
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void executeBuffer(MemoryBuffer *output, const rcti *rect, MemoryBuffer **inputs);
 };
 
 class MixValueOperation : public MixBaseOperation {
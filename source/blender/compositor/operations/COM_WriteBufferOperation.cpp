@@ -27,6 +27,8 @@ WriteBufferOperation::WriteBufferOperation(DataType datatype) : NodeOperation()
   this->m_memoryProxy = new MemoryProxy(datatype);
   this->m_memoryProxy->setWriteBufferOperation(this);
   this->m_memoryProxy->setExecutor(NULL);
+  this->m_cacheKey.hash[0] = this->m_cacheKey.hash[1] = 0;
+  this->m_cacheKey.is_valid = false;
 }
 WriteBufferOperation::~WriteBufferOperation()
 {
@@ -21,6 +21,7 @@
 
 #include "COM_MemoryProxy.h"
 #include "COM_NodeOperation.h"
+#include "COM_ResultCache.h"
 #include "COM_SocketReader.h"
 /**
  * \brief NodeOperation to write to a tile
@@ -30,6 +31,8 @@ class WriteBufferOperation : public NodeOperation {
   MemoryProxy *m_memoryProxy;
   bool m_single_value; /* single value stored in buffer */
   NodeOperation *m_input;
+  /** Key of the buffer in the ResultCache. */
+  ResultCacheKey m_cacheKey;
 
  public:
   WriteBufferOperation(DataType datatype);
@@ -62,5 +65,13 @@ class WriteBufferOperation : public NodeOperation {
   {
     return m_input;
   }
+  void setCacheKey(const ResultCacheKey &key)
+  {
+    this->m_cacheKey = key;
+  }
+  const ResultCacheKey &getCacheKey() const
+  {
+    return this->m_cacheKey;
+  }
 };
 #endif
@@ -995,6 +995,12 @@ static void graph_draw_driver_settings_panel(uiLayout *layout,
       else {
         uiItemL(col, TIP_("Slow Python expression"), ICON_INFO);
       }
+
+      /* Tell why, so the expression can be changed to avoid Python. */
+      const char *simple_expr_error = BKE_driver_simple_expression_error(driver);
+      if (simple_expr_error) {
+        uiItemL(col, simple_expr_error, ICON_BLANK1);
+      }
     }
 
     /* Explicit bpy-references are evil. Warn about these to prevent errors */
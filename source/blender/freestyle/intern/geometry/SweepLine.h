@@ -262,8 +262,34 @@ template<class T, class Point> class SweepLine {
                   real epsilon)
   {
     real t, u;
+    for (typename std::list<Segment<T, Point> *>::iterator s = _set.begin(), send = _set.end();
+         s != send;
+         s++) {
+      Segment<T, Point> *currentS = (*s);
+      if (intersect(S, currentS, binrule, epsilon, t, u)) {
+        addIntersection(S, t, currentS, u);
+      }
+    }
+    // add the added segment to the list of active segments
+    _set.push_back(S);
+  }
+
+  /*! Tests the intersection of a segment added to the sweep line with an active segment.
+   *  Returns true if they intersect, with the intersection parameters in t and u.
+   */
+  static inline bool intersect(Segment<T, Point> *S,
+                               Segment<T, Point> *currentS,
+                               binary_rule<Segment<T, Point>, Segment<T, Point>> &binrule,
+                               real epsilon,
+                               real &t,
+                               real &u)
+  {
     Point CP;
     Vec2r v0, v1, v2, v3;
+    if (true != binrule(*S, *currentS)) {
+      return false;
+    }
+
     if (true == S->order()) {
       v0[0] = ((*S)[0])[0];
       v0[1] = ((*S)[0])[1];
@@ -276,52 +302,51 @@ template<class T, class Point> class SweepLine {
       v0[0] = ((*S)[1])[0];
       v0[1] = ((*S)[1])[1];
     }
-    for (typename std::list<Segment<T, Point> *>::iterator s = _set.begin(), send = _set.end();
-         s != send;
-         s++) {
-      Segment<T, Point> *currentS = (*s);
-      if (true != binrule(*S, *currentS)) {
-        continue;
-      }
+    if (true == currentS->order()) {
+      v2[0] = ((*currentS)[0])[0];
+      v2[1] = ((*currentS)[0])[1];
+      v3[0] = ((*currentS)[1])[0];
+      v3[1] = ((*currentS)[1])[1];
+    }
+    else {
+      v3[0] = ((*currentS)[0])[0];
+      v3[1] = ((*currentS)[0])[1];
+      v2[0] = ((*currentS)[1])[0];
+      v2[1] = ((*currentS)[1])[1];
+    }
+    if (S->CommonVertex(*currentS, CP)) {
+      return false;  // the two edges have a common vertex->no need to check
+    }
 
-      if (true == currentS->order()) {
-        v2[0] = ((*currentS)[0])[0];
-        v2[1] = ((*currentS)[0])[1];
-        v3[0] = ((*currentS)[1])[0];
-        v3[1] = ((*currentS)[1])[1];
-      }
-      else {
-        v3[0] = ((*currentS)[0])[0];
-        v3[1] = ((*currentS)[0])[1];
-        v2[0] = ((*currentS)[1])[0];
-        v2[1] = ((*currentS)[1])[1];
-      }
-      if (S->CommonVertex(*currentS, CP)) {
-        continue;  // the two edges have a common vertex->no need to check
-      }
+    return GeomUtils::intersect2dSeg2dSegParametric(v0, v1, v2, v3, t, u, epsilon) ==
+           GeomUtils::DO_INTERSECT;
+  }
 
-      if (GeomUtils::intersect2dSeg2dSegParametric(v0, v1, v2, v3, t, u, epsilon) ==
-          GeomUtils::DO_INTERSECT) {
-        // create the intersection
-        Intersection<Segment<T, Point>> *inter = new Intersection<Segment<T, Point>>(
-            S, t, currentS, u);
-        // add it to the intersections list
-        _Intersections.push_back(inter);
-        // add this intersection to the first edge intersections list
-        S->AddIntersection(inter);
-        // add this intersection to the second edge intersections list
-        currentS->AddIntersection(inter);
-      }
-    }
-    // add the added segment to the list of active segments
-    _set.push_back(S);
+  /*! Records the intersection of two segments, S being the one added last. */
+  inline void addIntersection(Segment<T, Point> *S, real t, Segment<T, Point> *currentS, real u)
+  {
+    // create the intersection
+    Intersection<Segment<T, Point>> *inter = new Intersection<Segment<T, Point>>(
+        S, t, currentS, u);
+    // add it to the intersections list
+    _Intersections.push_back(inter);
+    // add this intersection to the first edge intersections list
+    S->AddIntersection(inter);
+    // add this intersection to the second edge intersections list
+    currentS->AddIntersection(inter);
   }
 
-  inline void remove(Segment<T, Point> *s)
+  /*! Records a segment that left the sweep line as intersected, if it has intersections. */
+  inline void addIntersectedEdge(Segment<T, Point> *s)
   {
     if (s->intersections().size() > 0) {
       _IntersectedEdges.push_back(s);
     }
+  }
+
+  inline void remove(Segment<T, Point> *s)
+  {
+    addIntersectedEdge(s);
     _set.remove(s);
   }
 
@@ -20,9 +20,11 @@
  */
 
 #include <algorithm>
+#include <climits>
 #include <memory>
 #include <sstream>
 #include <stdexcept>
+#include <unordered_map>
 
 #include "FRS_freestyle.h"
 
@@ -40,6 +42,13 @@
 
 #include "BKE_global.h"
 
+#include "BLI_task.h"
+#include "BLI_threads.h"
+
+#include "PIL_time.h"
+
+#include "atomic_ops.h"
+
 namespace Freestyle {
 
 // XXX Grmll... G is used as template's typename parameter :/
@@ -433,222 +442,194 @@ static int computeVisibility(ViewMap *viewMap,
 // QI <= 22.
 
 template<typename G, typename I>
-static void computeCumulativeVisibility(ViewMap *ioViewMap,
-                                        G &grid,
-                                        real epsilon,
-                                        RenderMonitor *iRenderMonitor)
+static void computeViewEdgeCumulativeVisibility(ViewMap *ioViewMap,
+                                                ViewEdge *ve,
+                                                G &grid,
+                                                real epsilon)
 {
-  vector<ViewEdge *> &vedges = ioViewMap->ViewEdges();
-
   FEdge *fe, *festart;
   int nSamples = 0;
   vector<WFace *> wFaces;
   WFace *wFace = NULL;
-  unsigned cnt = 0;
-  unsigned cntStep = (unsigned)ceil(0.01f * vedges.size());
   unsigned tmpQI = 0;
   unsigned qiClasses[256];
   unsigned maxIndex, maxCard;
   unsigned qiMajority;
-  for (vector<ViewEdge *>::iterator ve = vedges.begin(), veend = vedges.end(); ve != veend; ve++) {
-    if (iRenderMonitor) {
-      if (iRenderMonitor->testBreak()) {
-        break;
-      }
-      if (cnt % cntStep == 0) {
-        stringstream ss;
-        ss << "Freestyle: Visibility computations " << (100 * cnt / vedges.size()) << "%";
-        iRenderMonitor->setInfo(ss.str());
-        iRenderMonitor->progress((float)cnt / vedges.size());
-      }
-      cnt++;
-    }
+
+#if LOGGING
+  if (_global.debug & G_DEBUG_FREESTYLE) {
+    cout << "Processing ViewEdge " << ve->getId() << endl;
+  }
+#endif
+  // Find an edge to test
+  if (!ve->isInImage()) {
+    // This view edge has been proscenium culled
+    ve->setQI(255);
+    ve->setaShape(0);
 #if LOGGING
     if (_global.debug & G_DEBUG_FREESTYLE) {
-      cout << "Processing ViewEdge " << (*ve)->getId() << endl;
+      cout << "\tCulled." << endl;
     }
 #endif
-    // Find an edge to test
-    if (!(*ve)->isInImage()) {
-      // This view edge has been proscenium culled
-      (*ve)->setQI(255);
-      (*ve)->setaShape(0);
+    return;
+  }
+
+  // Test edge
+  festart = ve->fedgeA();
+  fe = ve->fedgeA();
+  qiMajority = 0;
+  do {
+    if (fe != NULL && fe->isInImage()) {
+      qiMajority++;
+    }
+    fe = fe->nextEdge();
+  } while (fe && fe != festart);
+
+  if (qiMajority == 0) {
+    // There are no occludable FEdges on this ViewEdge
+    // This should be impossible.
+    if (_global.debug & G_DEBUG_FREESTYLE) {
+      cout << "View Edge in viewport without occludable FEdges: " << ve->getId() << endl;
+    }
+    // We can recover from this error:
+    // Treat this edge as fully visible with no occludee
+    ve->setQI(0);
+    ve->setaShape(0);
+    return;
+  }
+  else {
+    ++qiMajority;
+    qiMajority >>= 1;
+  }
 #if LOGGING
-      if (_global.debug & G_DEBUG_FREESTYLE) {
-        cout << "\tCulled." << endl;
-      }
+  if (_global.debug & G_DEBUG_FREESTYLE) {
+    cout << "\tqiMajority: " << qiMajority << endl;
+  }
 #endif
-      continue;
-    }
 
-    // Test edge
-    festart = (*ve)->fedgeA();
-    fe = (*ve)->fedgeA();
-    qiMajority = 0;
-    do {
-      if (fe != NULL && fe->isInImage()) {
-        qiMajority++;
-      }
-      fe = fe->nextEdge();
-    } while (fe && fe != festart);
+  tmpQI = 0;
+  maxIndex = 0;
+  maxCard = 0;
+  nSamples = 0;
+  memset(qiClasses, 0, 256 * sizeof(*qiClasses));
+  set<ViewShape *> foundOccluders;
 
-    if (qiMajority == 0) {
-      // There are no occludable FEdges on this ViewEdge
-      // This should be impossible.
-      if (_global.debug & G_DEBUG_FREESTYLE) {
-        cout << "View Edge in viewport without occludable FEdges: " << (*ve)->getId() << endl;
-      }
-      // We can recover from this error:
-      // Treat this edge as fully visible with no occludee
-      (*ve)->setQI(0);
-      (*ve)->setaShape(0);
+  fe = ve->fedgeA();
+  do {
+    if (!fe || !fe->isInImage()) {
+      fe = fe->nextEdge();
       continue;
     }
-    else {
-      ++qiMajority;
-      qiMajority >>= 1;
-    }
+    if ((maxCard < qiMajority)) {
+      // ARB: change &wFace to wFace and use reference in called function
+      tmpQI = computeVisibility<G, I>(ioViewMap, fe, grid, epsilon, ve, &wFace, &foundOccluders);
 #if LOGGING
-    if (_global.debug & G_DEBUG_FREESTYLE) {
-      cout << "\tqiMajority: " << qiMajority << endl;
-    }
+      if (_global.debug & G_DEBUG_FREESTYLE) {
+        cout << "\tFEdge: visibility " << tmpQI << endl;
+      }
 #endif
 
-    tmpQI = 0;
-    maxIndex = 0;
-    maxCard = 0;
-    nSamples = 0;
-    memset(qiClasses, 0, 256 * sizeof(*qiClasses));
-    set<ViewShape *> foundOccluders;
+      // ARB: This is an error condition, not an alert condition.
+      // Some sort of recovery or abort is necessary.
+      if (tmpQI >= 256) {
+        cerr << "Warning: too many occluding levels" << endl;
+        // ARB: Wild guess: instead of aborting or corrupting memory, treat as tmpQI == 255
+        tmpQI = 255;
+      }
 
-    fe = (*ve)->fedgeA();
-    do {
-      if (!fe || !fe->isInImage()) {
-        fe = fe->nextEdge();
-        continue;
+      if (++qiClasses[tmpQI] > maxCard) {
+        maxCard = qiClasses[tmpQI];
+        maxIndex = tmpQI;
       }
-      if ((maxCard < qiMajority)) {
-        // ARB: change &wFace to wFace and use reference in called function
-        tmpQI = computeVisibility<G, I>(
-            ioViewMap, fe, grid, epsilon, *ve, &wFace, &foundOccluders);
+    }
+    else {
+      // ARB: FindOccludee is redundant if ComputeRayCastingVisibility has been called
+      // ARB: change &wFace to wFace and use reference in called function
+      findOccludee<G, I>(fe, grid, epsilon, ve, &wFace);
 #if LOGGING
-        if (_global.debug & G_DEBUG_FREESTYLE) {
-          cout << "\tFEdge: visibility " << tmpQI << endl;
-        }
+      if (_global.debug & G_DEBUG_FREESTYLE) {
+        cout << "\tFEdge: occludee only (" << (wFace != NULL ? "found" : "not found") << ")"
+             << endl;
+      }
 #endif
+    }
 
-        // ARB: This is an error condition, not an alert condition.
-        // Some sort of recovery or abort is necessary.
-        if (tmpQI >= 256) {
-          cerr << "Warning: too many occluding levels" << endl;
-          // ARB: Wild guess: instead of aborting or corrupting memory, treat as tmpQI == 255
-          tmpQI = 255;
-        }
-
-        if (++qiClasses[tmpQI] > maxCard) {
-          maxCard = qiClasses[tmpQI];
-          maxIndex = tmpQI;
-        }
+    // Store test results
+    if (wFace) {
+      vector<Vec3r> vertices;
+      for (int i = 0, numEdges = wFace->numberOfEdges(); i < numEdges; ++i) {
+        vertices.push_back(Vec3r(wFace->GetVertex(i)->GetVertex()));
       }
-      else {
-        // ARB: FindOccludee is redundant if ComputeRayCastingVisibility has been called
-        // ARB: change &wFace to wFace and use reference in called function
-        findOccludee<G, I>(fe, grid, epsilon, *ve, &wFace);
+      Polygon3r poly(vertices, wFace->GetNormal());
+      poly.userdata = (void *)wFace;
+      fe->setaFace(poly);
+      wFaces.push_back(wFace);
+      fe->setOccludeeEmpty(false);
 #if LOGGING
-        if (_global.debug & G_DEBUG_FREESTYLE) {
-          cout << "\tFEdge: occludee only (" << (wFace != NULL ? "found" : "not found") << ")"
-               << endl;
-        }
-#endif
+      if (_global.debug & G_DEBUG_FREESTYLE) {
+        cout << "\tFound occludee" << endl;
       }
-
-      // Store test results
-      if (wFace) {
-        vector<Vec3r> vertices;
-        for (int i = 0, numEdges = wFace->numberOfEdges(); i < numEdges; ++i) {
-          vertices.push_back(Vec3r(wFace->GetVertex(i)->GetVertex()));
-        }
-        Polygon3r poly(vertices, wFace->GetNormal());
-        poly.userdata = (void *)wFace;
-        fe->setaFace(poly);
-        wFaces.push_back(wFace);
-        fe->setOccludeeEmpty(false);
-#if LOGGING
-        if (_global.debug & G_DEBUG_FREESTYLE) {
-          cout << "\tFound occludee" << endl;
-        }
 #endif
-      }
-      else {
-        fe->setOccludeeEmpty(true);
-      }
+    }
+    else {
+      fe->setOccludeeEmpty(true);
+    }
 
-      ++nSamples;
-      fe = fe->nextEdge();
-    } while ((maxCard < qiMajority) && (fe) && (fe != festart));
+    ++nSamples;
+    fe = fe->nextEdge();
+  } while ((maxCard < qiMajority) && (fe) && (fe != festart));
 
 #if LOGGING
-    if (_global.debug & G_DEBUG_FREESTYLE) {
-      cout << "\tFinished with " << nSamples << " samples, maxCard = " << maxCard << endl;
-    }
+  if (_global.debug & G_DEBUG_FREESTYLE) {
+    cout << "\tFinished with " << nSamples << " samples, maxCard = " << maxCard << endl;
+  }
 #endif
 
-    // ViewEdge
-    // qi --
-    // Find the minimum value that is >= the majority of the QI
-    for (unsigned count = 0, i = 0; i < 256; ++i) {
-      count += qiClasses[i];
-      if (count >= qiMajority) {
-        (*ve)->setQI(i);
-        break;
-      }
-    }
-    // occluders --
-    // I would rather not have to go through the effort of creating this set and then copying out
-    // its contents. Is there a reason why ViewEdge::_Occluders cannot be converted to a set<>?
-    for (set<ViewShape *>::iterator o = foundOccluders.begin(), oend = foundOccluders.end();
-         o != oend;
-         ++o) {
-      (*ve)->AddOccluder((*o));
+  // ViewEdge
+  // qi --
+  // Find the minimum value that is >= the majority of the QI
+  for (unsigned count = 0, i = 0; i < 256; ++i) {
+    count += qiClasses[i];
+    if (count >= qiMajority) {
+      ve->setQI(i);
+      break;
     }
+  }
+  // occluders --
+  // I would rather not have to go through the effort of creating this set and then copying out
+  // its contents. Is there a reason why ViewEdge::_Occluders cannot be converted to a set<>?
+  for (set<ViewShape *>::iterator o = foundOccluders.begin(), oend = foundOccluders.end();
+       o != oend;
+       ++o) {
+    ve->AddOccluder((*o));
+  }
 #if LOGGING
-    if (_global.debug & G_DEBUG_FREESTYLE) {
-      cout << "\tConclusion: QI = " << maxIndex << ", " << (*ve)->occluders_size() << " occluders."
-           << endl;
-    }
+  if (_global.debug & G_DEBUG_FREESTYLE) {
+    cout << "\tConclusion: QI = " << maxIndex << ", " << ve->occluders_size() << " occluders."
+         << endl;
+  }
 #else
-    (void)maxIndex;
+  (void)maxIndex;
 #endif
-    // occludee --
-    if (!wFaces.empty()) {
-      if (wFaces.size() <= (float)nSamples / 2.0f) {
-        (*ve)->setaShape(0);
-      }
-      else {
-        ViewShape *vshape = ioViewMap->viewShape(
-            (*wFaces.begin())->GetVertex(0)->shape()->GetId());
-        (*ve)->setaShape(vshape);
-      }
+  // occludee --
+  if (!wFaces.empty()) {
+    if (wFaces.size() <= (float)nSamples / 2.0f) {
+      ve->setaShape(0);
+    }
+    else {
+      ViewShape *vshape = ioViewMap->viewShape(
+          (*wFaces.begin())->GetVertex(0)->shape()->GetId());
+      ve->setaShape(vshape);
     }
-
-    wFaces.clear();
-  }
-  if (iRenderMonitor && vedges.size()) {
-    stringstream ss;
-    ss << "Freestyle: Visibility computations " << (100 * cnt / vedges.size()) << "%";
-    iRenderMonitor->setInfo(ss.str());
-    iRenderMonitor->progress((float)cnt / vedges.size());
   }
 }
 
 template<typename G, typename I>
-static void computeDetailedVisibility(ViewMap *ioViewMap,
-                                      G &grid,
-                                      real epsilon,
-                                      RenderMonitor *iRenderMonitor)
+static void computeViewEdgeDetailedVisibility(ViewMap *ioViewMap,
+                                              ViewEdge *ve,
+                                              G &grid,
+                                              real epsilon)
 {
-  vector<ViewEdge *> &vedges = ioViewMap->ViewEdges();
-
   FEdge *fe, *festart;
   int nSamples = 0;
   vector<WFace *> wFaces;
@@ -657,173 +638,280 @@ static void computeDetailedVisibility(ViewMap *ioViewMap,
   unsigned qiClasses[256];
   unsigned maxIndex, maxCard;
   unsigned qiMajority;
-  for (vector<ViewEdge *>::iterator ve = vedges.begin(), veend = vedges.end(); ve != veend; ve++) {
-    if (iRenderMonitor && iRenderMonitor->testBreak()) {
-      break;
-    }
+
+#if LOGGING
+  if (_global.debug & G_DEBUG_FREESTYLE) {
+    cout << "Processing ViewEdge " << ve->getId() << endl;
+  }
+#endif
+  // Find an edge to test
+  if (!ve->isInImage()) {
+    // This view edge has been proscenium culled
+    ve->setQI(255);
+    ve->setaShape(0);
 #if LOGGING
     if (_global.debug & G_DEBUG_FREESTYLE) {
-      cout << "Processing ViewEdge " << (*ve)->getId() << endl;
+      cout << "\tCulled." << endl;
     }
 #endif
-    // Find an edge to test
-    if (!(*ve)->isInImage()) {
-      // This view edge has been proscenium culled
-      (*ve)->setQI(255);
-      (*ve)->setaShape(0);
+    return;
+  }
+
+  // Test edge
+  festart = ve->fedgeA();
+  fe = ve->fedgeA();
+  qiMajority = 0;
+  do {
+    if (fe != NULL && fe->isInImage()) {
+      qiMajority++;
+    }
+    fe = fe->nextEdge();
+  } while (fe && fe != festart);
+
+  if (qiMajority == 0) {
+    // There are no occludable FEdges on this ViewEdge
+    // This should be impossible.
+    if (_global.debug & G_DEBUG_FREESTYLE) {
+      cout << "View Edge in viewport without occludable FEdges: " << ve->getId() << endl;
+    }
+    // We can recover from this error:
+    // Treat this edge as fully visible with no occludee
+    ve->setQI(0);
+    ve->setaShape(0);
+    return;
+  }
+  else {
+    ++qiMajority;
+    qiMajority >>= 1;
+  }
 #if LOGGING
-      if (_global.debug & G_DEBUG_FREESTYLE) {
-        cout << "\tCulled." << endl;
-      }
+  if (_global.debug & G_DEBUG_FREESTYLE) {
+    cout << "\tqiMajority: " << qiMajority << endl;
+  }
 #endif
+
+  tmpQI = 0;
+  maxIndex = 0;
+  maxCard = 0;
+  nSamples = 0;
+  memset(qiClasses, 0, 256 * sizeof(*qiClasses));
+  set<ViewShape *> foundOccluders;
+
+  fe = ve->fedgeA();
+  do {
+    if (fe == NULL || !fe->isInImage()) {
+      fe = fe->nextEdge();
       continue;
     }
+    if ((maxCard < qiMajority)) {
+      // ARB: change &wFace to wFace and use reference in called function
+      tmpQI = computeVisibility<G, I>(ioViewMap, fe, grid, epsilon, ve, &wFace, &foundOccluders);
+#if LOGGING
+      if (_global.debug & G_DEBUG_FREESTYLE) {
+        cout << "\tFEdge: visibility " << tmpQI << endl;
+      }
+#endif
 
-    // Test edge
-    festart = (*ve)->fedgeA();
-    fe = (*ve)->fedgeA();
-    qiMajority = 0;
-    do {
-      if (fe != NULL && fe->isInImage()) {
-        qiMajority++;
+      // ARB: This is an error condition, not an alert condition.
+      // Some sort of recovery or abort is necessary.
+      if (tmpQI >= 256) {
+        cerr << "Warning: too many occluding levels" << endl;
+        // ARB: Wild guess: instead of aborting or corrupting memory, treat as tmpQI == 255
+        tmpQI = 255;
       }
-      fe = fe->nextEdge();
-    } while (fe && fe != festart);
 
-    if (qiMajority == 0) {
-      // There are no occludable FEdges on this ViewEdge
-      // This should be impossible.
-      if (_global.debug & G_DEBUG_FREESTYLE) {
-        cout << "View Edge in viewport without occludable FEdges: " << (*ve)->getId() << endl;
+      if (++qiClasses[tmpQI] > maxCard) {
+        maxCard = qiClasses[tmpQI];
+        maxIndex = tmpQI;
       }
-      // We can recover from this error:
-      // Treat this edge as fully visible with no occludee
-      (*ve)->setQI(0);
-      (*ve)->setaShape(0);
-      continue;
     }
     else {
-      ++qiMajority;
-      qiMajority >>= 1;
-    }
+      // ARB: FindOccludee is redundant if ComputeRayCastingVisibility has been called
+      // ARB: change &wFace to wFace and use reference in called function
+      findOccludee<G, I>(fe, grid, epsilon, ve, &wFace);
 #if LOGGING
-    if (_global.debug & G_DEBUG_FREESTYLE) {
-      cout << "\tqiMajority: " << qiMajority << endl;
-    }
+      if (_global.debug & G_DEBUG_FREESTYLE) {
+        cout << "\tFEdge: occludee only (" << (wFace != NULL ? "found" : "not found") << ")"
+             << endl;
+      }
 #endif
+    }
 
-    tmpQI = 0;
-    maxIndex = 0;
-    maxCard = 0;
-    nSamples = 0;
-    memset(qiClasses, 0, 256 * sizeof(*qiClasses));
-    set<ViewShape *> foundOccluders;
-
-    fe = (*ve)->fedgeA();
-    do {
-      if (fe == NULL || !fe->isInImage()) {
-        fe = fe->nextEdge();
-        continue;
+    // Store test results
+    if (wFace) {
+      vector<Vec3r> vertices;
+      for (int i = 0, numEdges = wFace->numberOfEdges(); i < numEdges; ++i) {
+        vertices.push_back(Vec3r(wFace->GetVertex(i)->GetVertex()));
       }
-      if ((maxCard < qiMajority)) {
-        // ARB: change &wFace to wFace and use reference in called function
-        tmpQI = computeVisibility<G, I>(
-            ioViewMap, fe, grid, epsilon, *ve, &wFace, &foundOccluders);
+      Polygon3r poly(vertices, wFace->GetNormal());
+      poly.userdata = (void *)wFace;
+      fe->setaFace(poly);
+      wFaces.push_back(wFace);
+      fe->setOccludeeEmpty(false);
 #if LOGGING
-        if (_global.debug & G_DEBUG_FREESTYLE) {
-          cout << "\tFEdge: visibility " << tmpQI << endl;
-        }
+      if (_global.debug & G_DEBUG_FREESTYLE) {
+        cout << "\tFound occludee" << endl;
+      }
 #endif
+    }
+    else {
+      fe->setOccludeeEmpty(true);
+    }
 
-        // ARB: This is an error condition, not an alert condition.
-        // Some sort of recovery or abort is necessary.
-        if (tmpQI >= 256) {
-          cerr << "Warning: too many occluding levels" << endl;
-          // ARB: Wild guess: instead of aborting or corrupting memory, treat as tmpQI == 255
-          tmpQI = 255;
-        }
+    ++nSamples;
+    fe = fe->nextEdge();
+  } while ((maxCard < qiMajority) && (fe) && (fe != festart));
 
-        if (++qiClasses[tmpQI] > maxCard) {
-          maxCard = qiClasses[tmpQI];
-          maxIndex = tmpQI;
-        }
-      }
-      else {
-        // ARB: FindOccludee is redundant if ComputeRayCastingVisibility has been called
-        // ARB: change &wFace to wFace and use reference in called function
-        findOccludee<G, I>(fe, grid, epsilon, *ve, &wFace);
 #if LOGGING
-        if (_global.debug & G_DEBUG_FREESTYLE) {
-          cout << "\tFEdge: occludee only (" << (wFace != NULL ? "found" : "not found") << ")"
-               << endl;
-        }
+  if (_global.debug & G_DEBUG_FREESTYLE) {
+    cout << "\tFinished with " << nSamples << " samples, maxCard = " << maxCard << endl;
+  }
 #endif
-      }
 
-      // Store test results
-      if (wFace) {
-        vector<Vec3r> vertices;
-        for (int i = 0, numEdges = wFace->numberOfEdges(); i < numEdges; ++i) {
-          vertices.push_back(Vec3r(wFace->GetVertex(i)->GetVertex()));
-        }
-        Polygon3r poly(vertices, wFace->GetNormal());
-        poly.userdata = (void *)wFace;
-        fe->setaFace(poly);
-        wFaces.push_back(wFace);
-        fe->setOccludeeEmpty(false);
+  // ViewEdge
+  // qi --
+  ve->setQI(maxIndex);
+  // occluders --
+  // I would rather not have to go through the effort of creating this this set and then copying
+  // out its contents. Is there a reason why ViewEdge::_Occluders cannot be converted to a set<>?
+  for (set<ViewShape *>::iterator o = foundOccluders.begin(), oend = foundOccluders.end();
+       o != oend;
+       ++o) {
+    ve->AddOccluder((*o));
+  }
 #if LOGGING
-        if (_global.debug & G_DEBUG_FREESTYLE) {
-          cout << "\tFound occludee" << endl;
-        }
+  if (_global.debug & G_DEBUG_FREESTYLE) {
+    cout << "\tConclusion: QI = " << maxIndex << ", " << ve->occluders_size() << " occluders."
+         << endl;
+  }
 #endif
-      }
-      else {
-        fe->setOccludeeEmpty(true);
-      }
+  // occludee --
+  if (!wFaces.empty()) {
+    if (wFaces.size() <= (float)nSamples / 2.0f) {
+      ve->setaShape(0);
+    }
+    else {
+      ViewShape *vshape = ioViewMap->viewShape(
+          (*wFaces.begin())->GetVertex(0)->shape()->GetId());
+      ve->setaShape(vshape);
+    }
+  }
+}
 
-      ++nSamples;
-      fe = fe->nextEdge();
-    } while ((maxCard < qiMajority) && (fe) && (fe != festart));
+// The grids are only read while computing the visibility of a ViewEdge, and everything written
+// belongs to the ViewEdge and its FEdges, so ViewEdges can be processed in parallel.
+template<typename G> struct ViewEdgeVisibilityData {
+  typedef void (*ComputeFunc)(ViewMap *ioViewMap, ViewEdge *ve, G &grid, real epsilon);
 
-#if LOGGING
-    if (_global.debug & G_DEBUG_FREESTYLE) {
-      cout << "\tFinished with " << nSamples << " samples, maxCard = " << maxCard << endl;
-    }
-#endif
+  ViewMap *viewMap;
+  G *grid;
+  real epsilon;
+  ComputeFunc compute;
+  RenderMonitor *renderMonitor;
+  bool reportProgress;
+  unsigned cnt;
+  unsigned cntStep;
+  bool cancelled;
+  ThreadMutex mutex;
+};
 
-    // ViewEdge
-    // qi --
-    (*ve)->setQI(maxIndex);
-    // occluders --
-    // I would rather not have to go through the effort of creating this this set and then copying
-    // out its contents. Is there a reason why ViewEdge::_Occluders cannot be converted to a set<>?
-    for (set<ViewShape *>::iterator o = foundOccluders.begin(), oend = foundOccluders.end();
-         o != oend;
-         ++o) {
-      (*ve)->AddOccluder((*o));
-    }
-#if LOGGING
-    if (_global.debug & G_DEBUG_FREESTYLE) {
-      cout << "\tConclusion: QI = " << maxIndex << ", " << (*ve)->occluders_size() << " occluders."
-           << endl;
-    }
-#endif
-    // occludee --
-    if (!wFaces.empty()) {
-      if (wFaces.size() <= (float)nSamples / 2.0f) {
-        (*ve)->setaShape(0);
+template<typename G>
+static void computeViewEdgeVisibilityTask(void *__restrict userdata,
+                                          const int iter,
+                                          const TaskParallelTLS *__restrict /*tls*/)
+{
+  ViewEdgeVisibilityData<G> *data = (ViewEdgeVisibilityData<G> *)userdata;
+  vector<ViewEdge *> &vedges = data->viewMap->ViewEdges();
+
+  if (data->cancelled) {
+    return;
+  }
+
+  RenderMonitor *iRenderMonitor = data->renderMonitor;
+  if (iRenderMonitor) {
+    unsigned cnt = atomic_fetch_and_add_u(&data->cnt, 1);
+    if (cnt % data->cntStep == 0) {
+      // The render monitor is used by one thread at a time.
+      BLI_mutex_lock(&data->mutex);
+      if (iRenderMonitor->testBreak()) {
+        data->cancelled = true;
       }
-      else {
-        ViewShape *vshape = ioViewMap->viewShape(
-            (*wFaces.begin())->GetVertex(0)->shape()->GetId());
-        (*ve)->setaShape(vshape);
+      else if (data->reportProgress) {
+        stringstream ss;
+        ss << "Freestyle: Visibility computations " << (100 * cnt / vedges.size()) << "%";
+        iRenderMonitor->setInfo(ss.str());
+        iRenderMonitor->progress((float)cnt / vedges.size());
+      }
+      BLI_mutex_unlock(&data->mutex);
+
+      if (data->cancelled) {
+        return;
       }
     }
+  }
 
-    wFaces.clear();
+  data->compute(data->viewMap, vedges[iter], *data->grid, data->epsilon);
+}
+
+template<typename G>
+static void computeViewEdgesVisibility(ViewMap *ioViewMap,
+                                       G &grid,
+                                       real epsilon,
+                                       RenderMonitor *iRenderMonitor,
+                                       typename ViewEdgeVisibilityData<G>::ComputeFunc compute,
+                                       bool reportProgress)
+{
+  vector<ViewEdge *> &vedges = ioViewMap->ViewEdges();
+
+  ViewEdgeVisibilityData<G> data;
+  data.viewMap = ioViewMap;
+  data.grid = &grid;
+  data.epsilon = epsilon;
+  data.compute = compute;
+  data.renderMonitor = iRenderMonitor;
+  data.reportProgress = reportProgress;
+  data.cnt = 0;
+  data.cntStep = max(1u, (unsigned)ceil(0.01f * vedges.size()));
+  data.cancelled = false;
+  BLI_mutex_init(&data.mutex);
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = 16;
+  BLI_task_parallel_range(
+      0, (int)vedges.size(), &data, computeViewEdgeVisibilityTask<G>, &settings);
+
+  BLI_mutex_end(&data.mutex);
+
+  if (reportProgress && iRenderMonitor && vedges.size()) {
+    unsigned cnt = min(data.cnt, (unsigned)vedges.size());
+    stringstream ss;
+    ss << "Freestyle: Visibility computations " << (100 * cnt / vedges.size()) << "%";
+    iRenderMonitor->setInfo(ss.str());
+    iRenderMonitor->progress((float)cnt / vedges.size());
   }
 }
 
+template<typename G, typename I>
+static void computeCumulativeVisibility(ViewMap *ioViewMap,
+                                        G &grid,
+                                        real epsilon,
+                                        RenderMonitor *iRenderMonitor)
+{
+  computeViewEdgesVisibility<G>(
+      ioViewMap, grid, epsilon, iRenderMonitor, computeViewEdgeCumulativeVisibility<G, I>, true);
+}
+
+template<typename G, typename I>
+static void computeDetailedVisibility(ViewMap *ioViewMap,
+                                      G &grid,
+                                      real epsilon,
+                                      RenderMonitor *iRenderMonitor)
+{
+  computeViewEdgesVisibility<G>(
+      ioViewMap, grid, epsilon, iRenderMonitor, computeViewEdgeDetailedVisibility<G, I>, false);
+}
+
 template<typename G, typename I>
 static void computeFastVisibility(ViewMap *ioViewMap, G &grid, real epsilon)
 {
@@ -1043,6 +1131,16 @@ void ViewMapBuilder::BuildGrid(WingedEdge &we, const BBox<Vec3r> &bbox, unsigned
   _Grid->displayDebug();
 }
 
+// Prints the time spent in a phase of the view map building, and restarts the timer.
+static void printPhaseTime(const char *phase, double &r_time)
+{
+  double now = PIL_check_seconds_timer();
+  if (_global.debug & G_DEBUG_FREESTYLE) {
+    cout << "ViewMap building, " << phase << ": " << (now - r_time) << "s" << endl;
+  }
+  r_time = now;
+}
+
 ViewMap *ViewMapBuilder::BuildViewMap(WingedEdge &we,
                                       visibility_algo iAlgo,
                                       real epsilon,
@@ -1054,17 +1152,23 @@ ViewMap *ViewMapBuilder::BuildViewMap(WingedEdge &we,
   _currentFId = 0;
   _currentSVertexId = 0;
 
+  double time = PIL_check_seconds_timer();
+
   // Builds initial view edges
   computeInitialViewEdges(we);
+  printPhaseTime("initial view edges", time);
 
   // Detects cusps
   computeCusps(_ViewMap);
+  printPhaseTime("cusps", time);
 
   // Compute intersections
   ComputeIntersections(_ViewMap, sweep_line, epsilon);
+  printPhaseTime("intersections", time);
 
   // Compute visibility
   ComputeEdgesVisibility(_ViewMap, we, bbox, sceneNumFaces, iAlgo, epsilon);
+  printPhaseTime("visibility", time);
 
   return _ViewMap;
 }
@@ -2341,6 +2445,202 @@ struct silhouette_binary_rule : public binary_rule<segment, segment> {
   }
 };
 
+// Above this number of FEdges, the intersections are found with a uniform grid.
+static const unsigned gGridIntersectionsMinSize = 10000;
+
+// Segment of the grid intersections, in the order it was added to the sweep line.
+struct GridSegment {
+  segment *seg;
+  unsigned addEvent;
+  unsigned removeEvent;
+  real min[2], max[2];
+};
+
+struct GridIntersection {
+  unsigned rank;
+  real t, u;
+};
+
+struct GridIntersectionsData {
+  vector<GridSegment> segments;
+  vector<vector<unsigned>> cells;
+  vector<vector<GridIntersection>> intersections;
+  real origin[2];
+  real cellSize[2];
+  int resolution;
+  real epsilon;
+
+  inline int cell(real x, int axis) const
+  {
+    int i = (int)((x - origin[axis]) / cellSize[axis]);
+    return min(max(i, 0), resolution - 1);
+  }
+};
+
+// Tests a segment against the segments that were on the sweep line when it was added, sharing a
+// cell with it. A pair of segments is only tested in the cell containing the lower corner of the
+// overlap of their bounds, so that it is tested once.
+static void computeGridIntersectionsTask(void *__restrict userdata,
+                                         const int iter,
+                                         const TaskParallelTLS *__restrict /*tls*/)
+{
+  GridIntersectionsData *data = (GridIntersectionsData *)userdata;
+  const GridSegment &S = data->segments[iter];
+  vector<GridIntersection> &intersections = data->intersections[iter];
+  silhouette_binary_rule sbr;
+
+  int xmin = data->cell(S.min[0], 0), xmax = data->cell(S.max[0], 0);
+  int ymin = data->cell(S.min[1], 1), ymax = data->cell(S.max[1], 1);
+  for (int y = ymin; y <= ymax; y++) {
+    for (int x = xmin; x <= xmax; x++) {
+      const vector<unsigned> &cell = data->cells[y * data->resolution + x];
+      // Cells are sorted by rank, only the segments added before are tested.
+      for (unsigned i = 0; i < cell.size() && cell[i] < (unsigned)iter; i++) {
+        const GridSegment &C = data->segments[cell[i]];
+        if (C.removeEvent <= S.addEvent) {
+          continue;
+        }
+
+        real lower[2] = {max(S.min[0], C.min[0]), max(S.min[1], C.min[1])};
+        if (lower[0] > min(S.max[0], C.max[0]) || lower[1] > min(S.max[1], C.max[1])) {
+          continue;
+        }
+        if (data->cell(lower[0], 0) != x || data->cell(lower[1], 1) != y) {
+          continue;
+        }
+
+        GridIntersection intersection;
+        if (SweepLine<FEdge *, Vec3r>::intersect(
+                S.seg, C.seg, sbr, data->epsilon, intersection.t, intersection.u)) {
+          intersection.rank = cell[i];
+          intersections.push_back(intersection);
+        }
+      }
+    }
+  }
+
+  sort(intersections.begin(),
+       intersections.end(),
+       [](const GridIntersection &a, const GridIntersection &b) { return a.rank < b.rank; });
+}
+
+// Finds the same intersections as SweepLine::process() does over the sorted SVertices, in the same
+// order. The events are replayed to know which segments are on the sweep line when a segment is
+// added, and the tests against them are done in parallel, only for segments sharing grid cells.
+// Returns false when the events can't be replayed, the sweep line is used then.
+static bool computeGridIntersections(SweepLine<FEdge *, Vec3r> &SL,
+                                     vector<SVertex *> &svertices,
+                                     vector<segment *> &segments,
+                                     real epsilon,
+                                     RenderMonitor *iRenderMonitor)
+{
+  unordered_map<segment *, unsigned> indices;
+  indices.reserve(segments.size());
+  for (unsigned i = 0; i < segments.size(); i++) {
+    indices[segments[i]] = i;
+  }
+
+  vector<unsigned> addEvent(segments.size(), UINT_MAX);
+  vector<unsigned> removeEvent(segments.size(), UINT_MAX);
+  vector<unsigned> added, removed, toadd;
+
+  // First the segments are removed, then they are added, like SweepLine::process() does.
+  for (unsigned e = 0; e < svertices.size(); e++) {
+    Vec3r evt(svertices[e]->point2D());
+    const vector<FEdge *> &vedges = svertices[e]->fedges();
+
+    toadd.clear();
+    for (vector<FEdge *>::const_iterator sve = vedges.begin(), sveend = vedges.end();
+         sve != sveend;
+         sve++) {
+      segment *s = (segment *)((*sve)->userdata);
+      unsigned i = indices[s];
+      if (evt == (*s)[0]) {
+        toadd.push_back(i);
+      }
+      else if (addEvent[i] != UINT_MAX) {
+        if (removeEvent[i] != UINT_MAX) {
+          return false;
+        }
+        removeEvent[i] = e;
+        removed.push_back(i);
+      }
+    }
+
+    for (vector<unsigned>::iterator i = toadd.begin(), iend = toadd.end(); i != iend; i++) {
+      if (addEvent[*i] != UINT_MAX) {
+        return false;
+      }
+      addEvent[*i] = e;
+      added.push_back(*i);
+    }
+  }
+
+  if (added.empty() || (iRenderMonitor && iRenderMonitor->testBreak())) {
+    return true;
+  }
+
+  GridIntersectionsData data;
+  data.epsilon = epsilon;
+  data.segments.resize(added.size());
+  data.intersections.resize(added.size());
+
+  real bmin[2] = {FLT_MAX, FLT_MAX}, bmax[2] = {-FLT_MAX, -FLT_MAX};
+  for (unsigned rank = 0; rank < added.size(); rank++) {
+    GridSegment &S = data.segments[rank];
+    S.seg = segments[added[rank]];
+    S.addEvent = addEvent[added[rank]];
+    S.removeEvent = removeEvent[added[rank]];
+    Vec3r A = (*S.seg)[0], B = (*S.seg)[1];
+    for (int axis = 0; axis < 2; axis++) {
+      S.min[axis] = min(A[axis], B[axis]) - epsilon;
+      S.max[axis] = max(A[axis], B[axis]) + epsilon;
+      bmin[axis] = min(bmin[axis], S.min[axis]);
+      bmax[axis] = max(bmax[axis], S.max[axis]);
+    }
+  }
+
+  data.resolution = min(max((int)sqrt((double)added.size()), 1), 1024);
+  for (int axis = 0; axis < 2; axis++) {
+    data.origin[axis] = bmin[axis];
+    data.cellSize[axis] = (bmax[axis] - bmin[axis]) / data.resolution;
+    if (data.cellSize[axis] <= 0.0) {
+      data.cellSize[axis] = 1.0;
+    }
+  }
+
+  data.cells.resize(data.resolution * data.resolution);
+  for (unsigned rank = 0; rank < added.size(); rank++) {
+    const GridSegment &S = data.segments[rank];
+    for (int y = data.cell(S.min[1], 1), ymax = data.cell(S.max[1], 1); y <= ymax; y++) {
+      for (int x = data.cell(S.min[0], 0), xmax = data.cell(S.max[0], 0); x <= xmax; x++) {
+        data.cells[y * data.resolution + x].push_back(rank);
+      }
+    }
+  }
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = 64;
+  BLI_task_parallel_range(0, (int)added.size(), &data, computeGridIntersectionsTask, &settings);
+
+  // Record the intersections and the intersected edges in the order of the sweep line.
+  for (unsigned rank = 0; rank < added.size(); rank++) {
+    const vector<GridIntersection> &intersections = data.intersections[rank];
+    for (unsigned i = 0; i < intersections.size(); i++) {
+      SL.addIntersection(data.segments[rank].seg,
+                         intersections[i].t,
+                         data.segments[intersections[i].rank].seg,
+                         intersections[i].u);
+    }
+  }
+  for (vector<unsigned>::iterator i = removed.begin(), iend = removed.end(); i != iend; i++) {
+    SL.addIntersectedEdge(segments[*i]);
+  }
+
+  return true;
+}
+
 void ViewMapBuilder::ComputeSweepLineIntersections(ViewMap *ioViewMap, real epsilon)
 {
   vector<SVertex *> &svertices = ioViewMap->SVertices();
@@ -2387,33 +2687,36 @@ void ViewMapBuilder::ComputeSweepLineIntersections(ViewMap *ioViewMap, real epsi
     segments.push_back(s);
   }
 
-  vector<segment *> vsegments;
-  for (vector<SVertex *>::iterator sv = svertices.begin(), svend = svertices.end(); sv != svend;
-       sv++) {
-    if (_pRenderMonitor && _pRenderMonitor->testBreak()) {
-      break;
-    }
+  if (fEdgesSize < gGridIntersectionsMinSize ||
+      !computeGridIntersections(SL, svertices, segments, epsilon, _pRenderMonitor)) {
+    vector<segment *> vsegments;
+    for (vector<SVertex *>::iterator sv = svertices.begin(), svend = svertices.end(); sv != svend;
+         sv++) {
+      if (_pRenderMonitor && _pRenderMonitor->testBreak()) {
+        break;
+      }
 
-    const vector<FEdge *> &vedges = (*sv)->fedges();
+      const vector<FEdge *> &vedges = (*sv)->fedges();
 
-    for (vector<FEdge *>::const_iterator sve = vedges.begin(), sveend = vedges.end();
-         sve != sveend;
-         sve++) {
-      vsegments.push_back((segment *)((*sve)->userdata));
-    }
+      for (vector<FEdge *>::const_iterator sve = vedges.begin(), sveend = vedges.end();
+           sve != sveend;
+           sve++) {
+        vsegments.push_back((segment *)((*sve)->userdata));
+      }
 
-    Vec3r evt((*sv)->point2D());
-    silhouette_binary_rule sbr;
-    SL.process(evt, vsegments, sbr, epsilon);
+      Vec3r evt((*sv)->point2D());
+      silhouette_binary_rule sbr;
+      SL.process(evt, vsegments, sbr, epsilon);
 
-    if (progressBarDisplay) {
-      counter--;
-      if (counter <= 0) {
-        counter = progressBarStep;
-        _pProgressBar->setProgress(_pProgressBar->getProgress() + 1);
+      if (progressBarDisplay) {
+        counter--;
+        if (counter <= 0) {
+          counter = progressBarStep;
+          _pProgressBar->setProgress(_pProgressBar->getProgress() + 1);
+        }
       }
+      vsegments.clear();
     }
-    vsegments.clear();
   }
 
   if (_pRenderMonitor && _pRenderMonitor->testBreak()) {
@@ -170,6 +170,8 @@ typedef enum eImBufFlags {
   IB_thumbnail = 1 << 16,
   IB_multiview = 1 << 17,
   IB_halffloat = 1 << 18,
+  /** decode movies a GOP at a time in background threads, caching frames around the playhead */
+  IB_animprefetch = 1 << 19,
 } eImBufFlags;
 
 /** \} */
@@ -81,6 +81,7 @@
 
 #define MAXNUMSTREAMS 50
 
+struct AnimPrefetch;
 struct IDProperty;
 struct _AviMovie;
 struct anim_index;
@@ -137,6 +138,9 @@ struct anim {
   int64_t last_pts;
   int64_t next_pts;
   AVPacket next_packet;
+
+  /* Parallel decoding of GOPs around the playhead, with IB_animprefetch. */
+  struct AnimPrefetch *prefetch;
 #endif
 
   char index_dir[768];
@@ -53,8 +53,12 @@
 #  include <io.h>
 #endif
 
+#include "BLI_listbase.h"
+#include "BLI_math_base.h"
 #include "BLI_path_util.h"
 #include "BLI_string.h"
+#include "BLI_task.h"
+#include "BLI_threads.h"
 #include "BLI_utildefines.h"
 
 #include "MEM_guardedalloc.h"
@@ -72,6 +76,7 @@
 #include "IMB_anim.h"
 #include "IMB_indexer.h"
 #include "IMB_metadata.h"
+#include "IMB_moviecache.h"
 
 #ifdef WITH_FFMPEG
 #  include "BKE_global.h" /* ENDIAN_ORDER */
@@ -486,6 +491,67 @@ BLI_INLINE bool need_aligned_ffmpeg_buffer(struct anim *anim)
   return (anim->x & 31) != 0;
 }
 
+/* Create the context converting decoded frames of the codec to RGBA. */
+static struct SwsContext *ffmpeg_sws_context_create(struct anim *anim, AVCodecContext *codec_ctx)
+{
+  struct SwsContext *img_convert_ctx;
+#  ifdef FFMPEG_SWSCALE_COLOR_SPACE_SUPPORT
+  /* The following for color space determination */
+  int srcRange, dstRange, brightness, contrast, saturation;
+  int *table;
+  const int *inv_table;
+#  endif
+
+  img_convert_ctx = sws_getContext(anim->x,
+                                   anim->y,
+                                   codec_ctx->pix_fmt,
+                                   anim->x,
+                                   anim->y,
+                                   AV_PIX_FMT_RGBA,
+                                   SWS_FAST_BILINEAR | SWS_PRINT_INFO | SWS_FULL_CHR_H_INT,
+                                   NULL,
+                                   NULL,
+                                   NULL);
+
+  if (!img_convert_ctx) {
+    return NULL;
+  }
+
+#  ifdef FFMPEG_SWSCALE_COLOR_SPACE_SUPPORT
+  /* Try do detect if input has 0-255 YCbCR range (JFIF Jpeg MotionJpeg) */
+  if (!sws_getColorspaceDetails(img_convert_ctx,
+                                (int **)&inv_table,
+                                &srcRange,
+                                &table,
+                                &dstRange,
+                                &brightness,
+                                &contrast,
+                                &saturation)) {
+    srcRange = srcRange || codec_ctx->color_range == AVCOL_RANGE_JPEG;
+    inv_table = sws_getCoefficients(codec_ctx->colorspace);
+
+    if (sws_setColorspaceDetails(img_convert_ctx,
+                                 (int *)inv_table,
+                                 srcRange,
+                                 table,
+                                 dstRange,
+                                 brightness,
+                                 contrast,
+                                 saturation)) {
+      fprintf(stderr, "Warning: Could not set libswscale colorspace details.\n");
+    }
+  }
+  else {
+    fprintf(stderr, "Warning: Could not set libswscale colorspace details.\n");
+  }
+#  endif
+
+  return img_convert_ctx;
+}
+
+static int ffmpeg_seek_by_byte(AVFormatContext *pFormatCtx);
+static struct AnimPrefetch *anim_prefetch_create(struct anim *anim);
+
 static int startffmpeg(struct anim *anim)
 {
   int i, video_stream_index;
@@ -499,13 +565,6 @@ static int startffmpeg(struct anim *anim)
   double frs_den;
   int streamcount;
 
-#  ifdef FFMPEG_SWSCALE_COLOR_SPACE_SUPPORT
-  /* The following for color space determination */
-  int srcRange, dstRange, brightness, contrast, saturation;
-  int *table;
-  const int *inv_table;
-#  endif
-
   if (anim == NULL) {
     return (-1);
   }
@@ -673,16 +732,7 @@ static int startffmpeg(struct anim *anim)
     anim->preseek = 0;
   }
 
-  anim->img_convert_ctx = sws_getContext(anim->x,
-                                         anim->y,
-                                         anim->pCodecCtx->pix_fmt,
-                                         anim->x,
-                                         anim->y,
-                                         AV_PIX_FMT_RGBA,
-                                         SWS_FAST_BILINEAR | SWS_PRINT_INFO | SWS_FULL_CHR_H_INT,
-                                         NULL,
-                                         NULL,
-                                         NULL);
+  anim->img_convert_ctx = ffmpeg_sws_context_create(anim, anim->pCodecCtx);
 
   if (!anim->img_convert_ctx) {
     fprintf(stderr, "Can't transform color space??? Bailing out...\n");
@@ -695,54 +745,30 @@ static int startffmpeg(struct anim *anim)
     return -1;
   }
 
-#  ifdef FFMPEG_SWSCALE_COLOR_SPACE_SUPPORT
-  /* Try do detect if input has 0-255 YCbCR range (JFIF Jpeg MotionJpeg) */
-  if (!sws_getColorspaceDetails(anim->img_convert_ctx,
-                                (int **)&inv_table,
-                                &srcRange,
-                                &table,
-                                &dstRange,
-                                &brightness,
-                                &contrast,
-                                &saturation)) {
-    srcRange = srcRange || anim->pCodecCtx->color_range == AVCOL_RANGE_JPEG;
-    inv_table = sws_getCoefficients(anim->pCodecCtx->colorspace);
-
-    if (sws_setColorspaceDetails(anim->img_convert_ctx,
-                                 (int *)inv_table,
-                                 srcRange,
-                                 table,
-                                 dstRange,
-                                 brightness,
-                                 contrast,
-                                 saturation)) {
-      fprintf(stderr, "Warning: Could not set libswscale colorspace details.\n");
-    }
-  }
-  else {
-    fprintf(stderr, "Warning: Could not set libswscale colorspace details.\n");
+  if ((anim->ib_flags & IB_animprefetch) && !ffmpeg_seek_by_byte(pFormatCtx)) {
+    anim->prefetch = anim_prefetch_create(anim);
   }
-#  endif
 
   return (0);
 }
 
-/* postprocess the image in anim->pFrame and do color conversion
+/* postprocess the decoded frame and do color conversion
  * and deinterlacing stuff.
  *
- * Output is anim->last_frame
+ * Output is ibuf, using the temporary frames of the decoder.
  */
 
-static void ffmpeg_postprocess(struct anim *anim)
+static void ffmpeg_postprocess_frame(struct anim *anim,
+                                     AVCodecContext *codec_ctx,
+                                     struct SwsContext *img_convert_ctx,
+                                     AVFrame *frame,
+                                     AVFrame *frame_deinterlaced,
+                                     AVFrame *frame_rgb,
+                                     ImBuf *ibuf)
 {
-  AVFrame *input = anim->pFrame;
-  ImBuf *ibuf = anim->last_frame;
+  AVFrame *input = frame;
   int filter_y = 0;
 
-  if (!anim->pFrameComplete) {
-    return;
-  }
-
   /* This means the data wasn't read properly,
    * this check stops crashing */
   if (input->data[0] == 0 && input->data[1] == 0 && input->data[2] == 0 && input->data[3] == 0) {
@@ -752,29 +778,29 @@ static void ffmpeg_postprocess(struct anim *anim)
     return;
   }
 
-  av_log(anim->pFormatCtx,
+  av_log(codec_ctx,
          AV_LOG_DEBUG,
-         "  POSTPROC: anim->pFrame planes: %p %p %p %p\n",
+         "  POSTPROC: frame planes: %p %p %p %p\n",
          input->data[0],
          input->data[1],
          input->data[2],
          input->data[3]);
 
   if (anim->ib_flags & IB_animdeinterlace) {
-    if (avpicture_deinterlace((AVPicture *)anim->pFrameDeinterlaced,
-                              (const AVPicture *)anim->pFrame,
-                              anim->pCodecCtx->pix_fmt,
-                              anim->pCodecCtx->width,
-                              anim->pCodecCtx->height) < 0) {
+    if (avpicture_deinterlace((AVPicture *)frame_deinterlaced,
+                              (const AVPicture *)frame,
+                              codec_ctx->pix_fmt,
+                              codec_ctx->width,
+                              codec_ctx->height) < 0) {
       filter_y = true;
     }
     else {
-      input = anim->pFrameDeinterlaced;
+      input = frame_deinterlaced;
     }
   }
 
   if (!need_aligned_ffmpeg_buffer(anim)) {
-    avpicture_fill((AVPicture *)anim->pFrameRGB,
+    avpicture_fill((AVPicture *)frame_rgb,
                    (unsigned char *)ibuf->rect,
                    AV_PIX_FMT_RGBA,
                    anim->x,
@@ -782,15 +808,15 @@ static void ffmpeg_postprocess(struct anim *anim)
   }
 
   if (ENDIAN_ORDER == B_ENDIAN) {
-    int *dstStride = anim->pFrameRGB->linesize;
-    uint8_t **dst = anim->pFrameRGB->data;
+    int *dstStride = frame_rgb->linesize;
+    uint8_t **dst = frame_rgb->data;
     int dstStride2[4] = {dstStride[0], 0, 0, 0};
     uint8_t *dst2[4] = {dst[0], 0, 0, 0};
     int x, y, h, w;
     unsigned char *bottom;
     unsigned char *top;
 
-    sws_scale(anim->img_convert_ctx,
+    sws_scale(img_convert_ctx,
               (const uint8_t *const *)input->data,
               input->linesize,
               0,
@@ -828,12 +854,12 @@ static void ffmpeg_postprocess(struct anim *anim)
     }
   }
   else {
-    int *dstStride = anim->pFrameRGB->linesize;
-    uint8_t **dst = anim->pFrameRGB->data;
+    int *dstStride = frame_rgb->linesize;
+    uint8_t **dst = frame_rgb->data;
     int dstStride2[4] = {-dstStride[0], 0, 0, 0};
     uint8_t *dst2[4] = {dst[0] + (anim->y - 1) * dstStride[0], 0, 0, 0};
 
-    sws_scale(anim->img_convert_ctx,
+    sws_scale(img_convert_ctx,
               (const uint8_t *const *)input->data,
               input->linesize,
               0,
@@ -843,12 +869,12 @@ static void ffmpeg_postprocess(struct anim *anim)
   }
 
   if (need_aligned_ffmpeg_buffer(anim)) {
-    uint8_t *src = anim->pFrameRGB->data[0];
+    uint8_t *src = frame_rgb->data[0];
     uint8_t *dst = (uint8_t *)ibuf->rect;
     for (int y = 0; y < anim->y; y++) {
       memcpy(dst, src, anim->x * 4);
       dst += anim->x * 4;
-      src += anim->pFrameRGB->linesize[0];
+      src += frame_rgb->linesize[0];
     }
   }
 
@@ -857,6 +883,26 @@ static void ffmpeg_postprocess(struct anim *anim)
   }
 }
 
+/* postprocess the image in anim->pFrame
+ *
+ * Output is anim->last_frame
+ */
+
+static void ffmpeg_postprocess(struct anim *anim)
+{
+  if (!anim->pFrameComplete) {
+    return;
+  }
+
+  ffmpeg_postprocess_frame(anim,
+                           anim->pCodecCtx,
+                           anim->img_convert_ctx,
+                           anim->pFrame,
+                           anim->pFrameDeinterlaced,
+                           anim->pFrameRGB,
+                           anim->last_frame);
+}
+
 /* decode one video frame also considering the packet read into next_packet */
 
 static int ffmpeg_decode_video_frame(struct anim *anim)
@@ -1029,6 +1075,591 @@ static int ffmpeg_seek_by_byte(AVFormatContext *pFormatCtx)
   return false;
 }
 
+/* PTS of the frame at the position, when there is no timecode index. */
+static int64_t ffmpeg_position_to_pts(int position,
+                                      double frame_rate,
+                                      double pts_time_base,
+                                      long long st_time)
+{
+  int64_t pts_to_search = (long long)floor(((double)position) / pts_time_base / frame_rate + 0.5);
+
+  if (st_time != AV_NOPTS_VALUE) {
+    pts_to_search += st_time / pts_time_base / AV_TIME_BASE;
+  }
+
+  return pts_to_search;
+}
+
+/* Parallel GOP decoding.
+ *
+ * Seeking in long-GOP footage means decoding from the previous key frame, for every frame when
+ * playing backwards or scrubbing. With IB_animprefetch, whole GOPs are decoded by a pool of
+ * decoders, each with its own format and codec context, in background threads. Every frame of
+ * a GOP is stored in a movie cache, and the GOPs around the last fetched frame are queued so
+ * playback in both directions finds its frames decoded already.
+ *
+ * Only used without timecode index, the frames are found by PTS like the sequential decoding
+ * does, and for formats that can be seeked by timestamp. */
+
+/* Frames around the last fetched one whose GOPs are decoded in advance. */
+#  define ANIM_PREFETCH_FRAMES 48
+#  define ANIM_PREFETCH_MAX_DECODERS 8
+/* GOP size until one was decoded. */
+#  define ANIM_PREFETCH_GOP_SIZE 12
+
+typedef struct AnimDecoder {
+  struct AnimDecoder *next, *prev;
+
+  AVFormatContext *format_ctx;
+  AVCodecContext *codec_ctx;
+  AVFrame *frame;
+  AVFrame *frame_deinterlaced;
+  AVFrame *frame_rgb;
+  struct SwsContext *img_convert_ctx;
+} AnimDecoder;
+
+typedef struct AnimPrefetchTask {
+  struct AnimPrefetchTask *next, *prev;
+
+  /* The GOP of this frame is decoded. */
+  int position;
+  /* Frames expected to be in the same GOP, not queued again. */
+  int start, end;
+  bool running;
+} AnimPrefetchTask;
+
+typedef struct AnimPrefetch {
+  struct anim *anim;
+  TaskPool *pool;
+
+  /* Protects everything below, waited on for decoders and tasks. */
+  ThreadMutex mutex;
+  ThreadCondition cond;
+
+  ListBase decoders;
+  int num_decoders, max_decoders;
+  ListBase tasks;
+
+  /* Frames by position. */
+  struct MovieCache *cache;
+  bool cache_full;
+  int gop_size;
+
+  double frame_rate;
+  double pts_time_base;
+  long long st_time;
+} AnimPrefetch;
+
+static void anim_decoder_free(struct anim *anim, AnimDecoder *decoder)
+{
+  if (anim->ib_flags & IB_animdeinterlace) {
+    MEM_freeN(decoder->frame_deinterlaced->data[0]);
+  }
+
+  avcodec_close(decoder->codec_ctx);
+  avformat_close_input(&decoder->format_ctx);
+
+  /* Like for anim->pFrame, see free_anim_ffmpeg(). */
+  av_free(decoder->frame);
+
+  if (decoder->frame_rgb) {
+    if (!need_aligned_ffmpeg_buffer(anim)) {
+      /* The buffer is the one of the ImBuf the frame was last converted to. */
+      avpicture_fill((AVPicture *)decoder->frame_rgb, NULL, AV_PIX_FMT_RGBA, anim->x, anim->y);
+    }
+    av_frame_free(&decoder->frame_rgb);
+  }
+  av_frame_free(&decoder->frame_deinterlaced);
+
+  if (decoder->img_convert_ctx) {
+    sws_freeContext(decoder->img_convert_ctx);
+  }
+
+  MEM_freeN(decoder);
+}
+
+static AnimDecoder *anim_decoder_open(struct anim *anim)
+{
+  AnimDecoder *decoder;
+  AVFormatContext *format_ctx = NULL;
+  AVCodecContext *codec_ctx;
+  AVCodec *codec;
+
+  if (avformat_open_input(&format_ctx, anim->name, NULL, NULL) != 0) {
+    return NULL;
+  }
+
+  if (avformat_find_stream_info(format_ctx, NULL) < 0 ||
+      anim->videoStream >= format_ctx->nb_streams) {
+    avformat_close_input(&format_ctx);
+    return NULL;
+  }
+
+  codec_ctx = format_ctx->streams[anim->videoStream]->codec;
+  codec = avcodec_find_decoder(codec_ctx->codec_id);
+  if (codec == NULL) {
+    avformat_close_input(&format_ctx);
+    return NULL;
+  }
+
+  codec_ctx->workaround_bugs = 1;
+
+  if (avcodec_open2(codec_ctx, codec, NULL) < 0) {
+    avformat_close_input(&format_ctx);
+    return NULL;
+  }
+
+  decoder = MEM_callocN(sizeof(AnimDecoder), "AnimDecoder");
+  decoder->format_ctx = format_ctx;
+  decoder->codec_ctx = codec_ctx;
+  decoder->frame = av_frame_alloc();
+  decoder->frame_deinterlaced = av_frame_alloc();
+  decoder->frame_rgb = av_frame_alloc();
+  decoder->img_convert_ctx = ffmpeg_sws_context_create(anim, codec_ctx);
+
+  if (need_aligned_ffmpeg_buffer(anim)) {
+    decoder->frame_rgb->format = AV_PIX_FMT_RGBA;
+    decoder->frame_rgb->width = anim->x;
+    decoder->frame_rgb->height = anim->y;
+
+    if (av_frame_get_buffer(decoder->frame_rgb, 32) < 0) {
+      av_frame_free(&decoder->frame_rgb);
+    }
+  }
+
+  if (anim->ib_flags & IB_animdeinterlace) {
+    avpicture_fill((AVPicture *)decoder->frame_deinterlaced,
+                   MEM_callocN(avpicture_get_size(codec_ctx->pix_fmt,
+                                                  codec_ctx->width,
+                                                  codec_ctx->height),
+                               "ffmpeg deinterlace"),
+                   codec_ctx->pix_fmt,
+                   codec_ctx->width,
+                   codec_ctx->height);
+  }
+
+  if (decoder->img_convert_ctx == NULL || decoder->frame_rgb == NULL) {
+    anim_decoder_free(anim, decoder);
+    return NULL;
+  }
+
+  return decoder;
+}
+
+/* Waits for a decoder when all of them are in use. */
+static AnimDecoder *anim_decoder_acquire(AnimPrefetch *prefetch)
+{
+  AnimDecoder *decoder;
+
+  BLI_mutex_lock(&prefetch->mutex);
+  while ((decoder = BLI_pophead(&prefetch->decoders)) == NULL &&
+         prefetch->num_decoders >= prefetch->max_decoders) {
+    BLI_condition_wait(&prefetch->cond, &prefetch->mutex);
+  }
+  if (decoder == NULL) {
+    prefetch->num_decoders++;
+  }
+  BLI_mutex_unlock(&prefetch->mutex);
+
+  if (decoder == NULL) {
+    /* Opening reads the stream info, don't block the other threads meanwhile. */
+    decoder = anim_decoder_open(prefetch->anim);
+
+    if (decoder == NULL) {
+      BLI_mutex_lock(&prefetch->mutex);
+      prefetch->num_decoders--;
+      BLI_condition_notify_all(&prefetch->cond);
+      BLI_mutex_unlock(&prefetch->mutex);
+    }
+  }
+
+  return decoder;
+}
+
+static void anim_decoder_release(AnimPrefetch *prefetch, AnimDecoder *decoder)
+{
+  BLI_mutex_lock(&prefetch->mutex);
+  BLI_addtail(&prefetch->decoders, decoder);
+  BLI_condition_notify_all(&prefetch->cond);
+  BLI_mutex_unlock(&prefetch->mutex);
+}
+
+static unsigned int anim_prefetch_hashhash(const void *keyv)
+{
+  return *(const int *)keyv;
+}
+
+static bool anim_prefetch_hashcmp(const void *av, const void *bv)
+{
+  return *(const int *)av != *(const int *)bv;
+}
+
+static int64_t anim_prefetch_pts(const AnimPrefetch *prefetch, int position)
+{
+  return ffmpeg_position_to_pts(
+      position, prefetch->frame_rate, prefetch->pts_time_base, prefetch->st_time);
+}
+
+/* First frame shown at or after the PTS. */
+static int anim_prefetch_position(const AnimPrefetch *prefetch, int64_t pts)
+{
+  const int duration = prefetch->anim->duration_in_frames;
+  double offset = (prefetch->st_time != AV_NOPTS_VALUE) ?
+                      prefetch->st_time / prefetch->pts_time_base / AV_TIME_BASE :
+                      0.0;
+  int position = (int)((pts - offset) * prefetch->pts_time_base * prefetch->frame_rate);
+
+  CLAMP(position, 0, duration);
+  while (position > 0 && anim_prefetch_pts(prefetch, position - 1) >= pts) {
+    position--;
+  }
+  while (position < duration && anim_prefetch_pts(prefetch, position) < pts) {
+    position++;
+  }
+
+  return position;
+}
+
+/* Caches the frame for the positions from *r_position until the one shown at next_pts.
+ * Returns false when the cache is full. */
+static bool anim_prefetch_store(AnimPrefetch *prefetch,
+                                ImBuf *ibuf,
+                                int *r_position,
+                                int64_t next_pts)
+{
+  const int duration = prefetch->anim->duration_in_frames;
+  bool stored = true;
+
+  BLI_mutex_lock(&prefetch->mutex);
+  for (; *r_position < duration && anim_prefetch_pts(prefetch, *r_position) < next_pts;
+       (*r_position)++) {
+    if (IMB_moviecache_has_frame(prefetch->cache, r_position)) {
+      continue;
+    }
+    if (!IMB_moviecache_put_if_possible(prefetch->cache, r_position, ibuf)) {
+      prefetch->cache_full = true;
+      stored = false;
+      break;
+    }
+  }
+  BLI_mutex_unlock(&prefetch->mutex);
+
+  return stored;
+}
+
+/* Decodes the GOP containing the frame at the position, from its key frame until the next key
+ * frame is shown, and caches all of its frames. */
+static void anim_prefetch_decode(AnimPrefetch *prefetch, int position)
+{
+  struct anim *anim = prefetch->anim;
+  AnimDecoder *decoder = anim_decoder_acquire(prefetch);
+  AVPacket packet;
+  int64_t key_pts = AV_NOPTS_VALUE;
+  int64_t next_key_pts = AV_NOPTS_VALUE;
+  ImBuf *ibuf = NULL;
+  int next_position = -1;
+  int first_position = -1;
+  bool eof = false;
+  /* there seem to exist *very* silly GOP lengths out in the wild... */
+  int count = 1000;
+
+  if (decoder == NULL) {
+    return;
+  }
+
+  if (av_seek_frame(decoder->format_ctx,
+                    anim->videoStream,
+                    anim_prefetch_pts(prefetch, position),
+                    AVSEEK_FLAG_BACKWARD) < 0) {
+    anim_decoder_release(prefetch, decoder);
+    return;
+  }
+
+  avcodec_flush_buffers(decoder->codec_ctx);
+
+  while (count > 0 && !BLI_task_pool_canceled(prefetch->pool)) {
+    int frame_complete = 0;
+    int64_t pts;
+
+    if (!eof) {
+      int ret = av_read_frame(decoder->format_ctx, &packet);
+
+      if (ret < 0) {
+        if (ret != AVERROR_EOF) {
+          break;
+        }
+        eof = true;
+      }
+      else {
+        if (packet.stream_index == anim->videoStream) {
+          if (packet.flags & AV_PKT_FLAG_KEY) {
+            pts = (packet.pts != AV_NOPTS_VALUE) ? packet.pts : packet.dts;
+            if (key_pts == AV_NOPTS_VALUE) {
+              key_pts = pts;
+            }
+            else if (next_key_pts == AV_NOPTS_VALUE && pts > key_pts) {
+              next_key_pts = pts;
+            }
+          }
+
+          avcodec_decode_video2(decoder->codec_ctx, decoder->frame, &frame_complete, &packet);
+        }
+        av_free_packet(&packet);
+      }
+    }
+
+    if (eof) {
+      /* Get the frames still in the decoder. */
+      av_init_packet(&packet);
+      packet.data = NULL;
+      packet.size = 0;
+
+      avcodec_decode_video2(decoder->codec_ctx, decoder->frame, &frame_complete, &packet);
+      if (!frame_complete) {
+        break;
+      }
+    }
+
+    if (!frame_complete) {
+      continue;
+    }
+
+    /* Leading frames of an open GOP depend on the previous one. */
+    pts = av_get_pts_from_frame(decoder->format_ctx, decoder->frame);
+    if (key_pts == AV_NOPTS_VALUE || pts < key_pts) {
+      continue;
+    }
+
+    if (ibuf) {
+      bool stored = anim_prefetch_store(prefetch, ibuf, &next_position, pts);
+      IMB_freeImBuf(ibuf);
+      ibuf = NULL;
+
+      if (!stored) {
+        break;
+      }
+    }
+    else {
+      first_position = next_position = anim_prefetch_position(prefetch, pts);
+    }
+
+    if (next_key_pts != AV_NOPTS_VALUE && pts >= next_key_pts) {
+      break;
+    }
+
+    ibuf = IMB_allocImBuf(anim->x, anim->y, 32, IB_rect);
+    ibuf->rect_colorspace = colormanage_colorspace_get_named(anim->colorspace);
+
+    ffmpeg_postprocess_frame(anim,
+                             decoder->codec_ctx,
+                             decoder->img_convert_ctx,
+                             decoder->frame,
+                             decoder->frame_deinterlaced,
+                             decoder->frame_rgb,
+                             ibuf);
+    count--;
+  }
+
+  if (ibuf) {
+    /* The last frame of the movie is shown until its end. */
+    if (eof) {
+      anim_prefetch_store(prefetch, ibuf, &next_position, INT64_MAX);
+    }
+    IMB_freeImBuf(ibuf);
+  }
+
+  anim_decoder_release(prefetch, decoder);
+
+  if (first_position != -1 && next_position > first_position) {
+    BLI_mutex_lock(&prefetch->mutex);
+    prefetch->gop_size = next_position - first_position;
+    BLI_mutex_unlock(&prefetch->mutex);
+  }
+}
+
+static AnimPrefetchTask *anim_prefetch_find_task(AnimPrefetch *prefetch, int position)
+{
+  LISTBASE_FOREACH (AnimPrefetchTask *, task, &prefetch->tasks) {
+    if (position >= task->start && position < task->end) {
+      return task;
+    }
+  }
+  return NULL;
+}
+
+static void anim_prefetch_task_finish(AnimPrefetch *prefetch, AnimPrefetchTask *task)
+{
+  BLI_freelinkN(&prefetch->tasks, task);
+  BLI_condition_notify_all(&prefetch->cond);
+}
+
+static void anim_prefetch_task_run(TaskPool *__restrict pool, void *taskdata)
+{
+  AnimPrefetch *prefetch = BLI_task_pool_user_data(pool);
+  const int position = POINTER_AS_INT(taskdata);
+  AnimPrefetchTask *task = NULL;
+
+  BLI_mutex_lock(&prefetch->mutex);
+  LISTBASE_FOREACH (AnimPrefetchTask *, queued, &prefetch->tasks) {
+    if (queued->position == position && !queued->running) {
+      task = queued;
+      task->running = true;
+      break;
+    }
+  }
+  BLI_mutex_unlock(&prefetch->mutex);
+
+  /* Decoded by the fetching thread already. */
+  if (task == NULL) {
+    return;
+  }
+
+  anim_prefetch_decode(prefetch, position);
+
+  BLI_mutex_lock(&prefetch->mutex);
+  anim_prefetch_task_finish(prefetch, task);
+  BLI_mutex_unlock(&prefetch->mutex);
+}
+
+static AnimPrefetchTask *anim_prefetch_task_add(AnimPrefetch *prefetch,
+                                                int position,
+                                                int start,
+                                                int end)
+{
+  AnimPrefetchTask *task = MEM_callocN(sizeof(AnimPrefetchTask), "AnimPrefetchTask");
+  task->position = position;
+  task->start = start;
+  task->end = end;
+  BLI_addtail(&prefetch->tasks, task);
+  return task;
+}
+
+static bool anim_prefetch_is_pending(AnimPrefetch *prefetch, int position)
+{
+  return IMB_moviecache_has_frame(prefetch->cache, &position) ||
+         anim_prefetch_find_task(prefetch, position) != NULL;
+}
+
+/* Queues the GOPs of the frames around the position which are not decoded yet, with the mutex
+ * locked. Returns the number of queued positions, the caller pushes their tasks after unlocking
+ * the mutex, as a pool without threads runs the task immediately. */
+static int anim_prefetch_queue(AnimPrefetch *prefetch,
+                               int position,
+                               int r_positions[ANIM_PREFETCH_FRAMES * 2])
+{
+  const int start = max_ii(position - ANIM_PREFETCH_FRAMES, 0);
+  const int end = min_ii(position + ANIM_PREFETCH_FRAMES, prefetch->anim->duration_in_frames);
+  const int gop_size = prefetch->gop_size;
+  int positions_len = 0;
+  int i;
+
+  if (prefetch->cache_full) {
+    return 0;
+  }
+
+  /* Frames ahead first, then the ones behind for reverse playback and scrubbing. */
+  for (i = position; i < end; i++) {
+    if (!anim_prefetch_is_pending(prefetch, i)) {
+      anim_prefetch_task_add(prefetch, i, i, i + gop_size);
+      r_positions[positions_len++] = i;
+      i += gop_size - 1;
+    }
+  }
+  for (i = position - 1; i >= start; i--) {
+    if (!anim_prefetch_is_pending(prefetch, i)) {
+      anim_prefetch_task_add(prefetch, i, i - gop_size + 1, i + 1);
+      r_positions[positions_len++] = i;
+      i -= gop_size - 1;
+    }
+  }
+
+  return positions_len;
+}
+
+/* Returns the cached frame, decoding its GOP when it isn't cached yet. NULL when the frame
+ * could not be decoded or cached, it is decoded sequentially then. */
+static ImBuf *anim_prefetch_fetch(AnimPrefetch *prefetch, int position)
+{
+  AnimPrefetchTask *task = NULL;
+  int positions[ANIM_PREFETCH_FRAMES * 2];
+  int positions_len;
+  ImBuf *ibuf;
+
+  BLI_mutex_lock(&prefetch->mutex);
+
+  /* Wait for the GOP being decoded, or take it from the queue. */
+  while ((ibuf = IMB_moviecache_get(prefetch->cache, &position)) == NULL &&
+         (task = anim_prefetch_find_task(prefetch, position)) && task->running) {
+    BLI_condition_wait(&prefetch->cond, &prefetch->mutex);
+  }
+
+  if (ibuf == NULL) {
+    if (task == NULL) {
+      task = anim_prefetch_task_add(prefetch, position, position, position + 1);
+    }
+    task->running = true;
+    prefetch->cache_full = false;
+    BLI_mutex_unlock(&prefetch->mutex);
+
+    anim_prefetch_decode(prefetch, task->position);
+
+    BLI_mutex_lock(&prefetch->mutex);
+    anim_prefetch_task_finish(prefetch, task);
+    ibuf = IMB_moviecache_get(prefetch->cache, &position);
+  }
+
+  positions_len = anim_prefetch_queue(prefetch, position, positions);
+
+  BLI_mutex_unlock(&prefetch->mutex);
+
+  for (int i = 0; i < positions_len; i++) {
+    BLI_task_pool_push(
+        prefetch->pool, anim_prefetch_task_run, POINTER_FROM_INT(positions[i]), false, NULL);
+  }
+
+  return ibuf;
+}
+
+static AnimPrefetch *anim_prefetch_create(struct anim *anim)
+{
+  AnimPrefetch *prefetch = MEM_callocN(sizeof(AnimPrefetch), "AnimPrefetch");
+  AVStream *v_st = anim->pFormatCtx->streams[anim->videoStream];
+
+  prefetch->anim = anim;
+  prefetch->pool = BLI_task_pool_create_background(prefetch, TASK_PRIORITY_LOW);
+  BLI_mutex_init(&prefetch->mutex);
+  BLI_condition_init(&prefetch->cond);
+  prefetch->max_decoders = min_ii(BLI_system_thread_count(), ANIM_PREFETCH_MAX_DECODERS);
+  prefetch->cache = IMB_moviecache_create(
+      "anim prefetch", sizeof(int), anim_prefetch_hashhash, anim_prefetch_hashcmp);
+  prefetch->gop_size = ANIM_PREFETCH_GOP_SIZE;
+
+  prefetch->frame_rate = av_q2d(av_guess_frame_rate(anim->pFormatCtx, v_st, NULL));
+  prefetch->pts_time_base = av_q2d(v_st->time_base);
+  prefetch->st_time = anim->pFormatCtx->start_time;
+
+  return prefetch;
+}
+
+static void anim_prefetch_free(AnimPrefetch *prefetch)
+{
+  AnimDecoder *decoder;
+
+  BLI_task_pool_cancel(prefetch->pool);
+  BLI_task_pool_free(prefetch->pool);
+
+  while ((decoder = BLI_pophead(&prefetch->decoders))) {
+    anim_decoder_free(prefetch->anim, decoder);
+  }
+  BLI_freelistN(&prefetch->tasks);
+
+  IMB_moviecache_free(prefetch->cache);
+
+  BLI_condition_end(&prefetch->cond);
+  BLI_mutex_end(&prefetch->mutex);
+  MEM_freeN(prefetch);
+}
+
 static ImBuf *ffmpeg_fetchibuf(struct anim *anim, int position, IMB_Timecode_Type tc)
 {
   int64_t pts_to_search = 0;
@@ -1063,11 +1694,7 @@ static ImBuf *ffmpeg_fetchibuf(struct anim *anim, int position, IMB_Timecode_Typ
     pts_to_search = IMB_indexer_get_pts(tc_index, new_frame_index);
   }
   else {
-    pts_to_search = (long long)floor(((double)position) / pts_time_base / frame_rate + 0.5);
-
-    if (st_time != AV_NOPTS_VALUE) {
-      pts_to_search += st_time / pts_time_base / AV_TIME_BASE;
-    }
+    pts_to_search = ffmpeg_position_to_pts(position, frame_rate, pts_time_base, st_time);
   }
 
   av_log(anim->pFormatCtx,
@@ -1090,6 +1717,13 @@ static ImBuf *ffmpeg_fetchibuf(struct anim *anim, int position, IMB_Timecode_Typ
     return anim->last_frame;
   }
 
+  if (anim->prefetch && !tc_index) {
+    ImBuf *ibuf = anim_prefetch_fetch(anim->prefetch, position);
+    if (ibuf) {
+      return ibuf;
+    }
+  }
+
   if (position > anim->curposition + 1 && anim->preseek && !tc_index &&
       position - (anim->curposition + 1) < anim->preseek) {
     av_log(anim->pFormatCtx, AV_LOG_DEBUG, "FETCH: within preseek interval (no index)\n");
@@ -1208,6 +1842,11 @@ static void free_anim_ffmpeg(struct anim *anim)
     return;
   }
 
+  if (anim->prefetch) {
+    anim_prefetch_free(anim->prefetch);
+    anim->prefetch = NULL;
+  }
+
   if (anim->pCodecCtx) {
     avcodec_close(anim->pCodecCtx);
     avformat_close_input(&anim->pFormatCtx);
@@ -1388,10 +2027,9 @@ struct ImBuf *IMB_anim_absolute(struct anim *anim,
 #endif
 #ifdef WITH_FFMPEG
     case ANIM_FFMPEG:
+      /* The position of the sequential decoder is kept by ffmpeg_fetchibuf(), frames of the
+       * prefetch cache don't change it. */
       ibuf = ffmpeg_fetchibuf(anim, position, tc);
-      if (ibuf) {
-        anim->curposition = position;
-      }
       filter_y = 0; /* done internally */
       break;
 #endif
@@ -1401,7 +2039,7 @@ struct ImBuf *IMB_anim_absolute(struct anim *anim,
     if (filter_y) {
       IMB_filtery(ibuf);
     }
-    BLI_snprintf(ibuf->name, sizeof(ibuf->name), "%s.%04d", anim->name, anim->curposition + 1);
+    BLI_snprintf(ibuf->name, sizeof(ibuf->name), "%s.%04d", anim->name, position + 1);
   }
   return (ibuf);
 }
@@ -123,6 +123,28 @@ struct Mesh *ABC_read_mesh(struct CacheReader *reader,
                            const char **err_str,
                            int flags);
 
+/* Returns the mesh ABC_read_mesh() would construct from current_mesh, if it was read in the
+ * background by ABC_prefetch_mesh() already. Returns NULL otherwise. */
+struct Mesh *ABC_read_mesh_prefetched(struct CacheReader *reader,
+                                      struct Object *ob,
+                                      struct Mesh *current_mesh,
+                                      const float time,
+                                      const char **err_str,
+                                      int flags);
+
+/* Starts reading the mesh at the given times from a copy of current_mesh in the background.
+ * Only has an effect for mesh objects. */
+void ABC_prefetch_mesh(struct CacheReader *reader,
+                       struct Object *ob,
+                       struct Mesh *current_mesh,
+                       const float *times,
+                       int times_num,
+                       int flags);
+
+/* Drops the meshes read by ABC_prefetch_mesh(), for when the mesh they were read from was edited
+ * in place. */
+void ABC_prefetch_mesh_clear(struct CacheReader *reader, struct Object *ob);
+
 bool ABC_mesh_topology_changed(struct CacheReader *reader,
                                struct Object *ob,
                                struct Mesh *existing_mesh,
@@ -22,11 +22,14 @@
  */
 
 #include "abc_reader_archive.h"
+#include "abc_reader_prefetch.h"
 
 #include "BKE_main.h"
 
+#include "BLI_math_base.h"
 #include "BLI_path_util.h"
 #include "BLI_string.h"
+#include "BLI_threads.h"
 
 #ifdef WIN32
 #  include "utfconv.h"
@@ -96,28 +99,40 @@ static IArchive open_archive(const std::string &filename,
   return IArchive();
 }
 
+/* Upper limit of the streams per archive, each stream holds a file handle. */
+#define ARCHIVE_MAX_STREAMS 16
+
 ArchiveReader::ArchiveReader(struct Main *bmain, const char *filename)
 {
   char abs_filename[FILE_MAX];
   BLI_strncpy(abs_filename, filename, FILE_MAX);
   BLI_path_abs(abs_filename, BKE_main_blendfile_path(bmain));
 
+  /* Open a stream per thread, so that parallel import and prefetching don't wait on each other
+   * for file access. */
+  const int num_streams = min_ii(BLI_system_thread_count(), ARCHIVE_MAX_STREAMS);
+
+  for (int i = 0; i < num_streams; i++) {
+    std::unique_ptr<std::ifstream> infile(new std::ifstream());
+
 #ifdef WIN32
-  UTF16_ENCODE(abs_filename);
-  std::wstring wstr(abs_filename_16);
-  m_infile.open(wstr.c_str(), std::ios::in | std::ios::binary);
-  UTF16_UN_ENCODE(abs_filename);
+    UTF16_ENCODE(abs_filename);
+    std::wstring wstr(abs_filename_16);
+    infile->open(wstr.c_str(), std::ios::in | std::ios::binary);
+    UTF16_UN_ENCODE(abs_filename);
 #else
-  m_infile.open(abs_filename, std::ios::in | std::ios::binary);
+    infile->open(abs_filename, std::ios::in | std::ios::binary);
 #endif
 
-  m_streams.push_back(&m_infile);
+    m_streams.push_back(infile.get());
+    m_infiles.push_back(std::move(infile));
+  }
 
   m_archive = open_archive(abs_filename, m_streams, m_is_hdf5);
 
   /* We can't open an HDF5 file from a stream, so close it. */
   if (m_is_hdf5) {
-    m_infile.close();
+    m_infiles.clear();
     m_streams.clear();
   }
 }
@@ -136,3 +151,13 @@ Alembic::Abc::IObject ArchiveReader::getTop()
 {
   return m_archive.getTop();
 }
+
+const std::shared_ptr<AbcMeshPrefetcher> &ArchiveReader::prefetcher()
+{
+  /* HDF5 can't be read from multiple threads, so there is no prefetching for it. */
+  if (!m_prefetcher && !m_is_hdf5) {
+    m_prefetcher = std::make_shared<AbcMeshPrefetcher>();
+  }
+
+  return m_prefetcher;
+}
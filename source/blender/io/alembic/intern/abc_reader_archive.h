@@ -33,7 +33,9 @@
 #include <Alembic/AbcCoreOgawa/All.h>
 
 #include <fstream>
+#include <memory>
 
+class AbcMeshPrefetcher;
 struct Main;
 struct Scene;
 
@@ -44,10 +46,13 @@ struct Scene;
 
 class ArchiveReader {
   Alembic::Abc::IArchive m_archive;
-  std::ifstream m_infile;
+  /* Ogawa reads from as many threads at once as it has streams. */
+  std::vector<std::unique_ptr<std::ifstream>> m_infiles;
   std::vector<std::istream *> m_streams;
   bool m_is_hdf5;
 
+  std::shared_ptr<AbcMeshPrefetcher> m_prefetcher;
+
  public:
   ArchiveReader(struct Main *bmain, const char *filename);
 
@@ -62,6 +67,12 @@ class ArchiveReader {
   bool is_hdf5() const;
 
   Alembic::Abc::IObject getTop();
+
+  /**
+   * Returns the prefetcher of upcoming mesh samples, shared by the readers of this archive.
+   * Empty for HDF5 archives, which don't support reading from multiple threads.
+   */
+  const std::shared_ptr<AbcMeshPrefetcher> &prefetcher();
 };
 
 #endif /* __ABC_READER_ARCHIVE_H__ */
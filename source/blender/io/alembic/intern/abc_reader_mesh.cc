@@ -494,6 +494,11 @@ template<> bool has_animations(Alembic::AbcGeom::IPolyMeshSchema &schema, Import
          (normalsParam.valid() && !normalsParam.isConstant());
 }
 
+void AbcMeshReader::readObjectSample(const Alembic::Abc::ISampleSelector &sample_sel)
+{
+  read_sample_mesh(sample_sel);
+}
+
 void AbcMeshReader::readObjectData(Main *bmain, const Alembic::Abc::ISampleSelector &sample_sel)
 {
   Mesh *mesh = BKE_mesh_add(bmain, m_data_name.c_str());
@@ -501,7 +506,7 @@ void AbcMeshReader::readObjectData(Main *bmain, const Alembic::Abc::ISampleSelec
   m_object = BKE_object_add_only_object(bmain, OB_MESH, m_object_name.c_str());
   m_object->data = mesh;
 
-  Mesh *read_mesh = this->read_mesh(mesh, sample_sel, MOD_MESHSEQ_READ_ALL, NULL);
+  Mesh *read_mesh = take_sample_mesh(mesh, sample_sel);
   if (read_mesh != mesh) {
     /* XXX fixme after 2.80; mesh->flag isn't copied by BKE_mesh_nomain_to_mesh() */
     /* read_mesh can be freed by BKE_mesh_nomain_to_mesh(), so get the flag before that happens. */
@@ -807,6 +812,11 @@ bool AbcSubDReader::accepts_object_type(
   return true;
 }
 
+void AbcSubDReader::readObjectSample(const Alembic::Abc::ISampleSelector &sample_sel)
+{
+  read_sample_mesh(sample_sel);
+}
+
 void AbcSubDReader::readObjectData(Main *bmain, const Alembic::Abc::ISampleSelector &sample_sel)
 {
   Mesh *mesh = BKE_mesh_add(bmain, m_data_name.c_str());
@@ -814,7 +824,7 @@ void AbcSubDReader::readObjectData(Main *bmain, const Alembic::Abc::ISampleSelec
   m_object = BKE_object_add_only_object(bmain, OB_MESH, m_object_name.c_str());
   m_object->data = mesh;
 
-  Mesh *read_mesh = this->read_mesh(mesh, sample_sel, MOD_MESHSEQ_READ_ALL, NULL);
+  Mesh *read_mesh = take_sample_mesh(mesh, sample_sel);
   if (read_mesh != mesh) {
     BKE_mesh_nomain_to_mesh(read_mesh, mesh, m_object, &CD_MASK_MESH, true);
   }
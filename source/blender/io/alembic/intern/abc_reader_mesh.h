@@ -38,6 +38,7 @@ class AbcMeshReader : public AbcObjectReader {
   bool accepts_object_type(const Alembic::AbcCoreAbstract::ObjectHeader &alembic_header,
                            const Object *const ob,
                            const char **err_str) const override;
+  void readObjectSample(const Alembic::Abc::ISampleSelector &sample_sel) override;
   void readObjectData(Main *bmain, const Alembic::Abc::ISampleSelector &sample_sel) override;
 
   struct Mesh *read_mesh(struct Mesh *existing_mesh,
@@ -70,6 +71,7 @@ class AbcSubDReader : public AbcObjectReader {
   bool accepts_object_type(const Alembic::AbcCoreAbstract::ObjectHeader &alembic_header,
                            const Object *const ob,
                            const char **err_str) const;
+  void readObjectSample(const Alembic::Abc::ISampleSelector &sample_sel);
   void readObjectData(Main *bmain, const Alembic::Abc::ISampleSelector &sample_sel);
   struct Mesh *read_mesh(struct Mesh *existing_mesh,
                          const Alembic::Abc::ISampleSelector &sample_sel,
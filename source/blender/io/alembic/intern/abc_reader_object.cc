@@ -29,6 +29,7 @@
 
 #include "BKE_constraint.h"
 #include "BKE_lib_id.h"
+#include "BKE_mesh.h"
 #include "BKE_modifier.h"
 #include "BKE_object.h"
 
@@ -51,6 +52,7 @@ AbcObjectReader::AbcObjectReader(const IObject &object, ImportSettings &settings
       m_min_time(std::numeric_limits<chrono_t>::max()),
       m_max_time(std::numeric_limits<chrono_t>::min()),
       m_refcount(0),
+      m_sample_mesh(NULL),
       parent_reader(NULL)
 {
   m_name = object.getFullName();
@@ -100,6 +102,9 @@ void AbcObjectReader::determine_inherits_xform()
 
 AbcObjectReader::~AbcObjectReader()
 {
+  if (m_sample_mesh) {
+    BKE_id_free(NULL, m_sample_mesh);
+  }
 }
 
 const IObject &AbcObjectReader::iobject() const
@@ -177,6 +182,37 @@ struct Mesh *AbcObjectReader::read_mesh(struct Mesh *existing_mesh,
   return existing_mesh;
 }
 
+void AbcObjectReader::readObjectSample(const Alembic::Abc::ISampleSelector &UNUSED(sample_sel))
+{
+}
+
+void AbcObjectReader::read_sample_mesh(const Alembic::Abc::ISampleSelector &sample_sel)
+{
+  /* Reading into an empty mesh always creates a new one, like when importing into a mesh that
+   * was just added to Main. */
+  Mesh *template_mesh = BKE_mesh_new_nomain(0, 0, 0, 0, 0);
+  Mesh *mesh = this->read_mesh(template_mesh, sample_sel, MOD_MESHSEQ_READ_ALL, NULL);
+
+  if (mesh != template_mesh) {
+    BKE_id_free(NULL, template_mesh);
+  }
+
+  m_sample_mesh = mesh;
+}
+
+Mesh *AbcObjectReader::take_sample_mesh(Mesh *existing_mesh,
+                                        const Alembic::Abc::ISampleSelector &sample_sel)
+{
+  Mesh *mesh = m_sample_mesh;
+  m_sample_mesh = NULL;
+
+  if (mesh == NULL) {
+    mesh = this->read_mesh(existing_mesh, sample_sel, MOD_MESHSEQ_READ_ALL, NULL);
+  }
+
+  return mesh;
+}
+
 bool AbcObjectReader::topology_changed(Mesh * /*existing_mesh*/,
                                        const Alembic::Abc::ISampleSelector & /*sample_sel*/)
 {
@@ -330,3 +366,13 @@ void AbcObjectReader::decref()
   m_refcount--;
   BLI_assert(m_refcount >= 0);
 }
+
+AbcMeshPrefetcher *AbcObjectReader::prefetcher() const
+{
+  return m_prefetcher.get();
+}
+
+void AbcObjectReader::prefetcher(const std::shared_ptr<AbcMeshPrefetcher> &prefetcher)
+{
+  m_prefetcher = prefetcher;
+}
@@ -26,6 +26,9 @@
 
 #include "DNA_ID.h"
 
+#include <memory>
+
+class AbcMeshPrefetcher;
 struct CacheFile;
 struct Main;
 struct Mesh;
@@ -94,6 +97,12 @@ class AbcObjectReader {
 
   bool m_inherits_xform;
 
+  /* Geometry read by readObjectSample(), owned by the reader until readObjectData() takes it. */
+  Mesh *m_sample_mesh;
+
+  /* Background reader of upcoming frames, shared by all readers of the archive. */
+  std::shared_ptr<AbcMeshPrefetcher> m_prefetcher;
+
  public:
   AbcObjectReader *parent_reader;
 
@@ -137,6 +146,11 @@ class AbcObjectReader {
                                    const Object *const ob,
                                    const char **err_str) const = 0;
 
+  /**
+   * Reads the geometry for readObjectData() into memory that is not part of Main. Since
+   * this doesn't modify Main, the importer calls it for all readers in parallel first.
+   */
+  virtual void readObjectSample(const Alembic::Abc::ISampleSelector &sample_sel);
   virtual void readObjectData(Main *bmain, const Alembic::Abc::ISampleSelector &sample_sel) = 0;
 
   virtual struct Mesh *read_mesh(struct Mesh *mesh,
@@ -160,8 +174,19 @@ class AbcObjectReader {
 
   void read_matrix(float r_mat[4][4], const float time, const float scale, bool &is_constant);
 
+  AbcMeshPrefetcher *prefetcher() const;
+  void prefetcher(const std::shared_ptr<AbcMeshPrefetcher> &prefetcher);
+
  protected:
   void determine_inherits_xform();
+
+  /** Reads the full geometry of the sample into a new mesh outside of Main. */
+  void read_sample_mesh(const Alembic::Abc::ISampleSelector &sample_sel);
+  /**
+   * Returns the mesh read by readObjectSample(), or reads the sample into the given mesh when
+   * there is none, returning what read_mesh() returns.
+   */
+  Mesh *take_sample_mesh(Mesh *existing_mesh, const Alembic::Abc::ISampleSelector &sample_sel);
 };
 
 Imath::M44d get_matrix(const Alembic::AbcGeom::IXformSchema &schema, const float time);
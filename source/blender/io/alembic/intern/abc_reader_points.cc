@@ -76,10 +76,15 @@ bool AbcPointsReader::accepts_object_type(
   return true;
 }
 
+void AbcPointsReader::readObjectSample(const Alembic::Abc::ISampleSelector &sample_sel)
+{
+  read_sample_mesh(sample_sel);
+}
+
 void AbcPointsReader::readObjectData(Main *bmain, const Alembic::Abc::ISampleSelector &sample_sel)
 {
   Mesh *mesh = BKE_mesh_add(bmain, m_data_name.c_str());
-  Mesh *read_mesh = this->read_mesh(mesh, sample_sel, 0, NULL);
+  Mesh *read_mesh = take_sample_mesh(mesh, sample_sel);
 
   if (read_mesh != mesh) {
     BKE_mesh_nomain_to_mesh(read_mesh, mesh, m_object, &CD_MASK_MESH, true);
@@ -39,6 +39,7 @@ class AbcPointsReader : public AbcObjectReader {
                            const Object *const ob,
                            const char **err_str) const;
 
+  void readObjectSample(const Alembic::Abc::ISampleSelector &sample_sel);
   void readObjectData(Main *bmain, const Alembic::Abc::ISampleSelector &sample_sel);
 
   struct Mesh *read_mesh(struct Mesh *existing_mesh,
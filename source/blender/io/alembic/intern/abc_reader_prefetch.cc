@@ -0,0 +1,366 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+/** \file
+ * \ingroup balembic
+ */
+
+#include "abc_reader_prefetch.h"
+#include "abc_reader_object.h"
+
+#include "MEM_guardedalloc.h"
+
+#include "DNA_customdata_types.h"
+#include "DNA_mesh_types.h"
+
+#include "BKE_customdata.h"
+#include "BKE_lib_id.h"
+
+#include "BLI_task.h"
+
+using Alembic::AbcGeom::ISampleSelector;
+
+namespace {
+
+struct PrefetchTask {
+  AbcObjectReader *reader;
+  float time;
+};
+
+const int mesh_copy_flags = LIB_ID_CREATE_NO_MAIN | LIB_ID_CREATE_NO_USER_REFCOUNT |
+                            LIB_ID_CREATE_NO_DEG_TAG | LIB_ID_COPY_NO_PREVIEW;
+
+Mesh *mesh_copy(const Mesh *mesh)
+{
+  Mesh *result;
+  BKE_id_copy_ex(NULL, &mesh->id, (ID **)&result, mesh_copy_flags);
+  return result;
+}
+
+size_t customdata_memory(const CustomData *data, int totelem)
+{
+  size_t memory = 0;
+  for (int i = 0; i < data->totlayer; i++) {
+    memory += size_t(CustomData_sizeof(data->layers[i].type)) * totelem;
+  }
+  return memory;
+}
+
+void customdata_layers(const CustomData *data, std::vector<std::pair<int, const void *>> &r_layers)
+{
+  /* Only the layers shared with the original mesh, the evaluation adds layers like ORCO or
+   * ORIGINDEX to every copy. The marker separates the layers of the domains. */
+  r_layers.emplace_back(-1, nullptr);
+  for (int i = 0; i < data->totlayer; i++) {
+    if (data->layers[i].flag & CD_FLAG_NOFREE) {
+      r_layers.emplace_back(data->layers[i].type, data->layers[i].data);
+    }
+  }
+}
+
+size_t mesh_memory(const Mesh *mesh)
+{
+  return sizeof(Mesh) + customdata_memory(&mesh->vdata, mesh->totvert) +
+         customdata_memory(&mesh->edata, mesh->totedge) +
+         customdata_memory(&mesh->ldata, mesh->totloop) +
+         customdata_memory(&mesh->pdata, mesh->totpoly);
+}
+
+}  // namespace
+
+AbcMeshPrefetcher::MeshKey::MeshKey()
+    : mvert(NULL),
+      medge(NULL),
+      mpoly(NULL),
+      mloop(NULL),
+      dvert(NULL),
+      totvert(0),
+      totedge(0),
+      totpoly(0),
+      totloop(0)
+{
+}
+
+AbcMeshPrefetcher::MeshKey::MeshKey(const Mesh *mesh)
+    : mvert(mesh->mvert),
+      medge(mesh->medge),
+      mpoly(mesh->mpoly),
+      mloop(mesh->mloop),
+      dvert(mesh->dvert),
+      totvert(mesh->totvert),
+      totedge(mesh->totedge),
+      totpoly(mesh->totpoly),
+      totloop(mesh->totloop)
+{
+  customdata_layers(&mesh->vdata, layers);
+  customdata_layers(&mesh->edata, layers);
+  customdata_layers(&mesh->ldata, layers);
+  customdata_layers(&mesh->pdata, layers);
+}
+
+bool AbcMeshPrefetcher::MeshKey::operator==(const MeshKey &other) const
+{
+  return mvert == other.mvert && medge == other.medge && mpoly == other.mpoly &&
+         mloop == other.mloop && dvert == other.dvert && totvert == other.totvert &&
+         totedge == other.totedge && totpoly == other.totpoly && totloop == other.totloop &&
+         layers == other.layers;
+}
+
+bool AbcMeshPrefetcher::MeshKey::operator!=(const MeshKey &other) const
+{
+  return !(*this == other);
+}
+
+AbcMeshPrefetcher::AbcMeshPrefetcher(size_t memory_limit)
+    : m_reading(NULL), m_memory_used(0), m_memory_limit(memory_limit)
+{
+  m_pool = BLI_task_pool_create_background_serial(this, TASK_PRIORITY_LOW);
+}
+
+AbcMeshPrefetcher::~AbcMeshPrefetcher()
+{
+  BLI_task_pool_cancel(m_pool);
+  BLI_task_pool_free(m_pool);
+
+  std::vector<Mesh *> meshes;
+  for (auto &item : m_readers) {
+    free_frames(item.second, meshes);
+  }
+
+  for (Mesh *mesh : meshes) {
+    BKE_id_free(NULL, mesh);
+  }
+}
+
+void AbcMeshPrefetcher::free_frames(ReaderState &state, std::vector<Mesh *> &r_meshes)
+{
+  for (auto &item : state.frames) {
+    m_memory_used -= item.second.memory;
+    r_meshes.push_back(item.second.mesh);
+  }
+
+  state.frames.clear();
+}
+
+void AbcMeshPrefetcher::request(AbcObjectReader *reader,
+                                const Mesh *input_mesh,
+                                const std::vector<float> &times,
+                                int read_flag)
+{
+  const MeshKey key(input_mesh);
+  std::vector<Mesh *> dropped;
+  std::shared_ptr<Mesh> template_mesh;
+
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    ReaderState &state = m_readers[reader];
+
+    if (!state.template_mesh || state.key != key || state.read_flag != read_flag) {
+      free_frames(state, dropped);
+      state.queued.clear();
+      state.template_mesh.reset();
+    }
+    else {
+      template_mesh = state.template_mesh;
+    }
+  }
+
+  /* Copy the input mesh outside of the lock, it is only used by this thread. */
+  if (!template_mesh) {
+    template_mesh = std::shared_ptr<Mesh>(mesh_copy(input_mesh),
+                                          [](Mesh *mesh) { BKE_id_free(NULL, mesh); });
+  }
+
+  std::vector<float> queue;
+
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    ReaderState &state = m_readers[reader];
+
+    state.key = key;
+    state.read_flag = read_flag;
+    state.template_mesh = template_mesh;
+
+    const std::set<float> requested(times.begin(), times.end());
+
+    for (auto iter = state.frames.begin(); iter != state.frames.end();) {
+      if (requested.count(iter->first)) {
+        ++iter;
+        continue;
+      }
+
+      m_memory_used -= iter->second.memory;
+      dropped.push_back(iter->second.mesh);
+      iter = state.frames.erase(iter);
+    }
+
+    for (auto iter = state.queued.begin(); iter != state.queued.end();) {
+      iter = requested.count(*iter) ? std::next(iter) : state.queued.erase(iter);
+    }
+
+    for (float time : requested) {
+      if (state.frames.count(time) == 0 && state.queued.insert(time).second) {
+        queue.push_back(time);
+      }
+    }
+  }
+
+  for (float time : queue) {
+    PrefetchTask *task = static_cast<PrefetchTask *>(
+        MEM_mallocN(sizeof(PrefetchTask), "AbcMeshPrefetcher task"));
+    task->reader = reader;
+    task->time = time;
+    BLI_task_pool_push(m_pool, read_task, task, true, NULL);
+  }
+
+  for (Mesh *mesh : dropped) {
+    BKE_id_free(NULL, mesh);
+  }
+}
+
+Mesh *AbcMeshPrefetcher::take(AbcObjectReader *reader,
+                              const Mesh *input_mesh,
+                              float time,
+                              int read_flag,
+                              const char **err_str)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  auto state_iter = m_readers.find(reader);
+  if (state_iter == m_readers.end()) {
+    return NULL;
+  }
+
+  ReaderState &state = state_iter->second;
+  if (state.key != MeshKey(input_mesh) || state.read_flag != read_flag) {
+    return NULL;
+  }
+
+  auto frame_iter = state.frames.find(time);
+  if (frame_iter == state.frames.end()) {
+    return NULL;
+  }
+
+  const Frame frame = frame_iter->second;
+  state.frames.erase(frame_iter);
+  m_memory_used -= frame.memory;
+
+  if (frame.err_str) {
+    *err_str = frame.err_str;
+  }
+
+  return frame.mesh;
+}
+
+void AbcMeshPrefetcher::remove(AbcObjectReader *reader)
+{
+  std::vector<Mesh *> dropped;
+
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    /* The background thread uses the reader without holding the lock. */
+    m_read_done.wait(lock, [&] { return m_reading != reader; });
+
+    auto state_iter = m_readers.find(reader);
+    if (state_iter != m_readers.end()) {
+      free_frames(state_iter->second, dropped);
+      m_readers.erase(state_iter);
+    }
+  }
+
+  for (Mesh *mesh : dropped) {
+    BKE_id_free(NULL, mesh);
+  }
+}
+
+void AbcMeshPrefetcher::read_task(TaskPool *__restrict pool, void *taskdata)
+{
+  AbcMeshPrefetcher *prefetcher = static_cast<AbcMeshPrefetcher *>(BLI_task_pool_user_data(pool));
+  const PrefetchTask *task = static_cast<const PrefetchTask *>(taskdata);
+
+  prefetcher->read(task->reader, task->time);
+}
+
+void AbcMeshPrefetcher::read(AbcObjectReader *reader, float time)
+{
+  std::shared_ptr<Mesh> template_mesh;
+  MeshKey key;
+  int read_flag;
+
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto state_iter = m_readers.find(reader);
+    if (state_iter == m_readers.end()) {
+      return;
+    }
+
+    ReaderState &state = state_iter->second;
+
+    /* Not requested anymore, or dropped because the input mesh changed. */
+    if (state.queued.erase(time) == 0) {
+      return;
+    }
+
+    /* Taking frames frees memory, the next request queues the frame again. */
+    if (m_memory_used >= m_memory_limit) {
+      return;
+    }
+
+    template_mesh = state.template_mesh;
+    key = state.key;
+    read_flag = state.read_flag;
+    m_reading = reader;
+  }
+
+  /* Same as the Mesh Sequence Cache modifier does: read into a copy of the input mesh, with
+   * kFloorIndex for compatibility with non-interpolating properties. */
+  Mesh *mesh = mesh_copy(template_mesh.get());
+  const char *err_str = NULL;
+  Mesh *result = reader->read_mesh(
+      mesh, ISampleSelector(time, ISampleSelector::kFloorIndex), read_flag, &err_str);
+
+  if (result != mesh) {
+    BKE_id_free(NULL, mesh);
+  }
+
+  const Frame frame = {result, err_str, mesh_memory(result)};
+  bool stored = false;
+
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto state_iter = m_readers.find(reader);
+    if (state_iter != m_readers.end()) {
+      ReaderState &state = state_iter->second;
+
+      if (state.key == key && state.read_flag == read_flag && state.frames.count(time) == 0) {
+        state.frames[time] = frame;
+        m_memory_used += frame.memory;
+        stored = true;
+      }
+    }
+
+    m_reading = NULL;
+  }
+
+  m_read_done.notify_all();
+
+  if (!stored) {
+    BKE_id_free(NULL, result);
+  }
+}
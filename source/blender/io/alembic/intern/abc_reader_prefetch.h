@@ -0,0 +1,119 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+/** \file
+ * \ingroup balembic
+ */
+
+#ifndef __ABC_READER_PREFETCH_H__
+#define __ABC_READER_PREFETCH_H__
+
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <utility>
+#include <vector>
+
+class AbcObjectReader;
+struct Mesh;
+struct TaskPool;
+
+/* Memory the prefetched meshes of one archive may use. */
+#define ABC_PREFETCH_MEMORY_LIMIT (512 * 1024 * 1024)
+
+/* Reads the meshes of upcoming frames in a background thread, so that the Mesh Sequence Cache
+ * modifier can swap in geometry that is ready instead of reading it during depsgraph evaluation.
+ *
+ * A prefetched mesh is the result of AbcObjectReader::read_mesh() on a copy of the modifier
+ * input mesh, so it is only handed out while the input mesh is still the same. Frames are read
+ * one after the other, and only while the cached meshes use less than the memory limit. */
+class AbcMeshPrefetcher {
+  /* Identifies the input mesh the frames were read from. The modifier input is a new copy on
+   * every evaluation, but its arrays are shared with the original mesh, so they identify it.
+   * Edits that keep the arrays, like painting, must drop the frames with remove(). */
+  struct MeshKey {
+    const void *mvert, *medge, *mpoly, *mloop, *dvert;
+    int totvert, totedge, totpoly, totloop;
+    /* Type and data of the shared custom data layers, so that an added UV or color layer of the
+     * original mesh is found. */
+    std::vector<std::pair<int, const void *>> layers;
+
+    MeshKey();
+    explicit MeshKey(const Mesh *mesh);
+    bool operator==(const MeshKey &other) const;
+    bool operator!=(const MeshKey &other) const;
+  };
+
+  struct Frame {
+    Mesh *mesh;
+    const char *err_str;
+    size_t memory;
+  };
+
+  struct ReaderState {
+    MeshKey key;
+    int read_flag;
+    /* Copy of the input mesh, frames are read into copies of it. */
+    std::shared_ptr<Mesh> template_mesh;
+    std::map<float, Frame> frames;
+    std::set<float> queued;
+  };
+
+  std::mutex m_mutex;
+  std::condition_variable m_read_done;
+  std::map<AbcObjectReader *, ReaderState> m_readers;
+  /* Reader whose mesh the background thread is reading right now. */
+  AbcObjectReader *m_reading;
+  size_t m_memory_used;
+  size_t m_memory_limit;
+  TaskPool *m_pool;
+
+ public:
+  explicit AbcMeshPrefetcher(size_t memory_limit = ABC_PREFETCH_MEMORY_LIMIT);
+  ~AbcMeshPrefetcher();
+
+  /**
+   * Queues reading of the reader's mesh at the given times, from the input mesh. Frames that
+   * were read before at other times are dropped.
+   */
+  void request(AbcObjectReader *reader,
+               const Mesh *input_mesh,
+               const std::vector<float> &times,
+               int read_flag);
+
+  /**
+   * Returns the mesh read at the time from the input mesh, and passes its ownership to the
+   * caller. Returns NULL when it isn't ready.
+   */
+  Mesh *take(AbcObjectReader *reader,
+             const Mesh *input_mesh,
+             float time,
+             int read_flag,
+             const char **err_str);
+
+  /** Drops all frames of the reader, waiting for the one being read right now. */
+  void remove(AbcObjectReader *reader);
+
+ private:
+  static void read_task(struct TaskPool *__restrict pool, void *taskdata);
+  void read(AbcObjectReader *reader, float time);
+
+  void free_frames(ReaderState &state, std::vector<Mesh *> &r_meshes);
+};
+
+#endif /* __ABC_READER_PREFETCH_H__ */
@@ -28,6 +28,7 @@
 #include "abc_reader_mesh.h"
 #include "abc_reader_nurbs.h"
 #include "abc_reader_points.h"
+#include "abc_reader_prefetch.h"
 #include "abc_reader_transform.h"
 #include "abc_util.h"
 #include "abc_writer_camera.h"
@@ -70,6 +71,7 @@
 #include "BLI_math.h"
 #include "BLI_path_util.h"
 #include "BLI_string.h"
+#include "BLI_task.h"
 
 #include "WM_api.h"
 #include "WM_types.h"
@@ -644,6 +646,25 @@ struct ImportJobData {
   bool import_ok;
 };
 
+struct ReadObjectSampleData {
+  std::vector<AbcObjectReader *> *readers;
+  const ISampleSelector *sample_sel;
+};
+
+static void read_object_sample_cb(void *__restrict userdata,
+                                  const int index,
+                                  const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  ReadObjectSampleData *data = static_cast<ReadObjectSampleData *>(userdata);
+  AbcObjectReader *reader = (*data->readers)[index];
+
+  if (G.is_break || !reader->valid()) {
+    return;
+  }
+
+  reader->readObjectSample(*data->sample_sel);
+}
+
 static void import_startjob(void *user_data, short *stop, short *do_update, float *progress)
 {
   SCOPE_TIMER("Alembic import, objects reading and creation");
@@ -701,6 +722,26 @@ static void import_startjob(void *user_data, short *stop, short *do_update, floa
   *data->do_update = true;
   *data->progress = 0.1f;
 
+  /* Read the geometry of all objects in parallel, this doesn't touch Main yet. */
+
+  ISampleSelector sample_sel(0.0f);
+  ReadObjectSampleData sample_data = {&data->readers, &sample_sel};
+
+  TaskParallelSettings task_settings;
+  BLI_parallel_range_settings_defaults(&task_settings);
+  /* HDF5 archives can't be read from multiple threads. */
+  task_settings.use_threading = !archive->is_hdf5();
+  BLI_task_parallel_range(
+      0, data->readers.size(), &sample_data, read_object_sample_cb, &task_settings);
+
+  if (G.is_break) {
+    data->was_cancelled = true;
+    return;
+  }
+
+  *data->do_update = true;
+  *data->progress = 0.3f;
+
   /* Create objects and set scene frame range. */
 
   const float size = static_cast<float>(data->readers.size());
@@ -709,7 +750,6 @@ static void import_startjob(void *user_data, short *stop, short *do_update, floa
   chrono_t min_time = std::numeric_limits<chrono_t>::max();
   chrono_t max_time = std::numeric_limits<chrono_t>::min();
 
-  ISampleSelector sample_sel(0.0f);
   std::vector<AbcObjectReader *>::iterator iter;
   for (iter = data->readers.begin(); iter != data->readers.end(); ++iter) {
     AbcObjectReader *reader = *iter;
@@ -725,7 +765,7 @@ static void import_startjob(void *user_data, short *stop, short *do_update, floa
                 << " is invalid.\n";
     }
 
-    *data->progress = 0.1f + 0.3f * (++i / size);
+    *data->progress = 0.3f + 0.1f * (++i / size);
     *data->do_update = true;
 
     if (G.is_break) {
@@ -1003,6 +1043,55 @@ Mesh *ABC_read_mesh(CacheReader *reader,
   return abc_reader->read_mesh(existing_mesh, sample_sel, read_flag, err_str);
 }
 
+Mesh *ABC_read_mesh_prefetched(CacheReader *reader,
+                               Object *ob,
+                               Mesh *existing_mesh,
+                               const float time,
+                               const char **err_str,
+                               int read_flag)
+{
+  const char *reader_err_str = NULL;
+  AbcObjectReader *abc_reader = get_abc_reader(reader, ob, &reader_err_str);
+  if (abc_reader == NULL || abc_reader->prefetcher() == NULL) {
+    return NULL;
+  }
+
+  return abc_reader->prefetcher()->take(abc_reader, existing_mesh, time, read_flag, err_str);
+}
+
+void ABC_prefetch_mesh(CacheReader *reader,
+                       Object *ob,
+                       Mesh *existing_mesh,
+                       const float *times,
+                       int times_num,
+                       int read_flag)
+{
+  /* Only meshes are read without modifying the object, which the prefetching relies on. */
+  if (ob->type != OB_MESH) {
+    return;
+  }
+
+  const char *err_str = NULL;
+  AbcObjectReader *abc_reader = get_abc_reader(reader, ob, &err_str);
+  if (abc_reader == NULL || abc_reader->prefetcher() == NULL) {
+    return;
+  }
+
+  abc_reader->prefetcher()->request(
+      abc_reader, existing_mesh, std::vector<float>(times, times + times_num), read_flag);
+}
+
+void ABC_prefetch_mesh_clear(CacheReader *reader, Object *ob)
+{
+  const char *err_str = NULL;
+  AbcObjectReader *abc_reader = get_abc_reader(reader, ob, &err_str);
+  if (abc_reader == NULL || abc_reader->prefetcher() == NULL) {
+    return;
+  }
+
+  abc_reader->prefetcher()->remove(abc_reader);
+}
+
 bool ABC_mesh_topology_changed(
     CacheReader *reader, Object *ob, Mesh *existing_mesh, const float time, const char **err_str)
 {
@@ -1023,6 +1112,10 @@ void CacheReader_free(CacheReader *reader)
   abc_reader->decref();
 
   if (abc_reader->refcount() == 0) {
+    /* Wait for the reader to be unused before its schema gets destroyed. */
+    if (abc_reader->prefetcher()) {
+      abc_reader->prefetcher()->remove(abc_reader);
+    }
     delete abc_reader;
   }
 }
@@ -1062,6 +1155,7 @@ CacheReader *CacheReader_open_alembic_object(AbcArchiveHandle *handle,
     return NULL;
   }
   abc_reader->object(object);
+  abc_reader->prefetcher(archive->prefetcher());
   abc_reader->incref();
 
   return reinterpret_cast<CacheReader *>(abc_reader);
@@ -829,8 +829,11 @@ typedef struct BooleanModifierData {
   ModifierData modifier;
 
   struct Object *object;
+  /** Used when operand_type is #eBooleanModifierOperandType_Collection. */
+  struct Collection *collection;
   char operation;
-  char _pad[2];
+  char operand_type;
+  char _pad[1];
   char bm_flag;
   float double_threshold;
 } BooleanModifierData;
@@ -841,6 +844,13 @@ typedef enum {
   eBooleanModifierOp_Difference = 2,
 } BooleanModifierOp;
 
+/* operand_type */
+typedef enum {
+  eBooleanModifierOperandType_Object = 0,
+  /** All mesh objects in the collection are intersected in a single pass. */
+  eBooleanModifierOperandType_Collection = 1,
+} BooleanModifierOperandType;
+
 /* bm_flag (only used when G_DEBUG) */
 enum {
   eBooleanModifierBMeshFlag_BMesh_Separate = (1 << 0),
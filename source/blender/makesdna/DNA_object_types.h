@@ -403,6 +403,11 @@ typedef struct Object {
   /** Contains data for levels of detail. */
   ListBase lodlevels;
   LodLevel *currentlod;
+  /** Levels of detail generated at game start when #OB_LOD_GENERATE is set. */
+  float lod_generate_ratio;
+  float lod_generate_distance;
+  short lod_generate_levels;
+  char _pad54[6];
 
   /* settings for game engine bullet soft body */
   struct BulletSoftBody *bsoft;
@@ -766,6 +771,8 @@ enum {
   OB_LOCK_RIGID_BODY_X_ROT_AXIS = 1 << 5,
   OB_LOCK_RIGID_BODY_Y_ROT_AXIS = 1 << 6,
   OB_LOCK_RIGID_BODY_Z_ROT_AXIS = 1 << 7,
+  OB_LOD_GENERATE = 1 << 8,
+  OB_NO_ANIMATION_LOD = 1 << 9,
 
   /*	OB_LIFE     = OB_PROP | OB_DYNAMIC | OB_ACTOR | OB_MAINACTOR | OB_CHILD, */
 };
@@ -881,7 +881,11 @@ typedef struct GameData {
   float timeScale;
   float levelHeight;
   float deactivationtime, lineardeactthreshold, angulardeactthreshold;
-  int _pad[2];
+
+  /* Armature animation LoD, see #SCE_LOD_ANIMATION. */
+  float anim_lod_distance;
+  short anim_lod_interval;
+  char _pad[2];
 
   /* Scene LoD */
   short lodflag, _pad2;
@@ -946,6 +950,8 @@ typedef struct GameData {
 #define GAME_USE_UI_ANTI_FLICKER (1 << 20)
 #define GAME_USE_VIEWPORT_RENDER (1 << 21)
 #define GAME_PYTHON_CONSOLE (1 << 22)
+#define GAME_USE_DBVT_CULLING (1 << 23)
+#define GAME_USE_CONVERSION_CACHE (1 << 24)
 /* Note: GameData.flag is now an int (max 32 flags). A short could only take 16 flags */
 
 /* GameData.playerflag */
@@ -963,6 +969,7 @@ enum {
 
 /* GameData.lodflag */
 #define SCE_LOD_USE_HYST (1 << 0)
+#define SCE_LOD_ANIMATION (1 << 1)
 
 /* UV Paint */
 /* ToolSettings.uv_sculpt_settings */
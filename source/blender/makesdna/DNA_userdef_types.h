@@ -874,7 +874,7 @@ typedef struct UserDef {
   int sequencer_disk_cache_compression; /* eUserpref_DiskCacheCompression */
   int sequencer_disk_cache_size_limit;
   short sequencer_disk_cache_flag;
-  char _pad5[2];
+  short movie_flag; /* eUserpref_MovieFlag */
 
   float collection_instance_empty_size;
   char _pad10[4];
@@ -1307,6 +1307,11 @@ typedef enum eUserpref_DiskCacheCompression {
   USER_SEQ_DISK_CACHE_COMPRESSION_HIGH = 2,
 } eUserpref_DiskCacheCompression;
 
+/** #UserDef.movie_flag */
+typedef enum eUserpref_MovieFlag {
+  USER_MOVIE_PARALLEL_DECODING = (1 << 0),
+} eUserpref_MovieFlag;
+
 /* Locale Ids. Auto will try to get local from OS. Our default is English though. */
 /** #UserDef.language */
 enum {
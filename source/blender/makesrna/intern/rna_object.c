@@ -4063,6 +4063,45 @@ static void rna_def_object(BlenderRNA *brna)
                            "A collection of detail levels to automatically switch between");
   RNA_def_property_update(prop, NC_OBJECT | ND_LOD, NULL);
 
+  prop = RNA_def_property(srna, "use_lod_generate", PROP_BOOLEAN, PROP_NONE);
+  RNA_def_property_boolean_sdna(prop, NULL, "gameflag2", OB_LOD_GENERATE);
+  RNA_def_property_ui_text(prop,
+                           "Generate Levels of Detail",
+                           "Generate decimated levels of detail when the game starts, "
+                           "used when the object has no levels of detail of its own");
+  RNA_def_property_update(prop, NC_OBJECT | ND_LOD, NULL);
+
+  prop = RNA_def_property(srna, "use_animation_lod", PROP_BOOLEAN, PROP_NONE);
+  RNA_def_property_boolean_negative_sdna(prop, NULL, "gameflag2", OB_NO_ANIMATION_LOD);
+  RNA_def_property_ui_text(prop,
+                           "Animation LoD",
+                           "Allow the scene animation level of detail to reduce the pose update "
+                           "rate of this armature");
+  RNA_def_property_update(prop, NC_OBJECT | ND_LOD, NULL);
+
+  prop = RNA_def_property(srna, "lod_generate_levels", PROP_INT, PROP_NONE);
+  RNA_def_property_int_sdna(prop, NULL, "lod_generate_levels");
+  RNA_def_property_range(prop, 1, 8);
+  RNA_def_property_ui_text(
+      prop, "Generated Levels", "Number of levels of detail generated after the original mesh");
+  RNA_def_property_update(prop, NC_OBJECT | ND_LOD, NULL);
+
+  prop = RNA_def_property(srna, "lod_generate_ratio", PROP_FLOAT, PROP_FACTOR);
+  RNA_def_property_float_sdna(prop, NULL, "lod_generate_ratio");
+  RNA_def_property_range(prop, 0.01f, 0.99f);
+  RNA_def_property_ui_text(prop,
+                           "Generated Ratio",
+                           "Ratio of faces kept by each generated level relative to the previous "
+                           "level");
+  RNA_def_property_update(prop, NC_OBJECT | ND_LOD, NULL);
+
+  prop = RNA_def_property(srna, "lod_generate_distance", PROP_FLOAT, PROP_DISTANCE);
+  RNA_def_property_float_sdna(prop, NULL, "lod_generate_distance");
+  RNA_def_property_range(prop, 0.0f, FLT_MAX);
+  RNA_def_property_ui_text(
+      prop, "Generated Distance", "Distance between two generated levels of detail");
+  RNA_def_property_update(prop, NC_OBJECT | ND_LOD, NULL);
+
   /*prop = RNA_def_property(srna, "lod_factor", PROP_FLOAT, PROP_NONE);
   RNA_def_property_float_sdna(prop, NULL, "lodfactor");
   RNA_def_property_range(prop, 0.0f, FLT_MAX);
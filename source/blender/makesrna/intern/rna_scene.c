@@ -5429,6 +5429,24 @@ static void rna_def_scene_game_data(BlenderRNA *brna)
       "Gravitational constant used for physics simulation in the game engine");
   RNA_def_property_update(prop, NC_SCENE, NULL);
 
+  prop = RNA_def_property(srna, "use_occlusion_culling", PROP_BOOLEAN, PROP_NONE);
+  RNA_def_property_boolean_sdna(prop, NULL, "flag", GAME_USE_DBVT_CULLING);
+  RNA_def_property_ui_text(prop,
+                           "DBVT Culling",
+                           "Use the Bullet DBVT tree to cull the objects outside the camera view "
+                           "or hidden by occluders, culled objects that don't cast shadows are "
+                           "not updated for rendering. Deformed meshes are never culled");
+  RNA_def_property_update(prop, NC_SCENE, NULL);
+
+  prop = RNA_def_property(srna, "use_conversion_cache", PROP_BOOLEAN, PROP_NONE);
+  RNA_def_property_boolean_sdna(prop, NULL, "flag", GAME_USE_CONVERSION_CACHE);
+  RNA_def_property_ui_text(prop,
+                           "Conversion Cache",
+                           "Store the converted mesh vertices, the collision shapes and their BVH "
+                           "in the user configuration directory and load them instead of "
+                           "converting the unchanged meshes on game start");
+  RNA_def_property_update(prop, NC_SCENE, NULL);
+
   prop = RNA_def_property(srna, "occlusion_culling_resolution", PROP_INT, PROP_PIXEL);
   RNA_def_property_int_sdna(prop, NULL, "occlusionRes");
   RNA_def_property_range(prop, 128.0, 1024.0);
@@ -5743,6 +5761,35 @@ static void rna_def_scene_game_data(BlenderRNA *brna)
       "Hysteresis %",
       "Minimum distance change required to transition to the previous level of detail");
   RNA_def_property_update(prop, NC_SCENE, NULL);
+
+  prop = RNA_def_property(srna, "use_animation_lod", PROP_BOOLEAN, PROP_NONE);
+  RNA_def_property_boolean_sdna(prop, NULL, "lodflag", SCE_LOD_ANIMATION);
+  RNA_def_property_ui_text(prop,
+                           "Animation LoD",
+                           "Reduce the pose update rate of distant or not visible armatures, "
+                           "the actions time is still advanced every frame");
+  RNA_def_property_update(prop, NC_SCENE, NULL);
+
+  prop = RNA_def_property(srna, "animation_lod_distance", PROP_FLOAT, PROP_DISTANCE);
+  RNA_def_property_float_sdna(prop, NULL, "anim_lod_distance");
+  RNA_def_property_range(prop, 0.0f, FLT_MAX);
+  RNA_def_property_ui_range(prop, 0.0f, 1000.0f, 100, 1);
+  RNA_def_property_float_default(prop, 30.0f);
+  RNA_def_property_ui_text(prop,
+                           "Animation LoD Distance",
+                           "Distance to the active camera beyond which the pose of an armature is "
+                           "updated at the reduced rate, or not at all when not visible");
+  RNA_def_property_update(prop, NC_SCENE, NULL);
+
+  prop = RNA_def_property(srna, "animation_lod_interval", PROP_INT, PROP_NONE);
+  RNA_def_property_int_sdna(prop, NULL, "anim_lod_interval");
+  RNA_def_property_range(prop, 1, 60);
+  RNA_def_property_int_default(prop, 4);
+  RNA_def_property_ui_text(prop,
+                           "Animation LoD Interval",
+                           "Number of animation frames between two pose updates of distant or not "
+                           "visible armatures");
+  RNA_def_property_update(prop, NC_SCENE, NULL);
 }
 
 static void rna_def_view_layers(BlenderRNA *brna, PropertyRNA *cprop)
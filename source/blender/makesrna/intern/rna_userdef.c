@@ -5286,6 +5286,13 @@ static void rna_def_userdef_system(BlenderRNA *brna)
   RNA_def_property_ui_text(prop, "Memory Cache Limit", "Memory cache limit (in megabytes)");
   RNA_def_property_update(prop, 0, "rna_Userdef_memcache_update");
 
+  prop = RNA_def_property(srna, "use_parallel_movie_decoding", PROP_BOOLEAN, PROP_NONE);
+  RNA_def_property_boolean_sdna(prop, NULL, "movie_flag", USER_MOVIE_PARALLEL_DECODING);
+  RNA_def_property_ui_text(prop,
+                           "Parallel Movie Decoding",
+                           "Decode movie strips and textures in background threads, caching the "
+                           "frames around the current frame (only for movies without timecode)");
+
   /* Sequencer disk cache */
 
   prop = RNA_def_property(srna, "use_sequencer_disk_cache", PROP_BOOLEAN, PROP_NONE);
@@ -28,13 +28,18 @@
 #include "BLI_utildefines.h"
 
 #include "BLI_alloca.h"
+#include "BLI_listbase.h"
 #include "BLI_math_geom.h"
 #include "BLI_math_matrix.h"
 
+#include "DNA_collection_types.h"
+#include "DNA_layer_types.h"
 #include "DNA_mesh_types.h"
 #include "DNA_meshdata_types.h"
 #include "DNA_object_types.h"
 
+#include "BKE_collection.h"
+#include "BKE_customdata.h"
 #include "BKE_global.h" /* only to check G.debug */
 #include "BKE_lib_id.h"
 #include "BKE_lib_query.h"
@@ -71,6 +76,10 @@ static bool isDisabled(const struct Scene *UNUSED(scene),
 {
   BooleanModifierData *bmd = (BooleanModifierData *)md;
 
+  if (bmd->operand_type == eBooleanModifierOperandType_Collection) {
+    return !bmd->collection;
+  }
+
   /* The object type check is only needed here in case we have a placeholder
    * object assigned (because the library containing the mesh is missing).
    *
@@ -86,10 +95,31 @@ static void foreachObjectLink(ModifierData *md, Object *ob, ObjectWalkFunc walk,
   walk(userData, ob, &bmd->object, IDWALK_CB_NOP);
 }
 
+static void foreachIDLink(ModifierData *md, Object *ob, IDWalkFunc walk, void *userData)
+{
+  BooleanModifierData *bmd = (BooleanModifierData *)md;
+
+  walk(userData, ob, (ID **)&bmd->collection, IDWALK_CB_NOP);
+
+  foreachObjectLink(md, ob, (ObjectWalkFunc)walk, userData);
+}
+
 static void updateDepsgraph(ModifierData *md, const ModifierUpdateDepsgraphContext *ctx)
 {
   BooleanModifierData *bmd = (BooleanModifierData *)md;
-  if (bmd->object != NULL) {
+  if (bmd->operand_type == eBooleanModifierOperandType_Collection) {
+    if (bmd->collection != NULL) {
+      DEG_add_generic_id_relation(ctx->node, &bmd->collection->id, "Boolean Modifier");
+      FOREACH_COLLECTION_OBJECT_RECURSIVE_BEGIN (bmd->collection, ob_iter) {
+        if (ob_iter->type == OB_MESH && ob_iter != ctx->object) {
+          DEG_add_object_relation(ctx->node, ob_iter, DEG_OB_COMP_TRANSFORM, "Boolean Modifier");
+          DEG_add_object_relation(ctx->node, ob_iter, DEG_OB_COMP_GEOMETRY, "Boolean Modifier");
+        }
+      }
+      FOREACH_COLLECTION_OBJECT_RECURSIVE_END;
+    }
+  }
+  else if (bmd->object != NULL) {
     DEG_add_object_relation(ctx->node, bmd->object, DEG_OB_COMP_TRANSFORM, "Boolean Modifier");
     DEG_add_object_relation(ctx->node, bmd->object, DEG_OB_COMP_GEOMETRY, "Boolean Modifier");
   }
@@ -153,6 +183,214 @@ static int bm_face_isect_pair(BMFace *f, void *UNUSED(user_data))
   return BM_elem_flag_test(f, BM_FACE_TAG) ? 1 : 0;
 }
 
+/* -------------------------------------------------------------------- */
+/** \name Collection Operand
+ *
+ * Every mesh in the collection is cut against all others (and the modified mesh) at once,
+ * instead of stacking one modifier per object.
+ * \{ */
+
+/* Temporary face layer storing the operand index, faces split by the intersection inherit it. */
+#define BOOLEAN_OPERAND_LAYER "__boolean_operand"
+
+static int bm_face_isect_operand(BMFace *f, void *user_data)
+{
+  const int cd_operand_offset = POINTER_AS_INT(user_data);
+  return BM_ELEM_CD_GET_INT(f, cd_operand_offset);
+}
+
+static Mesh *modifyMesh_collection(BooleanModifierData *bmd,
+                                   const ModifierEvalContext *ctx,
+                                   Mesh *mesh)
+{
+  Object *object = ctx->object;
+  Collection *collection = bmd->collection;
+
+  /* Operand zero is the mesh being modified. */
+  ListBase object_cache = BKE_collection_object_cache_get(collection);
+  int operands_len = 1 + BLI_listbase_count(&object_cache);
+
+  Object **ob_operands = MEM_malloc_arrayN(operands_len, sizeof(*ob_operands), __func__);
+  Mesh **me_operands = MEM_malloc_arrayN(operands_len, sizeof(*me_operands), __func__);
+  BMAllocTemplate allocsize = BMALLOC_TEMPLATE_FROM_ME(mesh);
+
+  operands_len = 1;
+  FOREACH_COLLECTION_OBJECT_RECURSIVE_BEGIN (collection, ob_iter) {
+    if (ob_iter->type != OB_MESH || ob_iter == object) {
+      continue;
+    }
+    Mesh *mesh_iter = BKE_modifier_get_evaluated_mesh_from_evaluated_object(ob_iter, false);
+    if (mesh_iter == NULL || mesh_iter->totpoly == 0) {
+      continue;
+    }
+    ob_operands[operands_len] = ob_iter;
+    me_operands[operands_len] = mesh_iter;
+    operands_len++;
+
+    allocsize.totvert += mesh_iter->totvert;
+    allocsize.totedge += mesh_iter->totedge;
+    allocsize.totloop += mesh_iter->totloop;
+    allocsize.totface += mesh_iter->totpoly;
+  }
+  FOREACH_COLLECTION_OBJECT_RECURSIVE_END;
+
+  /* Nothing to cut with, or nothing to cut (a union still joins the operands). */
+  if (operands_len == 1 || (mesh->totpoly == 0 && bmd->operation != eBooleanModifierOp_Union)) {
+    MEM_freeN(ob_operands);
+    MEM_freeN(me_operands);
+    if ((operands_len != 1) && (bmd->operation == eBooleanModifierOp_Intersect)) {
+      return BKE_mesh_new_nomain(0, 0, 0, 0, 0);
+    }
+    return mesh;
+  }
+
+  ob_operands[0] = object;
+  me_operands[0] = mesh;
+
+#ifdef DEBUG_TIME
+  TIMEIT_START(boolean_bmesh_collection);
+#endif
+
+  BMesh *bm = BM_mesh_create(&allocsize,
+                             &((struct BMeshCreateParams){
+                                 .use_toolflags = false,
+                             }));
+
+  /* Element ranges of each operand, self is added last to match the single object case. */
+  int(*vert_range)[2] = MEM_malloc_arrayN(operands_len, sizeof(*vert_range), __func__);
+  int(*face_range)[2] = MEM_malloc_arrayN(operands_len, sizeof(*face_range), __func__);
+  for (int i = 1; i <= operands_len; i++) {
+    const int operand = i % operands_len;
+    vert_range[operand][0] = bm->totvert;
+    face_range[operand][0] = bm->totface;
+    BM_mesh_bm_from_me(bm,
+                       me_operands[operand],
+                       &((struct BMeshFromMeshParams){
+                           .calc_face_normal = true,
+                       }));
+    vert_range[operand][1] = bm->totvert;
+    face_range[operand][1] = bm->totface;
+  }
+
+  BM_data_layer_add_named(bm, &bm->pdata, CD_PROP_INT, BOOLEAN_OPERAND_LAYER);
+  const int cd_operand_index = CustomData_get_named_layer_index(
+      &bm->pdata, CD_PROP_INT, BOOLEAN_OPERAND_LAYER);
+  const int cd_operand_offset = bm->pdata.layers[cd_operand_index].offset;
+
+  BM_mesh_elem_table_ensure(bm, BM_VERT | BM_FACE);
+
+  const int cd_loop_mdisp_offset = CustomData_get_offset(&bm->ldata, CD_MDISPS);
+  for (int operand = 0; operand < operands_len; operand++) {
+    const bool is_flip = (operand != 0) && (is_negative_m4(object->obmat) !=
+                                            is_negative_m4(ob_operands[operand]->obmat));
+    for (int i = face_range[operand][0]; i < face_range[operand][1]; i++) {
+      BMFace *efa = bm->ftable[i];
+      BM_ELEM_CD_SET_INT(efa, cd_operand_offset, operand);
+      if (UNLIKELY(is_flip)) {
+        BM_face_normal_flip_ex(bm, efa, cd_loop_mdisp_offset, true);
+      }
+    }
+  }
+
+  /* create tessface & intersect */
+  const int looptris_tot = poly_to_tri_count(bm->totface, bm->totloop);
+  int tottri;
+  BMLoop *(*looptris)[3] = MEM_malloc_arrayN(looptris_tot, sizeof(*looptris), __func__);
+
+  BM_mesh_calc_tessellation_beauty(bm, looptris, &tottri);
+
+  /* postpone this until after tessellating
+   * so we can use the original normals before the vertex are moved */
+  {
+    float imat[4][4];
+    invert_m4_m4(imat, object->obmat);
+
+    for (int operand = 1; operand < operands_len; operand++) {
+      Object *other = ob_operands[operand];
+      const bool is_flip = (is_negative_m4(object->obmat) != is_negative_m4(other->obmat));
+
+      float omat[4][4];
+      mul_m4_m4m4(omat, imat, other->obmat);
+
+      for (int i = vert_range[operand][0]; i < vert_range[operand][1]; i++) {
+        mul_m4_v3(omat, bm->vtable[i]->co);
+      }
+
+      float nmat[3][3];
+      copy_m3_m4(nmat, omat);
+      invert_m3(nmat);
+
+      if (UNLIKELY(is_flip)) {
+        negate_m3(nmat);
+      }
+
+      const short ob_src_totcol = other->totcol;
+      short *material_remap = MEM_malloc_arrayN(
+          ob_src_totcol ? ob_src_totcol : 1, sizeof(*material_remap), __func__);
+      BKE_object_material_remap_calc(object, other, material_remap);
+
+      for (int i = face_range[operand][0]; i < face_range[operand][1]; i++) {
+        BMFace *efa = bm->ftable[i];
+        mul_transposed_m3_v3(nmat, efa->no);
+        normalize_v3(efa->no);
+
+        /* remap material */
+        if (LIKELY(efa->mat_nr < ob_src_totcol)) {
+          efa->mat_nr = material_remap[efa->mat_nr];
+        }
+      }
+
+      MEM_freeN(material_remap);
+    }
+  }
+
+  MEM_freeN(vert_range);
+  MEM_freeN(face_range);
+  MEM_freeN(ob_operands);
+  MEM_freeN(me_operands);
+
+  bool use_dissolve = true;
+  bool use_island_connect = true;
+
+  /* change for testing */
+  if (G.debug & G_DEBUG) {
+    use_dissolve = (bmd->bm_flag & eBooleanModifierBMeshFlag_BMesh_NoDissolve) == 0;
+    use_island_connect = (bmd->bm_flag & eBooleanModifierBMeshFlag_BMesh_NoConnectRegions) == 0;
+  }
+
+  BM_mesh_intersect_nary(bm,
+                         looptris,
+                         tottri,
+                         bm_face_isect_operand,
+                         POINTER_FROM_INT(cd_operand_offset),
+                         operands_len,
+                         use_dissolve,
+                         use_island_connect,
+                         bmd->operation,
+                         bmd->double_threshold);
+
+  MEM_freeN(looptris);
+
+  BM_data_layer_free_n(bm,
+                       &bm->pdata,
+                       CD_PROP_INT,
+                       CustomData_get_named_layer(&bm->pdata, CD_PROP_INT, BOOLEAN_OPERAND_LAYER));
+
+  Mesh *result = BKE_mesh_from_bmesh_for_eval_nomain(bm, NULL, mesh);
+
+  BM_mesh_free(bm);
+
+  result->runtime.cd_dirty_vert |= CD_MASK_NORMAL;
+
+#ifdef DEBUG_TIME
+  TIMEIT_END(boolean_bmesh_collection);
+#endif
+
+  return result;
+}
+
+/** \} */
+
 static Mesh *modifyMesh(ModifierData *md, const ModifierEvalContext *ctx, Mesh *mesh)
 {
   BooleanModifierData *bmd = (BooleanModifierData *)md;
@@ -160,6 +398,13 @@ static Mesh *modifyMesh(ModifierData *md, const ModifierEvalContext *ctx, Mesh *
 
   Mesh *mesh_other;
 
+  if (bmd->operand_type == eBooleanModifierOperandType_Collection) {
+    if (bmd->collection == NULL) {
+      return result;
+    }
+    return modifyMesh_collection(bmd, ctx, mesh);
+  }
+
   if (bmd->object == NULL) {
     return result;
   }
@@ -372,7 +617,7 @@ ModifierTypeInfo modifierType_Boolean = {
     /* dependsOnTime */ NULL,
     /* dependsOnNormals */ NULL,
     /* foreachObjectLink */ foreachObjectLink,
-    /* foreachIDLink */ NULL,
+    /* foreachIDLink */ foreachIDLink,
     /* foreachTexLink */ NULL,
     /* freeRuntimeData */ NULL,
 };
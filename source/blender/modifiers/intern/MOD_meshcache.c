@@ -59,6 +59,17 @@ static void initData(ModifierData *md)
   mcmd->up_axis = 2;
 }
 
+static void freeRuntimeData(void *runtime_data)
+{
+  MOD_meshcache_file_free(runtime_data);
+}
+
+static void freeData(ModifierData *md)
+{
+  freeRuntimeData(md->runtime);
+  md->runtime = NULL;
+}
+
 static bool dependsOnTime(ModifierData *md)
 {
   MeshCacheModifierData *mcmd = (MeshCacheModifierData *)md;
@@ -93,6 +104,7 @@ static void meshcache_do(MeshCacheModifierData *mcmd,
 
   char filepath[FILE_MAX];
   const char *err_str = NULL;
+  MeshCacheFile *mcf;
   bool ok;
 
   float time;
@@ -142,22 +154,30 @@ static void meshcache_do(MeshCacheModifierData *mcmd,
   /* -------------------------------------------------------------------- */
   /* Read the File (or error out when the file is bad) */
 
-  /* would be nice if we could avoid doing this _every_ frame */
   BLI_strncpy(filepath, mcmd->filepath, sizeof(filepath));
   BLI_path_abs(filepath, ID_BLEND_PATH_FROM_GLOBAL((ID *)ob));
 
-  switch (mcmd->type) {
-    case MOD_MESHCACHE_TYPE_MDD:
-      ok = MOD_meshcache_read_mdd_times(
-          filepath, vertexCos, numVerts, mcmd->interp, time, fps, mcmd->time_mode, &err_str);
-      break;
-    case MOD_MESHCACHE_TYPE_PC2:
-      ok = MOD_meshcache_read_pc2_times(
-          filepath, vertexCos, numVerts, mcmd->interp, time, fps, mcmd->time_mode, &err_str);
-      break;
-    default:
-      ok = false;
-      break;
+  /* The file stays open (mapped) on the runtime, only re-opened when it changes. */
+  mcmd->modifier.runtime = MOD_meshcache_file_ensure(mcmd->modifier.runtime, filepath, &err_str);
+  mcf = mcmd->modifier.runtime;
+
+  if (mcf == NULL) {
+    ok = false;
+  }
+  else {
+    switch (mcmd->type) {
+      case MOD_MESHCACHE_TYPE_MDD:
+        ok = MOD_meshcache_read_mdd_times(
+            mcf, vertexCos, numVerts, mcmd->interp, time, fps, mcmd->time_mode, &err_str);
+        break;
+      case MOD_MESHCACHE_TYPE_PC2:
+        ok = MOD_meshcache_read_pc2_times(
+            mcf, vertexCos, numVerts, mcmd->interp, time, fps, mcmd->time_mode, &err_str);
+        break;
+      default:
+        ok = false;
+        break;
+    }
   }
 
   /* -------------------------------------------------------------------- */
@@ -308,7 +328,7 @@ ModifierTypeInfo modifierType_MeshCache = {
 
     /* initData */ initData,
     /* requiredDataMask */ NULL,
-    /* freeData */ NULL,
+    /* freeData */ freeData,
     /* isDisabled */ isDisabled,
     /* updateDepsgraph */ NULL,
     /* dependsOnTime */ dependsOnTime,
@@ -316,5 +336,5 @@ ModifierTypeInfo modifierType_MeshCache = {
     /* foreachObjectLink */ NULL,
     /* foreachIDLink */ NULL,
     /* foreachTexLink */ NULL,
-    /* freeRuntimeData */ NULL,
+    /* freeRuntimeData */ freeRuntimeData,
 };
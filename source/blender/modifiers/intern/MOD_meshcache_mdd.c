@@ -18,20 +18,14 @@
  * \ingroup modifiers
  */
 
-#include <errno.h>
 #include <stdio.h>
-#include <string.h>
 
 #include "BLI_utildefines.h"
 
-#include "BLI_fileops.h"
 #include "BLI_math.h"
 #ifdef __LITTLE_ENDIAN__
 #  include "BLI_endian_switch.h"
 #endif
-#ifdef WIN32
-#  include "BLI_winstuff.h"
-#endif
 
 #include "DNA_modifier_types.h"
 
@@ -42,12 +36,12 @@ typedef struct MDDHead {
   int verts_tot;
 } MDDHead; /* frames, verts */
 
-static bool meshcache_read_mdd_head(FILE *fp,
+static bool meshcache_read_mdd_head(MeshCacheFile *mcf,
                                     const int verts_tot,
                                     MDDHead *mdd_head,
                                     const char **err_str)
 {
-  if (!fread(mdd_head, sizeof(*mdd_head), 1, fp)) {
+  if (!MOD_meshcache_file_read(mcf, 0, mdd_head, sizeof(*mdd_head))) {
     *err_str = "Missing header";
     return false;
   }
@@ -65,36 +59,43 @@ static bool meshcache_read_mdd_head(FILE *fp,
     *err_str = "Invalid frame total";
     return false;
   }
-  /* intentionally dont seek back */
 
   return true;
 }
 
+/**
+ * Offset of a frame's vertex block, after the header and the table of frame times.
+ */
+static size_t meshcache_mdd_frame_offset(const MDDHead *mdd_head, const int index)
+{
+  return sizeof(*mdd_head) + ((size_t)mdd_head->frame_tot * sizeof(float)) +
+         ((size_t)index * (size_t)mdd_head->verts_tot * sizeof(float[3]));
+}
+
 /**
  * Gets the index frange and factor
  */
-static bool meshcache_read_mdd_range(FILE *fp,
+static bool meshcache_read_mdd_range(MeshCacheFile *mcf,
                                      const int verts_tot,
                                      const float frame,
                                      const char interp,
+                                     MDDHead *mdd_head,
                                      int r_index_range[2],
                                      float *r_factor,
                                      const char **err_str)
 {
-  MDDHead mdd_head;
-
   /* first check interpolation and get the vert locations */
 
-  if (meshcache_read_mdd_head(fp, verts_tot, &mdd_head, err_str) == false) {
+  if (meshcache_read_mdd_head(mcf, verts_tot, mdd_head, err_str) == false) {
     return false;
   }
 
-  MOD_meshcache_calc_range(frame, interp, mdd_head.frame_tot, r_index_range, r_factor);
+  MOD_meshcache_calc_range(frame, interp, mdd_head->frame_tot, r_index_range, r_factor);
 
   return true;
 }
 
-static bool meshcache_read_mdd_range_from_time(FILE *fp,
+static bool meshcache_read_mdd_range_from_time(MeshCacheFile *mcf,
                                                const int verts_tot,
                                                const float time,
                                                const float UNUSED(fps),
@@ -106,12 +107,16 @@ static bool meshcache_read_mdd_range_from_time(FILE *fp,
   float f_time, f_time_prev = FLT_MAX;
   float frame;
 
-  if (meshcache_read_mdd_head(fp, verts_tot, &mdd_head, err_str) == false) {
+  if (meshcache_read_mdd_head(mcf, verts_tot, &mdd_head, err_str) == false) {
     return false;
   }
 
   for (i = 0; i < mdd_head.frame_tot; i++) {
-    fread(&f_time, sizeof(float), 1, fp);
+    if (!MOD_meshcache_file_read(
+            mcf, sizeof(mdd_head) + ((size_t)i * sizeof(float)), &f_time, sizeof(float))) {
+      *err_str = "Failed to read frame times";
+      return false;
+    }
 #ifdef __LITTLE_ENDIAN__
     BLI_endian_switch_float(&f_time);
 #endif
@@ -142,7 +147,7 @@ static bool meshcache_read_mdd_range_from_time(FILE *fp,
   return true;
 }
 
-bool MOD_meshcache_read_mdd_index(FILE *fp,
+bool MOD_meshcache_read_mdd_index(MeshCacheFile *mcf,
                                   float (*vertexCos)[3],
                                   const int verts_tot,
                                   const int index,
@@ -151,81 +156,39 @@ bool MOD_meshcache_read_mdd_index(FILE *fp,
 {
   MDDHead mdd_head;
 
-  if (meshcache_read_mdd_head(fp, verts_tot, &mdd_head, err_str) == false) {
-    return false;
-  }
-
-  if (BLI_fseek(fp, mdd_head.frame_tot * sizeof(int), SEEK_CUR) != 0) {
-    *err_str = "Header seek failed";
-    return false;
-  }
-
-  if (BLI_fseek(fp, sizeof(float) * 3 * index * mdd_head.verts_tot, SEEK_CUR) != 0) {
-    *err_str = "Failed to seek frame";
+  if (meshcache_read_mdd_head(mcf, verts_tot, &mdd_head, err_str) == false) {
     return false;
   }
 
-  if (factor >= 1.0f) {
-#if 1
-    float *vco = *vertexCos;
-    uint i;
-    for (i = mdd_head.verts_tot; i != 0; i--, vco += 3) {
-      fread(vco, sizeof(float) * 3, 1, fp);
-
-#  ifdef __LITTLE_ENDIAN__
-      BLI_endian_switch_float(vco + 0);
-      BLI_endian_switch_float(vco + 1);
-      BLI_endian_switch_float(vco + 2);
-#  endif /* __LITTLE_ENDIAN__ */
-    }
-#else
-    /* no blending */
-    if (!fread(vertexCos, sizeof(float) * 3, mdd_head.verts_tot, f)) {
-      *err_str = errno ? strerror(errno) : "Failed to read frame";
-      return false;
-    }
-#  ifdef __LITTLE_ENDIAN__
-    BLI_endian_switch_float_array(vertexCos[0], mdd_head.verts_tot * 3);
-#  endif
-#endif
-  }
-  else {
-    const float ifactor = 1.0f - factor;
-    float *vco = *vertexCos;
-    uint i;
-    for (i = mdd_head.verts_tot; i != 0; i--, vco += 3) {
-      float tvec[3];
-      fread(tvec, sizeof(float) * 3, 1, fp);
-
+  return MOD_meshcache_file_read_frame(mcf,
+                                       meshcache_mdd_frame_offset(&mdd_head, index),
+                                       vertexCos,
+                                       mdd_head.verts_tot,
+                                       factor,
 #ifdef __LITTLE_ENDIAN__
-      BLI_endian_switch_float(tvec + 0);
-      BLI_endian_switch_float(tvec + 1);
-      BLI_endian_switch_float(tvec + 2);
+                                       true,
+#else
+                                       false,
 #endif
-
-      vco[0] = (vco[0] * ifactor) + (tvec[0] * factor);
-      vco[1] = (vco[1] * ifactor) + (tvec[1] * factor);
-      vco[2] = (vco[2] * ifactor) + (tvec[2] * factor);
-    }
-  }
-
-  return true;
+                                       err_str);
 }
 
-bool MOD_meshcache_read_mdd_frame(FILE *fp,
+bool MOD_meshcache_read_mdd_frame(MeshCacheFile *mcf,
                                   float (*vertexCos)[3],
                                   const int verts_tot,
                                   const char interp,
                                   const float frame,
                                   const char **err_str)
 {
+  MDDHead mdd_head;
   int index_range[2];
   float factor;
 
-  if (meshcache_read_mdd_range(fp,
+  if (meshcache_read_mdd_range(mcf,
                                verts_tot,
                                frame,
                                interp,
+                               &mdd_head,
                                index_range,
                                &factor, /* read into these values */
                                err_str) == false) {
@@ -234,29 +197,31 @@ bool MOD_meshcache_read_mdd_frame(FILE *fp,
 
   if (index_range[0] == index_range[1]) {
     /* read single */
-    if ((BLI_fseek(fp, 0, SEEK_SET) == 0) &&
-        MOD_meshcache_read_mdd_index(fp, vertexCos, verts_tot, index_range[0], 1.0f, err_str)) {
-      return true;
-    }
-    else {
+    if (!MOD_meshcache_read_mdd_index(mcf, vertexCos, verts_tot, index_range[0], 1.0f, err_str)) {
       return false;
     }
   }
   else {
     /* read both and interpolate */
-    if ((BLI_fseek(fp, 0, SEEK_SET) == 0) &&
-        MOD_meshcache_read_mdd_index(fp, vertexCos, verts_tot, index_range[0], 1.0f, err_str) &&
-        (BLI_fseek(fp, 0, SEEK_SET) == 0) &&
-        MOD_meshcache_read_mdd_index(fp, vertexCos, verts_tot, index_range[1], factor, err_str)) {
-      return true;
-    }
-    else {
+    if (!(MOD_meshcache_read_mdd_index(
+              mcf, vertexCos, verts_tot, index_range[0], 1.0f, err_str) &&
+          MOD_meshcache_read_mdd_index(
+              mcf, vertexCos, verts_tot, index_range[1], factor, err_str))) {
       return false;
     }
   }
+
+  /* Page in the frame following this one for playback. */
+  if (index_range[1] + 1 < mdd_head.frame_tot) {
+    MOD_meshcache_file_prefetch(mcf,
+                                meshcache_mdd_frame_offset(&mdd_head, index_range[1] + 1),
+                                (size_t)mdd_head.verts_tot * sizeof(float[3]));
+  }
+
+  return true;
 }
 
-bool MOD_meshcache_read_mdd_times(const char *filepath,
+bool MOD_meshcache_read_mdd_times(MeshCacheFile *mcf,
                                   float (*vertexCos)[3],
                                   const int verts_tot,
                                   const char interp,
@@ -267,14 +232,6 @@ bool MOD_meshcache_read_mdd_times(const char *filepath,
 {
   float frame;
 
-  FILE *fp = BLI_fopen(filepath, "rb");
-  bool ok;
-
-  if (fp == NULL) {
-    *err_str = errno ? strerror(errno) : "Unknown error opening file";
-    return false;
-  }
-
   switch (time_mode) {
     case MOD_MESHCACHE_TIME_FRAME: {
       frame = time;
@@ -282,29 +239,23 @@ bool MOD_meshcache_read_mdd_times(const char *filepath,
     }
     case MOD_MESHCACHE_TIME_SECONDS: {
       /* we need to find the closest time */
-      if (meshcache_read_mdd_range_from_time(fp, verts_tot, time, fps, &frame, err_str) == false) {
-        fclose(fp);
+      if (meshcache_read_mdd_range_from_time(mcf, verts_tot, time, fps, &frame, err_str) ==
+          false) {
         return false;
       }
-      rewind(fp);
       break;
     }
     case MOD_MESHCACHE_TIME_FACTOR:
     default: {
       MDDHead mdd_head;
-      if (meshcache_read_mdd_head(fp, verts_tot, &mdd_head, err_str) == false) {
-        fclose(fp);
+      if (meshcache_read_mdd_head(mcf, verts_tot, &mdd_head, err_str) == false) {
         return false;
       }
 
       frame = CLAMPIS(time, 0.0f, 1.0f) * (float)mdd_head.frame_tot;
-      rewind(fp);
       break;
     }
   }
 
-  ok = MOD_meshcache_read_mdd_frame(fp, vertexCos, verts_tot, interp, frame, err_str);
-
-  fclose(fp);
-  return ok;
+  return MOD_meshcache_read_mdd_frame(mcf, vertexCos, verts_tot, interp, frame, err_str);
 }
@@ -18,21 +18,15 @@
  * \ingroup modifiers
  */
 
-#include <errno.h>
 #include <stdio.h>
 #include <string.h>
 
 #include "BLI_utildefines.h"
 
-#include "BLI_fileops.h"
 #ifdef __BIG_ENDIAN__
 #  include "BLI_endian_switch.h"
 #endif
 
-#ifdef WIN32
-#  include "BLI_winstuff.h"
-#endif
-
 #include "DNA_modifier_types.h"
 
 #include "MOD_meshcache_util.h" /* own include */
@@ -46,12 +40,12 @@ typedef struct PC2Head {
   int frame_tot;
 } PC2Head; /* frames, verts */
 
-static bool meshcache_read_pc2_head(FILE *fp,
+static bool meshcache_read_pc2_head(MeshCacheFile *mcf,
                                     const int verts_tot,
                                     PC2Head *pc2_head,
                                     const char **err_str)
 {
-  if (!fread(pc2_head, sizeof(*pc2_head), 1, fp)) {
+  if (!MOD_meshcache_file_read(mcf, 0, pc2_head, sizeof(*pc2_head))) {
     *err_str = "Missing header";
     return false;
   }
@@ -75,38 +69,41 @@ static bool meshcache_read_pc2_head(FILE *fp,
     *err_str = "Invalid frame total";
     return false;
   }
-  /* intentionally dont seek back */
 
   return true;
 }
 
+static size_t meshcache_pc2_frame_offset(const PC2Head *pc2_head, const int index)
+{
+  return sizeof(*pc2_head) + ((size_t)index * (size_t)pc2_head->verts_tot * sizeof(float[3]));
+}
+
 /**
  * Gets the index frange and factor
  *
  * currently same as for MDD
  */
-static bool meshcache_read_pc2_range(FILE *fp,
+static bool meshcache_read_pc2_range(MeshCacheFile *mcf,
                                      const int verts_tot,
                                      const float frame,
                                      const char interp,
+                                     PC2Head *pc2_head,
                                      int r_index_range[2],
                                      float *r_factor,
                                      const char **err_str)
 {
-  PC2Head pc2_head;
-
   /* first check interpolation and get the vert locations */
 
-  if (meshcache_read_pc2_head(fp, verts_tot, &pc2_head, err_str) == false) {
+  if (meshcache_read_pc2_head(mcf, verts_tot, pc2_head, err_str) == false) {
     return false;
   }
 
-  MOD_meshcache_calc_range(frame, interp, pc2_head.frame_tot, r_index_range, r_factor);
+  MOD_meshcache_calc_range(frame, interp, pc2_head->frame_tot, r_index_range, r_factor);
 
   return true;
 }
 
-static bool meshcache_read_pc2_range_from_time(FILE *fp,
+static bool meshcache_read_pc2_range_from_time(MeshCacheFile *mcf,
                                                const int verts_tot,
                                                const float time,
                                                const float fps,
@@ -116,7 +113,7 @@ static bool meshcache_read_pc2_range_from_time(FILE *fp,
   PC2Head pc2_head;
   float frame;
 
-  if (meshcache_read_pc2_head(fp, verts_tot, &pc2_head, err_str) == false) {
+  if (meshcache_read_pc2_head(mcf, verts_tot, &pc2_head, err_str) == false) {
     return false;
   }
 
@@ -133,7 +130,7 @@ static bool meshcache_read_pc2_range_from_time(FILE *fp,
   return true;
 }
 
-bool MOD_meshcache_read_pc2_index(FILE *fp,
+bool MOD_meshcache_read_pc2_index(MeshCacheFile *mcf,
                                   float (*vertexCos)[3],
                                   const int verts_tot,
                                   const int index,
@@ -142,65 +139,39 @@ bool MOD_meshcache_read_pc2_index(FILE *fp,
 {
   PC2Head pc2_head;
 
-  if (meshcache_read_pc2_head(fp, verts_tot, &pc2_head, err_str) == false) {
+  if (meshcache_read_pc2_head(mcf, verts_tot, &pc2_head, err_str) == false) {
     return false;
   }
 
-  if (BLI_fseek(fp, sizeof(float) * 3 * index * pc2_head.verts_tot, SEEK_CUR) != 0) {
-    *err_str = "Failed to seek frame";
-    return false;
-  }
-
-  if (factor >= 1.0f) {
-    float *vco = *vertexCos;
-    uint i;
-    for (i = pc2_head.verts_tot; i != 0; i--, vco += 3) {
-      fread(vco, sizeof(float) * 3, 1, fp);
-
-#ifdef __BIG_ENDIAN__
-      BLI_endian_switch_float(vco + 0);
-      BLI_endian_switch_float(vco + 1);
-      BLI_endian_switch_float(vco + 2);
-#endif /* __BIG_ENDIAN__ */
-    }
-  }
-  else {
-    const float ifactor = 1.0f - factor;
-    float *vco = *vertexCos;
-    uint i;
-    for (i = pc2_head.verts_tot; i != 0; i--, vco += 3) {
-      float tvec[3];
-      fread(tvec, sizeof(float) * 3, 1, fp);
-
+  return MOD_meshcache_file_read_frame(mcf,
+                                       meshcache_pc2_frame_offset(&pc2_head, index),
+                                       vertexCos,
+                                       pc2_head.verts_tot,
+                                       factor,
 #ifdef __BIG_ENDIAN__
-      BLI_endian_switch_float(tvec + 0);
-      BLI_endian_switch_float(tvec + 1);
-      BLI_endian_switch_float(tvec + 2);
-#endif /* __BIG_ENDIAN__ */
-
-      vco[0] = (vco[0] * ifactor) + (tvec[0] * factor);
-      vco[1] = (vco[1] * ifactor) + (tvec[1] * factor);
-      vco[2] = (vco[2] * ifactor) + (tvec[2] * factor);
-    }
-  }
-
-  return true;
+                                       true,
+#else
+                                       false,
+#endif
+                                       err_str);
 }
 
-bool MOD_meshcache_read_pc2_frame(FILE *fp,
+bool MOD_meshcache_read_pc2_frame(MeshCacheFile *mcf,
                                   float (*vertexCos)[3],
                                   const int verts_tot,
                                   const char interp,
                                   const float frame,
                                   const char **err_str)
 {
+  PC2Head pc2_head;
   int index_range[2];
   float factor;
 
-  if (meshcache_read_pc2_range(fp,
+  if (meshcache_read_pc2_range(mcf,
                                verts_tot,
                                frame,
                                interp,
+                               &pc2_head,
                                index_range,
                                &factor, /* read into these values */
                                err_str) == false) {
@@ -209,29 +180,31 @@ bool MOD_meshcache_read_pc2_frame(FILE *fp,
 
   if (index_range[0] == index_range[1]) {
     /* read single */
-    if ((BLI_fseek(fp, 0, SEEK_SET) == 0) &&
-        MOD_meshcache_read_pc2_index(fp, vertexCos, verts_tot, index_range[0], 1.0f, err_str)) {
-      return true;
-    }
-    else {
+    if (!MOD_meshcache_read_pc2_index(mcf, vertexCos, verts_tot, index_range[0], 1.0f, err_str)) {
       return false;
     }
   }
   else {
     /* read both and interpolate */
-    if ((BLI_fseek(fp, 0, SEEK_SET) == 0) &&
-        MOD_meshcache_read_pc2_index(fp, vertexCos, verts_tot, index_range[0], 1.0f, err_str) &&
-        (BLI_fseek(fp, 0, SEEK_SET) == 0) &&
-        MOD_meshcache_read_pc2_index(fp, vertexCos, verts_tot, index_range[1], factor, err_str)) {
-      return true;
-    }
-    else {
+    if (!(MOD_meshcache_read_pc2_index(
+              mcf, vertexCos, verts_tot, index_range[0], 1.0f, err_str) &&
+          MOD_meshcache_read_pc2_index(
+              mcf, vertexCos, verts_tot, index_range[1], factor, err_str))) {
       return false;
     }
   }
+
+  /* Page in the frame following this one for playback. */
+  if (index_range[1] + 1 < pc2_head.frame_tot) {
+    MOD_meshcache_file_prefetch(mcf,
+                                meshcache_pc2_frame_offset(&pc2_head, index_range[1] + 1),
+                                (size_t)pc2_head.verts_tot * sizeof(float[3]));
+  }
+
+  return true;
 }
 
-bool MOD_meshcache_read_pc2_times(const char *filepath,
+bool MOD_meshcache_read_pc2_times(MeshCacheFile *mcf,
                                   float (*vertexCos)[3],
                                   const int verts_tot,
                                   const char interp,
@@ -242,14 +215,6 @@ bool MOD_meshcache_read_pc2_times(const char *filepath,
 {
   float frame;
 
-  FILE *fp = BLI_fopen(filepath, "rb");
-  bool ok;
-
-  if (fp == NULL) {
-    *err_str = errno ? strerror(errno) : "Unknown error opening file";
-    return false;
-  }
-
   switch (time_mode) {
     case MOD_MESHCACHE_TIME_FRAME: {
       frame = time;
@@ -257,29 +222,23 @@ bool MOD_meshcache_read_pc2_times(const char *filepath,
     }
     case MOD_MESHCACHE_TIME_SECONDS: {
       /* we need to find the closest time */
-      if (meshcache_read_pc2_range_from_time(fp, verts_tot, time, fps, &frame, err_str) == false) {
-        fclose(fp);
+      if (meshcache_read_pc2_range_from_time(mcf, verts_tot, time, fps, &frame, err_str) ==
+          false) {
         return false;
       }
-      rewind(fp);
       break;
     }
     case MOD_MESHCACHE_TIME_FACTOR:
     default: {
       PC2Head pc2_head;
-      if (meshcache_read_pc2_head(fp, verts_tot, &pc2_head, err_str) == false) {
-        fclose(fp);
+      if (meshcache_read_pc2_head(mcf, verts_tot, &pc2_head, err_str) == false) {
         return false;
       }
 
       frame = CLAMPIS(time, 0.0f, 1.0f) * (float)pc2_head.frame_tot;
-      rewind(fp);
       break;
     }
   }
 
-  ok = MOD_meshcache_read_pc2_frame(fp, vertexCos, verts_tot, interp, frame, err_str);
-
-  fclose(fp);
-  return ok;
+  return MOD_meshcache_read_pc2_frame(mcf, vertexCos, verts_tot, interp, frame, err_str);
 }
@@ -18,12 +18,29 @@
  * \ingroup modifiers
  */
 
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+
+#ifndef WIN32
+#  include <sys/mman.h>
+#  include <unistd.h>
+#else
+#  include <io.h>
+#endif
+
 #include "BLI_utildefines.h"
 
+#include "BLI_endian_switch.h"
+#include "BLI_fileops.h"
 #include "BLI_math.h"
+#include "BLI_string.h"
 
 #include "DNA_modifier_types.h"
 
+#include "MEM_guardedalloc.h"
+
 #include "MOD_meshcache_util.h"
 
 void MOD_meshcache_calc_range(const float frame,
@@ -62,3 +79,211 @@ void MOD_meshcache_calc_range(const float frame,
     }
   }
 }
+
+/* -------------------------------------------------------------------- */
+/** \name Cache File Access
+ *
+ * The cache file is opened once and kept on the modifier runtime,
+ * frames are read as spans of the mapped file instead of seeking and reading per vertex.
+ *
+ * On WIN32 the mapping emulation isn't thread-safe (modifiers evaluate in parallel),
+ * so the file is kept open instead and each frame is read with a single call.
+ * \{ */
+
+MeshCacheFile *MOD_meshcache_file_ensure(MeshCacheFile *mcf,
+                                         const char *filepath,
+                                         const char **err_str)
+{
+  BLI_stat_t st;
+
+  if (BLI_stat(filepath, &st) == -1) {
+    *err_str = errno ? strerror(errno) : "Unknown error opening file";
+    MOD_meshcache_file_free(mcf);
+    return NULL;
+  }
+
+  /* Re-open when the path changes or the file is written to (re-exported). */
+  if (mcf && STREQ(mcf->filepath, filepath) && (mcf->size == (size_t)st.st_size) &&
+      (mcf->mtime == (int64_t)st.st_mtime)) {
+    return mcf;
+  }
+
+  MOD_meshcache_file_free(mcf);
+
+  if (st.st_size <= 0) {
+    *err_str = "Missing header";
+    return NULL;
+  }
+
+  mcf = MEM_callocN(sizeof(*mcf), __func__);
+  BLI_strncpy(mcf->filepath, filepath, sizeof(mcf->filepath));
+  mcf->size = (size_t)st.st_size;
+  mcf->mtime = (int64_t)st.st_mtime;
+
+#ifndef WIN32
+  {
+    const int file = BLI_open(filepath, O_BINARY | O_RDONLY, 0);
+    void *data;
+
+    if (file == -1) {
+      *err_str = errno ? strerror(errno) : "Unknown error opening file";
+      MEM_freeN(mcf);
+      return NULL;
+    }
+
+    data = mmap(NULL, mcf->size, PROT_READ, MAP_SHARED, file, 0);
+    close(file);
+
+    if (data == MAP_FAILED) {
+      *err_str = errno ? strerror(errno) : "Failed to map file";
+      MEM_freeN(mcf);
+      return NULL;
+    }
+    mcf->data = data;
+  }
+#else
+  mcf->fp = BLI_fopen(filepath, "rb");
+  if (mcf->fp == NULL) {
+    *err_str = errno ? strerror(errno) : "Unknown error opening file";
+    MEM_freeN(mcf);
+    return NULL;
+  }
+#endif
+
+  return mcf;
+}
+
+void MOD_meshcache_file_free(MeshCacheFile *mcf)
+{
+  if (mcf == NULL) {
+    return;
+  }
+#ifndef WIN32
+  if (mcf->data) {
+    munmap((void *)mcf->data, mcf->size);
+  }
+#else
+  if (mcf->fp) {
+    fclose(mcf->fp);
+  }
+#endif
+  MEM_freeN(mcf);
+}
+
+static bool meshcache_file_range_check(const MeshCacheFile *mcf,
+                                       const size_t offset,
+                                       const size_t size)
+{
+  return (offset <= mcf->size) && (size <= mcf->size - offset);
+}
+
+bool MOD_meshcache_file_read(MeshCacheFile *mcf, const size_t offset, void *dst, const size_t size)
+{
+  if (!meshcache_file_range_check(mcf, offset, size)) {
+    return false;
+  }
+#ifndef WIN32
+  memcpy(dst, mcf->data + offset, size);
+  return true;
+#else
+  return (BLI_fseek(mcf->fp, (int64_t)offset, SEEK_SET) == 0) &&
+         (fread(dst, size, 1, mcf->fp) == 1);
+#endif
+}
+
+/**
+ * Read a block of `verts_tot` coordinates at `offset`,
+ * blending into `vertexCos` when `factor` is below one.
+ */
+bool MOD_meshcache_file_read_frame(MeshCacheFile *mcf,
+                                   const size_t offset,
+                                   float (*vertexCos)[3],
+                                   const int verts_tot,
+                                   const float factor,
+                                   const bool use_endian_switch,
+                                   const char **err_str)
+{
+  const size_t values_tot = (size_t)verts_tot * 3;
+  const size_t size = values_tot * sizeof(float);
+  float *vco = *vertexCos;
+  const float *src;
+  float *src_alloc = NULL;
+
+  if (!meshcache_file_range_check(mcf, offset, size)) {
+    *err_str = "Failed to read frame";
+    return false;
+  }
+
+  if (factor >= 1.0f) {
+    /* No blending, copy (or read) directly into the result. */
+    if (!MOD_meshcache_file_read(mcf, offset, vco, size)) {
+      *err_str = "Failed to read frame";
+      return false;
+    }
+    if (use_endian_switch) {
+      BLI_endian_switch_float_array(vco, (int)values_tot);
+    }
+    return true;
+  }
+
+#ifndef WIN32
+  /* Alignment is guaranteed, all formats store 4 byte values after a 4 byte aligned header. */
+  src = (const float *)(mcf->data + offset);
+#else
+  src_alloc = MEM_malloc_arrayN(values_tot, sizeof(float), __func__);
+  if (!MOD_meshcache_file_read(mcf, offset, src_alloc, size)) {
+    *err_str = "Failed to read frame";
+    MEM_freeN(src_alloc);
+    return false;
+  }
+  src = src_alloc;
+#endif
+
+  {
+    const float ifactor = 1.0f - factor;
+    size_t i;
+    if (use_endian_switch) {
+      for (i = 0; i < values_tot; i++) {
+        float value = src[i];
+        BLI_endian_switch_float(&value);
+        vco[i] = (vco[i] * ifactor) + (value * factor);
+      }
+    }
+    else {
+      /* Flat loop over all components so the compiler can vectorize it. */
+      for (i = 0; i < values_tot; i++) {
+        vco[i] = (vco[i] * ifactor) + (src[i] * factor);
+      }
+    }
+  }
+
+  if (src_alloc) {
+    MEM_freeN(src_alloc);
+  }
+
+  return true;
+}
+
+/**
+ * Hint that a range of the file will be read soon (the next frame during playback),
+ * so the system can page it in asynchronously.
+ */
+void MOD_meshcache_file_prefetch(const MeshCacheFile *mcf, size_t offset, size_t size)
+{
+#if !defined(WIN32) && defined(POSIX_MADV_WILLNEED)
+  const size_t page_size = (size_t)sysconf(_SC_PAGESIZE);
+  size_t offset_aligned;
+
+  if (!meshcache_file_range_check(mcf, offset, size)) {
+    return;
+  }
+
+  offset_aligned = offset - (offset % page_size);
+  posix_madvise(
+      (void *)(mcf->data + offset_aligned), size + (offset - offset_aligned), POSIX_MADV_WILLNEED);
+#else
+  UNUSED_VARS(mcf, offset, size);
+#endif
+}
+
+/** \} */
@@ -21,20 +21,22 @@
 #ifndef __MOD_MESHCACHE_UTIL_H__
 #define __MOD_MESHCACHE_UTIL_H__
 
+struct MeshCacheFile;
+
 /* MOD_meshcache_mdd.c */
-bool MOD_meshcache_read_mdd_index(FILE *fp,
+bool MOD_meshcache_read_mdd_index(struct MeshCacheFile *mcf,
                                   float (*vertexCos)[3],
                                   const int vertex_tot,
                                   const int index,
                                   const float factor,
                                   const char **err_str);
-bool MOD_meshcache_read_mdd_frame(FILE *fp,
+bool MOD_meshcache_read_mdd_frame(struct MeshCacheFile *mcf,
                                   float (*vertexCos)[3],
                                   const int verts_tot,
                                   const char interp,
                                   const float frame,
                                   const char **err_str);
-bool MOD_meshcache_read_mdd_times(const char *filepath,
+bool MOD_meshcache_read_mdd_times(struct MeshCacheFile *mcf,
                                   float (*vertexCos)[3],
                                   const int verts_tot,
                                   const char interp,
@@ -44,19 +46,19 @@ bool MOD_meshcache_read_mdd_times(const char *filepath,
                                   const char **err_str);
 
 /* MOD_meshcache_pc2.c */
-bool MOD_meshcache_read_pc2_index(FILE *fp,
+bool MOD_meshcache_read_pc2_index(struct MeshCacheFile *mcf,
                                   float (*vertexCos)[3],
                                   const int verts_tot,
                                   const int index,
                                   const float factor,
                                   const char **err_str);
-bool MOD_meshcache_read_pc2_frame(FILE *fp,
+bool MOD_meshcache_read_pc2_frame(struct MeshCacheFile *mcf,
                                   float (*vertexCos)[3],
                                   const int verts_tot,
                                   const char interp,
                                   const float frame,
                                   const char **err_str);
-bool MOD_meshcache_read_pc2_times(const char *filepath,
+bool MOD_meshcache_read_pc2_times(struct MeshCacheFile *mcf,
                                   float (*vertexCos)[3],
                                   const int verts_tot,
                                   const char interp,
@@ -72,6 +74,39 @@ void MOD_meshcache_calc_range(const float frame,
                               int r_index_range[2],
                               float *r_factor);
 
+/**
+ * Cache file kept open (memory mapped where supported) on the modifier runtime.
+ */
+typedef struct MeshCacheFile {
+  /** Absolute path, FILE_MAX. */
+  char filepath[1024];
+  /** Used to detect the file being replaced on disk. */
+  size_t size;
+  int64_t mtime;
+#ifndef WIN32
+  const char *data;
+#else
+  FILE *fp;
+#endif
+} MeshCacheFile;
+
+struct MeshCacheFile *MOD_meshcache_file_ensure(struct MeshCacheFile *mcf,
+                                                const char *filepath,
+                                                const char **err_str);
+void MOD_meshcache_file_free(struct MeshCacheFile *mcf);
+bool MOD_meshcache_file_read(struct MeshCacheFile *mcf,
+                             const size_t offset,
+                             void *dst,
+                             const size_t size);
+bool MOD_meshcache_file_read_frame(struct MeshCacheFile *mcf,
+                                   const size_t offset,
+                                   float (*vertexCos)[3],
+                                   const int verts_tot,
+                                   const float factor,
+                                   const bool use_endian_switch,
+                                   const char **err_str);
+void MOD_meshcache_file_prefetch(const struct MeshCacheFile *mcf, size_t offset, size_t size);
+
 #define FRAME_SNAP_EPS 0.0001f
 
 #endif /* __MOD_MESHCACHE_UTIL_H__ */
@@ -90,6 +90,27 @@ static bool isDisabled(const struct Scene *UNUSED(scene),
   return (mcmd->cache_file == NULL) || (mcmd->object_path[0] == '\0');
 }
 
+#ifdef WITH_ALEMBIC
+/* Number of frames after the current one that are read in the background. */
+#  define MESHSEQ_PREFETCH_FRAMES 8
+
+static void prefetch_frames(MeshSeqCacheModifierData *mcmd,
+                            const ModifierEvalContext *ctx,
+                            Mesh *mesh,
+                            const float frame)
+{
+  Scene *scene = DEG_get_evaluated_scene(ctx->depsgraph);
+  float times[MESHSEQ_PREFETCH_FRAMES];
+
+  for (int i = 0; i < MESHSEQ_PREFETCH_FRAMES; i++) {
+    times[i] = BKE_cachefile_time_offset(mcmd->cache_file, frame + i + 1, FPS);
+  }
+
+  ABC_prefetch_mesh(
+      mcmd->reader, ctx->object, mesh, times, MESHSEQ_PREFETCH_FRAMES, mcmd->read_flag);
+}
+#endif
+
 static Mesh *modifyMesh(ModifierData *md, const ModifierEvalContext *ctx, Mesh *mesh)
 {
 #ifdef WITH_ALEMBIC
@@ -130,6 +151,29 @@ static Mesh *modifyMesh(ModifierData *md, const ModifierEvalContext *ctx, Mesh *
     /* TODO(sybren+bastien): possibly check relevant custom data layers (UV/color depending on
      * flags) and duplicate those too. */
     if ((me->mvert == mvert) || (me->medge == medge) || (me->mpoly == mpoly)) {
+      /* The input is the original mesh, which stays the same between frames, so the upcoming
+       * frames can be read from it in the background. The input itself is a new copy on every
+       * evaluation, the prefetcher identifies it by the arrays shared with the original. */
+      if ((me->mvert == mvert) && (me->medge == medge) && (me->mpoly == mpoly) &&
+          !cache_file->is_sequence && !cache_file->override_frame) {
+        /* Edits like painting keep the arrays, the tag tells the prefetched frames are outdated. */
+        if (me->id.recalc & ID_RECALC_GEOMETRY) {
+          ABC_prefetch_mesh_clear(mcmd->reader, ctx->object);
+        }
+
+        Mesh *result = ABC_read_mesh_prefetched(
+            mcmd->reader, ctx->object, mesh, time, &err_str, mcmd->read_flag);
+
+        prefetch_frames(mcmd, ctx, mesh, frame);
+
+        if (result) {
+          if (err_str) {
+            BKE_modifier_set_error(md, "%s", err_str);
+          }
+          return result;
+        }
+      }
+
       /* We need to duplicate data here, otherwise we'll modify org mesh, see T51701. */
       BKE_id_copy_ex(NULL,
                      &mesh->id,
@@ -48,6 +48,8 @@
 typedef struct SubsurfRuntimeData {
   /* Cached subdivision surface descriptor, with topology and settings. */
   struct Subdiv *subdiv;
+  /* Cached result, re-evaluated when only coarse vertex positions change. */
+  struct SubdivMeshCache *mesh_cache;
 } SubsurfRuntimeData;
 
 static void initData(ModifierData *md)
@@ -82,6 +84,7 @@ static void freeRuntimeData(void *runtime_data_v)
   if (runtime_data->subdiv != NULL) {
     BKE_subdiv_free(runtime_data->subdiv);
   }
+  BKE_subdiv_mesh_cache_free(runtime_data->mesh_cache);
   MEM_freeN(runtime_data);
 }
 
@@ -163,7 +166,8 @@ static Mesh *subdiv_as_mesh(SubsurfModifierData *smd,
   if (mesh_settings.resolution < 3) {
     return result;
   }
-  result = BKE_subdiv_to_mesh(subdiv, &mesh_settings, mesh);
+  SubsurfRuntimeData *runtime_data = (SubsurfRuntimeData *)smd->modifier.runtime;
+  result = BKE_subdiv_to_mesh_cached(subdiv, &mesh_settings, mesh, &runtime_data->mesh_cache);
   return result;
 }
 
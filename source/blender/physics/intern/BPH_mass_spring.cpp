@@ -31,7 +31,9 @@
 #include "DNA_scene_types.h"
 
 #include "BLI_linklist.h"
+#include "BLI_listbase.h"
 #include "BLI_math.h"
+#include "BLI_task.h"
 #include "BLI_utildefines.h"
 
 #include "BKE_cloth.h"
@@ -500,6 +502,79 @@ static void hair_get_boundbox(ClothModifierData *clmd, float gmin[3], float gmax
   }
 }
 
+/* Minimum number of vertices for per-vertex forces to be computed multi-threaded. */
+#define CLOTH_FORCE_PARALLEL_LIMIT 1024
+
+typedef struct ClothVertexForceData {
+  Scene *scene;
+  ClothModifierData *clmd;
+  ListBase *effectors;
+  float gravity[3];
+  float time;
+  /* Output of the effector pass, one force per vertex. */
+  float (*winvec)[3];
+} ClothVertexForceData;
+
+/* Gravity and goal springs only touch the vertex itself, so vertices can run in parallel. */
+static void cloth_calc_vertex_force_cb(void *__restrict userdata,
+                                       const int i,
+                                       const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  ClothVertexForceData *force_data = (ClothVertexForceData *)userdata;
+  ClothModifierData *clmd = force_data->clmd;
+  Implicit_Data *data = clmd->clothObject->implicit;
+  ClothVertex *vert = &clmd->clothObject->verts[i];
+
+  BPH_mass_spring_force_gravity(data, i, vert->mass, force_data->gravity);
+
+  /* Vertex goal springs */
+  if ((!(vert->flags & CLOTH_VERT_FLAG_PINNED)) && (vert->goal > FLT_EPSILON)) {
+    float goal_x[3], goal_v[3];
+    float k;
+
+    /* divide by time_scale to prevent goal vertices' delta locations from being multiplied */
+    interp_v3_v3v3(
+        goal_x, vert->xold, vert->xconst, force_data->time / clmd->sim_parms->time_scale);
+    sub_v3_v3v3(goal_v, vert->xconst, vert->xold); /* distance covered over dt==1 */
+
+    k = vert->goal * clmd->sim_parms->goalspring / (clmd->sim_parms->avg_spring_len + FLT_EPSILON);
+
+    BPH_mass_spring_force_spring_goal(
+        data, i, goal_x, goal_v, k, clmd->sim_parms->goalfrict * 0.01f);
+  }
+}
+
+static void cloth_calc_effector_force_cb(void *__restrict userdata,
+                                         const int i,
+                                         const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  ClothVertexForceData *force_data = (ClothVertexForceData *)userdata;
+  ClothModifierData *clmd = force_data->clmd;
+  float x[3], v[3];
+  EffectedPoint epoint;
+
+  BPH_mass_spring_get_motion_state(clmd->clothObject->implicit, i, x, v);
+  pd_point_from_loc(force_data->scene, x, v, i, &epoint);
+  BKE_effectors_apply(force_data->effectors,
+                      NULL,
+                      clmd->sim_parms->effector_weights,
+                      &epoint,
+                      force_data->winvec[i],
+                      NULL);
+}
+
+/* Noisy effectors draw from the random generator shared in their #PartDeflect,
+ * the forces then depend on the order in which the vertices are evaluated. */
+static bool cloth_effectors_use_noise(ListBase *effectors)
+{
+  LISTBASE_FOREACH (EffectorCache *, eff, effectors) {
+    if (eff->pd && eff->pd->f_noise > 0.0f) {
+      return true;
+    }
+  }
+  return false;
+}
+
 static void cloth_calc_force(
     Scene *scene, ClothModifierData *clmd, float UNUSED(frame), ListBase *effectors, float time)
 {
@@ -514,6 +589,18 @@ static void cloth_calc_force(
   unsigned int mvert_num = cloth->mvert_num;
   ClothVertex *vert;
 
+  ClothVertexForceData force_data;
+  force_data.scene = scene;
+  force_data.clmd = clmd;
+  force_data.effectors = effectors;
+  force_data.time = time;
+  force_data.winvec = NULL;
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.use_threading = (mvert_num > CLOTH_FORCE_PARALLEL_LIMIT);
+  settings.min_iter_per_thread = 128;
+
 #ifdef CLOTH_FORCE_GRAVITY
   /* global acceleration (gravitation) */
   if (scene->physics_settings.flag & PHYS_GLOBAL_GRAVITY) {
@@ -523,26 +610,8 @@ static void cloth_calc_force(
                 0.001f * clmd->sim_parms->effector_weights->global_gravity);
   }
 
-  vert = cloth->verts;
-  for (i = 0; i < cloth->mvert_num; i++, vert++) {
-    BPH_mass_spring_force_gravity(data, i, vert->mass, gravity);
-
-    /* Vertex goal springs */
-    if ((!(vert->flags & CLOTH_VERT_FLAG_PINNED)) && (vert->goal > FLT_EPSILON)) {
-      float goal_x[3], goal_v[3];
-      float k;
-
-      /* divide by time_scale to prevent goal vertices' delta locations from being multiplied */
-      interp_v3_v3v3(goal_x, vert->xold, vert->xconst, time / clmd->sim_parms->time_scale);
-      sub_v3_v3v3(goal_v, vert->xconst, vert->xold); /* distance covered over dt==1 */
-
-      k = vert->goal * clmd->sim_parms->goalspring /
-          (clmd->sim_parms->avg_spring_len + FLT_EPSILON);
-
-      BPH_mass_spring_force_spring_goal(
-          data, i, goal_x, goal_v, k, clmd->sim_parms->goalfrict * 0.01f);
-    }
-  }
+  copy_v3_v3(force_data.gravity, gravity);
+  BLI_task_parallel_range(0, mvert_num, &force_data, cloth_calc_vertex_force_cb, &settings);
 #endif
 
   /* cloth_calc_volume_force(clmd); */
@@ -627,15 +696,14 @@ static void cloth_calc_force(
   if (effectors) {
     /* cache per-vertex forces to avoid redundant calculation */
     float(*winvec)[3] = (float(*)[3])MEM_callocN(sizeof(float[3]) * mvert_num, "effector forces");
-    for (i = 0; i < cloth->mvert_num; i++) {
-      float x[3], v[3];
-      EffectedPoint epoint;
+    force_data.winvec = winvec;
 
-      BPH_mass_spring_get_motion_state(data, i, x, v);
-      pd_point_from_loc(scene, x, v, i, &epoint);
-      BKE_effectors_apply(
-          effectors, NULL, clmd->sim_parms->effector_weights, &epoint, winvec[i], NULL);
+    TaskParallelSettings effector_settings = settings;
+    if (cloth_effectors_use_noise(effectors)) {
+      effector_settings.use_threading = false;
     }
+    BLI_task_parallel_range(
+        0, mvert_num, &force_data, cloth_calc_effector_force_cb, &effector_settings);
 
     /* Hair has only edges. */
     if ((clmd->hairdata == NULL) && (cloth->primitive_num > 0)) {
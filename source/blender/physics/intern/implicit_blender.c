@@ -33,7 +33,9 @@
 #  include "DNA_scene_types.h"
 #  include "DNA_texture_types.h"
 
+#  include "BLI_alloca.h"
 #  include "BLI_math.h"
+#  include "BLI_task.h"
 #  include "BLI_utildefines.h"
 
 #  include "BKE_cloth.h"
@@ -46,9 +48,10 @@
 #    pragma GCC diagnostic ignored "-Wtype-limits"
 #  endif
 
-#  ifdef _OPENMP
-#    define CLOTH_OPENMP_LIMIT 512
-#  endif
+/* Minimum number of vertices for solver operations to run multi-threaded. */
+#  define CLOTH_PARALLEL_LIMIT 512
+/* Vertices per chunk of reductions, fixed so that sums don't depend on the number of threads. */
+#  define CLOTH_REDUCE_CHUNK_SIZE 1024
 
 //#define DEBUG_TIME
 
@@ -192,20 +195,58 @@ DO_INLINE void submul_lfvectorS(float (*to)[3],
     VECSUBMUL(to[i], fLongVector[i], scalar);
   }
 }
+static void cloth_parallel_range_settings(TaskParallelSettings *settings, unsigned int verts)
+{
+  BLI_parallel_range_settings_defaults(settings);
+  settings->use_threading = (verts > CLOTH_PARALLEL_LIMIT);
+  settings->min_iter_per_thread = 1;
+}
+
+typedef struct DotLongVectorData {
+  float (*a)[3], (*b)[3];
+  float *chunk_sums;
+  unsigned int verts;
+} DotLongVectorData;
+
+static void dot_lfvector_chunk_cb(void *__restrict userdata,
+                                  const int chunk,
+                                  const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  DotLongVectorData *data = userdata;
+  const unsigned int start = (unsigned int)chunk * CLOTH_REDUCE_CHUNK_SIZE;
+  const unsigned int end = MIN2(start + CLOTH_REDUCE_CHUNK_SIZE, data->verts);
+  float temp = 0.0f;
+
+  for (unsigned int i = start; i < end; i++) {
+    temp += dot_v3v3(data->a[i], data->b[i]);
+  }
+  data->chunk_sums[chunk] = temp;
+}
+
 /* dot product for big vector */
 DO_INLINE float dot_lfvector(float (*fLongVectorA)[3],
                              float (*fLongVectorB)[3],
                              unsigned int verts)
 {
-  long i = 0;
-  float temp = 0.0;
-  // XXX brecht, disabled this for now (first schedule line was already disabled),
-  // due to non-commutative nature of floating point ops this makes the sim give
-  // different results each time you run it!
-  // schedule(guided, 2)
-  //#pragma omp parallel for reduction(+: temp) if (verts > CLOTH_OPENMP_LIMIT)
-  for (i = 0; i < (long)verts; i++) {
-    temp += dot_v3v3(fLongVectorA[i], fLongVectorB[i]);
+  /* Due to non-commutative nature of floating point ops, a regular parallel reduction would make
+   * the sim give different results each time you run it. Sum fixed size chunks in parallel, then
+   * add up the partial sums in order, so results only depend on the chunk size. */
+  const unsigned int chunks = divide_ceil_u(verts, CLOTH_REDUCE_CHUNK_SIZE);
+  float *chunk_sums = BLI_array_alloca(chunk_sums, MAX2(chunks, 1));
+  DotLongVectorData data = {
+      .a = fLongVectorA,
+      .b = fLongVectorB,
+      .chunk_sums = chunk_sums,
+      .verts = verts,
+  };
+
+  TaskParallelSettings settings;
+  cloth_parallel_range_settings(&settings, verts);
+  BLI_task_parallel_range(0, (int)chunks, &data, dot_lfvector_chunk_cb, &settings);
+
+  float temp = 0.0f;
+  for (unsigned int i = 0; i < chunks; i++) {
+    temp += chunk_sums[i];
   }
   return temp;
 }
@@ -221,6 +262,19 @@ DO_INLINE void add_lfvector_lfvector(float (*to)[3],
     add_v3_v3v3(to[i], fLongVectorA[i], fLongVectorB[i]);
   }
 }
+typedef struct AddLongVectorData {
+  float (*to)[3], (*a)[3], (*b)[3];
+  float bS;
+} AddLongVectorData;
+
+static void add_lfvector_lfvectorS_cb(void *__restrict userdata,
+                                      const int i,
+                                      const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  AddLongVectorData *data = userdata;
+  VECADDS(data->to[i], data->a[i], data->b[i], data->bS);
+}
+
 /* A = B + C * float --> for big vector */
 DO_INLINE void add_lfvector_lfvectorS(float (*to)[3],
                                       float (*fLongVectorA)[3],
@@ -228,11 +282,17 @@ DO_INLINE void add_lfvector_lfvectorS(float (*to)[3],
                                       float bS,
                                       unsigned int verts)
 {
-  unsigned int i = 0;
+  AddLongVectorData data = {
+      .to = to,
+      .a = fLongVectorA,
+      .b = fLongVectorB,
+      .bS = bS,
+  };
 
-  for (i = 0; i < verts; i++) {
-    VECADDS(to[i], fLongVectorA[i], fLongVectorB[i], bS);
-  }
+  TaskParallelSettings settings;
+  cloth_parallel_range_settings(&settings, verts);
+  settings.min_iter_per_thread = CLOTH_PARALLEL_LIMIT;
+  BLI_task_parallel_range(0, (int)verts, &data, add_lfvector_lfvectorS_cb, &settings);
 }
 /* A = B * float + C * float --> for big vector */
 DO_INLINE void add_lfvectorS_lfvectorS(float (*to)[3],
@@ -607,35 +667,116 @@ DO_INLINE void initdiag_bfmatrix(fmatrix3x3 *matrix, float m3[3][3])
   }
 }
 
-/* SPARSE SYMMETRIC multiply big matrix with long vector*/
-/* STATUS: verified */
-DO_INLINE void mul_bfmatrix_lfvector(float (*to)[3], fmatrix3x3 *from, lfVector *fLongVector)
+/* Per vertex lists of the blocks of a big matrix, so products can be computed one row at a time
+ * (in parallel) instead of scattering the contribution of each block. */
+typedef struct BigMatrixRows {
+  /* Off-diagonal blocks with (c == vertex), used transposed. */
+  unsigned int *col_offsets, *col_blocks;
+  /* All blocks with (r == vertex). */
+  unsigned int *row_offsets, *row_blocks;
+} BigMatrixRows;
+
+/* Build the block lists, blocks are stored in ascending order for every vertex. */
+static void bfmatrix_rows_init(BigMatrixRows *rows, fmatrix3x3 *matrix)
 {
-  unsigned int vcount = from[0].vcount;
-  lfVector *temp = create_lfvector(vcount);
+  const unsigned int vcount = matrix[0].vcount;
+  const unsigned int tot = matrix[0].vcount + matrix[0].scount;
+  unsigned int i;
 
-  zero_lfvector(to, vcount);
+  rows->col_offsets = MEM_callocN(sizeof(*rows->col_offsets) * (vcount + 1), __func__);
+  rows->row_offsets = MEM_callocN(sizeof(*rows->row_offsets) * (vcount + 1), __func__);
+  rows->col_blocks = MEM_mallocN(sizeof(*rows->col_blocks) * MAX2(tot - vcount, 1), __func__);
+  rows->row_blocks = MEM_mallocN(sizeof(*rows->row_blocks) * tot, __func__);
 
-#  pragma omp parallel sections if (vcount > CLOTH_OPENMP_LIMIT)
-  {
-#  pragma omp section
-    {
-      for (unsigned int i = from[0].vcount; i < from[0].vcount + from[0].scount; i++) {
-        /* This is the lower triangle of the sparse matrix,
-         * therefore multiplication occurs with transposed submatrices. */
-        muladd_fmatrixT_fvector(to[from[i].c], from[i].m, fLongVector[from[i].r]);
-      }
-    }
-#  pragma omp section
-    {
-      for (unsigned int i = 0; i < from[0].vcount + from[0].scount; i++) {
-        muladd_fmatrix_fvector(temp[from[i].r], from[i].m, fLongVector[from[i].c]);
-      }
-    }
+  /* Count, then turn counts into offsets (shifted by one, restored while filling). */
+  for (i = vcount; i < tot; i++) {
+    rows->col_offsets[matrix[i].c + 1]++;
+  }
+  for (i = 0; i < tot; i++) {
+    rows->row_offsets[matrix[i].r + 1]++;
+  }
+  for (i = 0; i < vcount; i++) {
+    rows->col_offsets[i + 1] += rows->col_offsets[i];
+    rows->row_offsets[i + 1] += rows->row_offsets[i];
+  }
+  for (i = vcount; i < tot; i++) {
+    rows->col_blocks[rows->col_offsets[matrix[i].c]++] = i;
   }
-  add_lfvector_lfvector(to, to, temp, from[0].vcount);
+  for (i = 0; i < tot; i++) {
+    rows->row_blocks[rows->row_offsets[matrix[i].r]++] = i;
+  }
+  for (i = vcount; i > 0; i--) {
+    rows->col_offsets[i] = rows->col_offsets[i - 1];
+    rows->row_offsets[i] = rows->row_offsets[i - 1];
+  }
+  rows->col_offsets[0] = 0;
+  rows->row_offsets[0] = 0;
+}
+
+static void bfmatrix_rows_free(BigMatrixRows *rows)
+{
+  MEM_freeN(rows->col_offsets);
+  MEM_freeN(rows->col_blocks);
+  MEM_freeN(rows->row_offsets);
+  MEM_freeN(rows->row_blocks);
+}
+
+typedef struct MulBigMatrixData {
+  float (*to)[3];
+  fmatrix3x3 *from;
+  const BigMatrixRows *rows;
+  lfVector *fLongVector;
+} MulBigMatrixData;
+
+static void mul_bfmatrix_lfvector_cb(void *__restrict userdata,
+                                     const int v,
+                                     const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  MulBigMatrixData *data = userdata;
+  fmatrix3x3 *from = data->from;
+  const BigMatrixRows *rows = data->rows;
+  float lower[3] = {0.0f, 0.0f, 0.0f}, upper[3] = {0.0f, 0.0f, 0.0f};
+
+  for (unsigned int j = rows->col_offsets[v]; j < rows->col_offsets[v + 1]; j++) {
+    const fmatrix3x3 *block = &from[rows->col_blocks[j]];
+    /* This is the lower triangle of the sparse matrix,
+     * therefore multiplication occurs with transposed submatrices. */
+    muladd_fmatrixT_fvector(lower, (float(*)[3])block->m, data->fLongVector[block->r]);
+  }
+  for (unsigned int j = rows->row_offsets[v]; j < rows->row_offsets[v + 1]; j++) {
+    const fmatrix3x3 *block = &from[rows->row_blocks[j]];
+    muladd_fmatrix_fvector(upper, (float(*)[3])block->m, data->fLongVector[block->c]);
+  }
+  add_v3_v3v3(data->to[v], lower, upper);
+}
+
+/* SPARSE SYMMETRIC multiply big matrix with long vector, using prebuilt block lists */
+DO_INLINE void mul_bfmatrix_lfvector_rows(float (*to)[3],
+                                          fmatrix3x3 *from,
+                                          const BigMatrixRows *rows,
+                                          lfVector *fLongVector)
+{
+  MulBigMatrixData data = {
+      .to = to,
+      .from = from,
+      .rows = rows,
+      .fLongVector = fLongVector,
+  };
+
+  TaskParallelSettings settings;
+  cloth_parallel_range_settings(&settings, from[0].vcount);
+  settings.min_iter_per_thread = CLOTH_PARALLEL_LIMIT / 4;
+  BLI_task_parallel_range(0, (int)from[0].vcount, &data, mul_bfmatrix_lfvector_cb, &settings);
+}
 
-  del_lfvector(temp);
+/* SPARSE SYMMETRIC multiply big matrix with long vector*/
+/* STATUS: verified */
+DO_INLINE void mul_bfmatrix_lfvector(float (*to)[3], fmatrix3x3 *from, lfVector *fLongVector)
+{
+  BigMatrixRows rows;
+  bfmatrix_rows_init(&rows, from);
+  mul_bfmatrix_lfvector_rows(to, from, &rows, fLongVector);
+  bfmatrix_rows_free(&rows);
 }
 
 /* SPARSE SYMMETRIC sub big matrix with big matrix*/
@@ -759,13 +900,30 @@ BLI_INLINE void root_to_world_m3(Implicit_Data *data, int index, float r[3][3],
 
 /* ================================ */
 
+typedef struct FilterData {
+  lfVector *V;
+  fmatrix3x3 *S;
+} FilterData;
+
+static void filter_cb(void *__restrict userdata,
+                      const int i,
+                      const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  FilterData *data = userdata;
+  mul_m3_v3(data->S[i].m, data->V[data->S[i].r]);
+}
+
 DO_INLINE void filter(lfVector *V, fmatrix3x3 *S)
 {
-  unsigned int i = 0;
+  FilterData data = {
+      .V = V,
+      .S = S,
+  };
 
-  for (i = 0; i < S[0].vcount; i++) {
-    mul_m3_v3(S[i].m, V[S[i].r]);
-  }
+  TaskParallelSettings settings;
+  cloth_parallel_range_settings(&settings, S[0].vcount);
+  settings.min_iter_per_thread = CLOTH_PARALLEL_LIMIT;
+  BLI_task_parallel_range(0, (int)S[0].vcount, &data, filter_cb, &settings);
 }
 
 /* this version of the CG algorithm does not work very well with partial constraints
@@ -858,6 +1016,10 @@ static int cg_filtered(lfVector *ldV,
   lfVector *s = create_lfvector(numverts);
   float bnorm2, delta_new, delta_old, delta_target, alpha;
 
+  /* The sparsity pattern of A doesn't change while solving. */
+  BigMatrixRows rows;
+  bfmatrix_rows_init(&rows, lA);
+
   cp_lfvector(ldV, z, numverts);
 
   /* d0 = filter(B)^T * P * filter(B) */
@@ -867,7 +1029,7 @@ static int cg_filtered(lfVector *ldV,
   delta_target = conjgrad_epsilon * conjgrad_epsilon * bnorm2;
 
   /* r = filter(B - A * dV) */
-  mul_bfmatrix_lfvector(AdV, lA, ldV);
+  mul_bfmatrix_lfvector_rows(AdV, lA, &rows, ldV);
   sub_lfvector_lfvector(r, lB, AdV, numverts);
   filter(r, S);
 
@@ -890,7 +1052,7 @@ static int cg_filtered(lfVector *ldV,
 #  endif
 
   while (delta_new > delta_target && conjgrad_loopcount < conjgrad_looplimit) {
-    mul_bfmatrix_lfvector(q, lA, c);
+    mul_bfmatrix_lfvector_rows(q, lA, &rows, c);
     filter(q, S);
 
     alpha = delta_new / dot_lfvector(c, q, numverts);
@@ -916,6 +1078,7 @@ static int cg_filtered(lfVector *ldV,
   printf("========\n");
 #  endif
 
+  bfmatrix_rows_free(&rows);
   del_lfvector(fB);
   del_lfvector(AdV);
   del_lfvector(r);
@@ -940,7 +1103,6 @@ DO_INLINE void BuildPPinv(fmatrix3x3 *lA, fmatrix3x3 *P, fmatrix3x3 *Pinv)
   unsigned int i = 0;
 
   // Take only the diagonal blocks of A
-  // #pragma omp parallel for private(i) if (lA[0].vcount > CLOTH_OPENMP_LIMIT)
   for (i = 0; i < lA[0].vcount; i++) {
     // block diagonalizer
     cp_fmatrix(P[i].m, lA[i].m);
@@ -25,17 +25,21 @@
  */
 
 #include <Python.h>
+#include <marshal.h>
 #include <stddef.h>
 
 #include "MEM_guardedalloc.h"
 
 #include "DNA_text_types.h"
 
+#include "BLI_fileops.h"
+#include "BLI_hash_mm2a.h"
 #include "BLI_listbase.h"
 #include "BLI_path_util.h"
 #include "BLI_string.h"
 #include "BLI_utildefines.h"
 
+#include "BKE_appdir.h"
 #include "BKE_main.h"
 /* UNUSED */
 #include "BKE_text.h" /* txt_to_buf */
@@ -46,6 +50,7 @@
 
 static Main *bpy_import_main = NULL;
 static ListBase bpy_import_main_list;
+static char bpy_import_bytecode_cache_dir[FILE_MAX] = "";
 
 static PyMethodDef bpy_import_meth;
 static PyMethodDef bpy_reload_meth;
@@ -127,6 +132,122 @@ void bpy_text_filename_get(char *fn, size_t fn_len, Text *text)
       fn, fn_len, "%s%c%s", ID_BLEND_PATH(bpy_import_main, &text->id), SEP, text->id.name + 2);
 }
 
+void bpy_import_bytecode_cache_set(const char *dirpath)
+{
+  BLI_strncpy(bpy_import_bytecode_cache_dir,
+              dirpath ? dirpath : "",
+              sizeof(bpy_import_bytecode_cache_dir));
+}
+
+/* Header of the bytecode cache files, followed by the marshalled code object */
+typedef struct BytecodeCacheHeader {
+  int python_magic;
+  int source_len;
+  /* second hash of the source, with the one in the file name the source is keyed on 64 bits */
+  unsigned int source_hash;
+} BytecodeCacheHeader;
+
+static PyObject *bytecode_cache_read(const char *filepath, const BytecodeCacheHeader *header)
+{
+  size_t data_len;
+  char *data;
+  PyObject *code = NULL;
+
+  /* files written by another user are not trusted */
+  if (!BKE_appdir_file_is_user_owned(filepath)) {
+    return NULL;
+  }
+
+  data = BLI_file_read_binary_as_mem(filepath, 0, &data_len);
+  if (data == NULL) {
+    return NULL;
+  }
+
+  if (data_len > sizeof(*header) && memcmp(data, header, sizeof(*header)) == 0) {
+    code = PyMarshal_ReadObjectFromString(data + sizeof(*header),
+                                          (Py_ssize_t)(data_len - sizeof(*header)));
+    if (code && !PyCode_Check(code)) {
+      Py_DECREF(code);
+      code = NULL;
+    }
+    /* an invalid file falls back to compiling the text */
+    PyErr_Clear();
+  }
+
+  MEM_freeN(data);
+  return code;
+}
+
+static void bytecode_cache_write(const char *filepath,
+                                 const BytecodeCacheHeader *header,
+                                 PyObject *code)
+{
+  PyObject *data = PyMarshal_WriteObjectToString(code, Py_MARSHAL_VERSION);
+  char tempname[FILE_MAX];
+  FILE *fp;
+
+  if (data == NULL) {
+    PyErr_Clear();
+    return;
+  }
+
+  /* write to a temporary file first, so that no partial file is ever read */
+  BLI_snprintf(tempname, sizeof(tempname), "%s@", filepath);
+  if ((fp = BLI_fopen(tempname, "wb"))) {
+    bool written = (fwrite(header, sizeof(*header), 1, fp) == 1 &&
+                    fwrite(PyBytes_AS_STRING(data), PyBytes_GET_SIZE(data), 1, fp) == 1);
+    written = (fclose(fp) == 0) && written;
+    if (!written || BLI_rename(tempname, filepath) != 0) {
+      BLI_delete(tempname, false, false);
+    }
+  }
+
+  Py_DECREF(data);
+}
+
+PyObject *bpy_compile_string_cached(const char *buf, PyObject *filename)
+{
+  char cache_name[FILE_MAXFILE];
+  char cache_path[FILE_MAX];
+  const char *filename_str;
+  BytecodeCacheHeader header;
+  PyObject *code;
+
+  if (bpy_import_bytecode_cache_dir[0] == '\0') {
+    return Py_CompileStringObject(buf, filename, Py_file_input, NULL, -1);
+  }
+
+  filename_str = PyUnicode_AsUTF8(filename);
+  if (filename_str == NULL) {
+    PyErr_Clear();
+    return Py_CompileStringObject(buf, filename, Py_file_input, NULL, -1);
+  }
+
+  /* The file name is part of the code object, so it is part of the key too */
+  BLI_snprintf(cache_name,
+               sizeof(cache_name),
+               "%08x%08x.pyc",
+               BLI_hash_mm2((const unsigned char *)buf, strlen(buf), 0),
+               BLI_hash_mm2((const unsigned char *)filename_str, strlen(filename_str), 0));
+  BLI_join_dirfile(cache_path, sizeof(cache_path), bpy_import_bytecode_cache_dir, cache_name);
+
+  header.python_magic = (int)PyImport_GetMagicNumber();
+  header.source_len = (int)strlen(buf);
+  header.source_hash = BLI_hash_mm2((const unsigned char *)buf, strlen(buf), 1);
+
+  code = bytecode_cache_read(cache_path, &header);
+  if (code) {
+    return code;
+  }
+
+  code = Py_CompileStringObject(buf, filename, Py_file_input, NULL, -1);
+  if (code && !Py_DontWriteBytecodeFlag) {
+    bytecode_cache_write(cache_path, &header, code);
+  }
+
+  return code;
+}
+
 bool bpy_text_compile(Text *text)
 {
   char fn_dummy[FILE_MAX];
@@ -141,7 +262,7 @@ bool bpy_text_compile(Text *text)
   fn_dummy_py = PyC_UnicodeFromByte(fn_dummy);
 
   buf = txt_to_buf(text, NULL);
-  text->compiled = Py_CompileStringObject(buf, fn_dummy_py, Py_file_input, NULL, -1);
+  text->compiled = bpy_compile_string_cached(buf, fn_dummy_py);
   MEM_freeN(buf);
 
   Py_DECREF(fn_dummy_py);
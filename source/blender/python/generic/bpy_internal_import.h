@@ -48,6 +48,12 @@ PyObject *bpy_text_reimport(PyObject *module, int *found);
 
 void bpy_text_filename_get(char *fn, size_t fn_len, struct Text *text);
 
+/* Compile text, loading the code from the bytecode cache when enabled */
+PyObject *bpy_compile_string_cached(const char *buf, PyObject *filename);
+
+/* The game engine stores the bytecode of text blocks in this directory, NULL disables it */
+void bpy_import_bytecode_cache_set(const char *dirpath);
+
 /* The game engine has its own Main struct, if this is set search this rather than G.main */
 struct Main *bpy_import_main_get(void);
 void bpy_import_main_set(struct Main *maggie);
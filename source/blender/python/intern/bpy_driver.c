@@ -96,6 +96,20 @@ int bpy_pydriver_create_dict(void)
   PyObject *mod_math = mod;
 #endif
 
+  /* Add math utility functions,
+   * keep in sync with the simple expression evaluator (BLI_expr_pylike_eval.h). */
+  mod = PyImport_ImportModuleLevel("bl_math", NULL, NULL, NULL, 0);
+  if (mod) {
+    static const char *names[] = {"clamp", "lerp", "smoothstep", NULL};
+
+    for (const char **pname = names; *pname; ++pname) {
+      PyObject *func = PyDict_GetItemString(PyModule_GetDict(mod), *pname);
+      PyDict_SetItemString(bpy_pydriver_Dict, *pname, func);
+    }
+
+    Py_DECREF(mod);
+  }
+
   /* add bpy to global namespace */
   mod = PyImport_ImportModuleLevel("bpy", NULL, NULL, NULL, 0);
   if (mod) {
@@ -130,6 +144,10 @@ int bpy_pydriver_create_dict(void)
         "bool",
         "float",
         "int",
+        /* bl_math */
+        "clamp",
+        "lerp",
+        "smoothstep",
 
         NULL,
     };
@@ -0,0 +1,167 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s):
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file gameengine/Common/CM_DiskCache.cpp
+ *  \ingroup common
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "CM_DiskCache.h"
+
+#include "BKE_appdir.h"
+#include "BLI_fileops.h"
+#include "BLI_path_util.h"
+#include "BLI_string.h"
+
+/// Header of the cache files, followed by the buffer data.
+struct DiskCacheHeader {
+  char magic[4];
+  int version;
+  uint64_t size;
+};
+
+static const char disk_cache_magic[4] = {'B', 'G', 'E', 'C'};
+
+CM_DiskCacheKey::CM_DiskCacheKey()
+{
+  BLI_hash_mm2a_init(&m_hash[0], 0);
+  BLI_hash_mm2a_init(&m_hash[1], 1);
+}
+
+void CM_DiskCacheKey::Add(const void *data, size_t size)
+{
+  BLI_hash_mm2a_add(&m_hash[0], (const unsigned char *)data, size);
+  BLI_hash_mm2a_add(&m_hash[1], (const unsigned char *)data, size);
+}
+
+std::string CM_DiskCacheKey::GetName() const
+{
+  // Ending a hash modifies it, end copies so that more data can be added later.
+  BLI_HashMurmur2A hash[2] = {m_hash[0], m_hash[1]};
+  char name[17];
+  BLI_snprintf(
+      name, sizeof(name), "%08x%08x", BLI_hash_mm2a_end(&hash[0]), BLI_hash_mm2a_end(&hash[1]));
+  return name;
+}
+
+/// Return the path of the cache file of key, or false if the cache folder isn't usable.
+static bool disk_cache_filepath(const char *extension,
+                                const CM_DiskCacheKey &key,
+                                char r_filepath[FILE_MAX])
+{
+  // The cache is private to the user, files written by someone else are ignored.
+  const char *dirpath = BKE_appdir_folder_caches_create("bge_cache");
+  if (!dirpath) {
+    return false;
+  }
+
+  char filename[FILE_MAXFILE];
+  BLI_snprintf(filename, sizeof(filename), "%s.%s", key.GetName().c_str(), extension);
+  BLI_join_dirfile(r_filepath, FILE_MAX, dirpath, filename);
+  return true;
+}
+
+CM_DiskCacheBuffer::CM_DiskCacheBuffer() : m_position(0)
+{
+}
+
+void CM_DiskCacheBuffer::Write(const void *data, size_t size)
+{
+  const char *bytes = (const char *)data;
+  m_data.insert(m_data.end(), bytes, bytes + size);
+}
+
+bool CM_DiskCacheBuffer::Read(void *data, size_t size)
+{
+  if (size > m_data.size() - m_position) {
+    return false;
+  }
+
+  memcpy(data, m_data.data() + m_position, size);
+  m_position += size;
+  return true;
+}
+
+bool CM_DiskCacheBuffer::AtEnd() const
+{
+  return m_position == m_data.size();
+}
+
+bool CM_DiskCacheBuffer::Load(const char *extension, const CM_DiskCacheKey &key, int version)
+{
+  m_data.clear();
+  m_position = 0;
+
+  char filepath[FILE_MAX];
+  if (!disk_cache_filepath(extension, key, filepath) ||
+      !BKE_appdir_file_is_user_owned(filepath)) {
+    return false;
+  }
+
+  FILE *file = BLI_fopen(filepath, "rb");
+  if (!file) {
+    return false;
+  }
+
+  DiskCacheHeader header;
+  bool loaded = false;
+  if (fread(&header, sizeof(header), 1, file) == 1 &&
+      memcmp(header.magic, disk_cache_magic, sizeof(header.magic)) == 0 &&
+      header.version == version && header.size == BLI_file_size(filepath) - sizeof(header)) {
+    m_data.resize(header.size);
+    loaded = (header.size == 0) || (fread(m_data.data(), header.size, 1, file) == 1);
+  }
+  fclose(file);
+
+  if (!loaded) {
+    m_data.clear();
+  }
+  return loaded;
+}
+
+void CM_DiskCacheBuffer::Save(const char *extension, const CM_DiskCacheKey &key, int version) const
+{
+  char filepath[FILE_MAX];
+  if (!disk_cache_filepath(extension, key, filepath)) {
+    return;
+  }
+
+  DiskCacheHeader header;
+  memcpy(header.magic, disk_cache_magic, sizeof(header.magic));
+  header.version = version;
+  header.size = m_data.size();
+
+  char tempname[FILE_MAX];
+  BLI_snprintf(tempname, sizeof(tempname), "%s@", filepath);
+  FILE *file = BLI_fopen(tempname, "wb");
+  if (!file) {
+    return;
+  }
+
+  const bool written = (fwrite(&header, sizeof(header), 1, file) == 1 &&
+                        (header.size == 0 || fwrite(m_data.data(), header.size, 1, file) == 1));
+  if (fclose(file) != 0 || !written || BLI_rename(tempname, filepath) != 0) {
+    BLI_delete(tempname, false, false);
+  }
+}
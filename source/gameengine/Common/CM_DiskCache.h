@@ -0,0 +1,126 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s):
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file CM_DiskCache.h
+ *  \ingroup common
+ */
+
+#ifndef __CM_DISKCACHE_H__
+#define __CM_DISKCACHE_H__
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "BLI_hash_mm2a.h"
+
+/** Hash of all the data a conversion result depends on, the cache file of the result is named
+ * after it.
+ */
+class CM_DiskCacheKey {
+ private:
+  /// Two hashes with different seeds, 32 bits are too few to name files of large levels.
+  BLI_HashMurmur2A m_hash[2];
+
+ public:
+  CM_DiskCacheKey();
+
+  void Add(const void *data, size_t size);
+
+  template<class Value> void Add(const Value &value)
+  {
+    Add(&value, sizeof(Value));
+  }
+
+  /// Add the size and the content of an array, data can be null for an empty array.
+  template<class Value> void AddArray(const Value *data, size_t count)
+  {
+    Add((uint64_t)count);
+    if (data) {
+      Add(data, count * sizeof(Value));
+    }
+  }
+
+  std::string GetName() const;
+};
+
+/** Conversion result stored in a cache file of the user configuration, written and read back
+ * sequentially. The cache files are only accessible by the user, files written by someone else
+ * are never read. Reading fails on any mismatch, the caller then converts again.
+ */
+class CM_DiskCacheBuffer {
+ private:
+  std::vector<char> m_data;
+  size_t m_position;
+
+ public:
+  CM_DiskCacheBuffer();
+
+  void Write(const void *data, size_t size);
+
+  template<class Value> void Write(const Value &value)
+  {
+    Write(&value, sizeof(Value));
+  }
+
+  template<class Array> void WriteArray(const Array &array)
+  {
+    Write((uint64_t)array.size());
+    if (array.size() > 0) {
+      Write(&array[0], array.size() * sizeof(array[0]));
+    }
+  }
+
+  bool Read(void *data, size_t size);
+
+  template<class Value> bool Read(Value &value)
+  {
+    return Read(&value, sizeof(Value));
+  }
+
+  /// Read an array written by WriteArray, its size is checked against the remaining data.
+  template<class Array> bool ReadArray(Array &array)
+  {
+    uint64_t size;
+    if (!Read(size) || size > (m_data.size() - m_position) / sizeof(array[0])) {
+      return false;
+    }
+    array.resize(size);
+    return (size == 0) || Read(&array[0], size * sizeof(array[0]));
+  }
+
+  /// Return true when all the data was read.
+  bool AtEnd() const;
+
+  /** Load the cache file of key.
+   * \param extension The extension of the cache files of a kind of conversion result.
+   * \param version The version of the format of the result, older files are ignored.
+   * \return False if the file doesn't exist, isn't owned by the user or is of another version.
+   */
+  bool Load(const char *extension, const CM_DiskCacheKey &key, int version);
+  /** Save the buffer as the cache file of key, a temporary file is written and renamed so that
+   * a game started meanwhile never loads a partial file.
+   */
+  void Save(const char *extension, const CM_DiskCacheKey &key, int version) const;
+};
+
+#endif  // __CM_DISKCACHE_H__
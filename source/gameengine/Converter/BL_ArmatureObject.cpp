@@ -38,6 +38,7 @@
 #include "BKE_context.h"
 #include "BKE_layer.h"
 #include "BKE_lib_id.h"
+#include "BKE_object.h"
 #include "BKE_scene.h"
 #include "DNA_armature_types.h"
 #include "MEM_guardedalloc.h"
@@ -45,6 +46,7 @@
 
 #include "BL_Action.h"
 #include "BL_BlenderSceneConverter.h"
+#include "KX_Camera.h"
 #include "KX_Globals.h"
 
 /**
@@ -201,7 +203,10 @@ BL_ArmatureObject::BL_ArmatureObject(void *sgReplicationInfo,
       m_timestep(0.040),
       m_vert_deform_type(vert_deform_type),
       m_drawDebug(false),
-      m_lastapplyframe(0.0)
+      m_lastapplyframe(0.0),
+      m_useAnimationLod((armature->gameflag2 & OB_NO_ANIMATION_LOD) == 0),
+      m_animationLodInterval(1),
+      m_animationLodFrame(0)
 {
   m_controlledConstraints = new CListValue<BL_ArmatureConstraint>();
   m_poseChannels = new CListValue<BL_ArmatureChannel>();
@@ -437,14 +442,6 @@ void BL_ArmatureObject::ApplyPose()
   }
 }
 
-void BL_ArmatureObject::SetPoseByAction(bAction *action, float localtime)
-{
-  PointerRNA ptrrna;
-  RNA_id_pointer_create(&m_objArma->id, &ptrrna);
-
-  animsys_evaluate_action(&ptrrna, action, localtime, false);
-}
-
 void BL_ArmatureObject::BlendInPose(bPose *blend_pose, float weight, short mode)
 {
   game_blend_poses(m_objArma->pose, blend_pose, weight, mode);
@@ -461,6 +458,65 @@ bool BL_ArmatureObject::UpdateTimestep(double curtime)
   return false;
 }
 
+bool BL_ArmatureObject::GetUseAnimationLod() const
+{
+  return m_useAnimationLod;
+}
+
+bool BL_ArmatureObject::IsVisibleFromCamera(KX_Camera *cam)
+{
+  const SG_Frustum &frustum = cam->GetFrustum();
+  CListValue<KX_GameObject> *children = GetChildren();
+
+  bool has_mesh = false;
+  bool visible = false;
+  for (KX_GameObject *child : children) {
+    Object *ob = child->GetBlenderObject();
+    if (child->GetMeshCount() == 0 || !ob) {
+      continue;
+    }
+    has_mesh = true;
+
+    if (!child->GetVisible()) {
+      continue;
+    }
+
+    // Bounds of the undeformed mesh, they don't depend on the skipped pose updates.
+    const BoundBox *bb = BKE_object_boundbox_get(ob);
+    if (!bb || frustum.AabbInsideFrustum(MT_Vector3(bb->vec[0]),
+                                         MT_Vector3(bb->vec[6]),
+                                         MT_Matrix4x4(child->NodeGetWorldTransform())) !=
+                   SG_Frustum::OUTSIDE) {
+      visible = true;
+      break;
+    }
+  }
+
+  children->Release();
+
+  // An armature without meshes, e.g. only moving other objects, must always be updated.
+  return visible || !has_mesh;
+}
+
+bool BL_ArmatureObject::UpdateAnimationLod(int interval)
+{
+  // Update the pose at once when the armature goes to a more frequent tier, e.g. becomes visible.
+  const bool promoted = (interval != 0) &&
+                        (m_animationLodInterval == 0 || interval < m_animationLodInterval);
+  m_animationLodInterval = interval;
+
+  if (interval == 0) {
+    return false;
+  }
+
+  if (promoted || ++m_animationLodFrame >= interval) {
+    m_animationLodFrame = 0;
+    return true;
+  }
+
+  return false;
+}
+
 Object *BL_ArmatureObject::GetArmatureObject()
 {
   return m_objArma;
@@ -43,6 +43,7 @@ struct bConstraint;
 struct Object;
 class MT_Matrix4x4;
 class BL_BlenderSceneConverter;
+class KX_Camera;
 class RAS_DebugDraw;
 
 class BL_ArmatureObject : public KX_GameObject {
@@ -70,6 +71,13 @@ class BL_ArmatureObject : public KX_GameObject {
 
   double m_lastapplyframe;
 
+  /// True if the scene animation level of detail can reduce the pose update rate.
+  bool m_useAnimationLod;
+  /// Frames between two pose updates in the current animation LoD tier, 0 to only manage time.
+  int m_animationLodInterval;
+  /// Frames since the last pose update.
+  int m_animationLodFrame;
+
  public:
   BL_ArmatureObject(void *sgReplicationInfo,
                     SG_Callbacks callbacks,
@@ -91,11 +99,19 @@ class BL_ArmatureObject : public KX_GameObject {
   /// Never edit this, only for accessing names.
   bPose *GetPose() const;
   void ApplyPose();
-  void SetPoseByAction(bAction *action, float localtime);
   void BlendInPose(bPose *blend_pose, float weight, short mode);
 
   bool UpdateTimestep(double curtime);
 
+  bool GetUseAnimationLod() const;
+  /// Return true if a mesh deformed by the armature is in the camera frustum, or if there is none.
+  bool IsVisibleFromCamera(KX_Camera *cam);
+  /** Set the pose update interval chosen by the scene animation level of detail.
+   * \param interval Frames between two pose updates, 0 to only manage the actions time.
+   * \return True if the pose must be updated this frame.
+   */
+  bool UpdateAnimationLod(int interval);
+
   Object *GetArmatureObject();
   Object *GetOrigArmatureObject();
   int GetVertDeformType();
@@ -61,16 +61,22 @@
 #include "BKE_armature.h"
 #include "BKE_cdderivedmesh.h"
 #include "BKE_context.h"
+#include "BKE_customdata.h"
 #include "BKE_displist.h"
 #include "BKE_layer.h"
 #include "BKE_main.h"
 #include "BKE_material.h" /* give_current_material */
+#include "BKE_mesh.h"
 #include "BKE_object.h"
 #include "BKE_scene.h"
+#include "BLI_task.h"
 #include "DEG_depsgraph_query.h"
 #include "DNA_camera_types.h"
 #include "DNA_mesh_types.h"
+#include "DNA_modifier_types.h"
 #include "DNA_python_component_types.h"
+#include "bmesh.h"
+#include "bmesh_tools.h"
 #include "wm_event_types.h"
 
 /* end of blender include block */
@@ -81,6 +87,7 @@
 #include "BL_ConvertControllers.h"
 #include "BL_ConvertProperties.h"
 #include "BL_ConvertSensors.h"
+#include "CM_DiskCache.h"
 #include "KX_BlenderMaterial.h"
 #include "KX_Camera.h"
 #include "KX_ClientObjectInfo.h"
@@ -97,8 +104,11 @@
 #include "KX_SG_NodeRelationships.h"
 #include "PHY_Pro.h"
 #include "RAS_ICanvas.h"
+#include "RAS_IDisplayArray.h"
+#include "RAS_Polygon.h"
 #include "RAS_TexVert.h"
 #ifdef WITH_BULLET
+#  include "CcdGraphicController.h"
 #  include "CcdPhysicsEnvironment.h"
 #endif
 
@@ -336,34 +346,463 @@ static RAS_MaterialBucket *material_from_mesh(Material *ma,
 }
 
 /* blenderobj can be nullptr, make sure its checked for */
-RAS_MeshObject *BL_ConvertMesh(Mesh *mesh,
-                               Object *blenderobj,
-                               KX_Scene *scene,
-                               RAS_Rasterizer *rasty,
-                               BL_BlenderSceneConverter *converter,
-                               bool libloading,
-                               bool converting_during_runtime)
+static Depsgraph *get_depsgraph(Scene *bl_scene)
 {
-  RAS_MeshObject *meshobj;
-  int lightlayer = blenderobj ? blenderobj->lay : (1 << 20) - 1;  // all layers if no object.
+  bContext *C = KX_GetActiveEngine()->GetContext();
+  ViewLayer *view_layer = BKE_view_layer_default_view(bl_scene);
+  return BKE_scene_get_depsgraph(CTX_data_main(C), bl_scene, view_layer, false);
+}
 
-  // Without checking names, we get some reuse we don't want that can cause
-  // problems with material LoDs.
-  if (blenderobj && ((meshobj = converter->FindGameMesh(mesh /*, ob->lay*/)) != nullptr)) {
-    const std::string bge_name = meshobj->GetName();
-    const std::string blender_name = ((ID *)blenderobj->data)->name + 2;
-    if (bge_name == blender_name) {
-      return meshobj;
+static Mesh *get_evaluated_mesh(Scene *bl_scene, Object *blenderobj)
+{
+  Object *ob_eval = DEG_get_evaluated_object(get_depsgraph(bl_scene), blenderobj);
+  return (Mesh *)ob_eval->data;
+}
+
+/// Polygons of a material slot and the memory their conversion needs.
+struct ConvertedMaterialPolys {
+  RAS_MeshMaterial *meshmat;
+  std::vector<unsigned int> polys;
+  unsigned int numCorners;
+  unsigned int numIndices;
+};
+
+struct ConvertVerticesData {
+  std::vector<ConvertedMaterialPolys> *materials;
+  const RAS_MeshObject::LayersInfo *layersInfo;
+  const MVert *mverts;
+  const MPoly *mpolys;
+  const MLoop *mloops;
+  const float(*normals)[3];
+  const float(*tangent)[4];
+  unsigned short uvLayers;
+  unsigned short colorLayers;
+  /// Display array offset of the vertex of each loop.
+  unsigned int *loopOffsets;
+  /// Set for the first loop using a vertex, which is then added to the shared vertex map.
+  unsigned char *loopNewVertex;
+};
+
+/** Convert the loops of all the polygons of a material slot into vertices of its display
+ * array. Vertices of the same original vertex with close attributes are shared, they are found
+ * in a table hashed by original index and chained by display array offset. The vertices are
+ * constructed in place in the reserved display array, so no allocation happens per vertex.
+ */
+static void convert_material_vertices_task(void *__restrict userdata,
+                                           const int index,
+                                           const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  ConvertVerticesData *data = (ConvertVerticesData *)userdata;
+  ConvertedMaterialPolys &mat = (*data->materials)[index];
+  RAS_IDisplayArray *darray = mat.meshmat->GetDisplayArray();
+
+  darray->ReserveVertices(mat.numCorners);
+  darray->ReserveIndices(mat.numIndices);
+
+  // Original indices are dense, their low bits hash well.
+  const unsigned int tableSize = power_of_2_max_u(max_ii(mat.numCorners, 1));
+  std::vector<unsigned int> table(tableSize, -1);
+  std::vector<unsigned int> chain;
+  chain.reserve(mat.numCorners);
+
+  for (unsigned int i : mat.polys) {
+    const MPoly &mpoly = data->mpolys[i];
+
+    // Mark face as flat, so vertices are split.
+    const bool flat = (mpoly.flag & ME_SMOOTH) == 0;
+
+    const unsigned int lpstart = mpoly.loopstart;
+    const unsigned int totlp = mpoly.totloop;
+    for (unsigned int j = lpstart; j < lpstart + totlp; ++j) {
+      const unsigned int vertid = data->mloops[j].v;
+      const MVert &mvert = data->mverts[vertid];
+
+      const MT_Vector3 pt(mvert.co);
+      const MT_Vector3 no(data->normals[j]);
+      const MT_Vector4 tan = data->tangent ? MT_Vector4(data->tangent[j]) :
+                                             MT_Vector4(0.0f, 0.0f, 0.0f, 0.0f);
+      MT_Vector2 uvs[RAS_Texture::MaxUnits];
+      unsigned int rgba[RAS_Texture::MaxUnits];
+
+      GetUvRgba(data->layersInfo->layers, j, uvs, rgba, data->uvLayers, data->colorLayers);
+
+      const unsigned int offset = darray->AddVertex(pt, uvs, tan, rgba, no);
+      RAS_ITexVert *vertex = darray->GetVertexNoCache(offset);
+      unsigned int &head = table[vertid & (tableSize - 1)];
+
+      unsigned int shared = -1;
+      for (unsigned int other = head; other != (unsigned int)-1; other = chain[other]) {
+        if (darray->GetVertexInfo(other).getOrigIndex() == vertid &&
+            darray->GetVertexNoCache(other)->closeTo(vertex)) {
+          shared = other;
+          break;
+        }
+      }
+
+      if (shared != (unsigned int)-1) {
+        darray->RemoveLastVertex();
+        data->loopOffsets[j] = shared;
+        data->loopNewVertex[j] = false;
+      }
+      else {
+        darray->AddVertexInfo(RAS_TexVertInfo(vertid, flat));
+        chain.push_back(head);
+        head = offset;
+        data->loopOffsets[j] = offset;
+        data->loopNewVertex[j] = true;
+      }
+    }
+  }
+
+  darray->ShrinkVertices();
+}
+
+/// Flags of a converted material slot, used by the polygons of the slot.
+struct ConvertedMaterial {
+  Material *ma;
+  RAS_MeshMaterial *meshmat;
+  bool visible;
+  bool twoside;
+  bool collider;
+  bool wire;
+};
+
+/* Extract the uv and color layers of the loops. The active layers are the default layers of
+ * the vertices. */
+static RAS_MeshObject::LayersInfo get_layers_info(CustomData *ldata)
+{
+  const short activeUv = CustomData_get_active_layer(ldata, CD_MLOOPUV);
+  const short activeColor = CustomData_get_active_layer(ldata, CD_MLOOPCOL);
+
+  RAS_MeshObject::LayersInfo layersInfo;
+  layersInfo.activeUv = (activeUv == -1) ? 0 : activeUv;
+  layersInfo.activeColor = (activeColor == -1) ? 0 : activeColor;
+
+  const unsigned short uvLayers = CustomData_number_of_layers(ldata, CD_MLOOPUV);
+  const unsigned short colorLayers = CustomData_number_of_layers(ldata, CD_MLOOPCOL);
+
+  // Extract UV loops.
+  for (unsigned short i = 0; i < uvLayers; ++i) {
+    const std::string name = CustomData_get_layer_name(ldata, CD_MLOOPUV, i);
+    MLoopUV *uv = (MLoopUV *)CustomData_get_layer_n(ldata, CD_MLOOPUV, i);
+    layersInfo.layers.push_back({uv, nullptr, i, name});
+  }
+  // Extract color loops.
+  for (unsigned short i = 0; i < colorLayers; ++i) {
+    const std::string name = CustomData_get_layer_name(ldata, CD_MLOOPCOL, i);
+    MLoopCol *col = (MLoopCol *)CustomData_get_layer_n(ldata, CD_MLOOPCOL, i);
+    layersInfo.layers.push_back({nullptr, col, i, name});
+  }
+
+  return layersInfo;
+}
+
+/// Version of the format of the mesh cache files.
+static const int mesh_cache_version = 1;
+
+/// Display array content of a material slot, as stored in the mesh cache.
+struct MeshCacheMaterial {
+  /// Position, normal, tangent and uvs of each vertex.
+  std::vector<float> vertices;
+  std::vector<unsigned int> colors;
+  std::vector<unsigned int> origIndices;
+  std::vector<short> flags;
+  /// Indices of the lines of a wire material, the other materials get indices from polygons.
+  std::vector<unsigned int> lines;
+};
+
+/// Number of floats of a vertex in the mesh cache, see MeshCacheMaterial::vertices.
+static unsigned int mesh_cache_vertex_floats(const RAS_TexVertFormat &format)
+{
+  return 10 + format.uvSize * 2;
+}
+
+static void mesh_cache_key_layers(CM_DiskCacheKey &key, CustomData *data, int type, int count)
+{
+  const int num = CustomData_number_of_layers(data, type);
+  key.Add(num);
+  for (int i = 0; i < num; ++i) {
+    key.AddArray((const char *)CustomData_get_layer_n(data, type, i),
+                 (size_t)count * CustomData_sizeof(type));
+  }
+}
+
+/** Hash the evaluated mesh data and the material flags the display arrays and the polygons
+ * of a mesh object are converted from.
+ */
+static void mesh_cache_key(CM_DiskCacheKey &key,
+                           Mesh *final_me,
+                           const std::vector<ConvertedMaterial> &convertedMats)
+{
+  key.Add((uint64_t)convertedMats.size());
+  for (const ConvertedMaterial &mat : convertedMats) {
+    key.Add(mat.visible);
+    key.Add(mat.twoside);
+    key.Add(mat.collider);
+    key.Add(mat.wire);
+  }
+
+  key.Add((short)(final_me->flag & ME_AUTOSMOOTH));
+  key.Add(final_me->smoothresh);
+  key.AddArray(final_me->mvert, final_me->totvert);
+  key.AddArray(final_me->medge, final_me->totedge);
+  key.AddArray(final_me->mpoly, final_me->totpoly);
+  key.AddArray(final_me->mloop, final_me->totloop);
+
+  // The tangents are computed from the active and render uv layers.
+  key.Add(CustomData_get_active_layer(&final_me->ldata, CD_MLOOPUV));
+  key.Add(CustomData_get_render_layer(&final_me->ldata, CD_MLOOPUV));
+  for (int type : {CD_MLOOPUV, CD_MLOOPCOL, CD_NORMAL, CD_CUSTOMLOOPNORMAL, CD_TANGENT}) {
+    mesh_cache_key_layers(key, &final_me->ldata, type, final_me->totloop);
+  }
+}
+
+/// Save the display arrays, the polygons and the shared vertices of a converted mesh object.
+static void mesh_cache_save(RAS_MeshObject *meshobj,
+                            const CM_DiskCacheKey &key,
+                            const std::vector<ConvertedMaterial> &convertedMats)
+{
+  CM_DiskCacheBuffer buffer;
+  std::map<RAS_IDisplayArray *, unsigned short> matIndices;
+
+  for (unsigned short i = 0, totmat = convertedMats.size(); i < totmat; ++i) {
+    RAS_IDisplayArray *darray = convertedMats[i].meshmat->GetDisplayArray();
+    const RAS_TexVertFormat &format = darray->GetFormat();
+    const unsigned int numVertices = darray->GetVertexCount();
+    matIndices[darray] = i;
+
+    MeshCacheMaterial mat;
+    mat.vertices.reserve(numVertices * mesh_cache_vertex_floats(format));
+    for (unsigned int j = 0; j < numVertices; ++j) {
+      const RAS_ITexVert *vertex = darray->GetVertexNoCache(j);
+      mat.vertices.insert(mat.vertices.end(), vertex->getXYZ(), vertex->getXYZ() + 3);
+      mat.vertices.insert(mat.vertices.end(), vertex->getNormal(), vertex->getNormal() + 3);
+      mat.vertices.insert(mat.vertices.end(), vertex->getTangent(), vertex->getTangent() + 4);
+      for (unsigned short k = 0; k < format.uvSize; ++k) {
+        mat.vertices.insert(mat.vertices.end(), vertex->getUV(k), vertex->getUV(k) + 2);
+      }
+      for (unsigned short k = 0; k < format.colorSize; ++k) {
+        mat.colors.push_back(vertex->getRawRGBA(k));
+      }
+
+      const RAS_TexVertInfo &info = darray->GetVertexInfo(j);
+      mat.origIndices.push_back(info.getOrigIndex());
+      mat.flags.push_back(info.getFlag());
+    }
+
+    if (convertedMats[i].wire) {
+      for (unsigned int j = 0, num = darray->GetIndexCount(); j < num; ++j) {
+        mat.lines.push_back(darray->GetIndex(j));
+      }
+    }
+
+    buffer.WriteArray(mat.vertices);
+    buffer.WriteArray(mat.colors);
+    buffer.WriteArray(mat.origIndices);
+    buffer.WriteArray(mat.flags);
+    buffer.WriteArray(mat.lines);
+  }
+
+  std::vector<unsigned short> polyMaterials;
+  std::vector<unsigned char> polyNumVerts;
+  std::vector<unsigned int> polyOffsets;
+  for (int i = 0, num = meshobj->NumPolygons(); i < num; ++i) {
+    RAS_Polygon *poly = meshobj->GetPolygon(i);
+    polyMaterials.push_back(matIndices[poly->GetDisplayArray()]);
+    polyNumVerts.push_back(poly->VertexCount());
+    for (int j = 0; j < poly->VertexCount(); ++j) {
+      polyOffsets.push_back(poly->GetVertexOffset(j));
+    }
+  }
+  buffer.WriteArray(polyMaterials);
+  buffer.WriteArray(polyNumVerts);
+  buffer.WriteArray(polyOffsets);
+
+  std::vector<unsigned int> sharedCounts;
+  std::vector<unsigned short> sharedMaterials;
+  std::vector<unsigned int> sharedOffsets;
+  for (const std::vector<RAS_MeshObject::SharedVertex> &vertices : meshobj->m_sharedvertex_map) {
+    sharedCounts.push_back(vertices.size());
+    for (const RAS_MeshObject::SharedVertex &shared : vertices) {
+      sharedMaterials.push_back(matIndices[shared.m_darray]);
+      sharedOffsets.push_back(shared.m_offset);
+    }
+  }
+  buffer.WriteArray(sharedCounts);
+  buffer.WriteArray(sharedMaterials);
+  buffer.WriteArray(sharedOffsets);
+
+  buffer.Save("mesh", key, mesh_cache_version);
+}
+
+/** Load the display arrays, the polygons and the shared vertices of a mesh object from the
+ * cache. The cached data is fully checked before filling the mesh object, so that the mesh
+ * object is left untouched when the conversion has to be done.
+ */
+static bool mesh_cache_load(RAS_MeshObject *meshobj,
+                            const CM_DiskCacheKey &key,
+                            const std::vector<ConvertedMaterial> &convertedMats,
+                            unsigned int totverts)
+{
+  CM_DiskCacheBuffer buffer;
+  if (!buffer.Load("mesh", key, mesh_cache_version)) {
+    return false;
+  }
+
+  const unsigned short totmat = convertedMats.size();
+  std::vector<MeshCacheMaterial> materials(totmat);
+  for (unsigned short i = 0; i < totmat; ++i) {
+    MeshCacheMaterial &mat = materials[i];
+    if (!buffer.ReadArray(mat.vertices) || !buffer.ReadArray(mat.colors) ||
+        !buffer.ReadArray(mat.origIndices) || !buffer.ReadArray(mat.flags) ||
+        !buffer.ReadArray(mat.lines)) {
+      return false;
+    }
+
+    const RAS_TexVertFormat &format = convertedMats[i].meshmat->GetDisplayArray()->GetFormat();
+    const size_t numVertices = mat.origIndices.size();
+    if (mat.vertices.size() != numVertices * mesh_cache_vertex_floats(format) ||
+        mat.colors.size() != numVertices * format.colorSize || mat.flags.size() != numVertices ||
+        (mat.lines.size() % 2) != 0 || (!convertedMats[i].wire && !mat.lines.empty())) {
+      return false;
+    }
+    for (unsigned int index : mat.origIndices) {
+      if (index >= totverts) {
+        return false;
+      }
+    }
+    for (unsigned int index : mat.lines) {
+      if (index >= numVertices) {
+        return false;
+      }
+    }
+  }
+
+  std::vector<unsigned short> polyMaterials;
+  std::vector<unsigned char> polyNumVerts;
+  std::vector<unsigned int> polyOffsets;
+  std::vector<unsigned int> sharedCounts;
+  std::vector<unsigned short> sharedMaterials;
+  std::vector<unsigned int> sharedOffsets;
+  if (!buffer.ReadArray(polyMaterials) || !buffer.ReadArray(polyNumVerts) ||
+      !buffer.ReadArray(polyOffsets) || !buffer.ReadArray(sharedCounts) ||
+      !buffer.ReadArray(sharedMaterials) || !buffer.ReadArray(sharedOffsets) ||
+      !buffer.AtEnd() || polyNumVerts.size() != polyMaterials.size() ||
+      sharedCounts.size() != totverts || sharedOffsets.size() != sharedMaterials.size()) {
+    return false;
+  }
+
+  size_t offset = 0;
+  for (size_t i = 0; i < polyMaterials.size(); ++i) {
+    const unsigned short matid = polyMaterials[i];
+    const unsigned char numverts = polyNumVerts[i];
+    if (matid >= totmat || (numverts != 3 && numverts != 4) ||
+        offset + numverts > polyOffsets.size()) {
+      return false;
+    }
+    for (unsigned short j = 0; j < numverts; ++j) {
+      if (polyOffsets[offset + j] >= materials[matid].origIndices.size()) {
+        return false;
+      }
+    }
+    offset += numverts;
+  }
+  if (offset != polyOffsets.size()) {
+    return false;
+  }
+
+  size_t totshared = 0;
+  for (unsigned int count : sharedCounts) {
+    totshared += count;
+  }
+  if (totshared != sharedMaterials.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < totshared; ++i) {
+    if (sharedMaterials[i] >= totmat ||
+        sharedOffsets[i] >= materials[sharedMaterials[i]].origIndices.size()) {
+      return false;
+    }
+  }
+
+  for (unsigned short i = 0; i < totmat; ++i) {
+    const MeshCacheMaterial &mat = materials[i];
+    RAS_MeshMaterial *meshmat = convertedMats[i].meshmat;
+    RAS_IDisplayArray *darray = meshmat->GetDisplayArray();
+    const RAS_TexVertFormat &format = darray->GetFormat();
+    const unsigned int numVertices = mat.origIndices.size();
+    const unsigned int stride = mesh_cache_vertex_floats(format);
+
+    darray->ReserveVertices(numVertices);
+    for (unsigned int j = 0; j < numVertices; ++j) {
+      const float *data = &mat.vertices[j * stride];
+      MT_Vector2 uvs[RAS_Texture::MaxUnits];
+      for (unsigned short k = 0; k < format.uvSize; ++k) {
+        uvs[k].setValue(&data[10 + k * 2]);
+      }
+
+      darray->AddVertex(MT_Vector3(&data[0]),
+                        uvs,
+                        MT_Vector4(&data[6]),
+                        &mat.colors[j * format.colorSize],
+                        MT_Vector3(&data[3]));
+
+      RAS_TexVertInfo info(mat.origIndices[j], false);
+      info.SetFlag(mat.flags[j]);
+      darray->AddVertexInfo(info);
+    }
+
+    for (unsigned int j = 0; j < mat.lines.size(); j += 2) {
+      meshobj->AddLine(meshmat, mat.lines[j], mat.lines[j + 1]);
+    }
+  }
+
+  offset = 0;
+  for (size_t i = 0; i < polyMaterials.size(); ++i) {
+    const ConvertedMaterial &mat = convertedMats[polyMaterials[i]];
+    meshobj->AddPolygon(mat.meshmat,
+                        polyNumVerts[i],
+                        &polyOffsets[offset],
+                        mat.visible,
+                        mat.collider,
+                        mat.twoside);
+    offset += polyNumVerts[i];
+  }
+
+  meshobj->m_sharedvertex_map.resize(totverts);
+  size_t sharedIndex = 0;
+  for (unsigned int i = 0; i < totverts; ++i) {
+    for (unsigned int j = 0; j < sharedCounts[i]; ++j, ++sharedIndex) {
+      RAS_MeshObject::SharedVertex shared;
+      shared.m_darray = convertedMats[sharedMaterials[sharedIndex]].meshmat->GetDisplayArray();
+      shared.m_offset = sharedOffsets[sharedIndex];
+      meshobj->m_sharedvertex_map[i].push_back(shared);
+    }
+  }
+
+  return true;
+}
+
+/** Convert the vertices and polygons of final_me into the display arrays of the materials
+ * of meshobj.
+ * \param useCache Load the converted data from the disk cache if final_me is unchanged, else
+ * save it there.
+ */
+static void convert_mesh_geometry(RAS_MeshObject *meshobj,
+                                  Mesh *final_me,
+                                  const std::vector<ConvertedMaterial> &convertedMats,
+                                  bool useCache)
+{
+  CM_DiskCacheKey cacheKey;
+  if (useCache) {
+    mesh_cache_key(cacheKey, final_me, convertedMats);
+    if (mesh_cache_load(meshobj, cacheKey, convertedMats, final_me->totvert)) {
+      meshobj->EndConversion();
+      return;
     }
   }
 
   // Get DerivedMesh data
-  bContext *C = KX_GetActiveEngine()->GetContext();
-  Scene *bl_scene = scene->GetBlenderScene();
-  ViewLayer *view_layer = BKE_view_layer_default_view(bl_scene);
-  Depsgraph *depsgraph = BKE_scene_get_depsgraph(CTX_data_main(C), bl_scene, view_layer, false);
-  Object *ob_eval = DEG_get_evaluated_object(depsgraph, blenderobj);
-  Mesh *final_me = (Mesh *)ob_eval->data;
   DerivedMesh *dm = CDDM_from_mesh(final_me);
   DM_ensure_tessface(dm);
 
@@ -383,31 +822,11 @@ RAS_MeshObject *BL_ConvertMesh(Mesh *mesh,
   }
   const float(*normals)[3] = (float(*)[3])dm->getLoopDataArray(dm, CD_NORMAL);
 
-  /* Extract available layers.
-   * Get the active color and uv layer. */
-  const short activeUv = CustomData_get_active_layer(&dm->loopData, CD_MLOOPUV);
-  const short activeColor = CustomData_get_active_layer(&dm->loopData, CD_MLOOPCOL);
-
-  RAS_MeshObject::LayersInfo layersInfo;
-  layersInfo.activeUv = (activeUv == -1) ? 0 : activeUv;
-  layersInfo.activeColor = (activeColor == -1) ? 0 : activeColor;
-
+  // The layers of the mesh object can point to released data, use the ones of dm.
+  const RAS_MeshObject::LayersInfo layersInfo = get_layers_info(&dm->loopData);
   const unsigned short uvLayers = CustomData_number_of_layers(&dm->loopData, CD_MLOOPUV);
   const unsigned short colorLayers = CustomData_number_of_layers(&dm->loopData, CD_MLOOPCOL);
 
-  // Extract UV loops.
-  for (unsigned short i = 0; i < uvLayers; ++i) {
-    const std::string name = CustomData_get_layer_name(&dm->loopData, CD_MLOOPUV, i);
-    MLoopUV *uv = (MLoopUV *)CustomData_get_layer_n(&dm->loopData, CD_MLOOPUV, i);
-    layersInfo.layers.push_back({uv, nullptr, i, name});
-  }
-  // Extract color loops.
-  for (unsigned short i = 0; i < colorLayers; ++i) {
-    const std::string name = CustomData_get_layer_name(&dm->loopData, CD_MLOOPCOL, i);
-    MLoopCol *col = (MLoopCol *)CustomData_get_layer_n(&dm->loopData, CD_MLOOPCOL, i);
-    layersInfo.layers.push_back({nullptr, col, i, name});
-  }
-
   float(*tangent)[4] = nullptr;
   if (uvLayers > 0) {
     if (CustomData_get_layer_index(&dm->loopData, CD_TANGENT) == -1) {
@@ -416,51 +835,51 @@ RAS_MeshObject *BL_ConvertMesh(Mesh *mesh,
     tangent = (float(*)[4])dm->getLoopDataArray(dm, CD_TANGENT);
   }
 
-  meshobj = new RAS_MeshObject(mesh, blenderobj, layersInfo);
   meshobj->m_sharedvertex_map.resize(totverts);
 
-  // Initialize vertex format with used uv and color layers.
-  RAS_TexVertFormat vertformat;
-  vertformat.uvSize = max_ii(1, uvLayers);
-  vertformat.colorSize = max_ii(1, colorLayers);
+  const unsigned short totmat = convertedMats.size();
 
-  struct ConvertedMaterial {
-    Material *ma;
-    RAS_MeshMaterial *meshmat;
-    bool visible;
-    bool twoside;
-    bool collider;
-    bool wire;
-  };
-
-  const unsigned short totmat = max_ii(final_me->totcol, 1);
-  std::vector<ConvertedMaterial> convertedMats(totmat);
-
-  // Convert all the materials contained in the mesh.
+  /* Sort the polygons per material slot, the vertices of each slot are converted in parallel
+   * as they belong to different display arrays. */
+  std::vector<ConvertedMaterialPolys> materialPolys(totmat);
   for (unsigned short i = 0; i < totmat; ++i) {
-    Material *ma = nullptr;
-    if (blenderobj) {
-      ma = BKE_object_material_get(blenderobj, i + 1);
-    }
-    else {
-      ma = final_me->mat ? final_me->mat[i] : nullptr;
-    }
-    // Check for blender material
-    if (!ma) {
-      ma = BKE_material_default_empty();
-    }
-
-    RAS_MaterialBucket *bucket = material_from_mesh(ma, lightlayer, scene, rasty, converter, converting_during_runtime);
-    RAS_MeshMaterial *meshmat = meshobj->AddMaterial(bucket, i, vertformat);
+    materialPolys[i] = {convertedMats[i].meshmat, {}, 0, 0};
+  }
+  for (unsigned int i = 0; i < numpolys; ++i) {
+    const MPoly &mpoly = mpolys[i];
+    const ConvertedMaterial &mat = convertedMats[mpoly.mat_nr];
+    ConvertedMaterialPolys &matPolys = materialPolys[mpoly.mat_nr];
 
-    convertedMats[i] = {ma,
-                        meshmat,
-                        ((ma->game.flag & GEMAT_INVISIBLE) == 0),
-                        ((ma->game.flag & GEMAT_BACKCULL) == 0),
-                        ((ma->game.flag & GEMAT_NOPHYSICS) == 0),
-                        bucket->IsWire()};
+    matPolys.polys.push_back(i);
+    matPolys.numCorners += mpoly.totloop;
+    if (mat.visible) {
+      matPolys.numIndices += mat.wire ? mpoly.totloop * 2 : (mpoly.totloop - 2) * 3;
+    }
   }
 
+  const unsigned int totloops = dm->getNumLoops(dm);
+  std::vector<unsigned int> loopOffsets(totloops);
+  // Not a std::vector<bool>, its elements are written from several threads.
+  std::vector<unsigned char> loopNewVertex(totloops);
+
+  ConvertVerticesData data;
+  data.materials = &materialPolys;
+  data.layersInfo = &layersInfo;
+  data.mverts = mverts;
+  data.mpolys = mpolys;
+  data.mloops = mloops;
+  data.normals = normals;
+  data.tangent = tangent;
+  data.uvLayers = uvLayers;
+  data.colorLayers = colorLayers;
+  data.loopOffsets = loopOffsets.data();
+  data.loopNewVertex = loopNewVertex.data();
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.use_threading = (totmat > 1 && totloops > 10000);
+  BLI_task_parallel_range(0, totmat, &data, convert_material_vertices_task, &settings);
+
   std::vector<std::vector<unsigned int>> mpolyToMface(numpolys);
   // Generate a list of all mfaces wrapped by a mpoly.
   for (unsigned int i = 0; i < totfaces; ++i) {
@@ -475,27 +894,22 @@ RAS_MeshObject *BL_ConvertMesh(Mesh *mesh,
 
     const ConvertedMaterial &mat = convertedMats[mpoly.mat_nr];
     RAS_MeshMaterial *meshmat = mat.meshmat;
-
-    // Mark face as flat, so vertices are split.
-    const bool flat = (mpoly.flag & ME_SMOOTH) == 0;
+    RAS_IDisplayArray *darray = meshmat->GetDisplayArray();
 
     const unsigned int lpstart = mpoly.loopstart;
     const unsigned int totlp = mpoly.totloop;
     for (unsigned int j = lpstart; j < lpstart + totlp; ++j) {
-      const MLoop &mloop = mloops[j];
-      const unsigned int vertid = mloop.v;
-      const MVert &mvert = mverts[vertid];
-
-      const MT_Vector3 pt(mvert.co);
-      const MT_Vector3 no(normals[j]);
-      const MT_Vector4 tan = tangent ? MT_Vector4(tangent[j]) : MT_Vector4(0.0f, 0.0f, 0.0f, 0.0f);
-      MT_Vector2 uvs[RAS_Texture::MaxUnits];
-      unsigned int rgba[RAS_Texture::MaxUnits];
-
-      GetUvRgba(layersInfo.layers, j, uvs, rgba, uvLayers, colorLayers);
+      const unsigned int vertid = mloops[j].v;
 
       // Add tracked vertices by the mpoly.
-      vertices[vertid] = meshobj->AddVertex(meshmat, pt, uvs, tan, rgba, no, flat, vertid);
+      vertices[vertid] = loopOffsets[j];
+
+      if (loopNewVertex[j]) {
+        RAS_MeshObject::SharedVertex shared;
+        shared.m_darray = darray;
+        shared.m_offset = loopOffsets[j];
+        meshobj->m_sharedvertex_map[vertid].push_back(shared);
+      }
     }
 
     // Convert to edges of material is rendering wire.
@@ -528,6 +942,100 @@ RAS_MeshObject *BL_ConvertMesh(Mesh *mesh,
   // but this didnt save much ram. - Campbell
   meshobj->EndConversion();
 
+  if (useCache) {
+    mesh_cache_save(meshobj, cacheKey, convertedMats);
+  }
+
+  dm->release(dm);
+}
+
+/** Convert final_me into a new mesh object named after mesh.
+ * The returned mesh object is not registered in the converter.
+ */
+static RAS_MeshObject *convert_mesh_data(Mesh *mesh,
+                                         Mesh *final_me,
+                                         Object *blenderobj,
+                                         KX_Scene *scene,
+                                         RAS_Rasterizer *rasty,
+                                         BL_BlenderSceneConverter *converter,
+                                         bool libloading,
+                                         bool converting_during_runtime)
+{
+  RAS_MeshObject *meshobj;
+  int lightlayer = blenderobj ? blenderobj->lay : (1 << 20) - 1;  // all layers if no object.
+
+  const RAS_MeshObject::LayersInfo layersInfo = get_layers_info(&final_me->ldata);
+  const unsigned short uvLayers = CustomData_number_of_layers(&final_me->ldata, CD_MLOOPUV);
+  const unsigned short colorLayers = CustomData_number_of_layers(&final_me->ldata, CD_MLOOPCOL);
+
+  meshobj = new RAS_MeshObject(mesh, blenderobj, layersInfo);
+
+  // Initialize vertex format with used uv and color layers.
+  RAS_TexVertFormat vertformat;
+  vertformat.uvSize = max_ii(1, uvLayers);
+  vertformat.colorSize = max_ii(1, colorLayers);
+
+  const unsigned short totmat = max_ii(final_me->totcol, 1);
+  std::vector<ConvertedMaterial> convertedMats(totmat);
+  std::vector<bool> colliderMats(totmat);
+
+  // Convert all the materials contained in the mesh.
+  for (unsigned short i = 0; i < totmat; ++i) {
+    Material *ma = nullptr;
+    if (blenderobj) {
+      ma = BKE_object_material_get(blenderobj, i + 1);
+    }
+    else {
+      ma = final_me->mat ? final_me->mat[i] : nullptr;
+    }
+    // Check for blender material
+    if (!ma) {
+      ma = BKE_material_default_empty();
+    }
+
+    RAS_MaterialBucket *bucket = material_from_mesh(ma, lightlayer, scene, rasty, converter, converting_during_runtime);
+    RAS_MeshMaterial *meshmat = meshobj->AddMaterial(bucket, i, vertformat);
+
+    convertedMats[i] = {ma,
+                        meshmat,
+                        ((ma->game.flag & GEMAT_INVISIBLE) == 0),
+                        ((ma->game.flag & GEMAT_BACKCULL) == 0),
+                        ((ma->game.flag & GEMAT_NOPHYSICS) == 0),
+                        bucket->IsWire()};
+    colliderMats[i] = convertedMats[i].collider;
+  }
+
+  meshobj->SetColliderMaterials(colliderMats);
+
+  const bool useCache = (scene->GetBlenderScene()->gm.flag & GAME_USE_CONVERSION_CACHE) != 0;
+
+  /* The vertices and polygons are only used by the physics, the python mesh access and the ray
+   * casts, the rendering uses the blender data. Convert them on demand, from the evaluated mesh
+   * at that time or the generated mesh. Meshes converted while libloading or at runtime are
+   * converted immediately, their scene may not be the active one later. */
+  if (blenderobj && !libloading && !converting_during_runtime) {
+    bool hasColliderPolygon = false;
+    for (unsigned int i = 0; i < final_me->totpoly; ++i) {
+      const short mat_nr = final_me->mpoly[i].mat_nr;
+      if (mat_nr < totmat && convertedMats[mat_nr].collider) {
+        hasColliderPolygon = true;
+        break;
+      }
+    }
+
+    Scene *bl_scene = scene->GetBlenderScene();
+    meshobj->SetGeometryConverter(
+        [bl_scene, blenderobj, convertedMats, useCache](RAS_MeshObject *meshobj) {
+          Mesh *generated_me = meshobj->GetGeneratedMesh();
+          Mesh *final_me = generated_me ? generated_me : get_evaluated_mesh(bl_scene, blenderobj);
+          convert_mesh_geometry(meshobj, final_me, convertedMats, useCache);
+        },
+        hasColliderPolygon);
+  }
+  else {
+    convert_mesh_geometry(meshobj, final_me, convertedMats, useCache);
+  }
+
   // Finalize materials.
   // However, we want to delay this if we're libloading so we can make sure we have the right
   // scene.
@@ -538,12 +1046,99 @@ RAS_MeshObject *BL_ConvertMesh(Mesh *mesh,
     }
   }
 
-  dm->release(dm);
+  return meshobj;
+}
+
+RAS_MeshObject *BL_ConvertMesh(Mesh *mesh,
+                               Object *blenderobj,
+                               KX_Scene *scene,
+                               RAS_Rasterizer *rasty,
+                               BL_BlenderSceneConverter *converter,
+                               bool libloading,
+                               bool converting_during_runtime)
+{
+  RAS_MeshObject *meshobj;
+
+  // Without checking names, we get some reuse we don't want that can cause
+  // problems with material LoDs.
+  if (blenderobj && ((meshobj = converter->FindGameMesh(mesh /*, ob->lay*/)) != nullptr)) {
+    const std::string bge_name = meshobj->GetName();
+    const std::string blender_name = ((ID *)blenderobj->data)->name + 2;
+    if (bge_name == blender_name) {
+      return meshobj;
+    }
+  }
+
+  Mesh *final_me = get_evaluated_mesh(scene->GetBlenderScene(), blenderobj);
+  meshobj = convert_mesh_data(
+      mesh, final_me, blenderobj, scene, rasty, converter, libloading, converting_during_runtime);
 
   converter->RegisterGameMesh(meshobj, mesh);
   return meshobj;
 }
 
+/// Maximum number of faces decimated by a single task when generating levels of detail.
+#define LOD_GENERATE_REGION_FACES 8192
+
+static Mesh *lod_generate_decimate(Mesh *me_src, float ratio)
+{
+  BMeshCreateParams create_params = {0};
+  BMeshFromMeshParams convert_params = {0};
+  convert_params.calc_face_normal = true;
+
+  BMesh *bm = BKE_mesh_to_bmesh_ex(me_src, &create_params, &convert_params);
+  BM_mesh_decimate_collapse_regions(bm, ratio, false, LOD_GENERATE_REGION_FACES);
+
+  Mesh *result = BKE_mesh_from_bmesh_for_eval_nomain(bm, nullptr, me_src);
+  BM_mesh_free(bm);
+  BKE_mesh_calc_normals(result);
+
+  return result;
+}
+
+const std::vector<RAS_MeshObject *> &BL_ConvertGeneratedLods(Object *blenderobj,
+                                                              KX_Scene *scene,
+                                                              RAS_Rasterizer *rasty,
+                                                              BL_BlenderSceneConverter *converter,
+                                                              bool libloading,
+                                                              bool converting_during_runtime)
+{
+  Mesh *mesh = (Mesh *)blenderobj->data;
+  const unsigned short levels = blenderobj->lod_generate_levels;
+
+  // Levels are generated once per object, its replicas share them.
+  const std::vector<RAS_MeshObject *> &cached = converter->FindGeneratedLods(blenderobj, mesh);
+  if (cached.size() == (levels + 1)) {
+    return cached;
+  }
+
+  std::vector<RAS_MeshObject *> lods;
+  // Each level is decimated from the previous one, the first level is a copy of the evaluated
+  // mesh. Only the game mesh data uses it, the render switches back to the evaluated mesh.
+  Mesh *level_me = BKE_mesh_copy_for_eval(
+      get_evaluated_mesh(scene->GetBlenderScene(), blenderobj), false);
+  for (unsigned short level = 0; level <= levels; ++level) {
+    if (level > 0) {
+      level_me = lod_generate_decimate(level_me, blenderobj->lod_generate_ratio);
+    }
+
+    RAS_MeshObject *meshobj = convert_mesh_data(mesh,
+                                                level_me,
+                                                blenderobj,
+                                                scene,
+                                                rasty,
+                                                converter,
+                                                libloading,
+                                                converting_during_runtime);
+    meshobj->SetGeneratedMesh(level_me);
+    converter->RegisterGameMesh(meshobj, nullptr);
+    lods.push_back(meshobj);
+  }
+
+  converter->RegisterGeneratedLods(lods, blenderobj, mesh);
+  return converter->FindGeneratedLods(blenderobj, mesh);
+}
+
 static PHY_ShapeProps *CreateShapePropsFromBlenderObject(struct Object *blenderobject)
 {
   PHY_ShapeProps *shapeProps = new PHY_ShapeProps;
@@ -671,6 +1266,35 @@ static void BL_CreatePhysicsObjectNew(KX_GameObject *gameobj,
   }
 }
 
+static void BL_CreateGraphicObjectNew(KX_GameObject *gameobj,
+                                      const MT_Vector3 &localAabbMin,
+                                      const MT_Vector3 &localAabbMax,
+                                      KX_Scene *kxscene,
+                                      bool isActive,
+                                      e_PhysicsEngine physics_engine)
+{
+  switch (physics_engine) {
+#ifdef WITH_BULLET
+    case UseBullet: {
+      CcdPhysicsEnvironment *env = (CcdPhysicsEnvironment *)kxscene->GetPhysicsEnvironment();
+      BLI_assert(env);
+      PHY_IMotionState *motionstate = new KX_MotionState(gameobj->GetSGNode());
+      CcdGraphicController *ctrl = new CcdGraphicController(env, motionstate);
+      gameobj->SetGraphicController(ctrl);
+      ctrl->SetNewClientInfo(gameobj->getClientInfo());
+      ctrl->SetLocalAabb(localAabbMin, localAabbMax);
+      // add first, this will create the proxy handle, only if the object is visible
+      if (isActive && gameobj->GetVisible()) {
+        env->AddCcdGraphicController(ctrl);
+      }
+      break;
+    }
+#endif
+    default:
+      break;
+  }
+}
+
 static KX_LodManager *lodmanager_from_blenderobject(Object *ob,
                                                     KX_Scene *scene,
                                                     RAS_Rasterizer *rasty,
@@ -678,7 +1302,8 @@ static KX_LodManager *lodmanager_from_blenderobject(Object *ob,
                                                     bool libloading,
                                                     bool converting_during_runtime)
 {
-  if (BLI_listbase_count_at_most(&ob->lodlevels, 2) <= 1) {
+  if (BLI_listbase_count_at_most(&ob->lodlevels, 2) <= 1 &&
+      !(ob->gameflag2 & OB_LOD_GENERATE)) {
     return nullptr;
   }
 
@@ -1177,15 +1802,19 @@ void BL_ConvertBlenderObjects(struct Main *maggie,
     /* set activity culling parameters */
     kxscene->SetActivityCulling(false);
     kxscene->SetActivityCullingRadius(blenderscene->gm.activityBoxRadius);
-    kxscene->SetDbvtCulling(false);
+    kxscene->SetDbvtCulling((blenderscene->gm.flag & GAME_USE_DBVT_CULLING) != 0);
 
-    // no occlusion culling by default
+    // no occlusion culling by default, enabled when the scene contains occluders
     kxscene->SetDbvtOcclusionRes(0);
 
     if (blenderscene->gm.lodflag & SCE_LOD_USE_HYST) {
       kxscene->SetLodHysteresis(true);
       kxscene->SetLodHysteresisValue(blenderscene->gm.scehysteresis);
     }
+
+    kxscene->SetAnimationLod(blenderscene->gm.lodflag & SCE_LOD_ANIMATION);
+    kxscene->SetAnimationLodDistance(blenderscene->gm.anim_lod_distance);
+    kxscene->SetAnimationLodInterval(blenderscene->gm.anim_lod_interval);
   }
 
   int activeLayerBitInfo = blenderscene->lay;
@@ -1448,6 +2077,48 @@ void BL_ConvertBlenderObjects(struct Main *maggie,
         gameobj, blenderobject, meshobj, kxscene, layerMask, converter, processCompoundChildren);
   }
 
+  // create graphic controllers for culling
+  if (kxscene->GetDbvtCulling()) {
+    bool occlusion = false;
+    for (KX_GameObject *gameobj : sumolist) {
+      struct Object *blenderobject = gameobj->GetBlenderObject();
+      if (single_object) {
+        if (blenderobject != single_object) {
+          continue;
+        }
+      }
+      if (gameobj->GetMeshCount() == 0) {
+        continue;
+      }
+      /* The bounds are only computed here, an armature or another deform modifier would move
+       * the vertices outside of them. */
+      if (BKE_object_is_deform_modified(blenderscene, blenderobject) & eModifierMode_Realtime) {
+        continue;
+      }
+
+      // Bounds of the evaluated mesh, including the modifiers.
+      Depsgraph *depsgraph = get_depsgraph(blenderscene);
+      const BoundBox *bb = BKE_object_boundbox_get(
+          depsgraph ? DEG_get_evaluated_object(depsgraph, blenderobject) : blenderobject);
+      if (!bb) {
+        continue;
+      }
+
+      const MT_Vector3 min(bb->vec[0]);
+      const MT_Vector3 max(bb->vec[6]);
+      gameobj->GetCullingNode().GetAabb().Set(min, max);
+
+      const bool isActive = objectlist->SearchValue(gameobj);
+      BL_CreateGraphicObjectNew(gameobj, min, max, kxscene, isActive, physics_engine);
+      if (gameobj->GetOccluder()) {
+        occlusion = true;
+      }
+    }
+    if (occlusion) {
+      kxscene->SetDbvtOcclusionRes(blenderscene->gm.occlusionRes);
+    }
+  }
+
   // create physics joints
   for (KX_GameObject *gameobj : sumolist) {
     PHY_IPhysicsEnvironment *physEnv = kxscene->GetPhysicsEnvironment();
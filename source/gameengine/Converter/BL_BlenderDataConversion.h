@@ -33,6 +33,7 @@
 #define __BL_BLENDERDATACONVERSION_H__
 
 #include <string>
+#include <vector>
 
 #include "EXP_Python.h"
 #include "KX_PhysicsEngineEnums.h"
@@ -46,6 +47,17 @@ class RAS_MeshObject *BL_ConvertMesh(struct Mesh *mesh,
                                      bool libloading,
                                      bool converting_during_runtime);
 
+/** Convert the levels of detail generated by decimating the evaluated mesh of blenderobj
+ * following its lod_generate settings, the first level is the undecimated mesh.
+ */
+const std::vector<class RAS_MeshObject *> &BL_ConvertGeneratedLods(
+    struct Object *blenderobj,
+    class KX_Scene *scene,
+    class RAS_Rasterizer *rasty,
+    class BL_BlenderSceneConverter *converter,
+    bool libloading,
+    bool converting_during_runtime);
+
 void BL_ConvertBlenderObjects(struct Main *maggie,
                               struct Depsgraph *depsgraph,
                               class KX_Scene *kxscene,
@@ -74,6 +74,19 @@ RAS_MeshObject *BL_BlenderSceneConverter::FindGameMesh(Mesh *for_blendermesh)
   return m_map_mesh_to_gamemesh[for_blendermesh];
 }
 
+void BL_BlenderSceneConverter::RegisterGeneratedLods(const std::vector<RAS_MeshObject *> &lods,
+                                                     Object *for_blenderobj,
+                                                     Mesh *for_blendermesh)
+{
+  m_map_mesh_to_generated_lods[std::make_pair(for_blenderobj, for_blendermesh)] = lods;
+}
+
+const std::vector<RAS_MeshObject *> &BL_BlenderSceneConverter::FindGeneratedLods(
+    Object *for_blenderobj, Mesh *for_blendermesh)
+{
+  return m_map_mesh_to_generated_lods[std::make_pair(for_blenderobj, for_blendermesh)];
+}
+
 void BL_BlenderSceneConverter::RegisterMaterial(KX_BlenderMaterial *blmat, Material *mat)
 {
   if (mat) {
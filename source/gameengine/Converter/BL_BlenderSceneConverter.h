@@ -33,6 +33,7 @@
 #define __BL_BLENDERSCENECONVERTER_H__
 
 #include <map>
+#include <utility>
 #include <vector>
 
 #include "CM_Message.h"
@@ -63,6 +64,8 @@ class BL_BlenderSceneConverter {
 
   std::map<Object *, KX_GameObject *> m_map_blender_to_gameobject;
   std::map<Mesh *, RAS_MeshObject *> m_map_mesh_to_gamemesh;
+  std::map<std::pair<Object *, Mesh *>, std::vector<RAS_MeshObject *>>
+      m_map_mesh_to_generated_lods;
   std::map<Material *, KX_BlenderMaterial *> m_map_mesh_to_polyaterial;
   std::map<bActuator *, SCA_IActuator *> m_map_blender_to_gameactuator;
   std::map<bController *, SCA_IController *> m_map_blender_to_gamecontroller;
@@ -81,6 +84,16 @@ class BL_BlenderSceneConverter {
   void RegisterGameMesh(RAS_MeshObject *gamemesh, Mesh *for_blendermesh);
   RAS_MeshObject *FindGameMesh(Mesh *for_blendermesh);
 
+  /** Register levels of detail generated from the mesh of an object, the meshes must be
+   * registered too. The levels depend on the object modifiers, so they are not shared between
+   * objects using the same mesh.
+   */
+  void RegisterGeneratedLods(const std::vector<RAS_MeshObject *> &lods,
+                             Object *for_blenderobj,
+                             Mesh *for_blendermesh);
+  const std::vector<RAS_MeshObject *> &FindGeneratedLods(Object *for_blenderobj,
+                                                         Mesh *for_blendermesh);
+
   void RegisterMaterial(KX_BlenderMaterial *blmat, Material *mat);
   KX_BlenderMaterial *FindMaterial(Material *mat);
 
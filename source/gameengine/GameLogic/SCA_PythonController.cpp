@@ -37,6 +37,7 @@
 #ifdef WITH_PYTHON
 #  include "compile.h"
 #  include "eval.h"
+#  include "bpy_internal_import.h"
 #  include "py_capi_utils.h"
 #endif  // WITH_PYTHON
 
@@ -80,6 +81,13 @@ SCA_PythonController::~SCA_PythonController()
 
 CValue *SCA_PythonController::GetReplica()
 {
+#ifdef WITH_PYTHON
+  // Compile the script once, the replicas share the bytecode.
+  if (m_mode == SCA_PYEXEC_SCRIPT && m_bModified) {
+    Compile();
+  }
+#endif
+
   SCA_PythonController *replica = new SCA_PythonController(*this);
 
 #ifdef WITH_PYTHON
@@ -257,8 +265,10 @@ bool SCA_PythonController::Compile()
     m_bytecode = nullptr;
   }
 
-  // recompile the scripttext into bytecode
-  m_bytecode = Py_CompileString(m_scriptText.c_str(), m_scriptName.c_str(), Py_file_input);
+  // recompile the scripttext into bytecode, or load it from the bytecode cache
+  PyObject *filename = PyC_UnicodeFromByte(m_scriptName.c_str());
+  m_bytecode = bpy_compile_string_cached(m_scriptText.c_str(), filename);
+  Py_DECREF(filename);
 
   if (m_bytecode) {
     return true;
@@ -72,6 +72,7 @@ BL_Action::~BL_Action()
   if (m_blendinpose)
     BKE_pose_free(m_blendinpose);
   ClearControllerList();
+  ClearBindings();
 
   Object *ob = m_obj->GetBlenderObject();
   if (ob && ob->adt && m_action) {
@@ -91,6 +92,25 @@ void BL_Action::ClearControllerList()
   m_sg_contr_list.clear();
 }
 
+void BL_Action::ClearBindings()
+{
+  for (const auto &pair : m_bindings) {
+    BKE_animsys_action_binding_free(pair.second);
+  }
+
+  m_bindings.clear();
+}
+
+void BL_Action::EvaluateAction(ID *id)
+{
+  PointerRNA ptrrna;
+  RNA_id_pointer_create(id, &ptrrna);
+
+  AnimsysActionBinding *&binding = m_bindings[id];
+  BKE_animsys_action_binding_ensure(&binding, &ptrrna, m_action);
+  BKE_animsys_action_binding_evaluate(binding, m_localframe);
+}
+
 bool BL_Action::Play(const std::string &name,
                      float start,
                      float end,
@@ -132,6 +152,9 @@ bool BL_Action::Play(const std::string &name,
 
   // First get rid of any old controllers
   ClearControllerList();
+  if (m_action != prev_action) {
+    ClearBindings();
+  }
 
   // Create an SG_Controller
   SG_Controller *sg_contr = BL_CreateIPO(m_action, m_obj, kxscene);
@@ -374,7 +397,7 @@ void BL_Action::Update(float curtime, bool applyToObject)
       obj->GetPose(&m_blendpose);
 
     // Extract the pose from the action
-    obj->SetPoseByAction(m_action, m_localframe);
+    EvaluateAction(&obj->GetArmatureObject()->id);
 
     // Handle blending between armature actions
     if (m_blendin && m_blendframe < m_blendin) {
@@ -407,9 +430,7 @@ void BL_Action::Update(float curtime, bool applyToObject)
       if (!BKE_modifier_is_non_geometrical(md) && ob->adt &&
           ob->adt->action->id.name == m_action->id.name) {
         DEG_id_tag_update(&ob->id, ID_RECALC_GEOMETRY);
-        PointerRNA ptrrna;
-        RNA_id_pointer_create(&ob->id, &ptrrna);
-        animsys_evaluate_action(&ptrrna, m_action, m_localframe, false);
+        EvaluateAction(&ob->id);
         scene->ResetTaaSamples();
         break;
       }
@@ -422,9 +443,7 @@ void BL_Action::Update(float curtime, bool applyToObject)
       if (con) {
         if (ob->adt && ob->adt->action->id.name == m_action->id.name) {
           DEG_id_tag_update(&ob->id, ID_RECALC_TRANSFORM);
-          PointerRNA ptrrna;
-          RNA_id_pointer_create(&ob->id, &ptrrna);
-          animsys_evaluate_action(&ptrrna, m_action, m_localframe, false);
+          EvaluateAction(&ob->id);
 
           scene->ResetTaaSamples();
           break;
@@ -442,9 +461,7 @@ void BL_Action::Update(float curtime, bool applyToObject)
           bNodeTree *node_tree = ma->nodetree;
           if (node_tree->adt && node_tree->adt->action->id.name == m_action->id.name) {
             DEG_id_tag_update(&ma->id, ID_RECALC_SHADING);
-            PointerRNA ptrrna;
-            RNA_id_pointer_create(&node_tree->id, &ptrrna);
-            animsys_evaluate_action(&ptrrna, m_action, m_localframe, false);
+            EvaluateAction(&node_tree->id);
             scene->ResetTaaSamples();
             break;
           }
@@ -459,9 +476,7 @@ void BL_Action::Update(float curtime, bool applyToObject)
         DEG_id_tag_update(&me->id, ID_RECALC_GEOMETRY);
         Key *key = me->key;
 
-        PointerRNA ptrrna;
-        RNA_id_pointer_create(&key->id, &ptrrna);
-        animsys_evaluate_action(&ptrrna, m_action, m_localframe, false);
+        EvaluateAction(&key->id);
 
         // Handle blending between shape actions
         if (m_blendin && m_blendframe < m_blendin) {
@@ -496,9 +511,7 @@ void BL_Action::Update(float curtime, bool applyToObject)
       bNodeTree *node_tree = world->nodetree;
       if (node_tree->adt && node_tree->adt->action->id.name == m_action->id.name) {
         DEG_id_tag_update(&world->id, ID_RECALC_SHADING);
-        PointerRNA ptrrna;
-        RNA_id_pointer_create(&node_tree->id, &ptrrna);
-        animsys_evaluate_action(&ptrrna, m_action, m_localframe, false);
+        EvaluateAction(&node_tree->id);
         scene->ResetTaaSamples();
       }
     }
@@ -27,12 +27,18 @@
 #ifndef __BL_ACTION_H__
 #define __BL_ACTION_H__
 
+#include <map>
 #include <string>
 #include <vector>
 
+struct AnimsysActionBinding;
+struct ID;
+
 class BL_Action {
  private:
   struct bAction *m_action;
+  /// Action F-Curves resolved per animated ID, reused while the action plays.
+  std::map<ID *, AnimsysActionBinding *> m_bindings;
   struct bPose *m_blendpose;
   struct bPose *m_blendinpose;
   std::vector<class SG_Controller *> m_sg_contr_list;
@@ -76,6 +82,9 @@ class BL_Action {
   float m_prevUpdate;
 
   void ClearControllerList();
+  void ClearBindings();
+  /// Evaluate the action at the current frame on the data-block using cached channel bindings.
+  void EvaluateAction(ID *id);
   void InitIPO();
   void SetLocalTime(float curtime);
   void ResetStartTime(float curtime);
@@ -0,0 +1,271 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file gameengine/Ketsji/KX_FontGlyphCache.cpp
+ *  \ingroup ketsji
+ */
+
+#include "KX_FontGlyphCache.h"
+
+#include <cwctype>
+#include <tuple>
+#include <vector>
+
+#include "BKE_curve.h"
+#include "BKE_displist.h"
+#include "BKE_font.h"
+#include "BKE_object.h"
+#include "BLI_listbase.h"
+#include "BLI_math_vector.h"
+#include "DNA_curve_types.h"
+#include "DNA_object_types.h"
+#include "DNA_vfont_types.h"
+#include "MEM_guardedalloc.h"
+
+/// Layout of the characters of a text object, see BKE_vfont_to_curve_ex.
+struct TextLayout {
+  const char32_t *text = nullptr;
+  int len = 0;
+  bool textFree = false;
+  CharTrans *chartransdata = nullptr;
+
+  TextLayout(Object *ob, Curve *cu)
+  {
+    if (!BKE_vfont_to_curve_ex(
+            ob, cu, FO_DUPLI, nullptr, &text, &len, &textFree, &chartransdata)) {
+      len = 0;
+    }
+  }
+
+  ~TextLayout()
+  {
+    if (textFree) {
+      MEM_freeN((void *)text);
+    }
+    if (chartransdata) {
+      MEM_freeN(chartransdata);
+    }
+  }
+
+  bool IsValid() const
+  {
+    return text && chartransdata;
+  }
+};
+
+// Same as which_vfont in font.c.
+static VFont *glyph_vfont(const Curve *cu, const CharInfo *info)
+{
+  switch (info->flag & (CU_CHINFO_BOLD | CU_CHINFO_ITALIC)) {
+    case CU_CHINFO_BOLD:
+      return cu->vfontb ? cu->vfontb : cu->vfont;
+    case CU_CHINFO_ITALIC:
+      return cu->vfonti ? cu->vfonti : cu->vfont;
+    case (CU_CHINFO_BOLD | CU_CHINFO_ITALIC):
+      return cu->vfontbi ? cu->vfontbi : cu->vfont;
+    default:
+      return cu->vfont;
+  }
+}
+
+/// Copy a display list element, moving its vertices by offset.
+static DispList *displist_copy_offset(const DispList *dl, const float offset[2], int charidx)
+{
+  DispList *dlnew = (DispList *)MEM_dupallocN(dl);
+  dlnew->next = dlnew->prev = nullptr;
+  dlnew->verts = (float *)MEM_dupallocN(dl->verts);
+  dlnew->nors = dl->nors ? (float *)MEM_dupallocN(dl->nors) : nullptr;
+  dlnew->index = dl->index ? (int *)MEM_dupallocN(dl->index) : nullptr;
+  dlnew->bevel_split = nullptr;
+  dlnew->charidx = charidx;
+
+  const int totvert = (dl->type == DL_INDEX3) ? dl->nr : dl->nr * dl->parts;
+  for (int i = 0; i < totvert; ++i) {
+    add_v2_v2(&dlnew->verts[i * 3], offset);
+  }
+
+  return dlnew;
+}
+
+bool KX_FontGlyphCache::GlyphKey::operator<(const GlyphKey &other) const
+{
+  return std::tie(vfont, character, size, shear, scale, resolu, col, fill) <
+         std::tie(other.vfont,
+                  other.character,
+                  other.size,
+                  other.shear,
+                  other.scale,
+                  other.resolu,
+                  other.col,
+                  other.fill);
+}
+
+KX_FontGlyphCache::~KX_FontGlyphCache()
+{
+  for (auto &item : m_glyphs) {
+    BKE_displist_free(&item.second);
+  }
+}
+
+KX_FontGlyphCache::GlyphKey KX_FontGlyphCache::GetKey(Object *ob,
+                                                      Curve *cu,
+                                                      const CharInfo *info,
+                                                      unsigned int character)
+{
+  // Match the glyph construction of vfont_to_curve and buildchar.
+  const bool smallcaps = (info->flag & CU_CHINFO_SMALLCAPS_CHECK);
+
+  GlyphKey key;
+  key.vfont = glyph_vfont(cu, info);
+  key.character = smallcaps ? towupper(character) : character;
+  key.size = cu->fsize_realtime;
+  key.shear = cu->shear;
+  key.scale = smallcaps ? cu->smallcaps_scale : 1.0f;
+  key.resolu = cu->resolu;
+  key.col = (info->mat_nr > 0 && info->mat_nr <= ob->totcol) ? info->mat_nr - 1 : 0;
+  key.fill = CU_DO_2DFILL(cu);
+
+  return key;
+}
+
+bool KX_FontGlyphCache::IsSupported(Object *ob_eval)
+{
+  const Curve *cu = (Curve *)ob_eval->data;
+  return (ob_eval->type == OB_FONT && ob_eval->runtime.curve_cache &&
+          BLI_listbase_is_empty(&ob_eval->modifiers) && !cu->editfont && cu->tb &&
+          !cu->textoncurve && !cu->bevobj && cu->ext1 == 0.0f && cu->ext2 == 0.0f &&
+          cu->width == 1.0f);
+}
+
+void KX_FontGlyphCache::AddGlyphs(Object *ob_eval)
+{
+  if (!IsSupported(ob_eval)) {
+    return;
+  }
+
+  Curve *cu = (Curve *)ob_eval->data;
+  const TextLayout layout(ob_eval, cu);
+  if (!layout.IsValid()) {
+    return;
+  }
+
+  const float z_up[3] = {0.0f, 0.0f, -1.0f};
+  const ListBase *dispbase = &ob_eval->runtime.curve_cache->disp;
+
+  for (int i = 0; i < layout.len; ++i) {
+    const CharInfo *info = &cu->strinfo[i];
+    if ((cu->overflow == CU_OVERFLOW_TRUNCATE) && (info->flag & CU_CHINFO_OVERFLOW)) {
+      break;
+    }
+    // The underline outline is part of the character it starts from.
+    if (layout.text[i] == '\n' || (info->flag & CU_CHINFO_UNDERLINE)) {
+      continue;
+    }
+
+    const GlyphKey key = GetKey(ob_eval, cu, info, layout.text[i]);
+    if (m_glyphs.find(key) != m_glyphs.end()) {
+      continue;
+    }
+
+    const CharTrans &ct = layout.chartransdata[i];
+    const float offset[2] = {-ct.xof * key.size, -ct.yof * key.size};
+
+    ListBase glyph = {nullptr, nullptr};
+    LISTBASE_FOREACH (const DispList *, dl, dispbase) {
+      if (dl->type == DL_POLY && dl->charidx == i) {
+        BLI_addtail(&glyph, displist_copy_offset(dl, offset, 0));
+      }
+    }
+
+    // Triangulate the outlines the same way as curve_to_filledpoly.
+    if (key.fill) {
+      BKE_displist_fill(&glyph, &glyph, z_up, false);
+    }
+
+    m_glyphs[key] = glyph;
+  }
+}
+
+bool KX_FontGlyphCache::BuildText(Object *ob_eval, Curve *cu)
+{
+  if (!IsSupported(ob_eval)) {
+    return false;
+  }
+
+  const TextLayout layout(ob_eval, cu);
+  if (!layout.IsValid()) {
+    return false;
+  }
+
+  std::vector<const ListBase *> glyphs(layout.len, nullptr);
+  for (int i = 0; i < layout.len; ++i) {
+    const CharInfo *info = &cu->strinfo[i];
+    if ((cu->overflow == CU_OVERFLOW_TRUNCATE) && (info->flag & CU_CHINFO_OVERFLOW)) {
+      break;
+    }
+    if (layout.text[i] == '\n') {
+      continue;
+    }
+    if (info->flag & CU_CHINFO_UNDERLINE) {
+      return false;
+    }
+
+    const auto it = m_glyphs.find(GetKey(ob_eval, cu, info, layout.text[i]));
+    if (it == m_glyphs.end()) {
+      return false;
+    }
+    glyphs[i] = &it->second;
+  }
+
+  ListBase dispbase = {nullptr, nullptr};
+  const float size = cu->fsize_realtime;
+  for (int i = 0; i < layout.len; ++i) {
+    if (!glyphs[i]) {
+      continue;
+    }
+
+    const CharTrans &ct = layout.chartransdata[i];
+    const float offset[2] = {ct.xof * size, ct.yof * size};
+    LISTBASE_FOREACH (const DispList *, dl, glyphs[i]) {
+      BLI_addtail(&dispbase, displist_copy_offset(dl, offset, i));
+    }
+  }
+
+  CurveCache *cache = ob_eval->runtime.curve_cache;
+  BKE_displist_free(&cache->disp);
+  cache->disp = dispbase;
+  // The bevel lists and nurbs describe the previous text, they are rebuilt by the next evaluation.
+  BKE_curve_bevelList_free(&cache->bev);
+  BKE_nurbList_free(&cache->deformed_nurbs);
+
+  // Same as boundbox_displist_object.
+  if (!ob_eval->runtime.bb) {
+    ob_eval->runtime.bb = (BoundBox *)MEM_callocN(sizeof(BoundBox), "boundbox");
+  }
+  float min[3], max[3];
+  INIT_MINMAX(min, max);
+  BKE_displist_minmax(&cache->disp, min, max);
+  BKE_boundbox_init_from_minmax(ob_eval->runtime.bb, min, max);
+  ob_eval->runtime.bb->flag &= ~BOUNDBOX_DIRTY;
+
+  BKE_curve_batch_cache_dirty_tag((Curve *)ob_eval->data, BKE_CURVE_BATCH_DIRTY_ALL);
+
+  return true;
+}
@@ -0,0 +1,81 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file KX_FontGlyphCache.h
+ *  \ingroup ketsji
+ */
+
+#ifndef __KX_FONT_GLYPH_CACHE_H__
+#define __KX_FONT_GLYPH_CACHE_H__
+
+#include <map>
+
+#include "DNA_listBase.h"
+
+struct CharInfo;
+struct Curve;
+struct Object;
+struct VFont;
+
+/** Cache of the triangulated glyphs of the text objects of a scene.
+ *
+ * The glyphs are extracted from the display list of evaluated text objects. A text using only
+ * cached glyphs is then assembled by copying the glyphs at their layout offsets into the display
+ * list of the evaluated object, without evaluating the curve or copying the object data.
+ * Only flat texts are supported, the geometry of extruded, beveled or deformed texts depends on
+ * the whole string.
+ */
+class KX_FontGlyphCache {
+ private:
+  struct GlyphKey {
+    VFont *vfont;
+    unsigned int character;
+    float size;
+    float shear;
+    float scale;
+    short resolu;
+    short col;
+    bool fill;
+
+    bool operator<(const GlyphKey &other) const;
+  };
+
+  /// Display lists of the glyphs, at the origin of the character.
+  std::map<GlyphKey, ListBase> m_glyphs;
+
+  static GlyphKey GetKey(Object *ob, Curve *cu, const CharInfo *info, unsigned int character);
+
+ public:
+  KX_FontGlyphCache() = default;
+  ~KX_FontGlyphCache();
+
+  /// Return true if the text of the evaluated object can be assembled from glyphs.
+  static bool IsSupported(Object *ob_eval);
+
+  /// Add the glyphs of the evaluated text object missing in the cache.
+  void AddGlyphs(Object *ob_eval);
+  /** Replace the display list of the evaluated text object by the cached glyphs of a text.
+   * \param cu The curve holding the text, a copy of the evaluated curve with another string.
+   * \return False if a glyph is missing, the object is then unchanged.
+   */
+  bool BuildText(Object *ob_eval, Curve *cu);
+};
+
+#endif  // __KX_FONT_GLYPH_CACHE_H__
@@ -31,14 +31,18 @@
 
 #include "KX_FontObject.h"
 
+#include "BKE_context.h"
 #include "BLI_blenlib.h"
 #include "DNA_curve_types.h"
 #include "MEM_guardedalloc.h"
 #include "depsgraph/DEG_depsgraph.h"
+#include "depsgraph/DEG_depsgraph_query.h"
 
 #include "EXP_StringValue.h"
-
-#define MAX_BGE_TEXT_LEN 1024  // eevee
+#include "KX_FontGlyphCache.h"
+#include "KX_Globals.h"
+#include "KX_KetsjiEngine.h"
+#include "KX_Scene.h"
 
 static std::vector<std::string> split_string(std::string str)
 {
@@ -59,11 +63,44 @@ static std::vector<std::string> split_string(std::string str)
   return text;
 }
 
+/// Copy text into the string of the curve, reusing its buffers when they are large enough.
+static void set_curve_text(Curve *cu, const std::string &text)
+{
+  const size_t strSize = text.size() + sizeof(wchar_t);
+  const size_t infoSize = (text.size() + 4) * sizeof(CharInfo);
+
+  if (!cu->str || MEM_allocN_len(cu->str) < strSize) {
+    MEM_SAFE_FREE(cu->str);
+    cu->str = (char *)MEM_mallocN(strSize, "str");
+  }
+  if (!cu->strinfo || MEM_allocN_len(cu->strinfo) < infoSize) {
+    MEM_SAFE_FREE(cu->strinfo);
+    cu->strinfo = (CharInfo *)MEM_callocN(infoSize, "texteditinfo");
+  }
+  else {
+    memset(cu->strinfo, 0, infoSize);
+  }
+
+  cu->len = text.size();
+  cu->len_wchar = BLI_strlen_utf8(text.c_str());
+  memcpy(cu->str, text.c_str(), text.size() + 1);
+}
+
+static Object *get_evaluated_object(Object *ob)
+{
+  bContext *C = KX_GetActiveEngine()->GetContext();
+  Depsgraph *depsgraph = CTX_data_depsgraph_on_load(C);
+  return DEG_get_evaluated_object(depsgraph, ob);
+}
+
 KX_FontObject::KX_FontObject(void *sgReplicationInfo,
                              SG_Callbacks callbacks,
                              RAS_Rasterizer *rasterizer,
                              Object *ob)
-    : KX_GameObject(sgReplicationInfo, callbacks), m_object(ob), m_rasterizer(rasterizer)
+    : KX_GameObject(sgReplicationInfo, callbacks),
+      m_object(ob),
+      m_addGlyphs(true),
+      m_rasterizer(rasterizer)
 {
   Curve *text = static_cast<Curve *>(ob->data);
 
@@ -101,30 +138,76 @@ void KX_FontObject::UpdateCurveText(std::string newText)  // eevee
 {
   Object *ob = GetBlenderObject();
   Curve *cu = (Curve *)ob->data;
-  if (cu->str)
-    MEM_freeN(cu->str);
-  if (cu->strinfo)
-    MEM_freeN(cu->strinfo);
-
-  cu->len_wchar = strlen(newText.c_str());
-  cu->len = BLI_strlen_utf8(newText.c_str());
-  cu->strinfo = (CharInfo *)MEM_callocN((cu->len_wchar + 4) * sizeof(CharInfo), "texteditinfo");
-  cu->str = (char *)MEM_mallocN(cu->len + sizeof(wchar_t), "str");
-  BLI_strncpy(cu->str, newText.c_str(), MAX_BGE_TEXT_LEN);
+  set_curve_text(cu, newText);
 
   DEG_id_tag_update(&ob->id, ID_RECALC_GEOMETRY);
   DEG_id_tag_update(&ob->id, ID_RECALC_COPY_ON_WRITE);
 
+  // Cache the glyphs of the new text once it is evaluated.
+  m_addGlyphs = true;
+
   GetScene()->ResetTaaSamples();
 }
 
+bool KX_FontObject::UpdateCurveTextFromGlyphs(const std::string &newText)
+{
+  Object *ob = GetBlenderObject();
+  Object *ob_eval = get_evaluated_object(ob);
+  if (ob_eval == ob || !KX_FontGlyphCache::IsSupported(ob_eval)) {
+    return false;
+  }
+
+  Curve *cu_eval = (Curve *)ob_eval->data;
+
+  /* Lay out the text in a copy of the evaluated curve, so that the evaluated curve always
+   * matches its display list. */
+  Curve cu_text = *cu_eval;
+  cu_text.str = nullptr;
+  cu_text.strinfo = nullptr;
+  set_curve_text(&cu_text, newText);
+
+  if (!GetScene()->GetFontGlyphCache()->BuildText(ob_eval, &cu_text)) {
+    MEM_freeN(cu_text.str);
+    MEM_freeN(cu_text.strinfo);
+    return false;
+  }
+
+  std::swap(cu_eval->str, cu_text.str);
+  std::swap(cu_eval->strinfo, cu_text.strinfo);
+  cu_eval->len = cu_text.len;
+  cu_eval->len_wchar = cu_text.len_wchar;
+  cu_eval->lines = cu_text.lines;
+  cu_eval->fsize_realtime = cu_text.fsize_realtime;
+  MEM_SAFE_FREE(cu_text.str);
+  MEM_SAFE_FREE(cu_text.strinfo);
+
+  // Update the original curve without tagging, its next evaluation gives the same text.
+  set_curve_text((Curve *)ob->data, newText);
+
+  GetScene()->ResetTaaSamples();
+
+  return true;
+}
+
 void KX_FontObject::UpdateTextFromProperty()
 {
+  if (m_addGlyphs) {
+    Object *ob_eval = get_evaluated_object(GetBlenderObject());
+    const Curve *cu_eval = (Curve *)ob_eval->data;
+    // Wait for the evaluation of the last text.
+    if (cu_eval->str && m_text == cu_eval->str) {
+      GetScene()->GetFontGlyphCache()->AddGlyphs(ob_eval);
+      m_addGlyphs = false;
+    }
+  }
+
   // Allow for some logic brick control
   CValue *prop = GetProperty("Text");
   if (prop && prop->GetText() != m_text) {
     SetText(prop->GetText());
-    UpdateCurveText(m_text);  // eevee
+    if (!UpdateCurveTextFromGlyphs(m_text)) {
+      UpdateCurveText(m_text);  // eevee
+    }
   }
 }
 
@@ -56,6 +56,10 @@ class KX_FontObject : public KX_GameObject {
   }
 
   void UpdateCurveText(std::string text);  // eevee
+  /** Update the evaluated text object from the glyph cache of the scene, without evaluating the
+   * curve. Return false if the text can't be assembled from cached glyphs.
+   */
+  bool UpdateCurveTextFromGlyphs(const std::string &text);
 
   // Update text and bounding box.
   void SetText(const std::string &text);
@@ -66,6 +70,8 @@ class KX_FontObject : public KX_GameObject {
   std::string m_text;
   std::vector<std::string> m_texts;
   Object *m_object;
+  /// Add the glyphs of the text to the cache of the scene after its next evaluation.
+  bool m_addGlyphs;
 
   std::string m_backupText;  // eevee
   /// needed for drawing routine
@@ -68,8 +68,10 @@
 #include "KX_PythonComponent.h"
 #include "KX_RayCast.h"
 #include "KX_SG_NodeRelationships.h"
+#include "PHY_IGraphicController.h"
 #include "SCA_ISensor.h"
 #include "SG_Controller.h"
+#include "SG_Frustum.h"
 
 #ifdef WITH_PYTHON
 #  include "EXP_PythonCallBack.h"
@@ -97,6 +99,7 @@ KX_GameObject::KX_GameObject(void *sgReplicationInfo, SG_Callbacks callbacks)
       m_bVisible(true),
       m_bOccluder(false),
       m_pPhysicsController(nullptr),
+      m_pGraphicController(nullptr),
       m_components(NULL),
       m_pInstanceObjects(nullptr),
       m_pDupliGroupObject(nullptr),
@@ -116,6 +119,9 @@ KX_GameObject::KX_GameObject(void *sgReplicationInfo, SG_Callbacks callbacks)
   KX_NormalParentRelation *parent_relation = KX_NormalParentRelation::New();
   m_pSGNode->SetParentRelation(parent_relation);
 
+  // Objects are visible until a culling pass tells otherwise.
+  m_cullingNode.SetCulled(false);
+
   unit_m4(m_origObmat); // eevee
   unit_m4(m_prevObmat); // eevee
 };
@@ -167,6 +173,11 @@ KX_GameObject::~KX_GameObject()
     if (ob && ob->type == OB_MBALL) {
       DEG_id_tag_update(&ob->id, ID_RECALC_GEOMETRY);
     }
+    /* Generated levels of detail are freed with the scene meshes,
+     * re-evaluate to restore the object data. */
+    if (ob && (ob->gameflag2 & OB_LOD_GENERATE)) {
+      DEG_id_tag_update(&ob->id, ID_RECALC_GEOMETRY);
+    }
   }
 
   /* END OF EEVEE INTEGRATION */
@@ -198,6 +209,10 @@ KX_GameObject::~KX_GameObject()
     delete m_pPhysicsController;
   }
 
+  if (m_pGraphicController) {
+    delete m_pGraphicController;
+  }
+
   if (m_actionManager) {
     delete m_actionManager;
   }
@@ -840,6 +855,7 @@ void KX_GameObject::ProcessReplica()
   ReplicateBlenderObject();
 
   m_pPhysicsController = nullptr;
+  m_pGraphicController = nullptr;
   m_pSGNode = nullptr;
 
   /* Dupli group and instance list are set later in replication.
@@ -1013,7 +1029,21 @@ void KX_GameObject::RemoveMeshes()
 
 bool KX_GameObject::UseCulling() const
 {
-  return false;
+  return (m_pGraphicController != nullptr);
+}
+
+bool KX_GameObject::IsRenderedInFrustum(const SG_Frustum &frustum)
+{
+  Object *ob = GetBlenderObject();
+  if (!ob) {
+    return false;
+  }
+
+  // The blender object matrix is the one of the last TagForUpdate.
+  const SG_BBox &aabb = m_cullingNode.GetAabb();
+  return (frustum.AabbInsideFrustum(
+              aabb.GetMin(), aabb.GetMax(), MT_Matrix4x4(&ob->obmat[0][0])) !=
+          SG_Frustum::OUTSIDE);
 }
 
 void KX_GameObject::SetLodManager(KX_LodManager *lodManager)
@@ -1073,10 +1103,24 @@ void KX_GameObject::UpdateLod(const MT_Vector3 &cam_pos, float lodfactor)
      * depsgraph */
     Object *ob_eval = DEG_get_evaluated_object(depsgraph, GetBlenderObject());
 
-    Object *eval_lod_ob = DEG_get_evaluated_object(depsgraph,
-                                                   currentMeshObject->GetOriginalObject());
-    /* Try to get the object with all modifiers applied */
-    ob_eval->data = eval_lod_ob->data;
+    Mesh *generatedMesh = currentMeshObject->GetGeneratedMesh();
+    if (generatedMesh && currentLodLevel->GetLevel() == 0) {
+      /* The first generated level is a copy of the evaluated mesh made at conversion, render
+       * the evaluated mesh instead so that armature, shape key and modifier deformation go on. */
+      if (ob_eval->runtime.data_eval) {
+        ob_eval->data = ob_eval->runtime.data_eval;
+      }
+    }
+    else if (generatedMesh) {
+      /* Level of detail generated at conversion, not owned by any object */
+      ob_eval->data = generatedMesh;
+    }
+    else {
+      Object *eval_lod_ob = DEG_get_evaluated_object(depsgraph,
+                                                     currentMeshObject->GetOriginalObject());
+      /* Try to get the object with all modifiers applied */
+      ob_eval->data = eval_lod_ob->data;
+    }
   }
 }
 
@@ -1085,6 +1129,9 @@ void KX_GameObject::UpdateTransform()
   // HACK: saves function call for dynamic object, they are handled differently
   if (m_pPhysicsController && !m_pPhysicsController->IsDynamic())
     m_pPhysicsController->SetTransform();
+  if (m_pGraphicController)
+    // update the culling tree
+    m_pGraphicController->SetGraphicTransform();
 }
 
 void KX_GameObject::UpdateTransformFunc(SG_Node *node, void *gameobj, void *scene)
@@ -1171,6 +1218,37 @@ void KX_GameObject::SetVisible(bool v, bool recursive)
   }
 
   m_bVisible = v;
+
+  // Invisible objects are removed from the culling tree.
+  if (m_pGraphicController) {
+    m_pGraphicController->Activate(m_bVisible);
+  }
+}
+
+static void setGraphicController_recursive(SG_Node *node)
+{
+  NodeList &children = node->GetSGChildren();
+
+  for (NodeList::iterator childit = children.begin(); !(childit == children.end()); ++childit) {
+    SG_Node *childnode = (*childit);
+    KX_GameObject *clientgameobj = static_cast<KX_GameObject *>((*childit)->GetSGClientObject());
+    if (clientgameobj != nullptr)  // This is a GameObject
+      clientgameobj->ActivateGraphicController(false);
+
+    // if the childobj is nullptr then this may be an inverse parent link
+    // so a non recursive search should still look down this node.
+    setGraphicController_recursive(childnode);
+  }
+}
+
+void KX_GameObject::ActivateGraphicController(bool recurse)
+{
+  if (m_pGraphicController) {
+    m_pGraphicController->Activate(m_bVisible);
+  }
+  if (recurse) {
+    setGraphicController_recursive(GetSGNode());
+  }
 }
 
 static void setOccluder_recursive(SG_Node *node, bool v)
@@ -2116,6 +2194,7 @@ PyAttributeDef KX_GameObject::Attributes[] = {
         "angularVelocityMax", KX_GameObject, pyattr_get_ang_vel_max, pyattr_set_ang_vel_max),
     KX_PYATTRIBUTE_RW_FUNCTION("layer", KX_GameObject, pyattr_get_layer, pyattr_set_layer),
     KX_PYATTRIBUTE_RW_FUNCTION("visible", KX_GameObject, pyattr_get_visible, pyattr_set_visible),
+    KX_PYATTRIBUTE_RO_FUNCTION("culled", KX_GameObject, pyattr_get_culled),
     KX_PYATTRIBUTE_BOOL_RW("occlusion", KX_GameObject, m_bOccluder),
     KX_PYATTRIBUTE_RW_FUNCTION(
         "position", KX_GameObject, pyattr_get_worldPosition, pyattr_set_localPosition),
@@ -2931,6 +3010,12 @@ int KX_GameObject::pyattr_set_visible(PyObjectPlus *self_v,
   return PY_SET_ATTR_SUCCESS;
 }
 
+PyObject *KX_GameObject::pyattr_get_culled(PyObjectPlus *self_v, const KX_PYATTRIBUTE_DEF *attrdef)
+{
+  KX_GameObject *self = static_cast<KX_GameObject *>(self_v);
+  return PyBool_FromLong(self->GetCullingNode().GetCulled());
+}
+
 PyObject *KX_GameObject::pyattr_get_worldPosition(PyObjectPlus *self_v,
                                                   const KX_PYATTRIBUTE_DEF *attrdef)
 {
@@ -51,6 +51,7 @@
 #include "MT_Transform.h"
 #include "SCA_IObject.h"
 #include "SCA_LogicManager.h" /* for ConvertPythonToGameObject to search object names */
+#include "SG_CullingNode.h"
 #include "SG_Node.h"
 
 // Forward declarations.
@@ -61,6 +62,8 @@ class KX_PythonComponent;
 class RAS_MeshObject;
 class PHY_IPhysicsEnvironment;
 class PHY_IPhysicsController;
+class PHY_IGraphicController;
+class SG_Frustum;
 class BL_ActionManager;
 struct Object;
 class KX_ObstacleSimulation;
@@ -120,7 +123,10 @@ class KX_GameObject : public SCA_IObject {
   bool m_bOccluder;
 
   PHY_IPhysicsController *m_pPhysicsController;
+  PHY_IGraphicController *m_pGraphicController;
   SG_Node *m_pSGNode;
+  /// Culling state of the last culling pass and local bounds of the meshes.
+  SG_CullingNode m_cullingNode;
 
 #ifdef WITH_PYTHON
   CListValue<KX_PythonComponent> *m_components;
@@ -422,6 +428,22 @@ class KX_GameObject : public SCA_IObject {
   {
     m_pPhysicsController = physicscontroller;
   }
+
+  /**
+   * \return a pointer to the graphic controller owned by this class, used for culling.
+   */
+  PHY_IGraphicController *GetGraphicController()
+  {
+    return m_pGraphicController;
+  }
+
+  void SetGraphicController(PHY_IGraphicController *graphiccontroller)
+  {
+    m_pGraphicController = graphiccontroller;
+  }
+
+  /// Add or remove the object from the culling tree depending on its visibility.
+  void ActivateGraphicController(bool recurse);
   /// Return true when the game object is a .
   virtual bool IsDeformable() const
   {
@@ -663,6 +685,21 @@ class KX_GameObject : public SCA_IObject {
   /// Return true when the object can be culled.
   bool UseCulling() const;
 
+  bool GetCastShadows() const
+  {
+    return m_castShadows;
+  }
+
+  SG_CullingNode &GetCullingNode()
+  {
+    return m_cullingNode;
+  }
+
+  /** Return true if the object as last updated for rendering intersects the frustum.
+   * A culled object must still be updated in this case, else it is drawn at its old place.
+   */
+  bool IsRenderedInFrustum(const SG_Frustum &frustum);
+
   /**
    * Was this object marked visible? (only for the explicit
    * visibility system).
@@ -854,6 +891,7 @@ class KX_GameObject : public SCA_IObject {
                               const KX_PYATTRIBUTE_DEF *attrdef,
                               PyObject *value);
   static PyObject *pyattr_get_visible(PyObjectPlus *self_v, const KX_PYATTRIBUTE_DEF *attrdef);
+  static PyObject *pyattr_get_culled(PyObjectPlus *self_v, const KX_PYATTRIBUTE_DEF *attrdef);
   static int pyattr_set_visible(PyObjectPlus *self_v,
                                 const KX_PYATTRIBUTE_DEF *attrdef,
                                 PyObject *value);
@@ -136,6 +136,15 @@ KX_LodManager::KX_LodManager(Object *ob,
       m_levels.push_back(lodLevel);
     }
   }
+  else if ((ob->gameflag2 & OB_LOD_GENERATE) && ob->type == OB_MESH) {
+    const std::vector<RAS_MeshObject *> &meshes = BL_ConvertGeneratedLods(
+        ob, scene, rasty, converter, libloading, converting_during_runtime);
+    for (unsigned short level = 0; level < meshes.size(); ++level) {
+      KX_LodLevel *lodLevel = new KX_LodLevel(
+          level * ob->lod_generate_distance, 0.0f, level, meshes[level], KX_LodLevel::USE_MESH);
+      m_levels.push_back(lodLevel);
+    }
+  }
 }
 
 KX_LodManager::KX_LodManager(RAS_MeshObject *meshObj) : m_refcount(1), m_distanceFactor(1.0f)
@@ -726,6 +726,7 @@ bool KX_NavMeshObject::BuildVertIndArrays(float *&vertices,
   else {
     // create from RAS_MeshObject (detailed mesh is fake)
     RAS_MeshObject *meshobj = GetMesh(0);
+    meshobj->EnsureGeometry();
     vertsPerPoly = 3;
     nverts = meshobj->m_sharedvertex_map.size();
     if (nverts >= 0xffff)
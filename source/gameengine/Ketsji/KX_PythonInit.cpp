@@ -2005,6 +2005,14 @@ static void restorePySysObjects(void)
   gp_sys_backup.modules = nullptr;
 }
 
+/* Store the bytecode of the text blocks in a cache folder private to the user, the cache files
+ * are keyed by the text content and the python version so they are reused by the next game
+ * starts. The cache is disabled when the folder can't be created. */
+static void initBytecodeCache()
+{
+  bpy_import_bytecode_cache_set(BKE_appdir_folder_caches_create("bge_bytecode_cache"));
+}
+
 void appendPythonPath(const std::string &path)
 {
   PyObject *sys_path = PySys_GetObject("path");
@@ -2170,6 +2178,7 @@ void initGamePlayerPythonScripting(Main *maggie, int argc, char **argv, bContext
   bpy_import_init(PyEval_GetBuiltins());
 
   bpy_import_main_set(maggie);
+  initBytecodeCache();
 
   initPySysObjects(maggie);
 
@@ -2220,6 +2229,7 @@ void exitGamePlayerPythonScripting()
 
   // Py_Finalize();
   bpy_import_main_set(nullptr);
+  bpy_import_bytecode_cache_set(nullptr);
   PyObjectPlus::ClearDeprecationWarning();
 }
 
@@ -2284,6 +2294,7 @@ void initGamePythonScripting(Main *maggie)
   bpy_import_init(PyEval_GetBuiltins());
 
   bpy_import_main_set(maggie);
+  initBytecodeCache();
 
   initPySysObjects(maggie);
 
@@ -2328,6 +2339,7 @@ void exitGamePythonScripting()
 
   restorePySysObjects(); /* get back the original sys.path and clear the backup */
   bpy_import_main_set(nullptr);
+  bpy_import_bytecode_cache_set(nullptr);
   PyObjectPlus::ClearDeprecationWarning();
 }
 
@@ -48,6 +48,7 @@
 #include "depsgraph/DEG_depsgraph_query.h"
 #include "windowmanager/wm_draw.h"
 
+#include "BL_ArmatureObject.h"
 #include "BL_BlenderConverter.h"
 #include "BL_BlenderDataConversion.h"
 #include "BL_BlenderSceneConverter.h"
@@ -56,6 +57,7 @@
 #include "KX_BlenderCanvas.h"
 #include "KX_Camera.h"
 #include "KX_CollisionEventManager.h"
+#include "KX_FontGlyphCache.h"
 #include "KX_FontObject.h"
 #include "KX_Globals.h"
 #include "KX_Light.h"
@@ -65,6 +67,7 @@
 #include "KX_ObstacleSimulation.h"
 #include "KX_PyMath.h"
 #include "KX_SG_NodeRelationships.h"
+#include "PHY_IGraphicController.h"
 #include "PHY_IPhysicsController.h"
 #include "PHY_IPhysicsEnvironment.h"
 #include "RAS_BucketManager.h"
@@ -144,6 +147,9 @@ KX_Scene::KX_Scene(SCA_IInputDevice *inputDevice,
       m_blenderScene(scene),
       m_isActivedHysteresis(false),
       m_lodHysteresisValue(0),
+      m_animationLod(false),
+      m_animationLodDistance(0.0f),
+      m_animationLodInterval(1),
       m_isRuntime(true)  // eevee
 {
 
@@ -156,6 +162,7 @@ KX_Scene::KX_Scene(SCA_IInputDevice *inputDevice,
   m_inactivelist = new CListValue<KX_GameObject>();
   m_cameralist = new CListValue<KX_Camera>();
   m_fontlist = new CListValue<KX_FontObject>();
+  m_fontGlyphCache = new KX_FontGlyphCache();
 
   m_filterManager = new KX_2DFilterManager();
   m_logicmgr = new SCA_LogicManager();
@@ -349,6 +356,10 @@ KX_Scene::~KX_Scene()
     m_fontlist->Release();
   }
 
+  if (m_fontGlyphCache) {
+    delete m_fontGlyphCache;
+  }
+
   if (m_filterManager) {
     delete m_filterManager;
   }
@@ -622,7 +633,26 @@ void KX_Scene::RenderAfterCameraSetup(KX_Camera *cam, bool is_overlay_pass)
 
   BKE_scene_graph_update_tagged(depsgraph, bmain);
 
+  const RAS_Rect *viewport = &canvas->GetViewportArea();
+  int v[4] = {viewport->GetLeft(),
+              viewport->GetBottom(),
+              viewport->GetWidth() + 1,
+              viewport->GetHeight() + 1};
+
+  /* The overlay pass draws only the overlay collection, the culling state of the main pass is
+   * kept. */
+  KX_Camera *cullingcam = (m_overrideCullingCamera) ? m_overrideCullingCamera : cam;
+  const bool culling = cam && !is_overlay_pass && CalculateVisibleMeshes(cullingcam, v);
+
   for (KX_GameObject *gameobj : GetObjectList()) {
+    /* Culled objects are not updated for rendering, unless they are still drawn at their
+     * previous place in the camera view. Out of view, they don't restart the TAA either.
+     * Shadow casters are always updated, their shadows and probes can be in view. */
+    if (culling && gameobj->GetCullingNode().GetCulled() && !gameobj->GetCastShadows() &&
+        !gameobj->IsRenderedInFrustum(cullingcam->GetFrustum())) {
+      AppendToStaticObjects(gameobj);
+      continue;
+    }
     gameobj->TagForUpdate(is_overlay_pass);
   }
 
@@ -632,12 +662,6 @@ void KX_Scene::RenderAfterCameraSetup(KX_Camera *cam, bool is_overlay_pass)
   m_resetTaaSamples = false;
   m_staticObjects.clear();
 
-  const RAS_Rect *viewport = &canvas->GetViewportArea();
-  int v[4] = {viewport->GetLeft(),
-              viewport->GetBottom(),
-              viewport->GetWidth() + 1,
-              viewport->GetHeight() + 1};
-
   const rcti window = {0, viewport->GetWidth(), 0, viewport->GetHeight()};
 
   /* Here we'll render directly the scene with viewport code. */
@@ -889,6 +913,11 @@ CListValue<KX_FontObject> *KX_Scene::GetFontList() const
   return m_fontlist;
 }
 
+KX_FontGlyphCache *KX_Scene::GetFontGlyphCache() const
+{
+  return m_fontGlyphCache;
+}
+
 void KX_Scene::SetFramingType(RAS_FrameSettings &frame_settings)
 {
   m_frame_settings = frame_settings;
@@ -1047,6 +1076,14 @@ KX_GameObject *KX_Scene::AddNodeReplicaObject(SG_Node *node, KX_GameObject *game
       newctrl->SuspendDynamics();
   }
 
+  // replicate graphic controller, it is activated once the replica is placed
+  if (gameobj->GetGraphicController()) {
+    PHY_IMotionState *motionstate = new KX_MotionState(newobj->GetSGNode());
+    PHY_IGraphicController *newctrl = gameobj->GetGraphicController()->GetReplica(motionstate);
+    newctrl->SetNewClientInfo(newobj->getClientInfo());
+    newobj->SetGraphicController(newctrl);
+  }
+
   return newobj;
 }
 
@@ -1250,6 +1287,8 @@ void KX_Scene::DupliGroupRecurse(KX_GameObject *groupobj, int level)
     replica->NodeSetLocalOrientation(newori);
     // update scenegraph for entire tree of children
     replica->GetSGNode()->UpdateWorldData(0);
+    // the size is correct, we can add the graphic controller to the culling tree
+    replica->ActivateGraphicController(true);
 
     // done with replica
     replica->Release();
@@ -1399,6 +1438,8 @@ KX_GameObject *KX_Scene::AddReplicaObject(KX_GameObject *originalobject,
   }
 
   replica->GetSGNode()->UpdateWorldData(0);
+  // the size is correct, we can add the graphic controller to the culling tree
+  replica->ActivateGraphicController(true);
 
   // now replicate logic
   for (KX_GameObject *gameobj : m_logicHierarchicalGameObjects) {
@@ -1542,6 +1583,10 @@ bool KX_Scene::NewRemoveObject(KX_GameObject *gameobj)
 
   gameobj->RemoveMeshes();
 
+  if (gameobj->GetGraphicController()) {
+    gameobj->GetGraphicController()->Activate(false);
+  }
+
   bool ret = true;
   if (m_lightlist->RemoveValue(gameobj)) {
     ret = (gameobj->Release() != nullptr);
@@ -1674,6 +1719,35 @@ void KX_Scene::PhysicsCullingCallback(KX_ClientObjectInfo *objectInfo, void *cul
     // ideally, invisible objects should be removed from the culling tree temporarily
     return;
   }
+
+  gameobj->GetCullingNode().SetCulled(false);
+}
+
+bool KX_Scene::CalculateVisibleMeshes(KX_Camera *cam, const int viewport[4])
+{
+  if (!m_dbvt_culling) {
+    return false;
+  }
+
+  for (KX_GameObject *gameobj : *m_objectlist) {
+    gameobj->GetCullingNode().SetCulled(gameobj->UseCulling());
+  }
+
+  const SG_Frustum &frustum = cam->GetFrustum();
+  if (m_physicsEnvironment->CullingTest(PhysicsCullingCallback,
+                                        nullptr,
+                                        frustum.GetPlanes(),
+                                        m_dbvt_occlusion_res,
+                                        viewport,
+                                        frustum.GetMatrix())) {
+    return true;
+  }
+
+  // No culling tree, everything is visible.
+  for (KX_GameObject *gameobj : *m_objectlist) {
+    gameobj->GetCullingNode().SetCulled(false);
+  }
+  return false;
 }
 
 void KX_Scene::RenderDebugProperties(RAS_DebugDraw &debugDraw,
@@ -1816,14 +1890,49 @@ static void update_anim_thread_func(TaskPool *pool, void *taskdata, int UNUSED(t
   }
 }
 
+/** Pose update interval of an armature for the animation LoD: every frame when visible and near
+ * the camera, every \a interval frames when only one of both, else never (only time is managed).
+ */
+static int animation_lod_interval(BL_ArmatureObject *armature,
+                                  KX_Camera *cam,
+                                  KX_Camera *cullcam,
+                                  float distance,
+                                  int interval)
+{
+  const bool near = (armature->NodeGetWorldPosition() - cam->NodeGetWorldPosition()).length2() <=
+                    distance * distance;
+  const bool visible = !cullcam->hasValidProjectionMatrix() ||
+                       armature->IsVisibleFromCamera(cullcam);
+
+  if (near && visible) {
+    return 1;
+  }
+  if (near || visible) {
+    return interval;
+  }
+  return 0;
+}
+
 void KX_Scene::UpdateAnimations(double curtime)
 {
   // m_animationPoolData.curtime = curtime;
 
+  KX_Camera *cam = m_animationLod ? GetActiveCamera() : nullptr;
+  KX_Camera *cullcam = m_overrideCullingCamera ? m_overrideCullingCamera : cam;
+
   for (KX_GameObject *gameobj : m_animatedlist) {
     // BLI_task_pool_push(m_animationPool, update_anim_thread_func, gameobj, false,
     // TASK_PRIORITY_LOW);
-    gameobj->UpdateActionManager(curtime, true);
+    bool applyToObject = true;
+    if (cam && gameobj->GetGameObjectType() == SCA_IObject::OBJ_ARMATURE) {
+      BL_ArmatureObject *armature = static_cast<BL_ArmatureObject *>(gameobj);
+      if (armature->GetUseAnimationLod()) {
+        // Action time is always advanced, only the pose update is skipped.
+        applyToObject = armature->UpdateAnimationLod(animation_lod_interval(
+            armature, cam, cullcam, m_animationLodDistance, m_animationLodInterval));
+      }
+    }
+    gameobj->UpdateActionManager(curtime, applyToObject);
   }
 
   // BLI_task_pool_work_and_wait(m_animationPool);
@@ -1937,6 +2046,21 @@ int KX_Scene::GetLodHysteresisValue(void)
   return m_lodHysteresisValue;
 }
 
+void KX_Scene::SetAnimationLod(bool active)
+{
+  m_animationLod = active;
+}
+
+void KX_Scene::SetAnimationLodDistance(float distance)
+{
+  m_animationLodDistance = distance;
+}
+
+void KX_Scene::SetAnimationLodInterval(int interval)
+{
+  m_animationLodInterval = std::max(interval, 1);
+}
+
 void KX_Scene::UpdateObjectActivity(void)
 {
   if (m_activity_culling) {
@@ -2059,12 +2183,19 @@ static void MergeScene_GameObject(KX_GameObject *gameobj, KX_Scene *to, KX_Scene
     }
   }
 
-  /* graphics controller */
+  /* physics controller */
   PHY_IController *ctrl = gameobj->GetPhysicsController();
   if (ctrl) {
     ctrl->SetPhysicsEnvironment(to->GetPhysicsEnvironment());
   }
 
+  /* graphics controller */
+  ctrl = gameobj->GetGraphicController();
+  if (ctrl) {
+    // Moves the controller to the culling tree of the new scene.
+    ctrl->SetPhysicsEnvironment(to->GetPhysicsEnvironment());
+  }
+
   /* SG_Node can hold a scene reference */
   SG_Node *sg = gameobj->GetSGNode();
   if (sg) {
@@ -2113,6 +2244,8 @@ bool KX_Scene::MergeScene(KX_Scene *other)
   /* active + inactive == all ??? - lets hope so */
   for (KX_GameObject *gameobj : *other->GetObjectList()) {
     MergeScene_GameObject(gameobj, this, other);
+    // The converted scene could have no culling tree.
+    gameobj->ActivateGraphicController(false);
 
     /* add properties to debug list for LibLoad objects */
     if (KX_GetActiveEngine()->GetFlag(KX_KetsjiEngine::AUTO_ADD_DEBUG_PROPERTIES)) {
@@ -2280,6 +2413,8 @@ PyMethodDef KX_Scene::Methods[] = {
     KX_PYMETHODTABLE(KX_Scene, drawObstacleSimulation),
     KX_PYMETHODTABLE(KX_Scene, convertBlenderObject),
     KX_PYMETHODTABLE(KX_Scene, convertBlenderCollection),
+    KX_PYMETHODTABLE(KX_Scene, objectsForeachGet),
+    KX_PYMETHODTABLE(KX_Scene, objectsForeachSet),
 
     /* dict style access */
     KX_PYMETHODTABLE(KX_Scene, get),
@@ -2746,6 +2881,371 @@ KX_PYMETHODDEF_DOC(KX_Scene,
   Py_RETURN_NONE;
 }
 
+/* Bulk access to the transform of many objects, see objectsForeachGet/objectsForeachSet.
+ * Values are stored per object, orientations as 9 floats in row major order. */
+
+typedef void (*KX_ForeachGetFunc)(KX_GameObject *gameobj, float *r_values);
+typedef void (*KX_ForeachSetFunc)(KX_GameObject *gameobj, const float *values);
+
+static void foreach_vector_get(const MT_Vector3 &vec, float *r_values)
+{
+  r_values[0] = vec[0];
+  r_values[1] = vec[1];
+  r_values[2] = vec[2];
+}
+
+static void foreach_matrix_get(const MT_Matrix3x3 &mat, float *r_values)
+{
+  for (unsigned short i = 0; i < 3; ++i) {
+    for (unsigned short j = 0; j < 3; ++j) {
+      r_values[i * 3 + j] = mat[i][j];
+    }
+  }
+}
+
+static MT_Matrix3x3 foreach_matrix_from(const float *values)
+{
+  return MT_Matrix3x3(values[0],
+                      values[1],
+                      values[2],
+                      values[3],
+                      values[4],
+                      values[5],
+                      values[6],
+                      values[7],
+                      values[8]);
+}
+
+static void foreach_get_worldPosition(KX_GameObject *gameobj, float *r_values)
+{
+  foreach_vector_get(gameobj->NodeGetWorldPosition(), r_values);
+}
+
+static void foreach_set_worldPosition(KX_GameObject *gameobj, const float *values)
+{
+  gameobj->NodeSetWorldPosition(MT_Vector3(values));
+}
+
+static void foreach_get_localPosition(KX_GameObject *gameobj, float *r_values)
+{
+  foreach_vector_get(gameobj->NodeGetLocalPosition(), r_values);
+}
+
+static void foreach_set_localPosition(KX_GameObject *gameobj, const float *values)
+{
+  gameobj->NodeSetLocalPosition(MT_Vector3(values));
+}
+
+static void foreach_get_worldOrientation(KX_GameObject *gameobj, float *r_values)
+{
+  foreach_matrix_get(gameobj->NodeGetWorldOrientation(), r_values);
+}
+
+static void foreach_set_worldOrientation(KX_GameObject *gameobj, const float *values)
+{
+  gameobj->NodeSetGlobalOrientation(foreach_matrix_from(values));
+}
+
+static void foreach_get_localOrientation(KX_GameObject *gameobj, float *r_values)
+{
+  foreach_matrix_get(gameobj->NodeGetLocalOrientation(), r_values);
+}
+
+static void foreach_set_localOrientation(KX_GameObject *gameobj, const float *values)
+{
+  gameobj->NodeSetLocalOrientation(foreach_matrix_from(values));
+}
+
+static void foreach_get_worldScale(KX_GameObject *gameobj, float *r_values)
+{
+  foreach_vector_get(gameobj->NodeGetWorldScaling(), r_values);
+}
+
+static void foreach_set_worldScale(KX_GameObject *gameobj, const float *values)
+{
+  gameobj->NodeSetWorldScale(MT_Vector3(values));
+}
+
+static void foreach_get_localScale(KX_GameObject *gameobj, float *r_values)
+{
+  foreach_vector_get(gameobj->NodeGetLocalScaling(), r_values);
+}
+
+static void foreach_set_localScale(KX_GameObject *gameobj, const float *values)
+{
+  gameobj->NodeSetLocalScale(MT_Vector3(values));
+}
+
+static void foreach_get_worldLinearVelocity(KX_GameObject *gameobj, float *r_values)
+{
+  foreach_vector_get(gameobj->GetLinearVelocity(false), r_values);
+}
+
+static void foreach_set_worldLinearVelocity(KX_GameObject *gameobj, const float *values)
+{
+  gameobj->setLinearVelocity(MT_Vector3(values), false);
+}
+
+static void foreach_get_worldAngularVelocity(KX_GameObject *gameobj, float *r_values)
+{
+  foreach_vector_get(gameobj->GetAngularVelocity(false), r_values);
+}
+
+static void foreach_set_worldAngularVelocity(KX_GameObject *gameobj, const float *values)
+{
+  gameobj->setAngularVelocity(MT_Vector3(values), false);
+}
+
+struct KX_ForeachAttribute {
+  const char *name;
+  unsigned short size;
+  /** The value is in world space, the parent must be up to date to set it. */
+  bool world;
+  KX_ForeachGetFunc get;
+  KX_ForeachSetFunc set;
+};
+
+#  define KX_FOREACH_ATTRIBUTE(name, size, world) \
+    { \
+      #name, size, world, foreach_get_##name, foreach_set_##name \
+    }
+
+static const KX_ForeachAttribute foreach_attributes[] = {
+    KX_FOREACH_ATTRIBUTE(worldPosition, 3, true),
+    KX_FOREACH_ATTRIBUTE(localPosition, 3, false),
+    KX_FOREACH_ATTRIBUTE(worldOrientation, 9, true),
+    KX_FOREACH_ATTRIBUTE(localOrientation, 9, false),
+    KX_FOREACH_ATTRIBUTE(worldScale, 3, true),
+    KX_FOREACH_ATTRIBUTE(localScale, 3, false),
+    KX_FOREACH_ATTRIBUTE(worldLinearVelocity, 3, false),
+    KX_FOREACH_ATTRIBUTE(worldAngularVelocity, 3, false),
+    {nullptr, 0, false, nullptr, nullptr}  // Sentinel
+};
+
+#  undef KX_FOREACH_ATTRIBUTE
+
+/* Parse the arguments shared by objectsForeachGet and objectsForeachSet,
+ * returns the attribute or nullptr with a python error set. */
+static const KX_ForeachAttribute *foreach_parse_args(SCA_LogicManager *logicmgr,
+                                                     PyObject *args,
+                                                     const char *error_prefix,
+                                                     std::vector<KX_GameObject *> &r_objects,
+                                                     PyObject **r_values)
+{
+  PyObject *pyobjects;
+  const char *attr_str;
+
+  if (!PyArg_ParseTuple(args, "OsO", &pyobjects, &attr_str, r_values)) {
+    return nullptr;
+  }
+
+  const KX_ForeachAttribute *attr;
+  for (attr = foreach_attributes; attr->name; ++attr) {
+    if (STREQ(attr->name, attr_str)) {
+      break;
+    }
+  }
+
+  if (!attr->name) {
+    PyErr_Format(PyExc_AttributeError, "%s: unknown attribute \"%s\"", error_prefix, attr_str);
+    return nullptr;
+  }
+
+  PyObject *fast = PySequence_Fast(pyobjects, "");
+  if (!fast) {
+    PyErr_Format(PyExc_TypeError, "%s: expected a sequence of objects", error_prefix);
+    return nullptr;
+  }
+
+  const Py_ssize_t len = PySequence_Fast_GET_SIZE(fast);
+  PyObject **items = PySequence_Fast_ITEMS(fast);
+  r_objects.resize(len);
+  for (Py_ssize_t i = 0; i < len; ++i) {
+    if (!ConvertPythonToGameObject(logicmgr, items[i], &r_objects[i], false, error_prefix)) {
+      Py_DECREF(fast);
+      return nullptr;
+    }
+  }
+  Py_DECREF(fast);
+
+  return attr;
+}
+
+/* Get a contiguous float or double buffer of the expected size,
+ * returns false without error when the object doesn't support it. */
+static bool foreach_get_buffer(PyObject *values, int flags, Py_ssize_t len, Py_buffer *r_buf)
+{
+  if (!PyObject_CheckBuffer(values)) {
+    return false;
+  }
+  if (PyObject_GetBuffer(values, r_buf, flags | PyBUF_C_CONTIGUOUS | PyBUF_FORMAT) == -1) {
+    PyErr_Clear();
+    return false;
+  }
+  const char *format = r_buf->format ? r_buf->format : "B";
+  /* Skip native byte order and alignment prefixes. */
+  if (ELEM(format[0], '@', '=')) {
+    ++format;
+  }
+  if (r_buf->len / r_buf->itemsize == len && format[1] == '\0' && ELEM(format[0], 'f', 'd') &&
+      r_buf->itemsize == ((format[0] == 'f') ? sizeof(float) : sizeof(double))) {
+    return true;
+  }
+  PyBuffer_Release(r_buf);
+  return false;
+}
+
+KX_PYMETHODDEF_DOC(KX_Scene,
+                   objectsForeachGet,
+                   "objectsForeachGet(objects, attribute, values)\n"
+                   "Fill a float buffer or sequence with an attribute of all objects.\n")
+{
+  const char *error_prefix = "scene.objectsForeachGet(objects, attribute, values)";
+  std::vector<KX_GameObject *> objects;
+  PyObject *values;
+
+  const KX_ForeachAttribute *attr = foreach_parse_args(
+      m_logicmgr, args, error_prefix, objects, &values);
+  if (!attr) {
+    return nullptr;
+  }
+
+  const Py_ssize_t len = objects.size() * attr->size;
+  Py_buffer buf;
+  if (foreach_get_buffer(values, PyBUF_WRITABLE, len, &buf)) {
+    if (buf.itemsize == sizeof(float)) {
+      float *data = (float *)buf.buf;
+      for (KX_GameObject *gameobj : objects) {
+        attr->get(gameobj, data);
+        data += attr->size;
+      }
+    }
+    else {
+      double *data = (double *)buf.buf;
+      float tmp[9];
+      for (KX_GameObject *gameobj : objects) {
+        attr->get(gameobj, tmp);
+        for (unsigned short i = 0; i < attr->size; ++i) {
+          data[i] = tmp[i];
+        }
+        data += attr->size;
+      }
+    }
+    PyBuffer_Release(&buf);
+    Py_RETURN_NONE;
+  }
+
+  if (!PySequence_Check(values) || PySequence_Size(values) != len) {
+    PyErr_Clear();
+    PyErr_Format(PyExc_TypeError,
+                 "%s: expected a writable float buffer or sequence of size %d",
+                 error_prefix,
+                 (int)len);
+    return nullptr;
+  }
+
+  Py_ssize_t index = 0;
+  float tmp[9];
+  for (KX_GameObject *gameobj : objects) {
+    attr->get(gameobj, tmp);
+    for (unsigned short i = 0; i < attr->size; ++i, ++index) {
+      PyObject *item = PyFloat_FromDouble(tmp[i]);
+      const int ret = PySequence_SetItem(values, index, item);
+      Py_DECREF(item);
+      if (ret == -1) {
+        return nullptr;
+      }
+    }
+  }
+
+  Py_RETURN_NONE;
+}
+
+KX_PYMETHODDEF_DOC(KX_Scene,
+                   objectsForeachSet,
+                   "objectsForeachSet(objects, attribute, values)\n"
+                   "Set an attribute of all objects from a float buffer or sequence.\n")
+{
+  const char *error_prefix = "scene.objectsForeachSet(objects, attribute, values)";
+  std::vector<KX_GameObject *> objects;
+  PyObject *values;
+
+  const KX_ForeachAttribute *attr = foreach_parse_args(
+      m_logicmgr, args, error_prefix, objects, &values);
+  if (!attr) {
+    return nullptr;
+  }
+
+  const Py_ssize_t len = objects.size() * attr->size;
+  std::vector<float> data;
+  const float *src;
+
+  Py_buffer buf;
+  bool has_buf = foreach_get_buffer(values, PyBUF_SIMPLE, len, &buf);
+  if (has_buf && buf.itemsize == sizeof(float)) {
+    src = (const float *)buf.buf;
+  }
+  else {
+    data.resize(len);
+    if (has_buf) {
+      const double *src_double = (const double *)buf.buf;
+      for (Py_ssize_t i = 0; i < len; ++i) {
+        data[i] = src_double[i];
+      }
+      PyBuffer_Release(&buf);
+      has_buf = false;
+    }
+    else {
+      PyObject *fast = PySequence_Fast(values, "");
+      if (!fast || PySequence_Fast_GET_SIZE(fast) != len) {
+        Py_XDECREF(fast);
+        PyErr_Clear();
+        PyErr_Format(PyExc_TypeError,
+                     "%s: expected a float buffer or sequence of size %d",
+                     error_prefix,
+                     (int)len);
+        return nullptr;
+      }
+      PyObject **items = PySequence_Fast_ITEMS(fast);
+      for (Py_ssize_t i = 0; i < len; ++i) {
+        data[i] = PyFloat_AsDouble(items[i]);
+      }
+      Py_DECREF(fast);
+      if (PyErr_Occurred()) {
+        PyErr_Format(PyExc_TypeError, "%s: expected a sequence of floats", error_prefix);
+        return nullptr;
+      }
+    }
+    src = data.data();
+  }
+
+  /* Set all the nodes first, they are scheduled for update in the scene graph list
+   * and updated in a single pass afterward, parents before their children. */
+  for (KX_GameObject *gameobj : objects) {
+    /* World space values are converted using the parent transform, which must not be pending
+     * from a previous object, for the parent or any of its ancestors. */
+    if (attr->world) {
+      for (SG_Node *parent = gameobj->GetSGNode()->GetSGParent(); parent;
+           parent = parent->GetSGParent()) {
+        if (parent->IsModified()) {
+          UpdateParents(0.0);
+          break;
+        }
+      }
+    }
+    attr->set(gameobj, src);
+    src += attr->size;
+  }
+
+  if (has_buf) {
+    PyBuffer_Release(&buf);
+  }
+
+  UpdateParents(0.0);
+
+  Py_RETURN_NONE;
+}
+
 bool ConvertPythonToScene(PyObject *value,
                           KX_Scene **scene,
                           bool py_none_ok,
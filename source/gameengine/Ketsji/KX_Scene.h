@@ -68,6 +68,7 @@ class SG_Node;
 class SG_Node;
 class KX_Camera;
 class KX_FontObject;
+class KX_FontGlyphCache;
 class KX_GameObject;
 class KX_LightObject;
 class RAS_MeshObject;
@@ -161,6 +162,8 @@ class KX_Scene : public CValue, public SCA_IScene {
   CListValue<KX_Camera> *m_cameralist;
   /// The set of fonts for this scene
   CListValue<KX_FontObject> *m_fontlist;
+  /// The glyphs of the fonts for this scene
+  KX_FontGlyphCache *m_fontGlyphCache;
 
   SG_QList m_sghead;  // list of nodes that needs scenegraph update
                       // the Dlist is not object that must be updated
@@ -283,6 +286,11 @@ class KX_Scene : public CValue, public SCA_IScene {
    * Visibility testing functions.
    */
   static void PhysicsCullingCallback(KX_ClientObjectInfo *objectInfo, void *cullingInfo);
+  /** Update the culling state of the objects with the DBVT culling tree.
+   * \param viewport The viewport used by the occlusion buffer.
+   * \return False if the culling is disabled or unavailable, all objects are then not culled.
+   */
+  bool CalculateVisibleMeshes(KX_Camera *cam, const int viewport[4]);
 
   struct Scene *m_blenderScene;
 
@@ -299,6 +307,13 @@ class KX_Scene : public CValue, public SCA_IScene {
   bool m_isActivedHysteresis;
   int m_lodHysteresisValue;
 
+  /**
+   * Armature animation LOD settings
+   */
+  bool m_animationLod;
+  float m_animationLodDistance;
+  int m_animationLodInterval;
+
  public:
   KX_Scene(SCA_IInputDevice *inputDevice,
            const std::string &scenename,
@@ -396,6 +411,7 @@ class KX_Scene : public CValue, public SCA_IScene {
   CListValue<KX_Camera> *GetCameraList() const;
   void SetCameraList(CListValue<KX_Camera> *camList);
   CListValue<KX_FontObject> *GetFontList() const;
+  KX_FontGlyphCache *GetFontGlyphCache() const;
 
   /** Find the currently active camera. */
   KX_Camera *GetActiveCamera();
@@ -483,6 +499,11 @@ class KX_Scene : public CValue, public SCA_IScene {
   void SetLodHysteresisValue(int hysteresisvalue);
   int GetLodHysteresisValue();
 
+  // Animation LoD functions
+  void SetAnimationLod(bool active);
+  void SetAnimationLodDistance(float distance);
+  void SetAnimationLodInterval(int interval);
+
   // Update the activity box settings for objects in this scene, if needed.
   void UpdateObjectActivity(void);
 
@@ -556,6 +577,8 @@ class KX_Scene : public CValue, public SCA_IScene {
   KX_PYMETHOD_DOC(KX_Scene, drawObstacleSimulation);
   KX_PYMETHOD_DOC(KX_Scene, convertBlenderObject);
   KX_PYMETHOD_DOC(KX_Scene, convertBlenderCollection);
+  KX_PYMETHOD_DOC(KX_Scene, objectsForeachGet);
+  KX_PYMETHOD_DOC(KX_Scene, objectsForeachSet);
 
   /* attributes */
   static PyObject *pyattr_get_name(PyObjectPlus *self_v, const KX_PYATTRIBUTE_DEF *attrdef);
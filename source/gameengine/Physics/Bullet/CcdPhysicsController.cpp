@@ -28,9 +28,12 @@
 #include "../depsgraph/DEG_depsgraph_query.h"
 #include "BKE_cdderivedmesh.h"
 #include "BKE_context.h"
+#include "BKE_customdata.h"
 #include "BKE_layer.h"
 #include "BKE_object.h"
 #include "BKE_scene.h"
+#include "DNA_mesh_types.h"
+#include "DNA_meshdata_types.h"
 
 #include "BulletCollision/CollisionDispatch/btGhostObject.h"
 #include "BulletCollision/Gimpact/btGImpactShape.h"
@@ -38,6 +41,7 @@
 #include "BulletSoftBody/btSoftRigidDynamicsWorld.h"
 #include "LinearMath/btConvexHull.h"
 
+#include "CM_DiskCache.h"
 #include "CcdPhysicsEnvironment.h"
 #include "KX_GameObject.h"
 #include "RAS_DisplayArray.h"
@@ -1838,6 +1842,8 @@ void CcdShapeConstructionInfo::ProcessReplica()
   m_triangleIndexVertexArray = nullptr;
   m_forceReInstance = false;
   m_shapeProxy = nullptr;
+  m_bvhBuffer = nullptr;
+  m_optimizedBvh = nullptr;
   m_vertexArray.clear();
   m_polygonIndexArray.clear();
   m_triFaceArray.clear();
@@ -1845,6 +1851,90 @@ void CcdShapeConstructionInfo::ProcessReplica()
   m_shapeArray.clear();
 }
 
+/// Version of the format of the collision shape cache files.
+static const int shape_cache_version = 1;
+
+/** Hash the evaluated mesh data the collision shape arrays are converted from, with the
+ * collision flags of its materials.
+ */
+static void shape_cache_key(CM_DiskCacheKey &key,
+                            Mesh *me,
+                            RAS_MeshObject *meshobj,
+                            bool polytope)
+{
+  key.Add(polytope);
+  key.Add((int)sizeof(btScalar));
+
+  key.AddArray(me->mvert, me->totvert);
+  key.AddArray(me->mpoly, me->totpoly);
+  key.AddArray(me->mloop, me->totloop);
+
+  short maxMatNr = 0;
+  for (int i = 0; i < me->totpoly; ++i) {
+    maxMatNr = std::max(maxMatNr, me->mpoly[i].mat_nr);
+  }
+  for (short i = 0; i <= maxMatNr; ++i) {
+    key.Add(meshobj->IsColliderMaterial(i));
+  }
+
+  // The triangle UVs are the ones of the active layer.
+  key.Add(CustomData_get_active_layer(&me->ldata, CD_MLOOPUV));
+  for (int i = 0, num = CustomData_number_of_layers(&me->ldata, CD_MLOOPUV); i < num; ++i) {
+    key.AddArray((MLoopUV *)CustomData_get_layer_n(&me->ldata, CD_MLOOPUV, i), me->totloop);
+  }
+  key.AddArray((int *)CustomData_get_layer(&me->pdata, CD_ORIGINDEX), me->totpoly);
+}
+
+/// Load the arrays of a mesh shape from the cache, they are checked to be a valid shape.
+static bool shape_cache_load(CcdShapeConstructionInfo *shapeInfo,
+                             const CM_DiskCacheKey &key,
+                             bool polytope)
+{
+  CM_DiskCacheBuffer buffer;
+  bool valid = (buffer.Load("shape", key, shape_cache_version) &&
+                buffer.ReadArray(shapeInfo->m_vertexArray) &&
+                buffer.ReadArray(shapeInfo->m_polygonIndexArray) &&
+                buffer.ReadArray(shapeInfo->m_triFaceArray) &&
+                buffer.ReadArray(shapeInfo->m_triFaceUVcoArray) && buffer.AtEnd());
+
+  const int numVertices = shapeInfo->m_vertexArray.size() / 3;
+  const size_t numTriangles = shapeInfo->m_polygonIndexArray.size();
+  valid = valid && numVertices > 0 && shapeInfo->m_vertexArray.size() == numVertices * 3;
+  if (polytope) {
+    valid = valid && numTriangles == 0 && shapeInfo->m_triFaceArray.empty() &&
+            shapeInfo->m_triFaceUVcoArray.empty();
+  }
+  else {
+    valid = valid && numTriangles > 0 && shapeInfo->m_triFaceArray.size() == numTriangles * 3 &&
+            (shapeInfo->m_triFaceUVcoArray.empty() ||
+             shapeInfo->m_triFaceUVcoArray.size() == numTriangles * 3);
+    for (size_t i = 0; valid && i < numTriangles; ++i) {
+      valid = (shapeInfo->m_polygonIndexArray[i] >= 0);
+    }
+    for (int index : shapeInfo->m_triFaceArray) {
+      valid = valid && index >= 0 && index < numVertices;
+    }
+  }
+
+  if (!valid) {
+    shapeInfo->m_vertexArray.clear();
+    shapeInfo->m_polygonIndexArray.clear();
+    shapeInfo->m_triFaceArray.clear();
+    shapeInfo->m_triFaceUVcoArray.clear();
+  }
+  return valid;
+}
+
+static void shape_cache_save(const CcdShapeConstructionInfo *shapeInfo, const CM_DiskCacheKey &key)
+{
+  CM_DiskCacheBuffer buffer;
+  buffer.WriteArray(shapeInfo->m_vertexArray);
+  buffer.WriteArray(shapeInfo->m_polygonIndexArray);
+  buffer.WriteArray(shapeInfo->m_triFaceArray);
+  buffer.WriteArray(shapeInfo->m_triFaceUVcoArray);
+  buffer.Save("shape", key, shape_cache_version);
+}
+
 bool CcdShapeConstructionInfo::SetMesh(class KX_Scene *kxscene,
                                        RAS_MeshObject *meshobj,
                                        DerivedMesh *dm,
@@ -1868,6 +1958,10 @@ bool CcdShapeConstructionInfo::SetMesh(class KX_Scene *kxscene,
     return false;
   }
 
+  // Only the shapes of the evaluated mesh are cached, a given derived mesh isn't keyed.
+  CM_DiskCacheKey cacheKey;
+  const bool useCache = (!dm && m_useConversionCache);
+
   if (!dm) {
     free_dm = true;
     Scene *scene = kxscene->GetBlenderScene();
@@ -1878,6 +1972,20 @@ bool CcdShapeConstructionInfo::SetMesh(class KX_Scene *kxscene,
 
     Object *ob_eval = DEG_get_evaluated_object(depsgraph, meshobj->GetOriginalObject());
     Mesh *me = (Mesh *)ob_eval->data;
+
+    if (useCache) {
+      shape_cache_key(cacheKey, me, meshobj, polytope);
+      if (shape_cache_load(this, cacheKey, polytope)) {
+        m_shapeType = (polytope) ? PHY_SHAPE_POLYTOPE : PHY_SHAPE_MESH;
+        m_meshObject = meshobj;
+        if (!polytope) {
+          m_meshShapeMap.insert(
+              std::pair<RAS_MeshObject *, CcdShapeConstructionInfo *>(meshobj, this));
+        }
+        return true;
+      }
+    }
+
     dm = CDDM_from_mesh(me);
   }
 
@@ -1910,10 +2018,10 @@ bool CcdShapeConstructionInfo::SetMesh(class KX_Scene *kxscene,
       const int origi = index_mf_to_mpoly ?
                             DM_origindex_mface_mpoly(index_mf_to_mpoly, index_mp_to_orig, p2) :
                             p2;
-      RAS_Polygon *poly = (origi != ORIGINDEX_NONE) ? meshobj->GetPolygon(origi) : nullptr;
+      const bool collider = (origi != ORIGINDEX_NONE) && meshobj->IsColliderMaterial(mf->mat_nr);
 
       // only add polygons that have the collision flag set
-      if (poly && poly->IsCollider()) {
+      if (collider) {
         if (!vert_tag_array[mf->v1]) {
           vert_tag_array[mf->v1] = true;
           tot_bt_verts++;
@@ -1947,10 +2055,10 @@ bool CcdShapeConstructionInfo::SetMesh(class KX_Scene *kxscene,
       const int origi = index_mf_to_mpoly ?
                             DM_origindex_mface_mpoly(index_mf_to_mpoly, index_mp_to_orig, p2) :
                             p2;
-      RAS_Polygon *poly = (origi != ORIGINDEX_NONE) ? meshobj->GetPolygon(origi) : nullptr;
+      const bool collider = (origi != ORIGINDEX_NONE) && meshobj->IsColliderMaterial(mf->mat_nr);
 
       // only add polygons that have the collisionflag set
-      if (poly->IsCollider()) {
+      if (collider) {
         if (vert_tag_array[mf->v1]) {
           const float *vtx = mvert[mf->v1].co;
           vert_tag_array[mf->v1] = false;
@@ -1992,10 +2100,10 @@ bool CcdShapeConstructionInfo::SetMesh(class KX_Scene *kxscene,
       const int origi = index_mf_to_mpoly ?
                             DM_origindex_mface_mpoly(index_mf_to_mpoly, index_mp_to_orig, p2) :
                             p2;
-      RAS_Polygon *poly = (origi != ORIGINDEX_NONE) ? meshobj->GetPolygon(origi) : nullptr;
+      const bool collider = (origi != ORIGINDEX_NONE) && meshobj->IsColliderMaterial(mf->mat_nr);
 
       // only add polygons that have the collision flag set
-      if (poly && poly->IsCollider()) {
+      if (collider) {
         if (!vert_tag_array[mf->v1]) {
           vert_tag_array[mf->v1] = true;
           vert_remap_array[mf->v1] = tot_bt_verts;
@@ -2046,10 +2154,10 @@ bool CcdShapeConstructionInfo::SetMesh(class KX_Scene *kxscene,
       const int origi = index_mf_to_mpoly ?
                             DM_origindex_mface_mpoly(index_mf_to_mpoly, index_mp_to_orig, p2) :
                             p2;
-      RAS_Polygon *poly = (origi != ORIGINDEX_NONE) ? meshobj->GetPolygon(origi) : nullptr;
+      const bool collider = (origi != ORIGINDEX_NONE) && meshobj->IsColliderMaterial(mf->mat_nr);
 
       // only add polygons that have the collisionflag set
-      if (poly && poly->IsCollider()) {
+      if (collider) {
         MVert *v1 = &mvert[mf->v1];
         MVert *v2 = &mvert[mf->v2];
         MVert *v3 = &mvert[mf->v3];
@@ -2147,6 +2255,10 @@ bool CcdShapeConstructionInfo::SetMesh(class KX_Scene *kxscene,
 	}
 #endif
 
+  if (useCache) {
+    shape_cache_save(this, cacheKey);
+  }
+
   m_meshObject = meshobj;
   if (free_dm) {
     dm->release(dm);
@@ -2235,10 +2347,10 @@ bool CcdShapeConstructionInfo::SetMesh2(RAS_MeshObject *meshobj, Object *ob, boo
       const int origi = index_mf_to_mpoly ?
                             DM_origindex_mface_mpoly(index_mf_to_mpoly, index_mp_to_orig, p2) :
                             p2;
-      RAS_Polygon *poly = (origi != ORIGINDEX_NONE) ? meshobj->GetPolygon(origi) : nullptr;
+      const bool collider = (origi != ORIGINDEX_NONE) && meshobj->IsColliderMaterial(mf->mat_nr);
 
       // only add polygons that have the collision flag set
-      if (poly && poly->IsCollider()) {
+      if (collider) {
         if (!vert_tag_array[mf->v1]) {
           vert_tag_array[mf->v1] = true;
           vert_remap_array[mf->v1] = tot_bt_verts;
@@ -2289,10 +2401,10 @@ bool CcdShapeConstructionInfo::SetMesh2(RAS_MeshObject *meshobj, Object *ob, boo
       const int origi = index_mf_to_mpoly ?
                             DM_origindex_mface_mpoly(index_mf_to_mpoly, index_mp_to_orig, p2) :
                             p2;
-      RAS_Polygon *poly = (origi != ORIGINDEX_NONE) ? meshobj->GetPolygon(origi) : nullptr;
+      const bool collider = (origi != ORIGINDEX_NONE) && meshobj->IsColliderMaterial(mf->mat_nr);
 
       // only add polygons that have the collisionflag set
-      if (poly && poly->IsCollider()) {
+      if (collider) {
         MVert *v1 = &mvert[mf->v1];
         MVert *v2 = &mvert[mf->v2];
         MVert *v3 = &mvert[mf->v3];
@@ -2828,6 +2940,9 @@ btCollisionShape *CcdShapeConstructionInfo::CreateBulletShape(btScalar margin,
       }
       else {
         if (!m_triangleIndexVertexArray || m_forceReInstance) {
+          // The cached BVH describes the previous mesh.
+          FreeOptimizedBvh();
+
           /// enable welding, only for the objects that need it (such as soft bodies)
           if (0.0f != m_weldingThreshold1) {
             btTriangleMesh *collisionMeshData = new btTriangleMesh(true, false);
@@ -2860,8 +2975,16 @@ btCollisionShape *CcdShapeConstructionInfo::CreateBulletShape(btScalar margin,
           m_forceReInstance = false;
         }
 
-        btBvhTriangleMeshShape *unscaledShape = new btBvhTriangleMeshShape(
-            m_triangleIndexVertexArray, true, useBvh);
+        btBvhTriangleMeshShape *unscaledShape;
+        // The welded mesh doesn't use the vertex and triangle arrays hashed for the cache.
+        if (useBvh && m_useConversionCache && m_weldingThreshold1 == 0.0f &&
+            !m_triFaceArray.empty()) {
+          unscaledShape = new btBvhTriangleMeshShape(m_triangleIndexVertexArray, true, false);
+          unscaledShape->setOptimizedBvh(GetOptimizedBvh(unscaledShape));
+        }
+        else {
+          unscaledShape = new btBvhTriangleMeshShape(m_triangleIndexVertexArray, true, useBvh);
+        }
         unscaledShape->setMargin(margin);
         collisionShape = new btScaledBvhTriangleMeshShape(unscaledShape,
                                                           btVector3(1.0f, 1.0f, 1.0f));
@@ -2892,6 +3015,98 @@ btCollisionShape *CcdShapeConstructionInfo::CreateBulletShape(btScalar margin,
   return collisionShape;
 }
 
+/// Version of the format of the BVH cache files.
+static const int bvh_cache_version = 3;
+
+/// Check that the nodes of a loaded BVH only reference existing nodes and triangles.
+static bool bvh_cache_nodes_valid(btOptimizedBvh *bvh, int numTriangles)
+{
+  if (!bvh->isQuantized()) {
+    return false;
+  }
+
+  const QuantizedNodeArray &nodes = bvh->getQuantizedNodeArray();
+  const int numNodes = nodes.size();
+  for (int i = 0; i < numNodes; i++) {
+    const btQuantizedBvhNode &node = nodes[i];
+    if (node.isLeafNode()) {
+      if (node.getPartId() != 0 || node.getTriangleIndex() >= numTriangles) {
+        return false;
+      }
+    }
+    else if (node.getEscapeIndex() <= 0 || node.getEscapeIndex() > numNodes - i) {
+      return false;
+    }
+  }
+
+  const BvhSubtreeInfoArray &subtrees = bvh->getSubtreeInfoArray();
+  for (int i = 0; i < subtrees.size(); i++) {
+    const btBvhSubtreeInfo &subtree = subtrees[i];
+    if (subtree.m_rootNodeIndex < 0 || subtree.m_subtreeSize < 0 ||
+        subtree.m_subtreeSize > numNodes - subtree.m_rootNodeIndex) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+btOptimizedBvh *CcdShapeConstructionInfo::GetOptimizedBvh(btBvhTriangleMeshShape *shape)
+{
+  if (m_optimizedBvh) {
+    return m_optimizedBvh;
+  }
+
+  // The serialized BVH depends on the mesh content and on the Bullet build.
+  CM_DiskCacheKey key;
+  key.Add(btGetVersion());
+  key.Add((int)sizeof(btScalar));
+  key.AddArray(&m_vertexArray[0], m_vertexArray.size());
+  key.AddArray(m_triFaceArray.data(), m_triFaceArray.size());
+
+  CM_DiskCacheBuffer cached;
+  std::vector<char> data;
+  if (cached.Load("bvh", key, bvh_cache_version) && cached.ReadArray(data) && cached.AtEnd() &&
+      !data.empty()) {
+    m_bvhBuffer = btAlignedAlloc(data.size(), 16);
+    memcpy(m_bvhBuffer, data.data(), data.size());
+    m_optimizedBvh = btOptimizedBvh::deSerializeInPlace(m_bvhBuffer, data.size(), false);
+
+    if (m_optimizedBvh && bvh_cache_nodes_valid(m_optimizedBvh, m_triFaceArray.size() / 3)) {
+      return m_optimizedBvh;
+    }
+    // Invalid cache, fall back to building the BVH.
+    FreeOptimizedBvh();
+  }
+
+  btOptimizedBvh bvh;
+  bvh.build(m_triangleIndexVertexArray, true, shape->getLocalAabbMin(), shape->getLocalAabbMax());
+
+  const unsigned int bufferSize = bvh.calculateSerializeBufferSize();
+  m_bvhBuffer = btAlignedAlloc(bufferSize, 16);
+  bvh.serializeInPlace(m_bvhBuffer, bufferSize, false);
+
+  CM_DiskCacheBuffer buffer;
+  buffer.Write((uint64_t)bufferSize);
+  buffer.Write(m_bvhBuffer, bufferSize);
+  buffer.Save("bvh", key, bvh_cache_version);
+
+  m_optimizedBvh = btOptimizedBvh::deSerializeInPlace(m_bvhBuffer, bufferSize, false);
+  return m_optimizedBvh;
+}
+
+void CcdShapeConstructionInfo::FreeOptimizedBvh()
+{
+  if (m_optimizedBvh) {
+    m_optimizedBvh->~btOptimizedBvh();
+    m_optimizedBvh = nullptr;
+  }
+  if (m_bvhBuffer) {
+    btAlignedFree(m_bvhBuffer);
+    m_bvhBuffer = nullptr;
+  }
+}
+
 void CcdShapeConstructionInfo::AddShape(CcdShapeConstructionInfo *shapeInfo)
 {
   m_shapeArray.push_back(shapeInfo);
@@ -2909,6 +3124,7 @@ CcdShapeConstructionInfo::~CcdShapeConstructionInfo()
 
   if (m_triangleIndexVertexArray)
     delete m_triangleIndexVertexArray;
+  FreeOptimizedBvh();
   m_vertexArray.clear();
   if (m_shapeType == PHY_SHAPE_MESH && m_meshObject != nullptr) {
     std::map<RAS_MeshObject *, CcdShapeConstructionInfo *>::iterator mit = m_meshShapeMap.find(
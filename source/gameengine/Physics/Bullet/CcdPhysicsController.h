@@ -83,7 +83,10 @@ class CcdShapeConstructionInfo : public CM_RefCount<CcdShapeConstructionInfo> {
         m_triangleIndexVertexArray(nullptr),
         m_forceReInstance(false),
         m_weldingThreshold1(0.0f),
-        m_shapeProxy(nullptr)
+        m_shapeProxy(nullptr),
+        m_useConversionCache(false),
+        m_bvhBuffer(nullptr),
+        m_optimizedBvh(nullptr)
   {
     m_childTrans.setIdentity();
   }
@@ -162,6 +165,15 @@ class CcdShapeConstructionInfo : public CM_RefCount<CcdShapeConstructionInfo> {
                                       bool useGimpact = false,
                                       bool useBvh = true);
 
+  /** Enable the disk cache of the shape arrays converted from the evaluated mesh and of the
+   * triangle mesh BVH. The cached data is keyed by the content of the mesh, it is loaded
+   * instead of being converted or built.
+   */
+  void SetUseConversionCache(bool useConversionCache)
+  {
+    m_useConversionCache = useConversionCache;
+  }
+
   // member variables
   PHY_ShapeType m_shapeType;
   btScalar m_radius;
@@ -204,6 +216,19 @@ class CcdShapeConstructionInfo : public CM_RefCount<CcdShapeConstructionInfo> {
   float m_weldingThreshold1;
   /// only used for PHY_SHAPE_PROXY, pointer to actual shape info
   CcdShapeConstructionInfo *m_shapeProxy;
+  /// Load and save the converted arrays and the BVH in the disk cache, see SetUseConversionCache.
+  bool m_useConversionCache;
+  /// Aligned buffer holding the serialized BVH of the triangle mesh, see GetOptimizedBvh.
+  void *m_bvhBuffer;
+  /// BVH of the triangle mesh shared by the mesh shapes, deserialized in m_bvhBuffer.
+  btOptimizedBvh *m_optimizedBvh;
+
+  /** Return the BVH of the triangle mesh, load it from the disk cache if its mesh content
+   * matches, else build it and write it to the cache.
+   * \param shape The shape used to compute the bounds of the BVH.
+   */
+  btOptimizedBvh *GetOptimizedBvh(btBvhTriangleMeshShape *shape);
+  void FreeOptimizedBvh();
 };
 
 struct CcdConstructionInfo {
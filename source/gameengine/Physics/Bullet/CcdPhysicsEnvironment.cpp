@@ -375,6 +375,7 @@ CcdPhysicsEnvironment::CcdPhysicsEnvironment(bool useDbvtCulling,
       m_linearDeactivationThreshold(0.8f),
       m_angularDeactivationThreshold(1.0f),
       m_contactBreakingThreshold(0.02f),
+      m_useConversionCache(false),
       m_solver(nullptr),
       m_ownPairCache(nullptr),
       m_filterCallback(nullptr),
@@ -949,6 +950,11 @@ void CcdPhysicsEnvironment::SetDeactivationTime(float dTime)
 {
   m_deactivationTime = dTime;
 }
+
+void CcdPhysicsEnvironment::SetUseConversionCache(bool useConversionCache)
+{
+  m_useConversionCache = useConversionCache;
+}
 void CcdPhysicsEnvironment::SetDeactivationLinearTreshold(float linTresh)
 {
   m_linearDeactivationThreshold = linTresh;
@@ -2732,11 +2738,13 @@ struct BlenderDebugDraw : public btIDebugDraw {
 
 CcdPhysicsEnvironment *CcdPhysicsEnvironment::Create(Scene *blenderscene, bool visualizePhysics)
 {
-  CcdPhysicsEnvironment *ccdPhysEnv = new CcdPhysicsEnvironment(false);
+  CcdPhysicsEnvironment *ccdPhysEnv = new CcdPhysicsEnvironment(
+      (blenderscene->gm.flag & GAME_USE_DBVT_CULLING) != 0);
   ccdPhysEnv->SetDebugDrawer(new BlenderDebugDraw());
   ccdPhysEnv->SetDeactivationLinearTreshold(blenderscene->gm.lineardeactthreshold);
   ccdPhysEnv->SetDeactivationAngularTreshold(blenderscene->gm.angulardeactthreshold);
   ccdPhysEnv->SetDeactivationTime(blenderscene->gm.deactivationtime);
+  ccdPhysEnv->SetUseConversionCache((blenderscene->gm.flag & GAME_USE_CONVERSION_CACHE) != 0);
 
   if (visualizePhysics)
     ccdPhysEnv->SetDebugMode(btIDebugDraw::DBG_DrawWireframe | btIDebugDraw::DBG_DrawAabb |
@@ -2768,6 +2776,7 @@ void CcdPhysicsEnvironment::ConvertObject(BL_BlenderSceneConverter *converter,
   bool useGimpact = false;
   CcdConstructionInfo ci;
   class CcdShapeConstructionInfo *shapeInfo = new CcdShapeConstructionInfo();
+  shapeInfo->SetUseConversionCache(m_useConversionCache);
 
   // get Root Parent of blenderobject
   Object *blenderparent = blenderobject->parent;
@@ -96,6 +96,9 @@ class CcdPhysicsEnvironment : public PHY_IPhysicsEnvironment {
   float m_angularDeactivationThreshold;
   float m_contactBreakingThreshold;
 
+  /// Passed to the shapes converted in this environment, see SetUseConversionCache.
+  bool m_useConversionCache;
+
   void ProcessFhSprings(double curTime, float timeStep);
 
  public:
@@ -119,6 +122,7 @@ class CcdPhysicsEnvironment : public PHY_IPhysicsEnvironment {
     m_numTimeSubSteps = numTimeSubSteps;
   }
   virtual void SetDeactivationTime(float dTime);
+  void SetUseConversionCache(bool useConversionCache);
   virtual void SetDeactivationLinearTreshold(float linTresh);
   virtual void SetDeactivationAngularTreshold(float angTresh);
   virtual void SetContactBreakingTreshold(float contactBreakingTreshold);
@@ -116,6 +116,33 @@ template<class Vertex> class RAS_DisplayArray : public virtual RAS_IDisplayArray
     m_vertexes.push_back(*((Vertex *)vert));
   }
 
+  virtual unsigned int AddVertex(const MT_Vector3 &xyz,
+                                 const MT_Vector2 *const uvs,
+                                 const MT_Vector4 &tangent,
+                                 const unsigned int *rgba,
+                                 const MT_Vector3 &normal)
+  {
+    m_vertexes.emplace_back(xyz, uvs, tangent, rgba, normal);
+    return m_vertexes.size() - 1;
+  }
+
+  virtual void RemoveLastVertex()
+  {
+    m_vertexes.pop_back();
+  }
+
+  virtual void ReserveVertices(const unsigned int count)
+  {
+    m_vertexes.reserve(count);
+    m_vertexInfos.reserve(count);
+  }
+
+  virtual void ShrinkVertices()
+  {
+    m_vertexes.shrink_to_fit();
+    m_vertexInfos.shrink_to_fit();
+  }
+
   virtual unsigned int GetVertexCount() const
   {
     return m_vertexes.size();
@@ -111,11 +111,34 @@ class RAS_IDisplayArray {
 
   virtual void AddVertex(RAS_ITexVert *vert) = 0;
 
+  /** Construct a vertex in place at the end of the array, without intermediate allocation.
+   * \return The index of the new vertex.
+   */
+  virtual unsigned int AddVertex(const MT_Vector3 &xyz,
+                                 const MT_Vector2 *const uvs,
+                                 const MT_Vector4 &tangent,
+                                 const unsigned int *rgba,
+                                 const MT_Vector3 &normal) = 0;
+
+  /// Remove the last vertex, e.g when it was found to be shared with an other vertex.
+  virtual void RemoveLastVertex() = 0;
+
+  /// Reserve memory for the vertices and vertex infos added during the conversion.
+  virtual void ReserveVertices(const unsigned int count) = 0;
+
+  /// Release the memory reserved for vertices and not used.
+  virtual void ShrinkVertices() = 0;
+
   inline void AddIndex(const unsigned int index)
   {
     m_indices.push_back(index);
   }
 
+  inline void ReserveIndices(const unsigned int count)
+  {
+    m_indices.reserve(count);
+  }
+
   inline void AddVertexInfo(const RAS_TexVertInfo &info)
   {
     m_vertexInfos.push_back(info);
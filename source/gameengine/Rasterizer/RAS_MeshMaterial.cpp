@@ -24,12 +24,13 @@
 
 #include "RAS_IDisplayArray.h"
 #include "RAS_MaterialBucket.h"
+#include "RAS_MeshObject.h"
 
 RAS_MeshMaterial::RAS_MeshMaterial(RAS_MeshObject *mesh,
                                    RAS_MaterialBucket *bucket,
                                    unsigned int index,
                                    const RAS_TexVertFormat &format)
-    : m_bucket(bucket), m_index(index)
+    : m_mesh(mesh), m_bucket(bucket), m_index(index)
 {
   RAS_IDisplayArray::PrimitiveType type = (bucket->IsWire()) ? RAS_IDisplayArray::LINES :
                                                                RAS_IDisplayArray::TRIANGLES;
@@ -56,6 +57,7 @@ RAS_MaterialBucket *RAS_MeshMaterial::GetBucket() const
 
 RAS_IDisplayArray *RAS_MeshMaterial::GetDisplayArray() const
 {
+  m_mesh->EnsureGeometry();
   return m_displayArray;
 }
 
@@ -46,6 +46,7 @@ struct RAS_TexVertFormat;
  */
 class RAS_MeshMaterial {
  private:
+  RAS_MeshObject *m_mesh;
   RAS_MaterialBucket *m_bucket;
   /// The blender material index position in the mesh.
   unsigned int m_index;
@@ -62,6 +63,7 @@ class RAS_MeshMaterial {
 
   unsigned int GetIndex() const;
   RAS_MaterialBucket *GetBucket() const;
+  /// Return the display array, converting the geometry of the mesh if it was deferred.
   RAS_IDisplayArray *GetDisplayArray() const;
   RAS_DisplayArrayBucket *GetDisplayArrayBucket() const;
 
@@ -31,6 +31,7 @@
 
 #include "RAS_MeshObject.h"
 
+#include "BKE_lib_id.h"
 #include "DNA_mesh_types.h"
 
 #include "CM_Message.h"
@@ -39,7 +40,12 @@
 #include "RAS_Polygon.h"
 
 RAS_MeshObject::RAS_MeshObject(Mesh *mesh, Object *originalOb, const LayersInfo &layersInfo)
-    : m_name(mesh->id.name + 2), m_layersInfo(layersInfo), m_mesh(mesh), m_originalOb(originalOb)
+    : m_name(mesh->id.name + 2),
+      m_layersInfo(layersInfo),
+      m_mesh(mesh),
+      m_originalOb(originalOb),
+      m_generatedMesh(nullptr),
+      m_hasColliderPolygon(false)
 {
 }
 
@@ -53,6 +59,10 @@ RAS_MeshObject::~RAS_MeshObject()
     delete *it;
   }
   m_materials.clear();
+
+  if (m_generatedMesh) {
+    BKE_id_free(nullptr, &m_generatedMesh->id);
+  }
 }
 
 int RAS_MeshObject::NumMaterials()
@@ -93,11 +103,15 @@ RAS_MeshMaterial *RAS_MeshObject::GetMeshMaterialBlenderIndex(unsigned int index
 
 int RAS_MeshObject::NumPolygons()
 {
+  EnsureGeometry();
+
   return m_polygons.size();
 }
 
 RAS_Polygon *RAS_MeshObject::GetPolygon(int num)
 {
+  EnsureGeometry();
+
   return &m_polygons[num];
 }
 
@@ -189,7 +203,9 @@ unsigned int RAS_MeshObject::AddVertex(RAS_MeshMaterial *meshmat,
                                        const unsigned int origindex)
 {
   RAS_IDisplayArray *darray = meshmat->GetDisplayArray();
-  RAS_ITexVert *vertex = darray->CreateVertex(xyz, uvs, tangent, rgba, normal);
+  // Construct the vertex in place, it is removed again if it can be shared.
+  const unsigned int offset = darray->AddVertex(xyz, uvs, tangent, rgba, normal);
+  RAS_ITexVert *vertex = darray->GetVertexNoCache(offset);
 
   { /* Shared Vertex! */
     /* find vertices shared between faces, with the restriction
@@ -205,18 +221,15 @@ unsigned int RAS_MeshObject::AddVertex(RAS_MeshMaterial *meshmat,
         continue;
 
       // found one, add it and we're done
-      delete vertex;
+      darray->RemoveLastVertex();
       return it->m_offset;
     }
   }
 
-  // no shared vertex found, add a new one
-  darray->AddVertex(vertex);
+  // no shared vertex found, keep the new one
   const RAS_TexVertInfo info(origindex, flat);
   darray->AddVertexInfo(info);
 
-  int offset = darray->GetVertexCount() - 1;
-
   {  // Shared Vertex!
     SharedVertex shared;
     shared.m_darray = darray;
@@ -224,10 +237,38 @@ unsigned int RAS_MeshObject::AddVertex(RAS_MeshMaterial *meshmat,
     m_sharedvertex_map[origindex].push_back(shared);
   }
 
-  delete vertex;
   return offset;
 }
 
+void RAS_MeshObject::SetGeometryConverter(const std::function<void(RAS_MeshObject *)> &converter,
+                                          bool hasColliderPolygon)
+{
+  m_geometryConverter = converter;
+  m_hasColliderPolygon = hasColliderPolygon;
+}
+
+void RAS_MeshObject::EnsureGeometry()
+{
+  if (!m_geometryConverter) {
+    return;
+  }
+
+  // Clear the converter first, the conversion accesses the display arrays of this mesh.
+  const std::function<void(RAS_MeshObject *)> converter = m_geometryConverter;
+  m_geometryConverter = nullptr;
+  converter(this);
+}
+
+void RAS_MeshObject::SetColliderMaterials(const std::vector<bool> &colliders)
+{
+  m_colliderMaterials = colliders;
+}
+
+bool RAS_MeshObject::IsColliderMaterial(unsigned int index) const
+{
+  return (index < m_colliderMaterials.size()) && m_colliderMaterials[index];
+}
+
 RAS_IDisplayArray *RAS_MeshObject::GetDisplayArray(unsigned int matid) const
 {
   RAS_MeshMaterial *mmat = GetMeshMaterial(matid);
@@ -253,6 +294,8 @@ RAS_ITexVert *RAS_MeshObject::GetVertex(unsigned int matid, unsigned int index)
 
 const float *RAS_MeshObject::GetVertexLocation(unsigned int orig_index)
 {
+  EnsureGeometry();
+
   std::vector<SharedVertex> &sharedmap = m_sharedvertex_map[orig_index];
   std::vector<SharedVertex>::iterator it = sharedmap.begin();
   return it->m_darray->GetVertex(it->m_offset)->getXYZ();
@@ -298,6 +341,10 @@ const RAS_MeshObject::LayersInfo &RAS_MeshObject::GetLayersInfo() const
 
 bool RAS_MeshObject::HasColliderPolygon()
 {
+  if (m_geometryConverter) {
+    return m_hasColliderPolygon;
+  }
+
   for (const RAS_Polygon &poly : m_polygons) {
     if (poly.IsCollider()) {
       return true;
@@ -312,3 +359,13 @@ Object *RAS_MeshObject::GetOriginalObject()
 {
   return m_originalOb;
 }
+
+void RAS_MeshObject::SetGeneratedMesh(Mesh *mesh)
+{
+  m_generatedMesh = mesh;
+}
+
+Mesh *RAS_MeshObject::GetGeneratedMesh() const
+{
+  return m_generatedMesh;
+}
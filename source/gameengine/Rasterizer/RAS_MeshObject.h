@@ -37,6 +37,7 @@
 #  pragma warning(disable : 4786)
 #endif
 
+#include <functional>
 #include <list>
 #include <string>
 #include <vector>
@@ -97,6 +98,15 @@ class RAS_MeshObject {
   /* In 2.8 code, ReinstancePhysicsShape2 needs an Object to recalculate the physics shape */
   Object *m_originalOb;
 
+  /// Mesh generated during the conversion (e.g. decimated level of detail), owned.
+  Mesh *m_generatedMesh;
+
+  /// Converts the vertices and polygons on first access, empty once they are converted.
+  std::function<void(RAS_MeshObject *)> m_geometryConverter;
+  /// Collision flag of each blender material index, known without the polygons.
+  std::vector<bool> m_colliderMaterials;
+  bool m_hasColliderPolygon;
+
  public:
   // for now, meshes need to be in a certain layer (to avoid sorting on lights in realtime)
   RAS_MeshObject(Mesh *mesh, Object *originalOb, const LayersInfo &layersInfo);
@@ -139,6 +149,22 @@ class RAS_MeshObject {
                                  const bool flat,
                                  const unsigned int origindex);
 
+  /** Defer the conversion of the vertices and polygons until they are first accessed, through
+   * the display arrays, the polygons or EnsureGeometry().
+   * \param converter The function filling the display arrays and polygons of this mesh.
+   * \param hasColliderPolygon True if any polygon to convert uses a collider material.
+   */
+  void SetGeometryConverter(const std::function<void(RAS_MeshObject *)> &converter,
+                            bool hasColliderPolygon);
+  /// Convert the vertices and polygons now if they were deferred.
+  void EnsureGeometry();
+
+  /** Set the collision flag of the polygons using each blender material index, so that the
+   * physics can find the collider polygons of a blender mesh without the converted polygons.
+   */
+  void SetColliderMaterials(const std::vector<bool> &colliders);
+  bool IsColliderMaterial(unsigned int index) const;
+
   // vertex and polygon acces
   RAS_IDisplayArray *GetDisplayArray(unsigned int matid) const;
   RAS_ITexVert *GetVertex(unsigned int matid, unsigned int index);
@@ -156,6 +182,12 @@ class RAS_MeshObject {
 
   Object *GetOriginalObject();
 
+  /** Set a mesh generated during the conversion, drawn instead of the evaluated data of the
+   * original object. The mesh is freed with this object.
+   */
+  void SetGeneratedMesh(Mesh *mesh);
+  Mesh *GetGeneratedMesh() const;
+
   // for construction to find shared vertices
   struct SharedVertex {
     RAS_IDisplayArray *m_darray;
@@ -0,0 +1,157 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+
+#include "util/SampleKernels.h"
+
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <vector>
+
+using namespace aud;
+
+namespace {
+
+std::vector<const SampleKernels *> simd_kernels()
+{
+  std::vector<const SampleKernels *> result;
+  for (SIMDLevel level : {SIMD_SSE2, SIMD_AVX, SIMD_NEON}) {
+    const SampleKernels *kernels = getSampleKernels(level);
+    if (kernels) {
+      result.push_back(kernels);
+    }
+  }
+  return result;
+}
+
+/* Includes values outside of [-1, 1] to cover the clamping of the conversions. */
+std::vector<float> random_samples(int length, unsigned int seed)
+{
+  std::mt19937 rng(seed);
+  std::uniform_real_distribution<float> dist(-1.25f, 1.25f);
+  std::vector<float> result(length);
+  for (float &sample : result) {
+    sample = dist(rng);
+  }
+  if (length > 1) {
+    result[0] = 1.0f;
+    result[1] = -1.0f;
+  }
+  return result;
+}
+
+}  // namespace
+
+TEST(audaspace_sample_kernels, DefaultKernels)
+{
+  const SampleKernels &kernels = getSampleKernels();
+  EXPECT_EQ(getSampleKernels(kernels.level), &kernels);
+  EXPECT_NE(getSampleKernels(SIMD_NONE), nullptr);
+}
+
+TEST(audaspace_sample_kernels, Mixing)
+{
+  const SampleKernels &reference = *getSampleKernels(SIMD_NONE);
+
+  for (const SampleKernels *kernels : simd_kernels()) {
+    for (int length = 0; length < 68; length++) {
+      std::vector<float> source = random_samples(length, length);
+      std::vector<float> target = random_samples(length, length + 1000);
+
+      std::vector<float> expected(target), result(target);
+      reference.add(expected.data(), source.data(), length, 0.7f);
+      kernels->add(result.data(), source.data(), length, 0.7f);
+      for (int i = 0; i < length; i++) {
+        EXPECT_FLOAT_EQ(expected[i], result[i]);
+      }
+
+      expected = target;
+      result = target;
+      reference.scale(expected.data(), length, 0.3f);
+      kernels->scale(result.data(), length, 0.3f);
+      for (int i = 0; i < length; i++) {
+        EXPECT_FLOAT_EQ(expected[i], result[i]);
+      }
+    }
+  }
+}
+
+TEST(audaspace_sample_kernels, MixingRamp)
+{
+  const SampleKernels &reference = *getSampleKernels(SIMD_NONE);
+
+  for (const SampleKernels *kernels : simd_kernels()) {
+    for (int channels = 1; channels <= 3; channels++) {
+      for (int length = 0; length < 68; length++) {
+        std::vector<float> source = random_samples(length * channels, length);
+        std::vector<float> target = random_samples(length * channels, length + 1000);
+
+        std::vector<float> expected(target), result(target);
+        reference.add_ramp(expected.data(), source.data(), length, channels, 0.2f, 0.9f);
+        kernels->add_ramp(result.data(), source.data(), length, channels, 0.2f, 0.9f);
+        for (int i = 0; i < length * channels; i++) {
+          EXPECT_FLOAT_EQ(expected[i], result[i]);
+        }
+      }
+    }
+  }
+}
+
+TEST(audaspace_sample_kernels, Conversion)
+{
+  const SampleKernels &reference = *getSampleKernels(SIMD_NONE);
+
+  for (const SampleKernels *kernels : simd_kernels()) {
+    for (int length = 0; length < 68; length++) {
+      std::vector<float> source = random_samples(length, length);
+
+      std::vector<int16_t> s16_expected(length), s16_result(length);
+      reference.convert_float_s16((data_t *)s16_expected.data(), (data_t *)source.data(), length);
+      kernels->convert_float_s16((data_t *)s16_result.data(), (data_t *)source.data(), length);
+      EXPECT_EQ(s16_expected, s16_result);
+
+      std::vector<int32_t> s32_expected(length), s32_result(length);
+      reference.convert_float_s32((data_t *)s32_expected.data(), (data_t *)source.data(), length);
+      kernels->convert_float_s32((data_t *)s32_result.data(), (data_t *)source.data(), length);
+      EXPECT_EQ(s32_expected, s32_result);
+
+      std::vector<float> expected(length), result(length);
+      reference.convert_s32_float(
+          (data_t *)expected.data(), (data_t *)s32_expected.data(), length);
+      kernels->convert_s32_float((data_t *)result.data(), (data_t *)s32_expected.data(), length);
+      EXPECT_EQ(expected, result);
+
+      reference.convert_s16_float(
+          (data_t *)expected.data(), (data_t *)s16_expected.data(), length);
+
+      /* The 16 bit to float conversion is used in place by the converter reader. */
+      std::vector<float> in_place(length);
+      std::memcpy(in_place.data(), s16_expected.data(), length * sizeof(int16_t));
+      kernels->convert_s16_float((data_t *)in_place.data(), (data_t *)in_place.data(), length);
+      EXPECT_EQ(expected, in_place);
+    }
+  }
+}
+
+TEST(audaspace_sample_kernels, WeightedSum)
+{
+  const SampleKernels &reference = *getSampleKernels(SIMD_NONE);
+
+  for (const SampleKernels *kernels : simd_kernels()) {
+    for (int channels = 1; channels <= 3; channels++) {
+      for (int length = 0; length < 68; length++) {
+        std::vector<float> data = random_samples(length * channels, length);
+        std::vector<float> weights_float = random_samples(length, length + 1000);
+        std::vector<double> weights(weights_float.begin(), weights_float.end());
+
+        std::vector<double> expected(channels, 0.5), result(channels, 0.5);
+        reference.weighted_sum(expected.data(), data.data(), weights.data(), length, channels);
+        kernels->weighted_sum(result.data(), data.data(), weights.data(), length, channels);
+        for (int c = 0; c < channels; c++) {
+          EXPECT_NEAR(expected[c], result[c], 1e-9);
+        }
+      }
+    }
+  }
+}
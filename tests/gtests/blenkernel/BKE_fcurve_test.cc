@@ -209,3 +209,37 @@ TEST(evaluate_fcurve, ExtrapolationBezierKeys)
 
   free_fcurve(fcu);
 }
+
+TEST(evaluate_fcurve, KeyCursor)
+{
+  FCurve *fcu = static_cast<FCurve *>(MEM_callocN(sizeof(FCurve), "FCurve"));
+
+  for (int i = 0; i < 8; i++) {
+    insert_vert_fcurve(
+        fcu, float(i * 2), float((i * 7) % 5), BEZT_KEYTYPE_KEYFRAME, INSERTKEY_NO_USERPREF);
+  }
+
+  /* Forward playback, the cursor should follow the keyframes. */
+  int key_cursor = 0;
+  for (float frame = -1.0f; frame < 16.0f; frame += 0.25f) {
+    EXPECT_NEAR(
+        evaluate_fcurve_cursor(fcu, frame, &key_cursor), evaluate_fcurve(fcu, frame), EPSILON);
+  }
+
+  /* Backward playback and random access, the cursor misses and falls back to a search. */
+  for (float frame = 16.0f; frame > -1.0f; frame -= 0.75f) {
+    EXPECT_NEAR(
+        evaluate_fcurve_cursor(fcu, frame, &key_cursor), evaluate_fcurve(fcu, frame), EPSILON);
+  }
+  const float frames[] = {3.3f, 11.0f, 0.5f, 13.9f, 6.0f - 0.00008f, 1.0f};
+  for (const float frame : frames) {
+    EXPECT_NEAR(
+        evaluate_fcurve_cursor(fcu, frame, &key_cursor), evaluate_fcurve(fcu, frame), EPSILON);
+  }
+
+  /* A stale cursor past the end (keys were removed) must not be used. */
+  key_cursor = 100;
+  EXPECT_NEAR(evaluate_fcurve_cursor(fcu, 5.0f, &key_cursor), evaluate_fcurve(fcu, 5.0f), EPSILON);
+
+  free_fcurve(fcu);
+}
@@ -0,0 +1,196 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The Original Code is Copyright (C) 2020 by Blender Foundation.
+ */
+#include "testing/testing.h"
+
+#include "MEM_guardedalloc.h"
+
+extern "C" {
+#include "BLI_fileops.h"
+#include "BLI_listbase.h"
+#include "BLI_path_util.h"
+#include "BLI_string.h"
+#include "BLI_threads.h"
+
+#include "BKE_appdir.h"
+#include "BKE_pointcache.h"
+
+#include "DNA_object_force_types.h"
+#include "DNA_object_types.h"
+#include "DNA_particle_types.h"
+}
+
+/* Enough points for the attribute chunks to be compressed in parallel. */
+static const unsigned int TOTPOINT = 4096;
+static const unsigned int TOTSPRING = 512;
+static const int TOTFRAME = 3;
+
+/* A frame with location, velocity and extra data chunks. The values vary smoothly, so that the
+ * chunks get smaller when compressed. */
+static PTCacheMem *frame_new(unsigned int frame)
+{
+  PTCacheMem *pm = (PTCacheMem *)MEM_callocN(sizeof(PTCacheMem), __func__);
+  pm->frame = frame;
+  pm->totpoint = TOTPOINT;
+  pm->data_types = (1 << BPHYS_DATA_LOCATION) | (1 << BPHYS_DATA_VELOCITY);
+
+  float(*location)[3] = (float(*)[3])MEM_mallocN(sizeof(float[3]) * TOTPOINT, __func__);
+  float(*velocity)[3] = (float(*)[3])MEM_mallocN(sizeof(float[3]) * TOTPOINT, __func__);
+  for (unsigned int i = 0; i < TOTPOINT; i++) {
+    location[i][0] = (float)(i % 64) * 0.25f;
+    location[i][1] = (float)(i / 64) * 0.25f;
+    location[i][2] = (float)frame * 0.1f;
+    velocity[i][0] = 0.0f;
+    velocity[i][1] = 0.0f;
+    velocity[i][2] = -9.81f * (float)frame;
+  }
+  pm->data[BPHYS_DATA_LOCATION] = location;
+  pm->data[BPHYS_DATA_VELOCITY] = velocity;
+
+  PTCacheExtra *extra = (PTCacheExtra *)MEM_callocN(sizeof(PTCacheExtra), __func__);
+  extra->type = BPHYS_EXTRA_FLUID_SPRINGS;
+  extra->totdata = TOTSPRING;
+  ParticleSpring *springs = (ParticleSpring *)MEM_callocN(sizeof(ParticleSpring) * TOTSPRING,
+                                                          __func__);
+  for (unsigned int i = 0; i < TOTSPRING; i++) {
+    springs[i].rest_length = 0.25f;
+    springs[i].particle_index[0] = i;
+    springs[i].particle_index[1] = i + 1;
+  }
+  extra->data = springs;
+  BLI_addtail(&pm->extradata, extra);
+
+  return pm;
+}
+
+static void expect_frames_equal(const PTCacheMem *pm_a, const PTCacheMem *pm_b)
+{
+  EXPECT_EQ(pm_a->frame, pm_b->frame);
+  EXPECT_EQ(pm_a->totpoint, pm_b->totpoint);
+  ASSERT_EQ(pm_a->data_types, pm_b->data_types);
+
+  const int data_types[2] = {BPHYS_DATA_LOCATION, BPHYS_DATA_VELOCITY};
+  for (int type : data_types) {
+    EXPECT_EQ(memcmp(pm_a->data[type], pm_b->data[type], sizeof(float[3]) * pm_a->totpoint), 0);
+  }
+
+  ASSERT_EQ(BLI_listbase_count(&pm_a->extradata), BLI_listbase_count(&pm_b->extradata));
+  const PTCacheExtra *extra_a = (const PTCacheExtra *)pm_a->extradata.first;
+  const PTCacheExtra *extra_b = (const PTCacheExtra *)pm_b->extradata.first;
+  for (; extra_a; extra_a = extra_a->next, extra_b = extra_b->next) {
+    EXPECT_EQ(extra_a->type, extra_b->type);
+    ASSERT_EQ(extra_a->totdata, extra_b->totdata);
+    EXPECT_EQ(memcmp(extra_a->data, extra_b->data, sizeof(ParticleSpring) * extra_a->totdata),
+              0);
+  }
+}
+
+class PointCacheChunksTest : public testing::Test {
+ protected:
+  Object *ob;
+  SoftBody *sb;
+  PointCache *cache;
+  PTCacheID pid;
+
+  static void SetUpTestCase()
+  {
+    testing::Test::SetUpTestCase();
+    BLI_threadapi_init();
+    BKE_tempdir_init(NULL);
+  }
+
+  static void TearDownTestCase()
+  {
+    BKE_tempdir_session_purge();
+    BLI_threadapi_exit();
+    testing::Test::TearDownTestCase();
+  }
+
+  void SetUp() override
+  {
+    ob = (Object *)MEM_callocN(sizeof(Object), __func__);
+    sb = (SoftBody *)MEM_callocN(sizeof(SoftBody), __func__);
+    sb->shared = (SoftBody_Shared *)MEM_callocN(sizeof(SoftBody_Shared), __func__);
+    cache = sb->shared->pointcache = BKE_ptcache_add(&sb->shared->ptcaches);
+
+    /* An external cache is written in its own directory, without a saved blend file. */
+    cache->flag |= PTCACHE_EXTERNAL;
+    cache->index = 0;
+    cache->endframe = TOTFRAME;
+    BLI_strncpy(cache->name, "chunks", sizeof(cache->name));
+    BLI_join_dirfile(cache->path, sizeof(cache->path), BKE_tempdir_base(), "ptcache_chunks");
+    BLI_path_slash_ensure(cache->path);
+
+    BKE_ptcache_id_from_softbody(&pid, ob, sb);
+  }
+
+  void TearDown() override
+  {
+    cache->flag |= PTCACHE_DISK_CACHE;
+    BKE_ptcache_id_clear(&pid, PTCACHE_CLEAR_ALL, 0);
+    BLI_delete(cache->path, true, false);
+
+    BKE_ptcache_free_list(&sb->shared->ptcaches);
+    MEM_freeN(sb->shared);
+    MEM_freeN(sb);
+    MEM_freeN(ob);
+  }
+
+  /* Write multi-chunk frames to disk and read them back. */
+  void round_trip(int compression)
+  {
+    cache->compression = compression;
+    for (int frame = 1; frame <= TOTFRAME; frame++) {
+      BLI_addtail(&cache->mem_cache, frame_new(frame));
+    }
+
+    cache->flag |= PTCACHE_DISK_CACHE;
+    BKE_ptcache_mem_to_disk(&pid);
+    /* Cleared when writing a frame fails. */
+    ASSERT_TRUE(cache->flag & PTCACHE_DISK_CACHE);
+
+    ListBase written = cache->mem_cache;
+    BLI_listbase_clear(&cache->mem_cache);
+
+    cache->flag &= ~PTCACHE_DISK_CACHE;
+    BKE_ptcache_disk_to_mem(&pid);
+
+    EXPECT_EQ(BLI_listbase_count(&cache->mem_cache), TOTFRAME);
+    const PTCacheMem *pm_read = (const PTCacheMem *)cache->mem_cache.first;
+    const PTCacheMem *pm_written = (const PTCacheMem *)written.first;
+    for (; pm_read && pm_written; pm_read = pm_read->next, pm_written = pm_written->next) {
+      expect_frames_equal(pm_written, pm_read);
+    }
+
+    BKE_ptcache_free_mem(&written);
+  }
+};
+
+TEST_F(PointCacheChunksTest, RoundTripUncompressed)
+{
+  round_trip(PTCACHE_COMPRESS_NO);
+}
+
+TEST_F(PointCacheChunksTest, RoundTripLZO)
+{
+  round_trip(PTCACHE_COMPRESS_LZO);
+}
+
+TEST_F(PointCacheChunksTest, RoundTripLZMA)
+{
+  round_trip(PTCACHE_COMPRESS_LZMA);
+}
@@ -113,6 +113,14 @@ TEST_PARSE_FAIL(Truncated7, "1 and")
 TEST_PARSE_FAIL(Truncated8, "1 or")
 TEST_PARSE_FAIL(Truncated9, "sqrt(1")
 TEST_PARSE_FAIL(Truncated10, "fmod(1,")
+TEST_PARSE_FAIL(Truncated11, "2 **")
+
+TEST_PARSE_FAIL(BadArgCount6, "clamp(1, 2)")
+TEST_PARSE_FAIL(BadArgCount7, "lerp(1, 2)")
+TEST_PARSE_FAIL(BadArgCount8, "log(1, 2, 3)")
+TEST_PARSE_FAIL(Attribute, "noise.random()")
+TEST_PARSE_FAIL(Subscript, "x[0]")
+TEST_PARSE_FAIL(String, "'x'")
 
 /* Constant expression with working constant folding */
 #define TEST_CONST(name, str, value) \
@@ -145,6 +153,8 @@ TEST_CONST(TenE, "1.e+1", 10.0)
 TEST_CONST(Half, ".5", 0.5)
 
 TEST_CONST(Pi, "pi", M_PI)
+TEST_CONST(Tau, "tau", 2.0 * M_PI)
+TEST_CONST(E, "e", M_E)
 TEST_CONST(True, "True", TRUE_VAL)
 TEST_CONST(False, "False", FALSE_VAL)
 
@@ -157,6 +167,31 @@ TEST_EVAL(FMod, "fmod(x, 2)", 3.5, 1.5)
 TEST_CONST(Pow, "pow(4, 0.5)", 2.0)
 TEST_EVAL(Pow, "pow(4, x)", 0.5, 2.0)
 
+TEST_CONST(Log, "log(e)", 1.0)
+TEST_CONST(LogBase, "log(8, 2)", 3.0)
+TEST_EVAL(LogBase, "log(x, 10)", 100.0, 2.0)
+
+TEST_CONST(Round1, "round(1.4)", 1.0)
+TEST_CONST(Round2, "round(2.5)", 2.0)
+TEST_CONST(Round3, "round(-3.5)", -4.0)
+
+TEST_CONST(Hypot, "hypot(3, 4)", 5.0)
+TEST_CONST(CopySign, "copysign(2, -1)", -2.0)
+
+TEST_CONST(Clamp1, "clamp(1.5)", 1.0)
+TEST_CONST(Clamp2, "clamp(-0.5)", 0.0)
+TEST_CONST(Clamp3, "clamp(5, 1, 3)", 3.0)
+TEST_EVAL(Clamp1, "clamp(x)", 0.25, 0.25)
+TEST_EVAL(Clamp2, "clamp(x, -1, 1)", -2.0, -1.0)
+
+TEST_CONST(Lerp, "lerp(2, 4, 0.25)", 2.5)
+TEST_EVAL(Lerp, "lerp(1, 3, x)", 0.5, 2.0)
+
+TEST_CONST(SmoothStep1, "smoothstep(1, 3, 0)", 0.0)
+TEST_CONST(SmoothStep2, "smoothstep(1, 3, 2)", 0.5)
+TEST_CONST(SmoothStep3, "smoothstep(1, 3, 4)", 1.0)
+TEST_EVAL(SmoothStep, "smoothstep(0, 2, x)", 0.5, 0.15625)
+
 TEST_RESULT(Min1, "min(3,1,2)", 1.0)
 TEST_RESULT(Max1, "max(3,1,2)", 3.0)
 TEST_RESULT(Min2, "min(1,2,3)", 1.0)
@@ -181,6 +216,26 @@ TEST_EVAL(BinaryMul, "x*3", 2, 6.0)
 TEST_CONST(BinaryDiv, "3/2", 1.5)
 TEST_EVAL(BinaryDiv, "3/x", 2, 1.5)
 
+TEST_CONST(BinaryFloorDiv1, "7 // 2", 3.0)
+TEST_CONST(BinaryFloorDiv2, "-7 // 2", -4.0)
+TEST_CONST(BinaryFloorDiv3, "1 // 0.1", 9.0)
+TEST_CONST(BinaryFloorDiv4, "-1 // 0.1", -10.0)
+TEST_CONST(BinaryFloorDiv5, "7.5 // -2", -4.0)
+TEST_EVAL(BinaryFloorDiv, "x // 2", 7, 3.0)
+
+TEST_CONST(BinaryMod1, "7 % 3", 1.0)
+TEST_CONST(BinaryMod2, "-7 % 3", 2.0)
+TEST_CONST(BinaryMod3, "7 % -3", -2.0)
+TEST_CONST(BinaryMod4, "-1.5 % 1", 0.5)
+TEST_EVAL(BinaryMod, "x % 3", -7, 2.0)
+
+TEST_CONST(BinaryPow1, "2 ** 3", 8.0)
+TEST_CONST(BinaryPow2, "-2 ** 2", -4.0)
+TEST_CONST(BinaryPow3, "2 ** -1", 0.5)
+TEST_CONST(BinaryPow4, "2 ** 3 ** 2", 512.0)
+TEST_CONST(BinaryPow5, "2 * 3 ** 2", 18.0)
+TEST_EVAL(BinaryPow, "x ** 2", 3, 9.0)
+
 TEST_CONST(Arith1, "1 + -2 * 3", -5.0)
 TEST_CONST(Arith2, "(1 + -2) * 3", -3.0)
 TEST_CONST(Arith3, "-1 + 2 * 3", 5.0)
@@ -318,6 +373,39 @@ TEST_ERROR(Mixed1, "sqrt(x) + 1 / max(0, x)", -1.0, EXPR_PYLIKE_MATH_ERROR)
 TEST_ERROR(Mixed2, "sqrt(x) + 1 / max(0, x)", 0.0, EXPR_PYLIKE_DIV_BY_ZERO)
 TEST_ERROR(Mixed3, "sqrt(x) + 1 / max(0, x)", 1.0, EXPR_PYLIKE_SUCCESS)
 
+TEST_ERROR(ModZero, "1 % x", 0.0, EXPR_PYLIKE_MATH_ERROR)
+TEST_ERROR(PowZero, "x ** -1", 0.0, EXPR_PYLIKE_DIV_BY_ZERO)
+
+TEST(expr_pylike, ParseError)
+{
+  const char *names[1] = {"x"};
+  ExprPyLike_Parsed *expr = BLI_expr_pylike_parse("x * 2", names, ARRAY_SIZE(names));
+
+  EXPECT_EQ(BLI_expr_pylike_parse_error(expr), (const char *)NULL);
+  BLI_expr_pylike_free(expr);
+
+  expr = BLI_expr_pylike_parse("noise.random() + x", names, ARRAY_SIZE(names));
+  EXPECT_STREQ(BLI_expr_pylike_parse_error(expr), "unknown name 'noise'");
+  BLI_expr_pylike_free(expr);
+
+  expr = BLI_expr_pylike_parse("floor_div(x)", names, ARRAY_SIZE(names));
+  EXPECT_STREQ(BLI_expr_pylike_parse_error(expr), "unsupported function 'floor_div'");
+  BLI_expr_pylike_free(expr);
+
+  expr = BLI_expr_pylike_parse("clamp(x, 1)", names, ARRAY_SIZE(names));
+  EXPECT_STREQ(BLI_expr_pylike_parse_error(expr),
+               "wrong number of arguments (2) to function 'clamp'");
+  BLI_expr_pylike_free(expr);
+
+  expr = BLI_expr_pylike_parse("x[0]", names, ARRAY_SIZE(names));
+  EXPECT_STREQ(BLI_expr_pylike_parse_error(expr), "unsupported syntax at column 2: '[0]'");
+  BLI_expr_pylike_free(expr);
+
+  expr = BLI_expr_pylike_parse("", names, ARRAY_SIZE(names));
+  EXPECT_STREQ(BLI_expr_pylike_parse_error(expr), "unexpected end of expression");
+  BLI_expr_pylike_free(expr);
+}
+
 TEST(expr_pylike, Error_Invalid)
 {
   ExprPyLike_Parsed *expr = BLI_expr_pylike_parse("", NULL, 0);
@@ -0,0 +1,173 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The Original Code is Copyright (C) 2020 by Blender Foundation.
+ */
+#include "testing/testing.h"
+
+#include "MEM_guardedalloc.h"
+
+#include "COM_CompositorContext.h"
+#include "COM_Node.h"
+#include "COM_ResultCache.h"
+
+extern "C" {
+#include "BKE_colortools.h"
+#include "BKE_node.h"
+
+#include "BLI_string.h"
+
+#include "DNA_color_types.h"
+#include "DNA_genfile.h"
+#include "DNA_node_types.h"
+#include "DNA_scene_types.h"
+
+#include "RE_pipeline.h"
+}
+
+/** Node without sockets, only its settings are hashed. */
+class SettingsNode : public Node {
+ public:
+  SettingsNode(bNode *editorNode) : Node(editorNode, false)
+  {
+  }
+
+  void convertToOperations(NodeConverter & /*converter*/,
+                           const CompositorContext & /*context*/) const
+  {
+  }
+};
+
+/* The tree is localized for every execution: the keys of copied nodes must match, so that
+ * unchanged results are reused, and differ as soon as a setting of the node changes. */
+class ResultCacheKeyTest : public testing::Test {
+ protected:
+  RenderData rd;
+  CompositorContext context;
+
+  static void SetUpTestCase()
+  {
+    DNA_sdna_current_init();
+  }
+
+  static void TearDownTestCase()
+  {
+    DNA_sdna_current_free();
+  }
+
+  void SetUp() override
+  {
+    memset(&rd, 0, sizeof(rd));
+    rd.cfra = 1;
+    rd.xsch = 64;
+    rd.ysch = 64;
+    rd.size = 100;
+    context.setRenderData(&rd);
+    context.setViewName("");
+  }
+
+  ResultCacheKey key(bNode *b_node)
+  {
+    SettingsNode node(b_node);
+    return ResultCache::node_key(context, &node);
+  }
+
+  static bool keys_equal(const ResultCacheKey &a, const ResultCacheKey &b)
+  {
+    return a.is_valid && b.is_valid && a.hash[0] == b.hash[0] && a.hash[1] == b.hash[1];
+  }
+};
+
+TEST_F(ResultCacheKeyTest, CurveStorageIgnoresPointers)
+{
+  bNodeType type = {};
+  STRNCPY(type.storagename, "CurveMapping");
+
+  bNode b_node = {};
+  b_node.type = CMP_NODE_CURVE_RGB;
+  b_node.typeinfo = &type;
+
+  CurveMapping *cumap = BKE_curvemapping_add(4, 0.0f, 0.0f, 1.0f, 1.0f);
+  BKE_curvemapping_initialize(cumap);
+  b_node.storage = cumap;
+  const ResultCacheKey key_original = key(&b_node);
+
+  /* Same values, different curve and table pointers. */
+  CurveMapping *cumap_copy = BKE_curvemapping_copy(cumap);
+  BKE_curvemapping_initialize(cumap_copy);
+  b_node.storage = cumap_copy;
+  EXPECT_TRUE(keys_equal(key_original, key(&b_node)));
+
+  cumap_copy->cm[3].curve[0].y = 0.25f;
+  EXPECT_FALSE(keys_equal(key_original, key(&b_node)));
+
+  BKE_curvemapping_free(cumap);
+  BKE_curvemapping_free(cumap_copy);
+}
+
+TEST_F(ResultCacheKeyTest, StorageParameterEdit)
+{
+  bNodeType type = {};
+  STRNCPY(type.storagename, "NodeBlurData");
+
+  NodeBlurData data = {};
+  data.sizex = data.sizey = 8;
+
+  bNode b_node = {};
+  b_node.type = CMP_NODE_BLUR;
+  b_node.typeinfo = &type;
+  b_node.storage = &data;
+  const ResultCacheKey key_original = key(&b_node);
+
+  /* A copy of the node, like the localized tree. */
+  NodeBlurData data_copy = data;
+  bNode b_node_copy = b_node;
+  b_node_copy.storage = &data_copy;
+  EXPECT_TRUE(keys_equal(key_original, key(&b_node_copy)));
+
+  data_copy.sizex = 16;
+  EXPECT_FALSE(keys_equal(key_original, key(&b_node_copy)));
+
+  b_node_copy.storage = &data;
+  b_node_copy.custom1 = 1;
+  EXPECT_FALSE(keys_equal(key_original, key(&b_node_copy)));
+}
+
+TEST_F(ResultCacheKeyTest, RenderSlotChange)
+{
+  Scene scene = {};
+  STRNCPY(scene.id.name, "SCResultCacheTest");
+
+  bNodeType type = {};
+  bNode b_node = {};
+  b_node.type = CMP_NODE_R_LAYERS;
+  b_node.typeinfo = &type;
+  b_node.id = &scene.id;
+
+  Render *re = RE_NewSceneRender(&scene);
+  const ResultCacheKey key_original = key(&b_node);
+  EXPECT_TRUE(keys_equal(key_original, key(&b_node)));
+
+  /* Switching render slots swaps the result without a new render. */
+  RenderResult *slot_result = (RenderResult *)MEM_callocN(sizeof(RenderResult), __func__);
+  RE_SwapResult(re, &slot_result);
+  EXPECT_FALSE(keys_equal(key_original, key(&b_node)));
+
+  RE_SwapResult(re, &slot_result);
+  EXPECT_TRUE(keys_equal(key_original, key(&b_node)));
+
+  MEM_freeN(slot_result);
+  RE_FreeRender(re);
+}
@@ -26,6 +26,7 @@ import math
 import pathlib
 import sys
 import tempfile
+import time
 import unittest
 
 import bpy
@@ -251,6 +252,53 @@ class VertexColourImportTest(AbstractAlembicTest):
         self.assertAlmostEqualFloatArray(layer.data[99].color, (0.1294117, 0.3529411, 0.7529411, 1.0))
 
 
+class MeshPrefetchTest(AbstractAlembicTest):
+    """The Mesh Sequence Cache modifier reads the next frames in the background during playback."""
+
+    def setUp(self):
+        super().setUp()
+
+        res = bpy.ops.wm.alembic_import(
+            filepath=str(self.testdir / 'animated-mesh.abc'),
+            as_background_job=False)
+        self.assertEqual({'FINISHED'}, res)
+        self.plane = bpy.context.active_object
+        self.uv_layer = self.plane.data.uv_layers.new(name='Prefetch')
+
+    def play(self, frames):
+        for frame in frames:
+            bpy.context.scene.frame_set(frame)
+            # Give the background thread time to read the next frames.
+            time.sleep(0.1)
+
+    def evaluated_mesh(self):
+        depsgraph = bpy.context.evaluated_depsgraph_get()
+        return self.plane.evaluated_get(depsgraph).to_mesh()
+
+    def test_playback(self):
+        self.play(range(1, 7))
+
+        mesh = self.evaluated_mesh()
+        self.assertAlmostEqual(0.5905638933181763, mesh.vertices[0].co.z)
+        self.assertAlmostEqual(0.5905638933181763, mesh.vertices[3].co.z)
+
+    def test_layer_added_during_playback(self):
+        self.play(range(1, 4))
+        self.plane.data.vertex_colors.new(name='Added')
+        self.play([4])
+
+        mesh = self.evaluated_mesh()
+        self.assertIn('Added', mesh.vertex_colors)
+
+    def test_edit_in_place_during_playback(self):
+        self.play(range(1, 4))
+        self.uv_layer.data[0].uv = (0.25, 0.75)
+        self.play([4])
+
+        mesh = self.evaluated_mesh()
+        self.assertAlmostEqualFloatArray(mesh.uv_layers['Prefetch'].data[0].uv, (0.25, 0.75))
+
+
 class CameraExportImportTest(unittest.TestCase):
     names = [
         'CAM_Unit_Transform',
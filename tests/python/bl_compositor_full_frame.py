@@ -0,0 +1,59 @@
+# Apache License, Version 2.0
+
+# ./blender.bin --background -noaudio --factory-startup \
+#     --python tests/python/bl_compositor_full_frame.py -- --verbose
+import os
+import sys
+import tempfile
+import unittest
+
+import bpy
+
+sys.path.append(os.path.dirname(os.path.realpath(__file__)))
+from compositor_benchmark import build_tree
+
+
+class TestCompositorFullFrame(unittest.TestCase):
+    size = 64
+
+    def setUp(self):
+        self.scene = bpy.context.scene
+        self.tree = build_tree(self.scene, self.size)
+
+        # Lossless float output, so the buffers can be compared exactly.
+        image_settings = self.scene.render.image_settings
+        image_settings.file_format = 'OPEN_EXR'
+        image_settings.color_depth = '32'
+        image_settings.exr_codec = 'NONE'
+        self.scene.view_settings.view_transform = 'Standard'
+
+        self.tempdir = tempfile.TemporaryDirectory()
+
+    def tearDown(self):
+        self.tempdir.cleanup()
+
+    def render_pixels(self, use_full_frame):
+        self.tree.use_full_frame = use_full_frame
+
+        filepath = os.path.join(self.tempdir.name, "full_frame_%d.exr" % use_full_frame)
+        self.scene.render.filepath = filepath
+        bpy.ops.render.render(write_still=True)
+
+        image = bpy.data.images.load(filepath)
+        pixels = image.pixels[:]
+        bpy.data.images.remove(image)
+        return pixels
+
+    def test_matches_tiled(self):
+        pixels_tiled = self.render_pixels(False)
+        pixels_full_frame = self.render_pixels(True)
+
+        self.assertEqual(len(pixels_tiled), self.size * self.size * 4)
+        self.assertEqual(len(pixels_tiled), len(pixels_full_frame))
+        for i, (tiled, full_frame) in enumerate(zip(pixels_tiled, pixels_full_frame)):
+            self.assertAlmostEqual(tiled, full_frame, places=5, msg="component %d" % i)
+
+
+if __name__ == '__main__':
+    sys.argv = [__file__] + (sys.argv[sys.argv.index("--") + 1:] if "--" in sys.argv else [])
+    unittest.main()
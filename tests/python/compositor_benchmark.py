@@ -0,0 +1,125 @@
+# ##### BEGIN GPL LICENSE BLOCK #####
+#
+#  This program is free software; you can redistribute it and/or
+#  modify it under the terms of the GNU General Public License
+#  as published by the Free Software Foundation; either version 2
+#  of the License, or (at your option) any later version.
+#
+#  This program is distributed in the hope that it will be useful,
+#  but WITHOUT ANY WARRANTY; without even the implied warranty of
+#  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#  GNU General Public License for more details.
+#
+#  You should have received a copy of the GNU General Public License
+#  along with this program; if not, write to the Free Software Foundation,
+#  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+#
+# ##### END GPL LICENSE BLOCK #####
+
+# <pep8 compliant>
+
+"""
+Compare the tiled and the full-frame execution of the compositor.
+
+Example Usage:
+
+./blender.bin --background --factory-startup --python tests/python/compositor_benchmark.py -- \
+    --size=2048 --runs=5
+"""
+
+import sys
+import time
+
+import bpy
+
+
+def build_tree(scene, size):
+    scene.use_nodes = True
+    tree = scene.node_tree
+    tree.nodes.clear()
+
+    image = bpy.data.images.new("benchmark", size, size, float_buffer=True)
+    image.generated_type = 'COLOR_GRID'
+
+    nodes = tree.nodes
+    links = tree.links
+
+    node_image = nodes.new("CompositorNodeImage")
+    node_image.image = image
+
+    node_multiply = nodes.new("CompositorNodeMixRGB")
+    node_multiply.blend_type = 'MULTIPLY'
+    node_multiply.inputs[0].default_value = 0.75
+    node_multiply.inputs[2].default_value = (0.8, 0.6, 0.4, 1.0)
+
+    node_screen = nodes.new("CompositorNodeMixRGB")
+    node_screen.blend_type = 'SCREEN'
+    node_screen.inputs[0].default_value = 0.5
+
+    node_bw = nodes.new("CompositorNodeRGBToBW")
+
+    node_math = nodes.new("CompositorNodeMath")
+    node_math.operation = 'MULTIPLY'
+    node_math.inputs[1].default_value = 1.5
+    node_math.use_clamp = True
+
+    node_blend = nodes.new("CompositorNodeMixRGB")
+    node_blend.blend_type = 'MIX'
+
+    node_composite = nodes.new("CompositorNodeComposite")
+
+    links.new(node_image.outputs[0], node_multiply.inputs[1])
+    links.new(node_multiply.outputs[0], node_screen.inputs[1])
+    links.new(node_image.outputs[0], node_screen.inputs[2])
+    links.new(node_screen.outputs[0], node_bw.inputs[0])
+    links.new(node_bw.outputs[0], node_math.inputs[0])
+    links.new(node_math.outputs[0], node_blend.inputs[0])
+    links.new(node_multiply.outputs[0], node_blend.inputs[1])
+    links.new(node_screen.outputs[0], node_blend.inputs[2])
+    links.new(node_blend.outputs[0], node_composite.inputs[0])
+
+    scene.render.resolution_x = size
+    scene.render.resolution_y = size
+    scene.render.resolution_percentage = 100
+    scene.render.use_compositing = True
+    scene.render.use_sequencer = False
+
+    return tree
+
+
+def time_render(runs):
+    best = None
+    for _ in range(runs):
+        start = time.perf_counter()
+        bpy.ops.render.render()
+        elapsed = time.perf_counter() - start
+        best = elapsed if best is None else min(best, elapsed)
+    return best
+
+
+def main():
+    import argparse
+
+    argv = sys.argv[sys.argv.index("--") + 1:] if "--" in sys.argv else []
+
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("--size", type=int, default=2048, help="Width and height of the image")
+    parser.add_argument("--runs", type=int, default=5, help="Number of renders, the best is used")
+    args = parser.parse_args(argv)
+
+    scene = bpy.context.scene
+    tree = build_tree(scene, args.size)
+
+    tree.use_full_frame = False
+    time_tiled = time_render(args.runs)
+
+    tree.use_full_frame = True
+    time_full_frame = time_render(args.runs)
+
+    print("Tiled:      %.4f s" % time_tiled)
+    print("Full-frame: %.4f s" % time_full_frame)
+    print("Speedup:    %.2fx" % (time_tiled / time_full_frame))
+
+
+if __name__ == "__main__":
+    main()